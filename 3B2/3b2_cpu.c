@@ -134,11 +134,6 @@ instr *cpu_instr;
 /* The instruction to use if there is no history storage */
 instr inst;
 
-/* Circular buffer of instructions */
-instr *INST = NULL;
-uint32 cpu_hist_size = 0;
-uint32 cpu_hist_p = 0;
-
 t_bool cpu_in_wait = FALSE;
 
 volatile size_t cpu_exception_stack_depth = 0;
@@ -372,7 +367,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, (1u << 26), NULL, "64M",
       &cpu_set_size, NULL, NULL, "Set Memory to 64M bytes" },
 #endif
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Displays instruction history" },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "VIRTUAL", NULL,
       NULL, &cpu_show_virt, NULL, "Show translation for virtual address" },
@@ -1452,118 +1447,45 @@ t_stat cpu_show_virt(FILE *of, UNIT *uptr, int32 val, CONST void *desc)
 
 t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-    uint32 i, size;
-    t_stat result;
-
-    /* Clear the history buffer if no argument */
-    if (cptr == NULL) {
-        for (i = 0; i < cpu_hist_size; i++) {
-            INST[i].valid = FALSE;
-        }
-        return SCPE_OK;
-    }
-
-    /* Otherwise, get the new length */
-    size = (uint32) get_uint(cptr, 10, MAX_HIST_SIZE, &result);
-
-    /* If no length was provided, give up */
-    if (result != SCPE_OK) {
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, MAX_HIST_SIZE);
-    }
-
-    /* Legnth 0 is a special flag that means disable the feature. */
-    if (size == 0) {
-        if (INST != NULL) {
-            for (i = 0; i < cpu_hist_size; i++) {
-                INST[i].valid = FALSE;
-            }
-        }
-        cpu_hist_size = 0;
-        cpu_hist_p = 0;
-        return SCPE_OK;
-    }
-
-    /* Reinitialize the new history ring bufer */
-    cpu_hist_p = 0;
-    if (size > 0) {
-        if (INST != NULL) {
-            free(INST);
-        }
-        INST = (instr *)calloc(size, sizeof(instr));
-        if (INST == NULL) {
-            return SCPE_MEM;
-        }
-        memset(INST, 0, sizeof(instr) * size);
-        cpu_hist_size = size;
-    }
-
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(instr), &cpu_fprint_hist, 0, MAX_HIST_SIZE, cptr);
 }
 
 t_stat cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-    uint32 i;
-    size_t j, count;
-    char *cptr = (char *) desc;
-    t_stat result;
-    instr *ip;
-
-    int32 di;
-
-    if (cpu_hist_size == 0) {
-        return SCPE_NOFNC;
-    }
+    return sim_hist_show(st, &cpu_dev, sizeof(instr), &cpu_fprint_hist, (CONST char *) desc);
+}
 
-    /* 'count' is the number of history entries the user wants */
+void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed)
+{
+    uint32 j;
+    const instr *ip = (const instr *) rec;
 
-    if (cptr) {
-        count = (size_t) get_uint(cptr, 10, cpu_hist_size, &result);
-        if ((result != SCPE_OK) || (count == 0)) {
-            return SCPE_ARG;
-        }
-    } else {
-        count = cpu_hist_size;
+    if (ip == NULL) {
+        fprintf(st, "PSW      SP       PC        IR\n\n");
+        return;
     }
 
-    /* Position for reading from ring buffer */
-    di = (int32) (cpu_hist_p - count);
+    fprintf(st, "%08x %08x %08x  ", ip->psw, ip->sp, ip->pc);
 
-    if (di < 0) {
-        di = di + (int32) cpu_hist_size;
+    /* An instruction that faulted while being decoded is left invalid */
+    if (!ip->valid || ip->mn == NULL || ip->mn->op_count < 0) {
+        fprintf(st, "???");
+        return;
     }
 
-    fprintf(st, "PSW      SP       PC        IR\n");
+    /* Show the opcode mnemonic and operands */
+    fprint_sym_hist(st, (instr *) ip);
 
-    for (i = 0; i < count; i++) {
-        if (stop_cpu) {                                     /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                                          /* abandon remaining output */
-        }
-        ip = &INST[(di++) % (int32) cpu_hist_size];
-        if (ip->valid) {
-            /* Show the opcode mnemonic */
-            fprintf(st, "%08x %08x %08x  ", ip->psw, ip->sp, ip->pc);
-            /* Show the operand data */
-            if (ip->mn == NULL || ip->mn->op_count < 0) {
-                fprintf(st, "???");
-            } else {
-                fprint_sym_hist(st, ip);
-                if (ip->mn->op_count > 0 && ip->mn->mode == OP_DESC) {
-                    fprintf(st, "\n                            ");
-                    for (j = 0; j < (uint32) ip->mn->op_count; j++) {
-                        fprintf(st, "%08x", ip->operands[j].data);
-                        if (j < (uint32) ip->mn->op_count - 1) {
-                            fputc(' ', st);
-                        }
-                    }
-                }
+    /* Show the operand data */
+    if (ip->mn->op_count > 0 && ip->mn->mode == OP_DESC) {
+        fprintf(st, "\n                            ");
+        for (j = 0; j < (uint32) ip->mn->op_count; j++) {
+            fprintf(st, "%08x", ip->operands[j].data);
+            if (j < (uint32) ip->mn->op_count - 1) {
+                fputc(' ', st);
             }
-            fputc('\n', st);
         }
     }
-
-
-    return SCPE_OK;
 }
 
 void cpu_register_name(uint8 reg, char *buf, size_t len) {
@@ -2334,6 +2256,11 @@ t_stat sim_instr(void)
 
     stop_reason = 0;
 
+#if defined(REV3)
+    /* The PDC may have been modified from SCP since the last run */
+    mmu_pdc_invalidate();
+#endif
+
     abort_reason = (uint32) setjmp(save_env);
 
     /* Exception handler.
@@ -2479,9 +2406,9 @@ t_stat sim_instr(void)
         /* R[NUM_PSW] |= PSW_TM_MASK; */
 
         /* Record the instruction for history */
-        if (cpu_hist_size > 0) {
-            cpu_instr = &INST[cpu_hist_p];
-            cpu_hist_p = (cpu_hist_p + 1) % cpu_hist_size;
+        if (sim_hist_lnt > 0) {
+            cpu_instr = (instr *)sim_hist_add();
+            cpu_instr->valid = FALSE;
         } else {
             cpu_instr = &inst;
         }
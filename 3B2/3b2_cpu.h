@@ -601,6 +601,7 @@ t_stat cpu_reset(DEVICE *dptr);
 t_stat cpu_set_size(UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed);
 t_stat cpu_show_virt(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_show_stack(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_show_cio(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
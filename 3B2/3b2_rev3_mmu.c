@@ -77,6 +77,8 @@ MTAB mmu_mod[] = {
       NULL, &mmu_show_sdc, NULL, "Display SD Cache" },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "PDC", NULL,
       NULL, &mmu_show_pdc, NULL, "Display PD Cache" },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "PDCBENCH", NULL,
+      NULL, &mmu_show_pdc_bench, NULL, "Benchmark PD Cache lookup" },
     { 0 }
 };
 
@@ -152,6 +154,166 @@ uint32 pd_psl_masks[4] = {
 
 #define PDC_TAG(VA)     (MMU_CONF_MCE ? PDC_MTAG(VA) : PDC_STAG(VA))
 
+/*
+ * Host-side index into the Page Descriptor Cache.
+ *
+ * The PDC is architecturally fully associative, and the real
+ * hardware compares all 64 tags in parallel. Scanning every entry
+ * on each translation is far too slow in software, so we keep a
+ * small hash table of chains, keyed on the masked PDC tag, that
+ * points back into the architectural pdch/pdcl arrays. Only entries
+ * with a set G bit are indexed, since no other entry can ever
+ * match a lookup.
+ *
+ * The index is purely a shadow of the architectural state. Any
+ * operation that changes more than one tag at a time (a full flush,
+ * a change of page size or context mode, a peripheral write to the
+ * PDC, or a deposit from SCP) simply marks it invalid, and it is
+ * rebuilt on the next lookup.
+ *
+ * The U bits are shadowed as a bitmask so that the "all U bits set"
+ * check no longer scans the cache on every hit.
+ */
+#define PDC_HASH_SIZE   256
+#define PDC_HASH_NONE   0xff
+
+/* Hash on VA bits 13 and up, which are significant at every page size */
+#define PDC_HASH(TAG)   ((((TAG) >> 7) ^ ((TAG) >> 15) ^ ((TAG) >> 26)) & \
+                         (PDC_HASH_SIZE - 1))
+
+#define PDC_BIT(i)      (((t_uint64)1) << (i))
+#define PDC_ALL_U       (~((t_uint64)0))
+
+static struct {
+    t_bool   valid;                     /* Index matches pdch[] */
+    uint32   mask;                      /* PDC_TAG_MASK at build time */
+    t_uint64 u_bits;                    /* Shadow of the PDC U bits */
+    uint8    head[PDC_HASH_SIZE];       /* First slot in each chain */
+    uint8    next[MMU_PDCS];            /* Next slot in the same chain */
+    uint8    hash[MMU_PDCS];            /* Chain holding each slot */
+    uint32   tag[MMU_PDCS];             /* Masked tag of each slot */
+} pdc_index;
+
+static void pdc_index_add(uint32 slot)
+{
+    uint32 tag = mmu_state.pdch[slot] & pdc_index.mask;
+    uint8 h = PDC_HASH(tag);
+
+    pdc_index.tag[slot] = tag;
+    pdc_index.hash[slot] = h;
+    pdc_index.next[slot] = pdc_index.head[h];
+    pdc_index.head[h] = (uint8) slot;
+}
+
+static void pdc_index_remove(uint32 slot)
+{
+    uint8 *link = &pdc_index.head[pdc_index.hash[slot]];
+
+    while (*link != PDC_HASH_NONE) {
+        if (*link == slot) {
+            *link = pdc_index.next[slot];
+            break;
+        }
+        link = &pdc_index.next[*link];
+    }
+
+    pdc_index.hash[slot] = PDC_HASH_NONE;
+}
+
+static void pdc_index_rebuild()
+{
+    uint32 i;
+
+    memset(pdc_index.head, PDC_HASH_NONE, sizeof(pdc_index.head));
+    memset(pdc_index.hash, PDC_HASH_NONE, sizeof(pdc_index.hash));
+    pdc_index.mask = PDC_TAG_MASK;
+    pdc_index.u_bits = 0;
+
+    /* Insert in reverse so each chain is ordered by slot number */
+    for (i = MMU_PDCS; i-- > 0; ) {
+        if (mmu_state.pdch[i] & PDC_U_MASK) {
+            pdc_index.u_bits |= PDC_BIT(i);
+        }
+        if (mmu_state.pdch[i] & PDC_G_MASK) {
+            pdc_index_add(i);
+        }
+    }
+
+    pdc_index.valid = TRUE;
+}
+
+/*
+ * Discard the PDC index. It will be rebuilt from the architectural
+ * cache contents on the next lookup.
+ */
+void mmu_pdc_invalidate()
+{
+    pdc_index.valid = FALSE;
+}
+
+/*
+ * Find the lowest numbered PDC slot whose tag matches key_tag, or
+ * return MMU_PDCS if there is none. This is exactly the entry that a
+ * linear scan of the cache would have found.
+ */
+static uint32 pdc_lookup(uint32 key_tag)
+{
+    uint8 i;
+    uint32 found = MMU_PDCS;
+
+    for (i = pdc_index.head[PDC_HASH(key_tag)];
+         i != PDC_HASH_NONE;
+         i = pdc_index.next[i]) {
+        if (pdc_index.tag[i] == key_tag && i < found) {
+            found = i;
+        }
+    }
+
+    return found;
+}
+
+static uint32 pdc_find(uint32 key_tag)
+{
+    /* SCP may have modified the cache behind our back */
+    if (!pdc_index.valid || !sim_is_running) {
+        pdc_index_rebuild();
+    }
+
+    return pdc_lookup(key_tag);
+}
+
+/*
+ * Find a matching PDC slot by scanning the whole cache. This is the
+ * reference behavior that the index must reproduce, and is only used
+ * by the PDC benchmark.
+ */
+static uint32 pdc_scan(uint32 key_tag)
+{
+    uint32 i;
+
+    for (i = 0; i < MMU_PDCS; i++) {
+        if ((mmu_state.pdch[i] & PDC_TAG_MASK) == key_tag) {
+            return i;
+        }
+    }
+
+    return MMU_PDCS;
+}
+
+/*
+ * Clear the G and U bits of a PDC entry, removing it from the index.
+ */
+static void pdc_clear_entry(uint32 slot)
+{
+    mmu_state.pdch[slot] &= ~(PDC_G_MASK|PDC_U_MASK);
+    if (pdc_index.valid) {
+        pdc_index.u_bits &= ~PDC_BIT(slot);
+        if (pdc_index.hash[slot] != PDC_HASH_NONE) {
+            pdc_index_remove(slot);
+        }
+    }
+}
+
 /*
  * Retrieve a Segment Descriptor from the SD cache. The Segment
  * Descriptor Cache entry is returned in sd_lo and sd_hi, if found.
@@ -199,19 +361,19 @@ static void put_sdce(uint32 va, uint32 sd_hi, uint32 sd_lo)
  */
 static void set_u_bit(uint32 index)
 {
-    uint32 i;
-
     mmu_state.pdch[index] |= PDC_U_MASK;
 
+    if (!pdc_index.valid) {
+        pdc_index_rebuild();
+    }
+
+    pdc_index.u_bits |= PDC_BIT(index);
+
     /* Check to see if all U bits have been set. If so, the cache will
      * need to be flushed on the next put */
-    for (i = 0; i < MMU_PDCS; i++) {
-        if ((mmu_state.pdch[i] & PDC_U_MASK) == 0) {
-            return;
-        }
+    if (pdc_index.u_bits == PDC_ALL_U) {
+        mmu_state.flush_u = TRUE;
     }
-
-    mmu_state.flush_u = TRUE;
 }
 
 /*
@@ -220,28 +382,27 @@ static void set_u_bit(uint32 index)
  */
 static t_stat get_pdce(uint32 va, uint32 *pd, uint8 *pd_acc, uint32 *pdc_idx)
 {
-    uint32 i, key_tag, target_tag;
+    uint32 i, key_tag;
 
     *pdc_idx = 0;
 
-    /* This is a fully associative cache, so we must scan for an entry
-       with the correct tag. */
+    /* This is a fully associative cache, so we must look up the entry
+       with the correct tag in the host-side index. */
     key_tag = PDC_TAG(va) & PDC_TAG_MASK;
 
-    for (i = 0; i < MMU_PDCS; i++) {
-        target_tag = mmu_state.pdch[i] & PDC_TAG_MASK;
-        if (target_tag == key_tag) {
-            /* Construct the PD from the cached version */
-            *pd = PDCE_TO_PD(mmu_state.pdcl[i]);
-            *pd_acc = (mmu_state.pdcl[i] >> 24) & 0xff;
-            *pdc_idx = i;
-            sim_debug(MMU_TRACE_DBG, &mmu_dev,
-                      "PDC HIT. va=%08x idx=%d tag=%03x pd=%08x pdcl=%08x pdch=%08x\n",
-                      va, i, key_tag, *pd,
-                      mmu_state.pdcl[i], mmu_state.pdch[i]);
-            set_u_bit(i);
-            return SCPE_OK;
-        }
+    i = pdc_find(key_tag);
+
+    if (i < MMU_PDCS) {
+        /* Construct the PD from the cached version */
+        *pd = PDCE_TO_PD(mmu_state.pdcl[i]);
+        *pd_acc = (mmu_state.pdcl[i] >> 24) & 0xff;
+        *pdc_idx = i;
+        sim_debug(MMU_TRACE_DBG, &mmu_dev,
+                  "PDC HIT. va=%08x idx=%d tag=%03x pd=%08x pdcl=%08x pdch=%08x\n",
+                  va, i, key_tag, *pd,
+                  mmu_state.pdcl[i], mmu_state.pdch[i]);
+        set_u_bit(i);
+        return SCPE_OK;
     }
 
     sim_debug(MMU_CACHE_DBG, &mmu_dev,
@@ -256,8 +417,14 @@ static t_stat get_pdce(uint32 va, uint32 *pd, uint8 *pd_acc, uint32 *pdc_idx)
  */
 static void put_pdce_at(uint32 va, uint32 sd_lo, uint32 pd, uint32 slot)
 {
+    if (pdc_index.valid && pdc_index.hash[slot] != PDC_HASH_NONE) {
+        pdc_index_remove(slot);
+    }
     mmu_state.pdcl[slot] = PD_TO_PDCL(pd, sd_lo);
     mmu_state.pdch[slot] = VA_TO_PDCH(va, sd_lo);
+    if (pdc_index.valid) {
+        pdc_index_add(slot);
+    }
     sim_debug(MMU_CACHE_DBG, &mmu_dev,
               "Caching MMU PDC entry at index %d (pdc_hi=%08x pdc_lo=%08x va=%08x)\n",
               slot, mmu_state.pdch[slot], mmu_state.pdcl[slot], va);
@@ -286,6 +453,9 @@ static uint32 put_pdce(uint32 va, uint32 sd_lo, uint32 pd)
                 mmu_state.pdch[i] &= ~(PDC_U_MASK);
             }
         }
+        if (pdc_index.valid) {
+            pdc_index.u_bits &= PDC_BIT(mmu_state.last_cached);
+        }
     }
 
     /* TODO: This can be done in one pass! Clean it up */
@@ -320,41 +490,40 @@ static uint32 put_pdce(uint32 va, uint32 sd_lo, uint32 pd)
  */
 static void flush_pdc(uint32 va)
 {
-    uint32 i, j, key_tag, target_tag;
+    uint32 i, j, key_tag;
 
     /* Flush the PDC. This is a fully associative cache, so we must
-     * scan for an entry with the correct tag. */
+     * look up the entry with the correct tag in the index. */
 
     key_tag = PDC_TAG(va) & PDC_TAG_MASK;
 
-    for (i = 0; i < MMU_PDCS; i++) {
-        target_tag = mmu_state.pdch[i] & PDC_TAG_MASK;
-        if (target_tag == key_tag) {
+    i = pdc_find(key_tag);
+
+    if (i < MMU_PDCS) {
+        sim_debug(MMU_CACHE_DBG, &mmu_dev,
+                  "Flushing MMU PDC entry pdc_lo=%08x pdc_hi=%08x index %d (va=%08x)\n",
+                  mmu_state.pdcl[i],
+                  mmu_state.pdch[i],
+                  i,
+                  va);
+        if (mmu_state.pdch[i] & PDC_C_MASK) {
             sim_debug(MMU_CACHE_DBG, &mmu_dev,
-                      "Flushing MMU PDC entry pdc_lo=%08x pdc_hi=%08x index %d (va=%08x)\n",
-                      mmu_state.pdcl[i],
-                      mmu_state.pdch[i],
-                      i,
-                      va);
-            if (mmu_state.pdch[i] & PDC_C_MASK) {
-                sim_debug(MMU_CACHE_DBG, &mmu_dev,
-                          "Flushing MMU PDC entry: CONTIGUOUS\n");
-                /* If this PD came from a contiguous SD, we need to
-                 * flush ALL entries belonging to the same SD. All
-                 * pages within the same segment have the same upper
-                 * 11 bits. */
-                for (j = 0; j < MMU_PDCS; j++) {
-                    if ((mmu_state.pdch[j] & 0x3ffc000) ==
-                        (mmu_state.pdch[i] & 0x3ffc000)) {
-                        mmu_state.pdch[j] &= ~(PDC_G_MASK|PDC_U_MASK);
-                    }
+                      "Flushing MMU PDC entry: CONTIGUOUS\n");
+            /* If this PD came from a contiguous SD, we need to
+             * flush ALL entries belonging to the same SD. All
+             * pages within the same segment have the same upper
+             * 11 bits. */
+            for (j = 0; j < MMU_PDCS; j++) {
+                if ((mmu_state.pdch[j] & 0x3ffc000) ==
+                    (mmu_state.pdch[i] & 0x3ffc000)) {
+                    pdc_clear_entry(j);
                 }
-            } else {
-                /* Otherwise, just flush the one entry */
-                mmu_state.pdch[i] &= ~(PDC_G_MASK|PDC_U_MASK);
             }
-            return;
+        } else {
+            /* Otherwise, just flush the one entry */
+            pdc_clear_entry(i);
         }
+        return;
     }
 
     sim_debug(MMU_CACHE_DBG, &mmu_dev,
@@ -381,6 +550,8 @@ static void flush_caches()
         mmu_state.pdch[i] &= ~PDC_G_MASK;
         mmu_state.pdch[i] &= ~PDC_U_MASK;
     }
+
+    mmu_pdc_invalidate();
 }
 
 /*
@@ -572,6 +743,7 @@ void mmu_write(uint32 pa, uint32 val, size_t size)
                   "MMU_PDCH[%d] = %08x\n",
                   index, val);
         mmu_state.pdch[index] = val;
+        mmu_pdc_invalidate();
         break;
     case MMU_FDCR:
         sim_debug(MMU_WRITE_DBG, &mmu_dev,
@@ -603,6 +775,7 @@ void mmu_write(uint32 pa, uint32 val, size_t size)
                 mmu_state.pdch[i] &= ~(PDC_G_MASK);
             }
         }
+        mmu_pdc_invalidate();
         break;
     case MMU_SRAMB:
         index = index & 3;
@@ -630,6 +803,8 @@ void mmu_write(uint32 pa, uint32 val, size_t size)
         break;
     case MMU_CONF:
         mmu_state.conf = val & 0x7f;
+        /* Tag masks depend on page size and context mode */
+        mmu_pdc_invalidate();
         sim_debug(MMU_WRITE_DBG, &mmu_dev,
                   "MMU_CONF = %02x (M=%d R=%d $=%d PS=%d MCE=%d DCE=%d)\n",
                   val,
@@ -1129,6 +1304,78 @@ t_stat mmu_show_pdc(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
     return SCPE_OK;
 }
 
+/*
+ * Measure the host cost of a PD Cache lookup.
+ *
+ * The cache is filled with a synthetic set of entries, and every
+ * entry is then looked up repeatedly, once with a linear scan of the
+ * cache (the original lookup algorithm) and once through the hashed
+ * index. Both must find the same slot for every tag. The MMU state
+ * is restored when done, so this is safe to run at any time.
+ */
+#define PDC_BENCH_ROUNDS 100000
+
+t_stat mmu_show_pdc_bench(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+    MMU_STATE saved_state;
+    uint32 keys[MMU_PDCS];
+    uint32 i, round, va, mismatches = 0;
+    uint32 start, scan_ms, hash_ms;
+    volatile uint32 sink = 0;
+    double lookups;
+
+    saved_state = mmu_state;
+
+    /* Single-context mode, 2K pages: VAs spread across all sections */
+    mmu_state.conf = 0;
+    for (i = 0; i < MMU_PDCS; i++) {
+        va = ((i & 3) << 30) | ((i * 0x9e3779b9u) & 0x3ffff800u);
+        mmu_state.pdcl[i] = 0;
+        mmu_state.pdch[i] = VA_TO_PDCH(va, 0);
+        keys[i] = PDC_TAG(va) & PDC_TAG_MASK;
+    }
+    pdc_index_rebuild();
+
+    for (i = 0; i < MMU_PDCS; i++) {
+        if (pdc_scan(keys[i]) != pdc_lookup(keys[i])) {
+            mismatches++;
+        }
+    }
+
+    start = sim_os_msec();
+    for (round = 0; round < PDC_BENCH_ROUNDS; round++) {
+        for (i = 0; i < MMU_PDCS; i++) {
+            sink += pdc_scan(keys[i]);
+        }
+    }
+    scan_ms = sim_os_msec() - start;
+
+    start = sim_os_msec();
+    for (round = 0; round < PDC_BENCH_ROUNDS; round++) {
+        for (i = 0; i < MMU_PDCS; i++) {
+            sink += pdc_lookup(keys[i]);
+        }
+    }
+    hash_ms = sim_os_msec() - start;
+
+    mmu_state = saved_state;
+    mmu_pdc_invalidate();
+
+    lookups = (double) PDC_BENCH_ROUNDS * MMU_PDCS;
+
+    fprintf(st, "\nPage Descriptor Cache lookup (%.0f lookups)\n\n", lookups);
+    fprintf(st, "Linear scan:   %8u ms  %8.2f ns/lookup\n",
+            scan_ms, (scan_ms * 1.0e6) / lookups);
+    fprintf(st, "Hashed index:  %8u ms  %8.2f ns/lookup\n",
+            hash_ms, (hash_ms * 1.0e6) / lookups);
+    if (mismatches) {
+        fprintf(st, "ERROR: %u lookups disagree with the linear scan\n", mismatches);
+        return SCPE_IERR;
+    }
+
+    return SCPE_OK;
+}
+
 /*
  * Display the segment table for a section.
  */
@@ -350,9 +350,11 @@ t_stat mmu_decode_vaddr(uint32 vaddr, uint8 r_acc,
 t_stat mmu_decode_va(uint32 va, uint8 r_acc, t_bool fc, uint32 *pa);
 void   mmu_enable();
 void   mmu_disable();
+void   mmu_pdc_invalidate();
 
 t_stat mmu_show_sdt(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat mmu_show_sdc(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat mmu_show_pdc(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+t_stat mmu_show_pdc_bench(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 
 #endif /* _3B2_REV3_MMU_H_ */
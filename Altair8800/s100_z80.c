@@ -134,6 +134,7 @@ static int32 poc = TRUE; /* Power On Clear */
 static t_stat z80_set_chiptype      (UNIT *uptr, int32 value, const char *cptr, void *desc);
 static t_stat z80_set_hist          (UNIT *uptr, int32 val, const char *cptr, void *desc);
 static t_stat z80_show_hist         (FILE *st, UNIT *uptr, int32 val, const void *desc);
+static void z80_fprint_hist         (FILE *st, const void *rec, t_bool timed);
 static t_stat z80_show              (FILE *st, UNIT *uptr, int32 val, const void *desc);
 static t_stat chip_show             (FILE *st, UNIT *uptr, int32 val, const void *desc);
 static t_stat z80_reset(DEVICE *dptr);
@@ -178,7 +179,6 @@ static  uint32 executedTStates  = 0;                /* executed t-states
 #define HIST_MAX    8192
 
 typedef struct {
-    uint8 valid;
     uint16 af;
     uint16 bc;
     uint16 de;
@@ -194,9 +194,6 @@ typedef struct {
     t_value op[INST_MAX_BYTES];
 } insthist_t;
 
-static uint32 hst_p = 0;                        /* history pointer          */
-static uint32 hst_lnt = 0;                      /* history length           */
-static insthist_t *hst = NULL;                  /* instruction history      */
 
 static REG z80_reg[] = {
     // 8080 and Z80 registers
@@ -250,7 +247,7 @@ static MTAB z80_mod[] = {
         NULL, "Enable verbose messages"     },
     { UNIT_CPU_VERBOSE,     0,                  "QUIET",        "QUIET",        NULL, NULL,
         NULL, "Disable verbose messages"                },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALO|MTAB_SHP, 0, "HISTORY", "HISTORY",   &z80_set_hist, &z80_show_hist,
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",   &z80_set_hist, &z80_show_hist,
       NULL, "Instruction history buffer"},
     { 0 }
 };
@@ -5614,27 +5611,24 @@ t_stat z80_instr(void)
         /*
         ** Save in instruction history ring buffer
         */
-        if (hst_lnt && ((z80_chiptype == CHIP_TYPE_8080) || (z80_chiptype == CHIP_TYPE_Z80))) {
-            hst[hst_p].valid = 1;
-            hst[hst_p].pc = PCX;
-            hst[hst_p].sp = SP;
-            hst[hst_p].af = AF;
-            hst[hst_p].bc = BC;
-            hst[hst_p].de = DE;
-            hst[hst_p].hl = HL;
-            hst[hst_p].af1 = AF1_S;
-            hst[hst_p].bc1 = BC1_S;
-            hst[hst_p].de1 = DE1_S;
-            hst[hst_p].hl1 = HL1_S;
-            hst[hst_p].ix = IX;
-            hst[hst_p].iy = IY;
+        if (sim_hist_lnt && ((z80_chiptype == CHIP_TYPE_8080) || (z80_chiptype == CHIP_TYPE_Z80))) {
+            insthist_t *h = (insthist_t *) sim_hist_add();
+
+            h->pc = PCX;
+            h->sp = SP;
+            h->af = AF;
+            h->bc = BC;
+            h->de = DE;
+            h->hl = HL;
+            h->af1 = AF1_S;
+            h->bc1 = BC1_S;
+            h->de1 = DE1_S;
+            h->hl1 = HL1_S;
+            h->ix = IX;
+            h->iy = IY;
 
             for (i = 0; i < INST_MAX_BYTES; i++) {
-                hst[hst_p].op[i] = s100_bus_memr(PCX + i);
-            }
-
-            if (++hst_p == hst_lnt) {
-                hst_p = 0;
+                h->op[i] = s100_bus_memr(PCX + i);
             }
         }
 
@@ -5772,9 +5766,6 @@ static t_stat z80_set_chiptype(UNIT *uptr, int32 value, const char *cptr, void *
 
 static t_stat z80_set_hist(UNIT *uptr, int32 val, const char *cptr, void *desc)
 {
-    uint32 i, lnt;
-    t_stat r;
-
     if ((z80_chiptype >= 0) && (z80_chiptype != CHIP_TYPE_8080) && (z80_chiptype != CHIP_TYPE_Z80)) {
         sim_printf("History not supported for chiptype: %s\n",
                (z80_chiptype < NUM_CHIP_TYPE) ? z80_mod[z80_chiptype].mstring : "????");
@@ -5784,63 +5775,16 @@ static t_stat z80_set_hist(UNIT *uptr, int32 val, const char *cptr, void *desc)
     /*
     ** If cptr is NULL, reset ring buffer ("SET HISTORY")
     */
-    if (cptr == NULL) {
-        if (hst == NULL) {
-            sim_printf("History buffer not enabled.\n");
-            return SCPE_NOFNC;
-        }
-
-        for (i = 0; i < hst_lnt; i++) {
-            hst[i].valid = 0;
-        }
-
-        hst_p = 0;
-
-        return SCPE_OK;
-    }
-
-    /*
-    ** Enable/Resize ring buffer ("SET HISTORY=<n>")
-    */
-    lnt = (uint32) get_uint (cptr, 10, HIST_MAX, &r);
-
-    if ((r != SCPE_OK) || (lnt && (lnt < HIST_MIN))) {
-        sim_printf("History buffer minimum/maximum size: %d/%d\n", HIST_MIN, HIST_MAX);
-        return SCPE_ARG;
-    }
-
-    /*
-    ** Delete old history buffer
-    */
-    if (hst!=NULL) {
-        free (hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-
-    hst_p = 0;
-
-    /*
-    ** If a length was specified, allocate new buffer ("SET HISTORY=<n>" where n>0)
-    */
-    if (lnt) {
-        hst = (insthist_t *) calloc (lnt, sizeof (insthist_t));
-        if (hst == NULL) {
-            return SCPE_MEM;
-        }
-        hst_lnt = lnt;
+    if ((cptr == NULL) && (sim_hist_lnt == 0)) {
+        sim_printf("History buffer not enabled.\n");
+        return SCPE_NOFNC;
     }
 
-    return SCPE_OK;
+    return sim_hist_set(&z80_dev, sizeof(insthist_t), &z80_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 t_stat z80_show_hist (FILE *st, UNIT *uptr, int32 val, const void *desc)
 {
-    int32 k, di, lnt;
-    const char *cptr = (const char *) desc;
-    t_stat r;
-    insthist_t *h;
-
     if ((z80_chiptype != CHIP_TYPE_8080) && (z80_chiptype != CHIP_TYPE_Z80)) {
         sim_printf("History not supported for chiptype: %s\n",
             (0 <= z80_chiptype) && (z80_chiptype < NUM_CHIP_TYPE) ?
@@ -5848,68 +5792,53 @@ t_stat z80_show_hist (FILE *st, UNIT *uptr, int32 val, const void *desc)
         return SCPE_NOFNC;
     }
 
-    if (hst_lnt == 0) {
-        return SCPE_NOFNC;                    /* enabled? */
-    }
+    return sim_hist_show(st, &z80_dev, sizeof(insthist_t), &z80_fprint_hist, (const char *) desc);
+}
 
-    if (cptr) {
-        lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
+static void z80_fprint_hist(FILE *st, const void *rec, t_bool timed)
+{
+    const insthist_t *h = (const insthist_t *) rec;
+    t_value op[INST_MAX_BYTES];
+    int32 i;
 
-        if ((r != SCPE_OK) || (lnt == 0)) {
-            return SCPE_ARG;
-        }
-    } else {
-        lnt = hst_lnt;
+    if (h == NULL) {                                 /* no column headings */
+        return;
     }
 
-    di = hst_p - lnt;
-
-    if (di < 0) di = di + hst_lnt;
-
-    for (k = 0; k < lnt; k++) {
-        if (stop_cpu) {                              /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                                   /* abandon remaining output */
-        }
-        h = &hst[(di++) % hst_lnt];
-
-        if (h->valid) {                              /* valid entry? */
-            if (z80_chiptype == CHIP_TYPE_8080) {
-                /*
-                ** Use DDT output:
-                ** CfZfMfEfIf A=bb B=dddd D=dddd H=dddd S=dddd P=dddd inst
-                */
-                fprintf(st, "Z80: C%dZ%dM%dE%dI%d A=%02X B=%04X D=%04X H=%04X S=%04X P=%04X ",
-                    TSTFLAG2(h->af, C),
-                    TSTFLAG2(h->af, Z),
-                    TSTFLAG2(h->af, S),
-                    TSTFLAG2(h->af, P),
-                    TSTFLAG2(h->af, H),
-                    HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
-                fprint_sym (st, h->pc, h->op, &z80_unit, SWMASK ('M'));
-                fprintf(st, "\n");
-            } else {    /* Z80 */
-                /*
-                ** Use DDT/Z output:
-                */
-                fprintf(st, "Z80: C%dZ%dS%dV%dH%dN%d A =%02X BC =%04X DE =%04X HL =%04X S =%04X P =%04X ",
-                    TSTFLAG2(h->af, C),
-                    TSTFLAG2(h->af, Z),
-                    TSTFLAG2(h->af, S),
-                    TSTFLAG2(h->af, P),
-                    TSTFLAG2(h->af, H),
-                    TSTFLAG2(h->af, N),
-                    HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
-                fprint_sym (st, h->pc, h->op, &z80_unit, SWMASK ('M'));
-                fprintf(st, "\n");
-                fprintf(st, "                  A'=%02X BC'=%04X DE'=%04X HL'=%04X IX=%04X IY=%04X ",
-                    HIGH_REGISTER(h->af1), h->bc1, h->de1, h->hl1, h->ix, h->iy);
-                fprintf(st, "\n");
-            }
-        }
+    for (i = 0; i < INST_MAX_BYTES; i++) {
+        op[i] = h->op[i];
     }
 
-    return SCPE_OK;
+    if (z80_chiptype == CHIP_TYPE_8080) {
+        /*
+        ** Use DDT output:
+        ** CfZfMfEfIf A=bb B=dddd D=dddd H=dddd S=dddd P=dddd inst
+        */
+        fprintf(st, "Z80: C%dZ%dM%dE%dI%d A=%02X B=%04X D=%04X H=%04X S=%04X P=%04X ",
+            TSTFLAG2(h->af, C),
+            TSTFLAG2(h->af, Z),
+            TSTFLAG2(h->af, S),
+            TSTFLAG2(h->af, P),
+            TSTFLAG2(h->af, H),
+            HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
+        fprint_sym (st, h->pc, op, &z80_unit, SWMASK ('M'));
+    } else {    /* Z80 */
+        /*
+        ** Use DDT/Z output:
+        */
+        fprintf(st, "Z80: C%dZ%dS%dV%dH%dN%d A =%02X BC =%04X DE =%04X HL =%04X S =%04X P =%04X ",
+            TSTFLAG2(h->af, C),
+            TSTFLAG2(h->af, Z),
+            TSTFLAG2(h->af, S),
+            TSTFLAG2(h->af, P),
+            TSTFLAG2(h->af, H),
+            TSTFLAG2(h->af, N),
+            HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
+        fprint_sym (st, h->pc, op, &z80_unit, SWMASK ('M'));
+        fprintf(st, "\n");
+        fprintf(st, "                  A'=%02X BC'=%04X DE'=%04X HL'=%04X IX=%04X IY=%04X ",
+            HIGH_REGISTER(h->af1), h->bc1, h->de1, h->hl1, h->ix, h->iy);
+    }
 }
 
 t_value z80_pc_value (void) {
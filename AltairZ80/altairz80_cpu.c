@@ -72,12 +72,15 @@
 
 #define PARITY(x)               parityTable[(x) & 0xff]
 
-/*  SET_PV and SET_PV2 are used to provide correct PARITY flag semantics for the 8080 in cases
-    where the Z80 uses the overflow flag.
+/*  SET_PV and SET_PVS are used to provide correct PARITY flag semantics for the 8080 in cases
+    where the Z80 uses the overflow flag. sim_instr_mmu selects the flag tables for the chip type
+    on entry, so that no chip type test is needed while executing instructions: for the Z80
+    pvCbitsTable is overflowTable and pvSumTable is noFlagsTable, for the 8080 pvCbitsTable is
+    noFlagsTable and pvSumTable is parityTable. INC and DEC use incFlagsTable and decFlagsTable
+    in the same way.
 */
-#define SET_PVS(s) ((chiptype == CHIP_TYPE_Z80) ? (((cbits >> 6) ^ (cbits >> 5)) & 4) : (PARITY(s)))
+#define SET_PVS(s) (pvCbitsTable[cbits & 0x1ff] | pvSumTable[(s) & 0xff])
 #define SET_PV (SET_PVS(sum))
-#define SET_PV2(x) ((chiptype == CHIP_TYPE_Z80) ? (((temp == (x)) << 2)) : (PARITY(temp)))
 
 /*  CHECK_CPU_8080 must be invoked whenever a Z80 only instruction is executed
     In case a Z80 instruction is executed on an 8080 there are two cases:
@@ -176,6 +179,7 @@ static t_stat cpu_set_memory        (UNIT *uptr, int32 value, CONST char *cptr,
 static t_stat cpu_resize_memory     (UNIT *uptr, int32 value, CONST char *cptr, void *desc);
 static t_stat cpu_set_hist          (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 static t_stat cpu_show_hist         (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist         (FILE *st, const void *rec, t_bool timed);
 static t_stat cpu_clear_command     (UNIT *uptr, int32 value, CONST char *cptr, void *desc);
 static void cpu_clear(t_bool unmap);
 static t_stat cpu_show              (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
@@ -279,7 +283,6 @@ static  REG *pcq_r              = NULL;             /* PC queue reg ptr
 #define HIST_MAX    8192
 
 typedef struct {
-    uint8 valid;
     uint16 af;
     uint16 bc;
     uint16 de;
@@ -295,9 +298,6 @@ typedef struct {
     t_value op[INST_MAX_BYTES];
 } insthist_t;
 
-static uint32 hst_p = 0;                        /* history pointer          */
-static uint32 hst_lnt = 0;                      /* history length           */
-static insthist_t *hst = NULL;                  /* instruction history      */
 
 uint32 m68k_registers[M68K_REG_CPU_TYPE + 1];   /* M68K CPU registers       */
 uint32 mmiobase = 0xff0000;                     /* M68K MMIO base address   */
@@ -624,7 +624,7 @@ static MTAB cpu_mod[] = {
         NULL, NULL, "Sets the M68K variant to 68LC040"  },
     { MTAB_XTD | MTAB_VDV,  M68K_CPU_TYPE_SCC68070,NULL,        "SCC68070",     &m68k_set_chiptype,
         NULL, NULL, "Sets the M68K variant to SCC68070" },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALO|MTAB_SHP, 0, "HISTORY", "HISTORY",   &cpu_set_hist, &cpu_show_hist,
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",   &cpu_set_hist, &cpu_show_hist,
       NULL, "CPU instruction history buffer"},
     { 0 }
 };
@@ -799,6 +799,12 @@ uint32 in(const uint32 Port) {
     negTable[i]             0..255  (((i & 0x0f) != 0) << 4) | ((i == 0x80) << 2) | 2 | (i != 0)
     rrdrldTable[i]          0..255  (i << 8) | (i & 0xa8) | (((i & 0xff) == 0) << 6) | parityTable[i]
     cpTable[i]              0..255  (i & 0x80) | (((i & 0xff) == 0) << 6)
+    inc8080Table[i]         0..256! (i & 0xa8) | (((i & 0xff) == 0) << 6) |
+                                    (((i & 0xf) == 0) << 4) | parityTable[i & 0xff]
+    dec8080Table[i]         0..255  (i & 0xa8) | (((i & 0xff) == 0) << 6) |
+                                    (((i & 0xf) != 0xf) << 4) | 2 | parityTable[i]
+    overflowTable[i]        0..511  ((i >> 6) ^ (i >> 5)) & 4
+    noFlagsTable[i]         0..511  0
 */
 
 /* parityTable[i] = (number of 1's in i is odd) ? 0 : 4, i = 0..255 */
@@ -1570,6 +1576,86 @@ static const uint8 cpTable[256] = {
     128,128,128,128,128,128,128,128,128,128,128,128,128,128,128,128,
 };
 
+/* inc8080Table[i] = (i & 0xa8) | (((i & 0xff) == 0) << 6) | (((i & 0xf) == 0) << 4) | parityTable[i & 0xff], i = 0..256 */
+static const uint8 inc8080Table[257] = {
+     84,  0,  0,  4,  0,  4,  4,  0,  8, 12, 12,  8, 12,  8,  8, 12,
+     16,  4,  4,  0,  4,  0,  0,  4, 12,  8,  8, 12,  8, 12, 12,  8,
+     48, 36, 36, 32, 36, 32, 32, 36, 44, 40, 40, 44, 40, 44, 44, 40,
+     52, 32, 32, 36, 32, 36, 36, 32, 40, 44, 44, 40, 44, 40, 40, 44,
+     16,  4,  4,  0,  4,  0,  0,  4, 12,  8,  8, 12,  8, 12, 12,  8,
+     20,  0,  0,  4,  0,  4,  4,  0,  8, 12, 12,  8, 12,  8,  8, 12,
+     52, 32, 32, 36, 32, 36, 36, 32, 40, 44, 44, 40, 44, 40, 40, 44,
+     48, 36, 36, 32, 36, 32, 32, 36, 44, 40, 40, 44, 40, 44, 44, 40,
+    144,132,132,128,132,128,128,132,140,136,136,140,136,140,140,136,
+    148,128,128,132,128,132,132,128,136,140,140,136,140,136,136,140,
+    180,160,160,164,160,164,164,160,168,172,172,168,172,168,168,172,
+    176,164,164,160,164,160,160,164,172,168,168,172,168,172,172,168,
+    148,128,128,132,128,132,132,128,136,140,140,136,140,136,136,140,
+    144,132,132,128,132,128,128,132,140,136,136,140,136,140,140,136,
+    176,164,164,160,164,160,160,164,172,168,168,172,168,172,172,168,
+    180,160,160,164,160,164,164,160,168,172,172,168,172,168,168,172,
+     84,
+};
+
+/* dec8080Table[i] = (i & 0xa8) | (((i & 0xff) == 0) << 6) | (((i & 0xf) != 0xf) << 4) | 2 | parityTable[i], i = 0..255 */
+static const uint8 dec8080Table[256] = {
+     86, 18, 18, 22, 18, 22, 22, 18, 26, 30, 30, 26, 30, 26, 26, 14,
+     18, 22, 22, 18, 22, 18, 18, 22, 30, 26, 26, 30, 26, 30, 30, 10,
+     50, 54, 54, 50, 54, 50, 50, 54, 62, 58, 58, 62, 58, 62, 62, 42,
+     54, 50, 50, 54, 50, 54, 54, 50, 58, 62, 62, 58, 62, 58, 58, 46,
+     18, 22, 22, 18, 22, 18, 18, 22, 30, 26, 26, 30, 26, 30, 30, 10,
+     22, 18, 18, 22, 18, 22, 22, 18, 26, 30, 30, 26, 30, 26, 26, 14,
+     54, 50, 50, 54, 50, 54, 54, 50, 58, 62, 62, 58, 62, 58, 58, 46,
+     50, 54, 54, 50, 54, 50, 50, 54, 62, 58, 58, 62, 58, 62, 62, 42,
+    146,150,150,146,150,146,146,150,158,154,154,158,154,158,158,138,
+    150,146,146,150,146,150,150,146,154,158,158,154,158,154,154,142,
+    182,178,178,182,178,182,182,178,186,190,190,186,190,186,186,174,
+    178,182,182,178,182,178,178,182,190,186,186,190,186,190,190,170,
+    150,146,146,150,146,150,150,146,154,158,158,154,158,154,154,142,
+    146,150,150,146,150,146,146,150,158,154,154,158,154,158,158,138,
+    178,182,182,178,182,178,178,182,190,186,186,190,186,190,190,170,
+    182,178,178,182,178,182,182,178,186,190,190,186,190,186,186,174,
+};
+
+/* overflowTable[i] = ((i >> 6) ^ (i >> 5)) & 4, i = 0..511 */
+static const uint8 overflowTable[512] = {
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+};
+
+/* noFlagsTable[i] = 0, i = 0..511 */
+static const uint8 noFlagsTable[512] = { 0 };
+
 /* remove comments to generate table contents and add a call to
  altairz80_print_tables in the altairz80_init
 static void altairz80_print_tables(void) {
@@ -1835,6 +1921,39 @@ static void altairz80_print_tables(void) {
         }
     }
 */
+/* inc8080Table */
+/*
+    uint32 temp, v;
+    for (temp = 0; temp <= 256; temp++) {
+        v = (temp & 0xa8) | (((temp & 0xff) == 0) << 6) | (((temp & 0xf) == 0) << 4) | parityTable[temp & 0xff];
+        sim_printf("%3d,", v);
+        if ( ((temp+1) & 0xf) == 0) {
+            sim_printf("\n");
+        }
+    }
+*/
+/* dec8080Table */
+/*
+    uint32 temp, v;
+    for (temp = 0; temp < 256; temp++) {
+        v = (temp & 0xa8) | (((temp & 0xff) == 0) << 6) | (((temp & 0xf) != 0xf) << 4) | 2 | parityTable[temp];
+        sim_printf("%3d,", v);
+        if ( ((temp+1) & 0xf) == 0) {
+            sim_printf("\n");
+        }
+    }
+*/
+/* overflowTable */
+/*
+    uint32 cbits, v;
+    for (cbits = 0; cbits < 512; cbits++) {
+        v = ((cbits >> 6) ^ (cbits >> 5)) & 4;
+        sim_printf("%1d,", v);
+        if ( ((cbits+1) & 0xf) == 0) {
+            sim_printf("\n");
+        }
+    }
+*/
 /* remove comments to generate table contents
 }
 */
@@ -1866,6 +1985,29 @@ static MDEV RAM_PAGE    =   {TRUE,  FALSE,  NULL, "RAM"};       /* this makes a
 static MDEV EMPTY_PAGE  =   {FALSE, TRUE,   NULL, "NONEXIST"};  /* this is non-existing memory  */
 static MDEV mmu_table[MAXMEMORY >> LOG2PAGESIZE];
 
+/*  ramPageMap is a direct-mapped page table for the 8080/Z80 instruction loop. While
+    sim_instr_mmu is running, ramPageMap[p] points to the memory holding logical page p
+    of the current bank if that page is RAM, or is NULL if GetBYTE and PutBYTE must
+    consult mmu_table (ROM, memory mapped I/O or non-existing memory). The map is rebuilt
+    whenever the bank or the memory map changes during a run. Outside of sim_instr_mmu all
+    entries are NULL, so SCP accesses always see the current register and map settings.
+*/
+static uint8 *ramPageMap[MAXBANKSIZE >> LOG2PAGESIZE];
+static t_bool ramPageMapEnabled = FALSE;
+
+static void updateRAMPageMap(void) {
+    uint32 page, addr;
+    for (page = 0; page < (MAXBANKSIZE >> LOG2PAGESIZE); page++) {
+        if (ramPageMapEnabled) {
+            addr = page << LOG2PAGESIZE;
+            if ((cpu_unit.flags & UNIT_CPU_BANKED) && (((common_low == 0) && (addr < common)) || ((common_low == 1) && (addr >= common))))
+                addr |= bankSelect << MAXBANKSIZELOG2;
+            ramPageMap[page] = mmu_table[addr >> LOG2PAGESIZE].isRAM ? &M[addr] : NULL;
+        } else
+            ramPageMap[page] = NULL;
+    }
+}
+
 /* Memory and I/O Resource Mapping and Unmapping routine. */
 uint32 sim_map_resource(uint32 baseaddr, uint32 size, uint32 resource_type,
                         int32 (*routine)(const int32, const int32, const int32), const char* name, uint8 unmap) {
@@ -1895,6 +2037,8 @@ uint32 sim_map_resource(uint32 baseaddr, uint32 size, uint32 resource_type,
                 mmu_table[page].name = name;
             }
         }
+        if (ramPageMapEnabled)
+            updateRAMPageMap();
     } else if (resource_type == RESOURCE_TYPE_IO) {
         for (i = baseaddr; i < baseaddr + size; i++)
             if (unmap) {
@@ -1919,6 +2063,12 @@ uint32 sim_map_resource(uint32 baseaddr, uint32 size, uint32 resource_type,
 
 static void PutBYTE(register uint32 Addr, const register uint32 Value) {
     MDEV m;
+    register uint8 *page = ramPageMap[(Addr & ADDRMASK) >> LOG2PAGESIZE];
+
+    if (page) {     /* RAM page of the running CPU */
+        page[Addr & (PAGESIZE - 1)] = Value;
+        return;
+    }
 
     Addr &= ADDRMASK;   /* registers are NOT guaranteed to be always 16-bit values */
     if ((cpu_unit.flags & UNIT_CPU_BANKED) && (((common_low == 0) && (Addr < common)) || ((common_low == 1) && (Addr >= common))))
@@ -1945,6 +2095,8 @@ static void PutBYTEasROMorRAM(register uint32 Addr, const register uint32 Value,
 
     mmu_table[Addr >> LOG2PAGESIZE] = makeROM ? ROM_PAGE : RAM_PAGE;
     M[Addr] = Value;
+    if (ramPageMapEnabled)
+        updateRAMPageMap();
 }
 
 void PutBYTEExtended(register uint32 Addr, const register uint32 Value) {
@@ -1972,6 +2124,10 @@ static void PutWORD(register uint32 Addr, const register uint32 Value) {
 
 static uint32 GetBYTE(register uint32 Addr) {
     MDEV m;
+    register uint8 *page = ramPageMap[(Addr & ADDRMASK) >> LOG2PAGESIZE];
+
+    if (page)       /* RAM page of the running CPU */
+        return page[Addr & (PAGESIZE - 1)];
 
     Addr &= ADDRMASK;   /* registers are NOT guaranteed to be always 16-bit values */
     if ((cpu_unit.flags & UNIT_CPU_BANKED) && (((common_low == 0) && (Addr < common)) || ((common_low == 1) && (Addr >= common))))
@@ -2014,6 +2170,8 @@ int32 getBankSelect(void) {
 
 void setBankSelect(const int32 b) {
     bankSelect = b;
+    if (ramPageMapEnabled)
+        updateRAMPageMap();
 }
 
 uint32 getCommon(void) {
@@ -2189,6 +2347,10 @@ static t_stat sim_instr_mmu (void) {
     register uint32 cbits;
     register uint32 op;
     register uint32 adr;
+    const uint8 *incFlagsTable;     /* flags for INC r, chip type specific */
+    const uint8 *decFlagsTable;     /* flags for DEC r, chip type specific */
+    const uint8 *pvCbitsTable;      /* P/V flag from cbits (Z80 overflow)  */
+    const uint8 *pvSumTable;        /* P/V flag from result (8080 parity)  */
 
     /*  The clock frequency simulation works as follows:
      For each 8080 or Z80 instruction one can determine the number of t-states
@@ -2215,6 +2377,21 @@ static t_stat sim_instr_mmu (void) {
 
     switch_cpu_now = TRUE;
 
+    if (chiptype == CHIP_TYPE_Z80) {
+        incFlagsTable = incZ80Table;
+        decFlagsTable = decZ80Table;
+        pvCbitsTable = overflowTable;
+        pvSumTable = noFlagsTable;
+    } else {
+        incFlagsTable = inc8080Table;
+        decFlagsTable = dec8080Table;
+        pvCbitsTable = noFlagsTable;
+        pvSumTable = parityTable;
+    }
+
+    ramPageMapEnabled = TRUE;
+    updateRAMPageMap();
+
     AF = AF_S;
     BC = BC_S;
     DE = DE_S;
@@ -2432,16 +2609,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR B 5 */
                 BC += 0x100;
                 temp = HIGH_REGISTER(BC);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x05:      /* DEC B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR B 5 */
                 BC -= 0x100;
                 temp = HIGH_REGISTER(BC);
-                AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x06:          /* LD B,nn */
@@ -2493,16 +2668,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR C 5 */
                 temp = LOW_REGISTER(BC) + 1;
                 SET_LOW_REGISTER(BC, temp);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x0d:      /* DEC C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR C 5 */
                 temp = LOW_REGISTER(BC) - 1;
                 SET_LOW_REGISTER(BC, temp);
-                AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x0e:          /* LD C,nn */
@@ -2553,16 +2726,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR D 5 */
                 DE += 0x100;
                 temp = HIGH_REGISTER(DE);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x15:      /* DEC D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR D 5 */
                 DE -= 0x100;
                 temp = HIGH_REGISTER(DE);
-                AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x16:          /* LD D,nn */
@@ -2613,16 +2784,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR E 5 */
                 temp = LOW_REGISTER(DE) + 1;
                 SET_LOW_REGISTER(DE, temp);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x1d:      /* DEC E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR E 5 */
                 temp = LOW_REGISTER(DE) - 1;
                 SET_LOW_REGISTER(DE, temp);
-                AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x1e:          /* LD E,nn */
@@ -2675,16 +2844,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR H 5 */
                 HL += 0x100;
                 temp = HIGH_REGISTER(HL);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x25:      /* DEC H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR H 5 */
                 HL -= 0x100;
                 temp = HIGH_REGISTER(HL);
-                AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x26:          /* LD H,nn */
@@ -2761,16 +2928,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR L 5 */
                 temp = LOW_REGISTER(HL) + 1;
                 SET_LOW_REGISTER(HL, temp);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x2d:      /* DEC L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR L 5 */
                 temp = LOW_REGISTER(HL) - 1;
                 SET_LOW_REGISTER(HL, temp);
-                AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x2e:          /* LD L,nn */
@@ -2824,7 +2989,7 @@ static t_stat sim_instr_mmu (void) {
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL) + 1;
                 PutBYTE(HL, temp);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x35:      /* DEC (HL) */
@@ -2832,9 +2997,7 @@ static t_stat sim_instr_mmu (void) {
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL) - 1;
                 PutBYTE(HL, temp);
-                AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x36:          /* LD (HL),nn */
@@ -2894,16 +3057,14 @@ static t_stat sim_instr_mmu (void) {
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR A 5 */
                 AF += 0x100;
                 temp = HIGH_REGISTER(AF);
-                AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
+                AF = (AF & ~0xfe) | incFlagsTable[temp];
                 break;
 
             case 0x3d:      /* DEC A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR A 5 */
                 AF -= 0x100;
                 temp = HIGH_REGISTER(AF);
-                AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                if (chiptype == CHIP_TYPE_8080)
-                    AF ^= 0x10;
+                AF = (AF & ~0xfe) | decFlagsTable[temp & 0xff];
                 break;
 
             case 0x3e:          /* LD A,nn */
@@ -6474,27 +6635,24 @@ static t_stat sim_instr_mmu (void) {
         /*
         ** Save in instruction history ring buffer
         */
-        if (hst_lnt && ((chiptype == CHIP_TYPE_8080) || (chiptype == CHIP_TYPE_Z80))) {
-            hst[hst_p].valid = 1;
-            hst[hst_p].pc = PCX;
-            hst[hst_p].sp = SP;
-            hst[hst_p].af = AF;
-            hst[hst_p].bc = BC;
-            hst[hst_p].de = DE;
-            hst[hst_p].hl = HL;
-            hst[hst_p].af1 = AF1_S;
-            hst[hst_p].bc1 = BC1_S;
-            hst[hst_p].de1 = DE1_S;
-            hst[hst_p].hl1 = HL1_S;
-            hst[hst_p].ix = IX;
-            hst[hst_p].iy = IY;
+        if (sim_hist_lnt && ((chiptype == CHIP_TYPE_8080) || (chiptype == CHIP_TYPE_Z80))) {
+            insthist_t *h = (insthist_t *) sim_hist_add();
+
+            h->pc = PCX;
+            h->sp = SP;
+            h->af = AF;
+            h->bc = BC;
+            h->de = DE;
+            h->hl = HL;
+            h->af1 = AF1_S;
+            h->bc1 = BC1_S;
+            h->de1 = DE1_S;
+            h->hl1 = HL1_S;
+            h->ix = IX;
+            h->iy = IY;
 
             for (i = 0; i < INST_MAX_BYTES; i++) {
-                hst[hst_p].op[i] = GetBYTE(PCX + i);
-            }
-
-            if (++hst_p == hst_lnt) {
-                hst_p = 0;
+                h->op[i] = GetBYTE(PCX + i);
             }
         }
 
@@ -6525,6 +6683,8 @@ static t_stat sim_instr_mmu (void) {
     IY_S = IY;
     SP_S = SP;
     executedTStates = tStates;
+    ramPageMapEnabled = FALSE;
+    updateRAMPageMap();
     return reason;
 }
 
@@ -7254,9 +7414,6 @@ static t_stat m68k_set_chiptype(UNIT* uptr, int32 value, CONST char* cptr, void*
 }
 
 static t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc) {
-    uint32 i, lnt;
-    t_stat r;
-
     if ((chiptype >= 0) && (chiptype != CHIP_TYPE_8080) && (chiptype != CHIP_TYPE_Z80)) {
         sim_printf("History not supported for chiptype: %s\n",
                (chiptype < NUM_CHIP_TYPE) ? cpu_mod[chiptype].mstring : "????");
@@ -7266,63 +7423,16 @@ static t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
     /*
     ** If cptr is NULL, reset ring buffer ("SET HISTORY")
     */
-    if (cptr == NULL) {
-        if (hst == NULL) {
-            sim_printf("History buffer not enabled.\n");
-            return SCPE_NOFNC;
-        }
-
-        for (i = 0; i < hst_lnt; i++) {
-            hst[i].valid = 0;
-        }
-
-        hst_p = 0;
-
-        return SCPE_OK;
-    }
-
-    /*
-    ** Enable/Resize ring buffer ("SET HISTORY=<n>")
-    */
-    lnt = (uint32) get_uint (cptr, 10, HIST_MAX, &r);
-
-    if ((r != SCPE_OK) || (lnt && (lnt < HIST_MIN))) {
-        sim_printf("History buffer minimum/maximum size: %d/%d\n", HIST_MIN, HIST_MAX);
-        return SCPE_ARG;
-    }
-
-    /*
-    ** Delete old history buffer
-    */
-    if (hst!=NULL) {
-        free (hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-
-    hst_p = 0;
-
-    /*
-    ** If a length was specified, allocate new buffer ("SET HISTORY=<n>" where n>0)
-    */
-    if (lnt) {
-        hst = (insthist_t *) calloc (lnt, sizeof (insthist_t));
-        if (hst == NULL) {
-            return SCPE_MEM;
-        }
-        hst_lnt = lnt;
+    if ((cptr == NULL) && (sim_hist_lnt == 0)) {
+        sim_printf("History buffer not enabled.\n");
+        return SCPE_NOFNC;
     }
 
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(insthist_t), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-    int32 k, di, lnt;
-    CONST char *cptr = (CONST char *) desc;
-    t_stat r;
-    insthist_t *h;
-
     if ((chiptype != CHIP_TYPE_8080) && (chiptype != CHIP_TYPE_Z80)) {
         sim_printf("History not supported for chiptype: %s\n",
             (0 <= chiptype) && (chiptype < NUM_CHIP_TYPE) ?
@@ -7330,68 +7440,52 @@ t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
         return SCPE_NOFNC;
     }
 
-    if (hst_lnt == 0) {
-        return SCPE_NOFNC;                    /* enabled? */
-    }
+    return sim_hist_show(st, &cpu_dev, sizeof(insthist_t), &cpu_fprint_hist, (CONST char *) desc);
+}
 
-    if (cptr) {
-        lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
+static void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed) {
+    const insthist_t *h = (const insthist_t *) rec;
+    t_value op[INST_MAX_BYTES];
+    int32 i;
 
-        if ((r != SCPE_OK) || (lnt == 0)) {
-            return SCPE_ARG;
-        }
-    } else {
-        lnt = hst_lnt;
+    if (h == NULL) {                                 /* no column headings */
+        return;
     }
 
-    di = hst_p - lnt;
-
-    if (di < 0) di = di + hst_lnt;
-
-    for (k = 0; k < lnt; k++) {
-        if (stop_cpu) {                              /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                                   /* abandon remaining output */
-        }
-        h = &hst[(di++) % hst_lnt];
-
-        if (h->valid) {                              /* valid entry? */
-            if (chiptype == CHIP_TYPE_8080) {
-                /*
-                ** Use DDT output:
-                ** CfZfMfEfIf A=bb B=dddd D=dddd H=dddd S=dddd P=dddd inst
-                */
-                fprintf(st, "CPU: C%dZ%dM%dE%dI%d A=%02X B=%04X D=%04X H=%04X S=%04X P=%04X ",
-                    TSTFLAG2(h->af, C),
-                    TSTFLAG2(h->af, Z),
-                    TSTFLAG2(h->af, S),
-                    TSTFLAG2(h->af, P),
-                    TSTFLAG2(h->af, H),
-                    HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
-                fprint_sym (st, h->pc, h->op, &cpu_unit, SWMASK ('M'));
-                fprintf(st, "\n");
-            } else {    /* Z80 */
-                /*
-                ** Use DDT/Z output:
-                */
-                fprintf(st, "CPU: C%dZ%dS%dV%dH%dN%d A =%02X BC =%04X DE =%04X HL =%04X S =%04X P =%04X ",
-                    TSTFLAG2(h->af, C),
-                    TSTFLAG2(h->af, Z),
-                    TSTFLAG2(h->af, S),
-                    TSTFLAG2(h->af, P),
-                    TSTFLAG2(h->af, H),
-                    TSTFLAG2(h->af, N),
-                    HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
-                fprint_sym (st, h->pc, h->op, &cpu_unit, SWMASK ('M'));
-                fprintf(st, "\n");
-                fprintf(st, "                  A'=%02X BC'=%04X DE'=%04X HL'=%04X IX=%04X IY=%04X ",
-                    HIGH_REGISTER(h->af1), h->bc1, h->de1, h->hl1, h->ix, h->iy);
-                fprintf(st, "\n");
-            }
-        }
+    for (i = 0; i < INST_MAX_BYTES; i++) {
+        op[i] = h->op[i];
     }
 
-    return SCPE_OK;
+    if (chiptype == CHIP_TYPE_8080) {
+        /*
+        ** Use DDT output:
+        ** CfZfMfEfIf A=bb B=dddd D=dddd H=dddd S=dddd P=dddd inst
+        */
+        fprintf(st, "CPU: C%dZ%dM%dE%dI%d A=%02X B=%04X D=%04X H=%04X S=%04X P=%04X ",
+            TSTFLAG2(h->af, C),
+            TSTFLAG2(h->af, Z),
+            TSTFLAG2(h->af, S),
+            TSTFLAG2(h->af, P),
+            TSTFLAG2(h->af, H),
+            HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
+        fprint_sym (st, h->pc, op, &cpu_unit, SWMASK ('M'));
+    } else {    /* Z80 */
+        /*
+        ** Use DDT/Z output:
+        */
+        fprintf(st, "CPU: C%dZ%dS%dV%dH%dN%d A =%02X BC =%04X DE =%04X HL =%04X S =%04X P =%04X ",
+            TSTFLAG2(h->af, C),
+            TSTFLAG2(h->af, Z),
+            TSTFLAG2(h->af, S),
+            TSTFLAG2(h->af, P),
+            TSTFLAG2(h->af, H),
+            TSTFLAG2(h->af, N),
+            HIGH_REGISTER(h->af), h->bc, h->de, h->hl, h->sp, h->pc);
+        fprint_sym (st, h->pc, op, &cpu_unit, SWMASK ('M'));
+        fprintf(st, "\n");
+        fprintf(st, "                  A'=%02X BC'=%04X DE'=%04X HL'=%04X IX=%04X IY=%04X ",
+            HIGH_REGISTER(h->af1), h->bc1, h->de1, h->hl1, h->ix, h->iy);
+    }
 }
 
 t_value altairz80_pc_value (void) {
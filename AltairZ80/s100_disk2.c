@@ -305,6 +305,9 @@ static t_stat disk2_detach(UNIT *uptr)
     if (uptr->flags & UNIT_DISK2_VERBOSE)
         sim_printf("Detach DISK2%d\n", i);
 
+    if (disk2_info->drive[i].imd != NULL)
+        diskClose(&disk2_info->drive[i].imd);
+
     r = detach_unit(uptr);  /* detach unit */
     if ( r != SCPE_OK)
         return r;
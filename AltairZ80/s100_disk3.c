@@ -376,6 +376,9 @@ static t_stat disk3_detach(UNIT *uptr)
     if (uptr->flags & UNIT_DISK3_VERBOSE)
         sim_printf("Detach DISK3%d\n", i);
 
+    if (pDrive->imd != NULL)
+        diskClose(&pDrive->imd);
+
     r = detach_unit(uptr);  /* detach unit */
     if ( r != SCPE_OK)
         return r;
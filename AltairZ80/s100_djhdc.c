@@ -404,6 +404,9 @@ static t_stat djhdc_detach(UNIT *uptr)
     if (uptr->flags & UNIT_DJHDC_VERBOSE)
         sim_printf("Detach DJHDC%d\n", i);
 
+    if (pDrive->imd != NULL)
+        diskClose(&pDrive->imd);
+
     r = detach_unit(uptr);  /* detach unit */
     if ( r != SCPE_OK)
         return r;
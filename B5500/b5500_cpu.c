@@ -247,10 +247,6 @@ struct InstHistory
         uint16          iar;
 };
 
-struct InstHistory *hst = NULL;
-int32               hst_p = 0;
-int32               hst_lnt = 0;
-
 #define F_AROF          00001
 #define F_BROF          00002
 #define F_CWMF          00004
@@ -258,7 +254,6 @@ int32               hst_lnt = 0;
 #define F_SALF          00020
 #define F_MSFF          00040
 #define F_VARF          00100
-#define HIST_PC         0100000
 
 t_stat              cpu_ex(t_value * vptr, t_addr addr, UNIT * uptr,
                            int32 sw);
@@ -272,6 +267,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 t_stat              cpu_help(FILE *, DEVICE *, UNIT *, int32, const char *);
 /* Interval timer */
 t_stat              rtc_srv(UNIT * uptr);
@@ -338,7 +334,7 @@ MTAB                cpu_mod[] = {
     {UNIT_MSIZE|MTAB_VDV, MEMAMOUNT(7), NULL, "32K", &cpu_set_size},
     {MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &sim_set_idle, &sim_show_idle },
     {MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -2047,7 +2043,7 @@ crf_loop:
         field = (T >> 6) & 077;
         TROF = 0;
 
-        if (hst_lnt) {  /* history enabled? */
+        if (sim_hist_lnt) {  /* history enabled? */
             /* Ignore idle loop when recording history */
                 /* DCMCP XIII */
             /* if ((C & 077774) != 01140) { */
@@ -2055,32 +2051,30 @@ crf_loop:
             /* if ((C & 077774) != 01254) { */
                 /* TSMCP XV */
             /* if ((C & 077774) != 01324) { */
-            hst_p = (hst_p + 1);        /* next entry */
-            if (hst_p >= hst_lnt) {
-                    hst_p = 0;
-            }
-            hst[hst_p].c = (C) | HIST_PC;
-            hst[hst_p].op = T;
-            hst[hst_p].s = S;
-            hst[hst_p].f = F;
-            hst[hst_p].r = R;
-            hst[hst_p].ma = Ma;
-            hst[hst_p].a_reg = A;
-            hst[hst_p].b_reg = B;
-            hst[hst_p].x_reg = X;
-            hst[hst_p].gh = GH;
-            hst[hst_p].kv = KV;
-            hst[hst_p].l = L;
-            hst[hst_p].q = Q;
-            hst[hst_p].cpu = cpu_index;
-            hst[hst_p].iar = IAR;
-            hst[hst_p].flags = ((AROF)? F_AROF : 0) | \
-                               ((BROF)? F_BROF : 0) | \
-                               ((CWMF)? F_CWMF : 0) | \
-                               ((NCSF)? F_NCSF : 0) | \
-                               ((SALF)? F_SALF : 0) | \
-                               ((MSFF)? F_MSFF : 0) | \
-                               ((VARF)? F_VARF : 0);
+            struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+            h->c = C;
+            h->op = T;
+            h->s = S;
+            h->f = F;
+            h->r = R;
+            h->ma = Ma;
+            h->a_reg = A;
+            h->b_reg = B;
+            h->x_reg = X;
+            h->gh = GH;
+            h->kv = KV;
+            h->l = L;
+            h->q = Q;
+            h->cpu = cpu_index;
+            h->iar = IAR;
+            h->flags = ((AROF)? F_AROF : 0) | \
+                       ((BROF)? F_BROF : 0) | \
+                       ((CWMF)? F_CWMF : 0) | \
+                       ((NCSF)? F_NCSF : 0) | \
+                       ((SALF)? F_SALF : 0) | \
+                       ((MSFF)? F_MSFF : 0) | \
+                       ((VARF)? F_VARF : 0);
              /* }  */
         }
 
@@ -3859,7 +3853,6 @@ cpu_reset(DEVICE * dptr)
 
     idle_addr = 0;
     sim_brk_types = sim_brk_dflt = SWMASK('E') | SWMASK('A') | SWMASK('B');
-    hst_p = 0;
 
     sim_rtcn_init_unit (&cpu_unit[0], cpu_unit[0].wait, TMR_RTC);
     sim_activate(&cpu_unit[0], cpu_unit[0].wait) ;
@@ -3937,34 +3930,8 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].c = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -3972,72 +3939,59 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    const char          *cptr = (const char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                         (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
     t_value             sim_eval;
-    struct InstHistory *h;
     CONST static char   flags[] = "ABCNSMV";
+    int                 i;
 
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st, "P    CL                 A                               B   "
-                "                       X     S     F     R      M  GH KV Flags"
-                "  Q Intruction     IAR\n\n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
-        }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->c & HIST_PC) {   /* instruction? */
-            int i;
-            fprintf(st, "%o %05o%o ", h->cpu, h->c & 077777, h->l);
-            sim_eval = (t_value)h->a_reg;
-            (void)fprint_sym(st, 0, &sim_eval, &cpu_unit[0], SWMASK('B'));
-            fputc((h->flags & F_AROF) ? '^': ' ', st);
-            fputc(' ', st);
-            sim_eval = (t_value)h->b_reg;
-            (void)fprint_sym(st, 0, &sim_eval, &cpu_unit[0], SWMASK('B'));
-            fputc((h->flags & F_BROF) ? '^': ' ', st);
-            fputc(' ', st);
-            fprint_val(st, (t_value)h->x_reg, 8, 39, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->s, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->f, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->r, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->ma, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->gh, 8, 6, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->kv, 8, 6, PV_RZRO);
-            fputc(' ', st);
-            for(i = 2; i < 8; i++) {
-                fputc (((1 << i) & h->flags) ? flags[i] : ' ', st);
-            }
-            fprint_val(st, h->q, 8, 9, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->op, 8, 12, PV_RZRO);
-            fputc(' ', st);
-            print_opcode(st, h->op, ((h->flags & F_CWMF) != 0));
-            fputc(' ', st);
-            fprint_val(st, h->iar, 8, 16, PV_RZRO);
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+    if (h == NULL) {
+        fprintf(st, "P    CL                 A                               B   "
+                    "                       X     S     F     R      M  GH KV Flags"
+                    "  Q Intruction     IAR\n\n");
+        return;
+    }
+    fprintf(st, "%o %05o%o ", h->cpu, h->c, h->l);
+    sim_eval = (t_value)h->a_reg;
+    (void)fprint_sym(st, 0, &sim_eval, &cpu_unit[0], SWMASK('B'));
+    fputc((h->flags & F_AROF) ? '^': ' ', st);
+    fputc(' ', st);
+    sim_eval = (t_value)h->b_reg;
+    (void)fprint_sym(st, 0, &sim_eval, &cpu_unit[0], SWMASK('B'));
+    fputc((h->flags & F_BROF) ? '^': ' ', st);
+    fputc(' ', st);
+    fprint_val(st, (t_value)h->x_reg, 8, 39, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->s, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->f, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->r, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->ma, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->gh, 8, 6, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->kv, 8, 6, PV_RZRO);
+    fputc(' ', st);
+    for(i = 2; i < 8; i++) {
+        fputc (((1 << i) & h->flags) ? flags[i] : ' ', st);
+    }
+    fprint_val(st, h->q, 8, 9, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->op, 8, 12, PV_RZRO);
+    fputc(' ', st);
+    print_opcode(st, h->op, ((h->flags & F_CWMF) != 0));
+    fputc(' ', st);
+    fprint_val(st, h->iar, 8, 16, PV_RZRO);
 }
 
 
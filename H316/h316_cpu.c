@@ -245,7 +245,6 @@
 #define m15             0000002
 #define m16             0000001
 
-#define HIST_PC         0x40000000
 #define HIST_C          0x20000000
 #define HIST_EA         0x10000000
 #define HIST_MIN        64
@@ -293,9 +292,6 @@ uint32 dma_eor[DMA_MAX] = { 0 };                        /* DMA end of range */
 uint32 chan_req = 0;                                    /* channel requests */
 uint32 chan_map[DMA_MAX + DMC_MAX] = { 0 };             /* chan->dev map */
 int32 (*iotab[DEV_MAX])(int32 inst, int32 fnc, int32 dat, int32 dev) = { NULL };
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 
 t_bool devtab_init (void);
 int32 dmaio (int32 inst, int32 fnc, int32 dat, int32 dev);
@@ -307,6 +303,7 @@ t_stat cpu_set_noext (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_show_dma (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_set_nchan (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_nchan (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
@@ -385,7 +382,7 @@ MTAB cpu_mod[] = {
       &cpu_set_nchan, NULL, NULL },             // [RLA]  documented to work!
     { UNIT_DMC, 0, "no DMC", "NODMC", NULL },
     { UNIT_DMC, UNIT_DMC, "DMC", "DMC", NULL },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { MTAB_XTD | MTAB_VDV, 0, "extended interrupts", "EXTINT",
       &cpu_set_interrupts, &cpu_show_interrupts, NULL },
@@ -535,16 +532,16 @@ else {
 
 dev_int = dev_int & ~INT_START;                         /* clr start button int */
 sim_interval = sim_interval - 1;
-if (hst_lnt) {                                          /* instr hist? */
-    hst_p = (hst_p + 1);                                /* next entry */
-    if (hst_p >= hst_lnt)
-        hst_p = 0;
-    hst[hst_p].pc = Y | HIST_PC | (C? HIST_C: 0);       /* fill slots */
-    hst[hst_p].ir = MB;
-    hst[hst_p].ar = AR;
-    hst[hst_p].br = BR;
-    hst[hst_p].xr = XR;
-    hst[hst_p].iack = iack;                             // [RLA] record if interrupt taken
+if (sim_hist_lnt) {                                     /* instr hist? */
+    InstHistory *h = (InstHistory *) sim_hist_add ();   /* next entry */
+
+    h->pc = Y | (C? HIST_C: 0);                         /* fill slots */
+    h->ir = MB;
+    h->ar = AR;
+    h->br = BR;
+    h->xr = XR;
+    h->ea = h->opnd = 0;
+    h->iack = iack;                                     // [RLA] record if interrupt taken
     }
 
 /* Memory reference instructions */
@@ -1086,10 +1083,12 @@ else {                                                  /* non-extend */
         }
     }                                                   /* end else */
 *addr = Y = Y & X_AMASK;                                /* return addr */
-if (hst_lnt) {                                          /* history? */
-    hst[hst_p].pc = hst[hst_p].pc | HIST_EA;
-    hst[hst_p].ea = Y;
-    hst[hst_p].opnd = Read (Y);
+if (sim_hist_lnt) {                                     /* history? */
+    InstHistory *h = (InstHistory *) sim_hist_last ();
+
+    h->pc = h->pc | HIST_EA;
+    h->ea = Y;
+    h->opnd = Read (Y);
     }
 if (i >= ind_max)
     return STOP_IND;                                    /* too many ind? */
@@ -1725,84 +1724,44 @@ return FALSE;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 cr, k, di, op, lnt;
-const char *cptr = (const char *) desc;
-t_stat r;
-InstHistory *h;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+int32 cr, op;
 static uint8 has_opnd[16] = {
     0, 0, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1
     };
 
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+if (h == NULL) {
+    fprintf (st, "  PC   C    A       B       X       ea     IR\n");
+    fprintf (st, "-----  - ------  ------  ------  -----  -----------\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "  PC   C    A       B       X       ea     IR\n");
-fprintf (st, "-----  - ------  ------  ------  -----  -----------\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        cr = (h->pc & HIST_C)? 1: 0;                    /* carry */
-        fprintf (st, "%05o  %o %06o  %06o  %06o  ",
-            h->pc & X_AMASK, cr, h->ar, h->br, h->xr);
-        if (h->pc & HIST_EA)
-            fprintf (st, "%05o  ", h->ea);
-        else fprintf (st, "       ");
-        sim_eval[0] = h->ir;
-        if ((fprint_sym (st, h->pc & X_AMASK, sim_eval,
-            &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %06o", h->ir);
-        op = I_GETOP (h->ir) & 017;                     /* base op */
-        if (has_opnd[op])
-            fprintf (st, "  [%06o]", h->opnd);
-        if (h->iack)                                    // [RLA]
-          fprintf(st, " INTERRUPT");                    // [RLA]
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+cr = (h->pc & HIST_C)? 1: 0;                            /* carry */
+fprintf (st, "%05o  %o %06o  %06o  %06o  ",
+    h->pc & X_AMASK, cr, h->ar, h->br, h->xr);
+if (h->pc & HIST_EA)
+    fprintf (st, "%05o  ", h->ea);
+else fprintf (st, "       ");
+sim_eval[0] = h->ir;
+if ((fprint_sym (st, h->pc & X_AMASK, sim_eval,
+    &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %06o", h->ir);
+op = I_GETOP (h->ir) & 017;                             /* base op */
+if (has_opnd[op])
+    fprintf (st, "  [%06o]", h->opnd);
+if (h->iack)                                            // [RLA]
+  fprintf(st, " INTERRUPT");                            // [RLA]
 }
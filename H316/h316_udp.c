@@ -135,6 +135,7 @@
 
 // Local constants ...
 #define MAXLINKS        10      // maximum number of simultaneous connections
+#define RXBATCH         32      // maximum packets taken from the line at once
 // UDP connection data structure ...
 //   One of these blocks is allocated for every simulated modem link. 
 struct _UDP_LINK {
@@ -144,6 +145,10 @@ struct _UDP_LINK {
   uint32  rxsequence;           // next message sequence number for receive
   uint32  txsequence;           // next message sequence number for transmit
   DEVICE  *dptr;                // Device associated with link
+  const uint8 *rxpkts[RXBATCH]; // received packets not yet taken by udp_receive
+  size_t  rxsizes[RXBATCH];     // and their lengths
+  int32   rxnext;               // next packet in rxpkts to be taken
+  int32   rxcount;              // number of packets in rxpkts
 };
 typedef struct _UDP_LINK UDP_LINK;
 
@@ -287,6 +292,7 @@ t_stat udp_release (DEVICE *dptr, int32 link)
 
   tmxr_detach_ln (&udp_lines[link]);
   udp_links[link].used = FALSE;
+  udp_links[link].rxnext = udp_links[link].rxcount = 0;
   sim_debug(IMP_DBG_UDP, dptr, "link %d - closed\n", link);
 
   return SCPE_OK;
@@ -330,6 +336,7 @@ t_stat udp_set_link_loopback (DEVICE *dptr, int32 link, t_bool enable_loopback)
   if (!udp_links[link].used) return SCPE_IERR;
   if (dptr != udp_links[link].dptr) return SCPE_IERR;
 
+  udp_links[link].rxnext = udp_links[link].rxcount = 0;   // drop packets from the old path
   return tmxr_set_line_loopback (&udp_lines[link], enable_loopback);
 }
 
@@ -343,21 +350,31 @@ int32 udp_receive_packet (int32 link, UDP_PACKET *ppkt)
   //   Note that this routine only receives the packet - it doesn't handle any
   // of the checking for valid packets, unexpected packets, duplicate or out of
   // sequence packets.  That's strictly the caller's problem!
+  //
+  //   Every packet waiting on the line is taken in one tmxr_get_packets_ln()
+  // call and handed out from rxpkts[] one at a time.  The packets stay valid
+  // until the next packet call on the line, which isn't made until they've
+  // all been taken.
+  UDP_LINK *plink = &udp_links[link];
   size_t pktsiz;
-  const uint8 *pbuf;
   t_stat ret;
 
-  udp_lines[link].rcve = TRUE;          // Enable receiver
-  tmxr_poll_rx (&udp_tmxr);
-  ret = tmxr_get_packet_ln (&udp_lines[link], &pbuf, &pktsiz);
-  udp_lines[link].rcve = FALSE;          // Disable receiver
-  if (ret != SCPE_OK) {
-    sim_messagef (ret, "UDP%d - tmxr_get_packet_ln() failed with error %s\n", link, sim_error_text(ret));
-    return NOLINK;
+  if (plink->rxnext >= plink->rxcount) {
+    plink->rxnext = 0;
+    udp_lines[link].rcve = TRUE;          // Enable receiver
+    tmxr_poll_rx (&udp_tmxr);
+    ret = tmxr_get_packets_ln (&udp_lines[link], plink->rxpkts, plink->rxsizes, RXBATCH, &plink->rxcount);
+    udp_lines[link].rcve = FALSE;          // Disable receiver
+    if (ret != SCPE_OK) {
+      sim_messagef (ret, "UDP%d - tmxr_get_packets_ln() failed with error %s\n", link, sim_error_text(ret));
+      return NOLINK;
+    }
+    if (plink->rxcount == 0) return 0;
   }
-  if (pbuf == NULL) return 0;
   // Got a packet, so copy it to the packet buffer
-  memcpy (ppkt, pbuf, pktsiz);
+  pktsiz = plink->rxsizes[plink->rxnext];
+  if (pktsiz > sizeof(UDP_PACKET)) pktsiz = sizeof(UDP_PACKET);
+  memcpy (ppkt, plink->rxpkts[plink->rxnext++], pktsiz);
   return pktsiz;
 }
 
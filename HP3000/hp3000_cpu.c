@@ -2310,10 +2310,33 @@ return;
    return, the SR register value will be zero.
 
    The routine does not check for stack overflow.
+
+
+   Implementation notes:
+
+    1. If the words to be written lie entirely within memory, and memory tracing
+       is not enabled, the values are stored through a memory stack window with
+       a single bounds check.  Otherwise, they are written individually, so
+       that an Illegal Address interrupt or the trace output occurs exactly as
+       it would for each word.
 */
 
 void cpu_flush (void)
 {
+MEMORY_WORD *window;
+
+if (SR > 0) {                                           /* if one or more registers are in use */
+    window = mem_stack_window (&cpu_dev, SM + 1, SM + SR);  /*   then get a window on the words to write */
+
+    if (window != NULL) {                               /* if the window is available */
+        SM = SM + SR & R_MASK;                          /*   then increment SM for all of the words to be written */
+
+        do                                              /* write the TOS registers */
+            *window++ = (MEMORY_WORD) TR [--SR];        /*   from the bottom register to the top */
+        while (SR > 0);                                 /*     until all are flushed */
+        }
+    }
+
 while (SR > 0) {                                        /* while one or more registers are in use */
     SM = SM + 1 & R_MASK;                               /*   increment the stack memory register */
     SR = SR - 1;                                        /*     and decrement the register-in-use count */
@@ -2345,17 +2368,43 @@ return;
 
     3. The cpu_queue_up routine isn't used, as that routine checks for a stack
        underflow after each word is moved rather than only after the last word.
+
+    4. If the words to be moved lie entirely within memory, and memory tracing
+       is not enabled, the values are read through a memory stack window with a
+       single bounds check.  Otherwise, they are read individually.  In either
+       case, SM and SR are updated before the underflow check, so the register
+       state presented to the trap handler is the same.
 */
 
 void cpu_adjust_sr (uint32 target)
 {
-do {
-    cpu_read_memory (stack, SM, &TR [SR]);              /* read the value from memory into a TOS register */
+MEMORY_WORD *window;
+uint32      count;
 
-    SM = SM - 1 & R_MASK;                               /* decrement the stack memory register */
-    SR = SR + 1;                                        /*   and increment the register-in-use count */
+if (SR < target) {                                      /* if registers are to be filled */
+    count = target - SR;                                /*   then get the number of words to move */
+    window = mem_stack_window (&cpu_dev, SM + 1 - count, SM);   /*     and a window on them */
     }
-while (SR < target);                                    /* queue up until the requested number of registers are in use */
+
+else                                                    /* otherwise a single word will be moved */
+    window = NULL;                                      /*   by the general routine */
+
+if (window != NULL) {                                   /* if the window is available */
+    SM = SM - count & R_MASK;                           /*   then decrement SM for all of the words to be read */
+
+    do                                                  /* read the words into the TOS registers */
+        TR [SR++] = (HP_WORD) window [--count];         /*   from the top of the memory stack down */
+    while (count > 0);                                  /*     until all have been moved */
+    }
+
+else                                                    /* otherwise */
+    do {                                                /*   move the words individually */
+        cpu_read_memory (stack, SM, &TR [SR]);          /* read the value from memory into a TOS register */
+
+        SM = SM - 1 & R_MASK;                           /* decrement the stack memory register */
+        SR = SR + 1;                                    /*   and increment the register-in-use count */
+        }
+    while (SR < target);                                /* queue up until the requested number of registers are in use */
 
 if (SM <= DB && NPRV)                                   /* if SM isn't above DB, or the mode is non-privileged */
     MICRO_ABORT (trap_Stack_Underflow);                 /*   then trap with a Stack Underflow */
@@ -2391,16 +2440,33 @@ return;
     1. The PB-relative return address points to the instruction after the point
        of the call.  Conceptually, this is location P + 1, but because the CPU
        uses a two-instruction prefetch, the location is actually P - 1.
+
+    2. The marker is stored through a memory stack window if it lies entirely
+       within memory and memory tracing is not enabled.  Otherwise, the words
+       are written individually.
 */
 
 void cpu_mark_stack (void)
 {
+MEMORY_WORD *window;
+
 SM = SM + 4 & R_MASK;                                   /* adjust the stack pointer */
 
-cpu_write_memory (stack, SM - 3, X);                    /* push the index register */
-cpu_write_memory (stack, SM - 2, P - 1 - PB & LA_MASK); /*   and delta P */
-cpu_write_memory (stack, SM - 1, STA);                  /*     and the status register */
-cpu_write_memory (stack, SM - 0, SM - Q & LA_MASK);     /*       and delta Q */
+window = mem_stack_window (&cpu_dev, SM - 3, SM);       /* get a window on the stack marker */
+
+if (window != NULL) {                                   /* if the window is available */
+    window [0] = (MEMORY_WORD) X;                       /*   then store the index register */
+    window [1] = (MEMORY_WORD) (P - 1 - PB & LA_MASK);  /*     and delta P */
+    window [2] = (MEMORY_WORD) STA;                     /*       and the status register */
+    window [3] = (MEMORY_WORD) (SM - Q & LA_MASK);      /*         and delta Q */
+    }
+
+else {                                                  /* otherwise write the words individually */
+    cpu_write_memory (stack, SM - 3, X);                    /* push the index register */
+    cpu_write_memory (stack, SM - 2, P - 1 - PB & LA_MASK); /*   and delta P */
+    cpu_write_memory (stack, SM - 1, STA);                  /*     and the status register */
+    cpu_write_memory (stack, SM - 0, SM - Q & LA_MASK);     /*       and delta Q */
+    }
 
 Q = SM;                                                 /* set Q to point to the new stack marker */
 
@@ -578,6 +578,49 @@ else {                                                  /* otherwise the access
 }
 
 
+/* Return a pointer to a window of words on the memory stack.
+
+   This routine returns a pointer to the main memory word corresponding to the
+   "first" offset in the stack bank if the range of offsets from "first" through
+   "last" lies entirely within physical memory, or NULL otherwise.  It permits
+   the CPU to move several words between the TOS registers and the memory stack
+   with a single bounds check, rather than dispatching through mem_read or
+   mem_write for each word.
+
+   The window is valid only for unchecked stack accesses that do not reference
+   the TOS registers, i.e., for offsets at or below SM, and only until SBANK or
+   the memory size is changed.  Because the window addresses main memory
+   directly, no state other than M is involved, so nothing need be synchronized
+   when a trap or simulation stop occurs after the caller has used the window.
+
+   NULL is returned if the range wraps around the end of the bank, extends
+   beyond the memory size, or if memory data tracing is enabled for the
+   requesting device.  In these cases, the caller must fall back to individual
+   mem_read and mem_write calls, which will set the Illegal Address interrupt
+   or produce the trace output as appropriate.
+
+
+   Implementation notes:
+
+    1. As in mem_read and mem_write, the bank register value is not masked, so
+       that an invalid SBANK value causes a fallback to the word routines,
+       which then generate an Illegal Address interrupt.
+*/
+
+MEMORY_WORD *mem_stack_window (DEVICE *dptr, uint32 first, uint32 last)
+{
+const uint32 address = SBANK << LA_WIDTH | first;       /* form the physical address of the first word */
+
+if (first > last || last > LA_MASK                      /* if the range wraps around the bank */
+  || (SBANK << LA_WIDTH | last) >= MEMSIZE              /*   or extends beyond the memory size */
+  || DPPRINTING (dptr, DEB_MDATA))                      /*     or the accesses must be traced */
+    return NULL;                                        /*       then the caller must use the word routines */
+
+else                                                    /* otherwise the whole range is accessible */
+    return M + address;                                 /*   so return a pointer to the first word */
+}
+
+
 /* Initialize a byte accessor.
 
    The supplied byte accessor structure is initialized for the starting relative
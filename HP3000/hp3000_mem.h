@@ -127,6 +127,7 @@ t_stat mem_deposit (t_value value,       t_addr address, UNIT *uptr, int32 switc
 
    mem_read         : read a word from main memory
    mem_write        : write a word to main memory
+   mem_stack_window : return a pointer to a range of words on the memory stack
 
    mem_init_byte    : initialize a memory byte access structure
    mem_set_byte     : set the access structure to a new byte offset
@@ -148,6 +149,8 @@ extern void   mem_fill       (uint32 starting_address, HP_WORD fill_value);
 extern t_bool mem_read  (DEVICE *dptr, ACCESS_CLASS classification, uint32 offset, HP_WORD *value);
 extern t_bool mem_write (DEVICE *dptr, ACCESS_CLASS classification, uint32 offset, HP_WORD  value);
 
+extern MEMORY_WORD *mem_stack_window (DEVICE *dptr, uint32 first, uint32 last);
+
 extern void   mem_init_byte   (BYTE_ACCESS *bap, ACCESS_CLASS class, HP_WORD *byte_offset, uint32 block_length);
 extern void   mem_set_byte    (BYTE_ACCESS *bap);
 extern uint8  mem_lookup_byte (BYTE_ACCESS *bap, uint8 index);
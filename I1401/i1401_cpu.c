@@ -203,9 +203,6 @@ int32 ind[64] = { 0 };                                  /* indicators */
 int32 ssa = 1;                                          /* sense switch A */
 int32 prchk = 0;                                        /* process check stop */
 int32 iochk = 0;                                        /* I/O check stop */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 t_bool conv_old = 0;                                    /* old conversions */
 
 extern int32 sim_emax;
@@ -216,6 +213,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_set_conv (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_conv (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 int32 store_addr_h (int32 addr);
@@ -298,7 +296,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 8000, NULL, "8K", &cpu_set_size },
     { UNIT_MSIZE, 12000, NULL, "12K", &cpu_set_size },
     { UNIT_MSIZE, 16000, NULL, "16K", &cpu_set_size },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "CONVERSIONS", "NEWCONVERSIONS",
       &cpu_set_conv, &cpu_show_conv },
@@ -687,14 +685,13 @@ CHECK_LENGTH:
         break;
         }
     ilnt = IS - saved_IS;                               /* get lnt */
-    if (hst_lnt) {                                      /* history enabled? */
-        hst_p = (hst_p + 1);                            /* next entry */
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        hst[hst_p].is = saved_IS;                       /* save IS */
-        hst[hst_p].ilnt = ilnt;
+    if (sim_hist_lnt) {                                 /* history enabled? */
+        InstHistory *h = (InstHistory *) sim_hist_add ();   /* next entry */
+
+        h->is = saved_IS;                               /* save IS */
+        h->ilnt = ilnt;
         for (i = 0; (i < MAX_L) && (i < ilnt); i++)
-            hst[hst_p].inst[i] = M[saved_IS + i];
+            h->inst[i] = M[saved_IS + i];
         }
     if (DEBUG_PRS (cpu_dev)) {
         fprint_val (sim_deb, saved_IS, 10, 5, PV_RSPC);
@@ -1883,77 +1880,37 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].ilnt = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 i, k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+int32 i;
 t_value sim_eval[MAX_L + 1];
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+
+if (h == NULL) {
+    fprintf (st, "IS     IR\n\n");
+    return;
+    }
+fprintf (st, "%05d  ", h->is);
+for (i = 0; i < h->ilnt; i++)
+    sim_eval[i] = h->inst[i];
+sim_eval[h->ilnt] = WM;
+if ((fprint_sym (st, h->is, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
+    fprintf (st, "(undefined)");
+    for (i = 0; i < h->ilnt; i++)
+        fprintf (st, " %02o", h->inst[i]);
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "IS     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->ilnt) {                                      /* instruction? */
-        fprintf (st, "%05d  ", h->is);
-        for (i = 0; i < h->ilnt; i++)
-            sim_eval[i] = h->inst[i];
-        sim_eval[h->ilnt] = WM;
-        if ((fprint_sym (st, h->is, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
-            fprintf (st, "(undefined)");
-            for (i = 0; i < h->ilnt; i++)
-                fprintf (st, " %02o", h->inst[i]);
-            }
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
 }
 
 /* Set conversions */
@@ -133,12 +133,10 @@
 #define PCQ_MASK        (PCQ_SIZE - 1)
 #define PCQ_ENTRY       pcq[pcq_p = (pcq_p - 1) & PCQ_MASK] = saved_PC
 
-#define HIST_PC         0x40000000
 #define HIST_MIN        64
 #define HIST_MAX        65536
 
 typedef struct {
-    uint16              vld;
     uint16              pc;
     uint8               inst[INST_LEN];
     } InstHistory;
@@ -163,9 +161,6 @@ int32 ind_max = 16;                                     /* iadr nest limit */
 uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 uint8 ind[NUM_IND] = { 0 };                             /* indicators */
 
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
@@ -180,6 +175,7 @@ t_stat cpu_set_table (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_release (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_set_cps (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_cps (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 
@@ -290,7 +286,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 60000, NULL, "60K", &cpu_set_size, NULL, NULL, "set memory size = 60K" },
     { UNIT_MSIZE, 0, NULL, "SAVE", &cpu_set_save },
     { UNIT_MSIZE, 0, NULL, "TABLE", &cpu_set_table },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Displays instruction history" },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, NULL, "RELEASE",
       &cpu_set_release, NULL, NULL, "Release/Complete pending I/O" },
@@ -600,14 +596,12 @@ while (reason == SCPE_OK) {                             /* loop until halted */
     else if (flags & IF_IMM)                            /* immediate? */
         QAR = qla;
 
-    if (hst_lnt) {                                      /* history enabled? */
-        hst_p = (hst_p + 1);                            /* next entry */
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        hst[hst_p].vld = 1;
-        hst[hst_p].pc = PC;     
+    if (sim_hist_lnt) {                                 /* history enabled? */
+        InstHistory *h = (InstHistory *) sim_hist_add ();   /* next entry */
+
+        h->pc = PC;     
         for (i = 0; i < INST_LEN; i++)
-            hst[hst_p].inst[i] = M[(PC + i) % MEMSIZE];
+            h->inst[i] = M[(PC + i) % MEMSIZE];
         }
 
     PC = ADDR_A (PC, INST_LEN);                         /* advance PC */
@@ -2398,76 +2392,36 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].vld = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 i, k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+int32 i;
 t_value sim_eval[INST_LEN];
-t_stat r;
-InstHistory *h;
 extern t_stat fprint_sym (FILE *ofile, t_addr addr, t_value *val,
     UNIT *uptr, int32 sw);
 
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+if (h == NULL) {
+    fprintf (st, "PC     IR\n\n");
+    return;
+    }
+fprintf (st, "%05d  ", h->pc);
+for (i = 0; i < INST_LEN; i++)
+    sim_eval[i] = h->inst[i];
+if ((fprint_sym (st, h->pc, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
+    fprintf (st, "(undefined)");
+    for (i = 0; i < INST_LEN; i++)
+        fprintf (st, "%02X", h->inst[i]);
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->vld) {                                       /* instruction? */
-        fprintf (st, "%05d  ", h->pc);
-        for (i = 0; i < INST_LEN; i++)
-            sim_eval[i] = h->inst[i];
-        if ((fprint_sym (st, h->pc, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
-            fprintf (st, "(undefined)");
-            for (i = 0; i < INST_LEN; i++)
-                fprintf (st, "%02X", h->inst[i]);
-            }
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
 }
@@ -369,6 +369,13 @@ int chan_select(int chan);
 int chan_write_char(int chan, uint8 *data, int flags);
 int chan_read_char(int chan, uint8 *data, int flags);
 
+/* Channel data handling a block at a time.  Transfers characters only
+   while the channel would take them with DATA_OK and nothing else to do,
+   returns the number moved.  The device carries on with the char routines
+   for the rest. */
+int chan_write_block(int chan, uint8 *buf, int len);
+int chan_read_block(int chan, uint8 *buf, int len);
+
 /* Flag end of file on channel */
 void chan_set_eof(int chan);
 
@@ -127,6 +127,8 @@ int                 disk_cmd(UNIT * uptr);
 int                 disk_write(UNIT * uptr, uint8 data, int chan,
                                int eor);
 int                 disk_read(UNIT * uptr, uint8 * data, int chan);
+int                 disk_write_block(UNIT * uptr, int chan);
+int                 disk_read_block(UNIT * uptr, int chan);
 int                 disk_format(UNIT * uptr, FILE * f, int cyl,
                                 UNIT * base);
 int                 bcd_to_track(uint32 addr);
@@ -137,6 +139,9 @@ uint8               dbuffer[NUM_DEVS_DSK * 4][MAXTRACK];
 /* Format buffer for cylinder */
 uint8               fbuffer[NUM_DEVS_DSK * 4][MAXTRACK / 4];
 
+/* Run of data chars passed to or from the channel in one go */
+uint8               dsk_xbuf[MAXTRACK];
+
 /* Currently loaded format record */
 uint16              fmt_cyl[NUM_DEVS_DSK * 4];
 
@@ -337,6 +342,7 @@ t_stat dsk_srv(UNIT * uptr)
     UNIT               *base = &dsk_unit[u];
     uint8               ch = 0;
     int                 eor = 0;
+    int                 i;
 
     chan = UNIT_G_CHAN(base->flags);
     sel = (base->flags & UNIT_SELECT) ? 1 : 0;
@@ -434,6 +440,13 @@ t_stat dsk_srv(UNIT * uptr)
             return SCPE_OK;
         }
         uptr->u5 |= DSKSTA_WRITE;       /* Flag as write */
+        /* Take as much of the record as the channel will give in one go */
+        i = disk_write_block(uptr, chan);
+        if (i > 0) {
+            uptr->u5 |= DSKSTA_DATA;
+            sim_activate(uptr, i * us_to_ticks(dsk->datarate));
+            return SCPE_OK;
+        }
         switch(chan_read_char(chan, &ch, 0)) {
         case TIME_ERROR:
             disk_posterr(uptr, DATA_RESPONSE);
@@ -477,6 +490,13 @@ t_stat dsk_srv(UNIT * uptr)
             sim_activate(uptr, us_to_ticks(100));
             return SCPE_OK;
         }
+        /* Give the channel as much of the record as it will take */
+        i = disk_read_block(uptr, chan);
+        if (i > 0) {
+            uptr->u5 |= DSKSTA_DATA;
+            sim_activate(uptr, i * us_to_ticks(dsk->datarate));
+            return SCPE_OK;
+        }
         eor = disk_read(uptr, &ch, chan);
         /* Check if we got error during read */
         if (eor == -1) {
@@ -1590,6 +1610,100 @@ disk_read(UNIT * uptr, uint8 * data, int chan)
     return 0;
 }
 
+/*
+ * Pass the channel a run of chars for the current write.  Only used once
+ * disk_write would store each char straight into the track: past the
+ * home address, inside a data area or a format, and not write checking.
+ * Returns the number of chars stored.
+ */
+int
+disk_write_block(UNIT * uptr, int chan)
+{
+    int                 u = uptr - dsk_unit;
+    UNIT               *base = (u > NUM_DEVS_DSK) ? &uptr[-NUM_DEVS_DSK] : uptr;
+    uint8               cmd = (uptr->u5) & DSKSTA_CMSK;
+    uint8               mask;
+    int                 schan;
+    int                 flag;
+    int                 i, n;
+
+    if (uptr->u5 & DSKSTA_CHECK)
+        return 0;
+    schan = (chan * 2) + ((base->flags & UNIT_SELECT) ? 1 : 0);
+    if (cmd == DWRF) {
+        /* Format writes chars as given up to the end of track */
+        n = (int)disk_type[uptr->u4].bpt + 1 - uptr->u6;
+        if (n > MAXTRACK - uptr->u6)
+            n = MAXTRACK - uptr->u6;
+        mask = 0377;
+    } else {
+        if (uptr->u6 == 0)
+            return 0;
+        if (cmd == DVSR && (uptr->u5 & DSKSTA_XFER) == 0)
+            return 0;
+        for (n = 0, i = uptr->u6; i < MAXTRACK; n++, i++) {
+            flag = fbuffer[u][i / 4];
+            flag >>= (i & 03) * 2;
+            flag &= 03;
+            if (flag != FMT_DATA)
+                break;
+        }
+        mask = (sense[schan] & STAT_SIXBIT)?077:0277;
+    }
+    if (n <= 0)
+        return 0;
+    n = chan_read_block(chan, dsk_xbuf, n);
+    for (i = 0; i < n; i++)
+        dbuffer[u][uptr->u6++] = dsk_xbuf[i] & mask;
+    if (n > 0) {
+        uptr->u5 |= DSKSTA_DIRTY;
+        sim_debug(DEBUG_DATA, &dsk_dev, "write block %d chars\n", n);
+    }
+    return n;
+}
+
+/*
+ * Pass the channel a run of data chars for the current read, stopping
+ * before the last char of the data area so disk_read still finds the end
+ * of record.  Returns the number of chars taken.
+ */
+int
+disk_read_block(UNIT * uptr, int chan)
+{
+    int                 u = uptr - dsk_unit;
+    UNIT               *base = (u > NUM_DEVS_DSK) ? &uptr[-NUM_DEVS_DSK] : uptr;
+    uint8               cmd = (uptr->u5) & DSKSTA_CMSK;
+    uint8               mask;
+    int                 schan;
+    int                 flag;
+    int                 i, n;
+
+    if (uptr->u6 == 0 || cmd == DWRF)
+        return 0;
+    if (cmd == DVSR && (uptr->u5 & DSKSTA_XFER) == 0)
+        return 0;
+    schan = (chan * 2) + ((base->flags & UNIT_SELECT) ? 1 : 0);
+    mask = (sense[schan] & STAT_SIXBIT)?077:0277;
+    flag = fbuffer[u][uptr->u6 / 4];
+    flag >>= (uptr->u6 & 03) * 2;
+    flag &= 03;
+    for (n = 0, i = uptr->u6; flag == FMT_DATA && i < (MAXTRACK - 1); i++) {
+        flag = fbuffer[u][(i + 1) / 4];
+        flag >>= ((i + 1) & 03) * 2;
+        flag &= 03;
+        if (flag != FMT_DATA)
+            break;
+        dsk_xbuf[n++] = dbuffer[u][i] & mask;
+    }
+    if (n == 0)
+        return 0;
+    n = chan_write_block(chan, dsk_xbuf, n);
+    uptr->u6 += n;
+    if (n > 0)
+        sim_debug(DEBUG_DATA, &dsk_dev, "read block %d chars\n", n);
+    return n;
+}
+
 /* Convert BCD track address to binary address */
 int
 bcd_to_track(uint32 addr)
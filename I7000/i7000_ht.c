@@ -328,6 +328,7 @@ t_stat ht_srv(UNIT * uptr)
     UNIT               *ctlr = &dptr->units[NUM_UNITS_HT];
     int                 sel;
     int                 schan;
+    int                 n;
     t_stat              r;
     t_mtrlnt            reclen;
 
@@ -389,6 +390,20 @@ t_stat ht_srv(UNIT * uptr)
             return SCPE_OK;
         }
 
+        /* Take as much as the channel will give in one go, leaving the
+           char that fills the buffer for the overrun check */
+        n = chan_read_block(chan,
+                    &ht_buffer[GET_DEV_BUF(dptr->flags)][uptr->u6],
+                    BUFFSIZE - 1 - uptr->u6);
+        if (n > 0) {
+            uptr->u5 |= HT_WRITE|HT_NOTRDY;
+            ctlr->u5 |= HT_NOTRDY;
+            uptr->u6 += n;
+            sim_debug(DEBUG_DATA, dptr, " write block %d chars\n", n);
+            sim_activate(uptr, n * us_to_ticks(20));
+            return SCPE_OK;
+        }
+
         switch(chan_read_char(chan, &ch, 0)) {
         case TIME_ERROR:
                 ht_tape_posterr(uptr, DATA_RESPONSE);
@@ -470,6 +485,18 @@ t_stat ht_srv(UNIT * uptr)
             sim_activate(uptr, us_to_ticks(50));
             return SCPE_OK;
         }
+        /* Give the channel all but the last char in one go */
+        if (uptr->u6 < (int32)uptr->hwmark) {
+            n = chan_write_block(chan,
+                    &ht_buffer[GET_DEV_BUF(dptr->flags)][uptr->u6],
+                    uptr->hwmark - uptr->u6);
+            if (n > 0) {
+                sim_debug(DEBUG_DATA, dptr, "data block %d chars\n", n);
+                uptr->u6 += n;
+                sim_activate(uptr, n * us_to_ticks(20));
+                return SCPE_OK;
+            }
+        }
         ch = ht_buffer[GET_DEV_BUF(dptr->flags)][uptr->u6++];
         sim_debug(DEBUG_DATA, dptr, "data %02o\n", ch);
         switch(chan_write_char(chan, &ch,
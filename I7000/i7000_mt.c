@@ -145,6 +145,12 @@ uint8               mt_chan[NUM_CHAN];
 /* One buffer per channel */
 uint8               mt_buffer[NUM_DEVS][BUFFSIZE];
 
+/* Translated record data for block transfers, valid from mt_xbeg to
+   mt_xend, which stops at the first char needing error handling */
+uint8               mt_xbuf[NUM_DEVS][BUFFSIZE];
+int32               mt_xbeg[NUM_DEVS];
+int32               mt_xend[NUM_DEVS];
+
 UNIT                mta_unit[] = {
 /* Controller 1 */
 #if (NUM_DEVS_MT > 0)
@@ -890,6 +896,7 @@ t_stat mt_srv(UNIT * uptr)
             }
             uptr->u6 = 0;
             uptr->hwmark = reclen;
+            mt_xend[bufnum] = -1;       /* No translated data yet */
             chan_clear(chan, CHS_EOF|CHS_ERR);
             sim_debug(DEBUG_DETAIL, dptr, "%s Block %d chars\n",
                       (cmd == MT_RDS) ? "BCD" : "Binary", reclen);
@@ -900,6 +907,50 @@ t_stat mt_srv(UNIT * uptr)
 
         }
 
+        /* Translate chars up to the next one with an error, leaving
+           the last char of the record for end of record handling. */
+        if (uptr->u6 < mt_xbeg[bufnum] || uptr->u6 > mt_xend[bufnum]) {
+            int32       i;
+
+            for (i = uptr->u6; i < (int32)uptr->hwmark - 1; i++) {
+                ch = mt_buffer[bufnum][i];
+                if ((parity_table[ch & 077] ^ (ch & 0100) ^ mode) == 0)
+                    break;
+#if I7090 | I704 | I701
+                if (mode) {
+                    ch ^= (ch & 020) << 1;
+                    if (ch == 012)
+                        ch = 0;
+                    if (ch == 017)
+                        break;
+                }
+#endif
+#ifdef I7010
+                if (mode && ch == 0120)
+                    ch = 0;
+#endif
+                mt_xbuf[bufnum][i] = ch & 077;
+            }
+            mt_xbeg[bufnum] = uptr->u6;
+            mt_xend[bufnum] = i;
+        }
+
+        /* Give the channel as much as it will take in one go */
+        if (uptr->u6 < mt_xend[bufnum]) {
+            int         n;
+
+            n = chan_write_block(chan, &mt_xbuf[bufnum][uptr->u6],
+                                 mt_xend[bufnum] - uptr->u6);
+            if (n > 0) {
+                sim_debug(DEBUG_DATA, dptr, "Read block unit=%d %d %d chars\n",
+                          unit, uptr->u6, n);
+                uptr->u6 += n;
+                uptr->u3 += n;
+                sim_activate(uptr, n * T1_us);
+                return SCPE_OK;
+            }
+        }
+
         ch = mt_buffer[bufnum][uptr->u6++];
         uptr->u3++;
         /* Do BCD translation */
@@ -986,6 +1037,36 @@ t_stat mt_srv(UNIT * uptr)
             return SCPE_OK;
         }
 
+        /* Take as much as the channel will give in one go */
+        if (uptr->u6 < BUFFSIZE) {
+            uint8       *bp = &mt_xbuf[bufnum][0];
+            int         i, n;
+
+            n = chan_read_block(chan, bp, BUFFSIZE - uptr->u6);
+            if (n > 0) {
+                sim_debug(DEBUG_DATA, dptr, "Write block unit=%d %d %d chars\n",
+                          unit, uptr->u6, n);
+                for (i = 0; i < n; i++) {
+                    ch = bp[i] & 077;
+#if I7090 | I701 | I704
+                    /* Not needed on decimal machines */
+                    if (mode) {
+                        /* Do BCD translation */
+                        ch ^= (ch & 020) << 1;
+                        if (ch == 0)
+                            ch = 012;
+                    }
+#endif
+                    ch |= mode ^ parity_table[ch] ^ 0100;
+                    mt_buffer[bufnum][uptr->u6++] = ch;
+                }
+                uptr->u3 += n;
+                uptr->hwmark = uptr->u6;
+                sim_activate(uptr, n * T1_us);
+                return SCPE_OK;
+            }
+        }
+
         switch (chan_read_char(chan, &ch,
                           (uptr->u6 > BUFFSIZE) ? DEV_WEOR : 0)) {
         case TIME_ERROR:
@@ -1074,6 +1155,7 @@ t_stat mt_srv(UNIT * uptr)
             }
             uptr->u6 = 0;
             uptr->hwmark = reclen;
+            mt_xend[bufnum] = -1;       /* No translated data yet */
             chan_clear(chan, CHS_EOF|CHS_ERR);
             sim_debug(DEBUG_DETAIL, dptr, "Binary Block %d chars\n", reclen);
         }
@@ -1330,6 +1412,7 @@ mt_boot(int32 unit_num, DEVICE * dptr)
         return r;
     uptr->u6 = 0;
     uptr->hwmark = reclen;
+    mt_xend[GET_DEV_BUF(dptr->flags)] = -1;
 
     /* Copy first three records. */
     mt_read_buff(uptr, MT_RDSB, dptr, &M[0]);
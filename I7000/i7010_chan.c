@@ -705,6 +705,57 @@ chan_read_char(int chan, uint8 * data, int flags)
     return DATA_OK;
 }
 
+/*
+ * Write a block of chars to memory.  Stops before a group mark or the
+ * end of memory.  The chars still go through chan_write_char, which
+ * holds the word mark and load mode handling; the checks here keep it on
+ * its DATA_OK path.  Anything else ends the block without counting the
+ * char, the device sees the status when it sends it again.
+ */
+int
+chan_write_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+
+    while (n < len) {
+        if (chan_flags[chan] & STA_WAIT)
+            break;
+        if (!MEM_ADDR_OK(caddr[chan]))
+            break;
+        if ((cmd[chan] & CHAN_NOREC) == 0 && M[caddr[chan]] == (WM|077))
+            break;
+        if (chan_write_char(chan, &buf[n], 0) != DATA_OK)
+            break;
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Read a block of chars from memory.  Stops before a group mark or the
+ * end of memory, as above the chars go through chan_read_char.
+ */
+int
+chan_read_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+
+    while (n < len && (chan_flags[chan] & STA_ACTIVE)) {
+        if (cmd[chan] & CHAN_DSK_DATA) {
+            if (M[caddr[chan]] == (WM|077))
+                break;
+        } else if ((cmd[chan] & (CHAN_LOAD|CHAN_WM)) != (CHAN_LOAD|CHAN_WM)) {
+            if (!MEM_ADDR_OK(caddr[chan]))
+                break;
+            if ((cmd[chan] & CHAN_NOREC) == 0 && M[caddr[chan]] == (WM|077))
+                break;
+        }
+        if (chan_read_char(chan, &buf[n], 0) != DATA_OK)
+            break;
+        n++;
+    }
+    return n;
+}
 
 void
 chan9_set_error(int chan, uint32 mask)
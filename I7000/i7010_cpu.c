@@ -66,9 +66,9 @@
 #define HIST_MIN        64
 #define HIST_MAX        65536
 #define HIST_NOEA       0x40000000
-#define HIST_PC         0x100000
 #define HIST_MSK        0x0FFFFF
 #define HIST_1401       0x200000        /* 1401 instruction */
+#define HIST_LAST       ((struct InstHistory *)sim_hist_last())
 
 struct InstHistory
 {
@@ -95,6 +95,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 t_stat              cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                                  const char *cptr);
 const char          *cpu_description (DEVICE *dptr);
@@ -152,9 +153,6 @@ int                 cycle_time = 28;            /* Cycle time in 100ns */
 uint8               time_digs[] = {0, 2, 3, 5, 7, 8};
 
 /* History information */
-int32               hst_p = 0;                  /* History pointer */
-int32               hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;                 /* History stack */
 extern UNIT         chan_unit[];
 
 /* Simulator debug controls */
@@ -229,7 +227,7 @@ MTAB                cpu_mod[] = {
           "No memory protection"},
     {OPTION_PROT, OPTION_PROT, "PROT", "PROT", NULL, NULL, NULL,
           "Memory Protection"},
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -593,8 +591,8 @@ sim_instr(void)
             } else {
                 if ((chwait & 040) == 0) {
                     BAR = caddr[chwait & 07];
-                    if (hst_lnt)        /* History enabled? */
-                        hst[hst_p].bend = BAR;
+                    if (sim_hist_lnt)   /* History enabled? */
+                        HIST_LAST->bend = BAR;
                 }
                 chan_io_status[chwait & 07] &= ~IO_CHS_DONE;
                 chwait = 0;
@@ -615,20 +613,19 @@ sim_instr(void)
 
         if (chwait == 0) {
             uint8 bbit = 0;
-            if (hst_lnt) {      /* History enabled? */
-                hst_p = (hst_p+1);      /* Next entry */
-                if (hst_p >= hst_lnt)
-                    hst_p = 0;
-                hst[hst_p].ic = IAR | HIST_PC;
+            if (sim_hist_lnt) { /* History enabled? */
+                struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                h->ic = IAR;
                 if (CPU_MODEL == 1)
-                    hst[hst_p].ic |= HIST_1401;
+                    h->ic |= HIST_1401;
             }
             op = FetchP(IAR++);
             /* Check if over the top */
             if (fault)
                 goto check_prot;
-            if (hst_lnt)        /* History enabled? */
-                hst[hst_p].inst[0] = op;
+            if (sim_hist_lnt)   /* History enabled? */
+                HIST_LAST->inst[0] = op;
             sim_interval -= 2;
             if ((op & WM) == 0) {
                 reason = STOP_NOWM;
@@ -642,8 +639,8 @@ sim_instr(void)
             while(((br = FetchP(IAR)) & WM) == 0 && op_info != 0 && fault == 0) {
                  IAR++;
                  sim_interval -= 2;
-                 if (hst_lnt)   /* History enabled? */
-                     hst[hst_p].inst[i++] = br;
+                 if (sim_hist_lnt) /* History enabled? */
+                     HIST_LAST->inst[i++] = br;
                  br &= 077;
                  if (CPU_MODEL != 1) {
                      switch(state) {
@@ -926,16 +923,16 @@ sim_instr(void)
                    goto check_prot;
             }
 
-            if (hst_lnt)        /* History enabled? */
-                hst[hst_p].inst[i++] = WM;      /* Term hist ins */
+            if (sim_hist_lnt)   /* History enabled? */
+                HIST_LAST->inst[i++] = WM;      /* Term hist ins */
 
             jump = 0;
             if (CPU_MODEL == 1) {
 
-                if (hst_lnt) {  /* History enabled? */
-                     hst[hst_p].astart = AAR;
-                     hst[hst_p].bstart = BAR;
-                     hst[hst_p].inst[state] = WM;
+                if (sim_hist_lnt) {  /* History enabled? */
+                     HIST_LAST->astart = AAR;
+                     HIST_LAST->bstart = BAR;
+                     HIST_LAST->inst[state] = WM;
                 }
 
                 /* Translate instruction from 1401 to 1410 */
@@ -1014,8 +1011,8 @@ sim_instr(void)
                                 }
                                 if (chwait != 0) {
                                     BAR = caddr[1];
-                                    if (hst_lnt)        /* History enabled? */
-                                        hst[hst_p].bend = BAR;
+                                    if (sim_hist_lnt)   /* History enabled? */
+                                        HIST_LAST->bend = BAR;
                                     chwait = 0;
                                 }
 
@@ -1300,13 +1297,13 @@ sim_instr(void)
                        break;
                 }
 
-                if (hst_lnt) {  /* History enabled? */
-                    hst[hst_p].astart = AAR;
-                    hst[hst_p].bstart = BAR;
+                if (sim_hist_lnt) {  /* History enabled? */
+                    HIST_LAST->astart = AAR;
+                    HIST_LAST->bstart = BAR;
                     if (op_info & O_M &&
                           (state == 1 || state == 6 || state == 11)) {
-                         hst[hst_p].inst[state] = op_mod;
-                         hst[hst_p].inst[state+1] = WM;
+                         HIST_LAST->inst[state] = op_mod;
+                         HIST_LAST->inst[state+1] = WM;
                     }
                 }
 
@@ -1391,10 +1388,10 @@ sim_instr(void)
                                 AAR = 101;
                                 op = OP_PRI;
                                 op_mod = CHR_X;
-                                if (hst_lnt) {  /* History enabled? */
-                                    hst[hst_p].inst[0] = op;
-                                    hst[hst_p].inst[1] = op_mod;
-                                    hst[hst_p].inst[2] = WM;
+                                if (sim_hist_lnt) {  /* History enabled? */
+                                    HIST_LAST->inst[0] = op;
+                                    HIST_LAST->inst[1] = op_mod;
+                                    HIST_LAST->inst[2] = WM;
                                 }
                             } else if (timer_enable && timer_irq == 1) {
                                 sim_debug(DEBUG_PRIO, &cpu_dev, "Tim=%d\n",IAR);
@@ -1403,10 +1400,10 @@ sim_instr(void)
                                 timer_irq = 2;
                                 op = OP_PRI;
                                 op_mod = CHR_X;
-                                if (hst_lnt) {  /* History enabled? */
-                                    hst[hst_p].inst[0] = op;
-                                    hst[hst_p].inst[1] = op_mod;
-                                    hst[hst_p].inst[2] = WM;
+                                if (sim_hist_lnt) {  /* History enabled? */
+                                    HIST_LAST->inst[0] = op;
+                                    HIST_LAST->inst[1] = op_mod;
+                                    HIST_LAST->inst[2] = WM;
                                 }
                             }
                         }
@@ -2431,8 +2428,8 @@ fprintf(stderr, "No device %d %d\n\r", ch, temp);
                 /* AAR pointes to exponent of FP */
                 /* BAR point to FP register locations 280 - 299 */
                 BAR = 299;
-                if (hst_lnt)    /* History enabled? */
-                    hst[hst_p].bstart = BAR;
+                if (sim_hist_lnt)   /* History enabled? */
+                    HIST_LAST->bstart = BAR;
                 switch(op_mod) {
                 case CHR_R:                /* R - Floating Reset Add */
                     /* Copy exponent to accumulator */
@@ -3403,30 +3400,31 @@ fprintf(stderr, "No device %d %d\n\r", ch, temp);
                 BAR = IAR;      /* Save current for posterity */
                 IAR = AAR & AMASK;
             }
-            if (hst_lnt) {      /* History enabled? */
+            if (sim_hist_lnt) { /* History enabled? */
+                struct InstHistory *h = HIST_LAST;
                 int     len, start;
-                hst[hst_p].aend = AAR;
-                hst[hst_p].bend = BAR;
-                len = hst[hst_p].bend - hst[hst_p].bstart;
+                h->aend = AAR;
+                h->bend = BAR;
+                len = h->bend - h->bstart;
                 if (len < 0) {
                    len = -len;
-                   start = hst[hst_p].bend + 1;
+                   start = h->bend + 1;
                    if (len > 50) {
-                        start = hst[hst_p].bstart - 50;
+                        start = h->bstart - 50;
                         len = 50;
                    }
                 } else {
                    if (len > 50)
                         len = 50;
-                   start = hst[hst_p].bstart;
+                   start = h->bstart;
                 }
                 if (jump) {
                    len = 0;
-                   start = hst[hst_p].bstart;
+                   start = h->bstart;
                 }
                 for(i = 0; i < len; i++)
-                    hst[hst_p].bdata[i] = ReadP(start+i);
-                hst[hst_p].dlen = len;
+                    h->bdata[i] = ReadP(start+i);
+                h->dlen = len;
             }
         }
 
@@ -3912,34 +3910,8 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].ic = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -3947,48 +3919,36 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, i, di, lnt, pc;
-    char               *cptr = (char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                         (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
+    int32               i, pc;
     t_value             sim_eval[50];
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st, "IC     A     B    Aend  Bend   \n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
-        }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->ic & HIST_PC) {  /* instruction? */
-            pc = h->ic & HIST_MSK;
-            fprintf(st, "%05d ", pc);
-            fprintf(st, "%05d ", h->astart & AMASK);
-            fprintf(st, "%05d ", h->bstart & AMASK);
-            fprintf(st, "%05d%c", h->aend & AMASK, (h->aend & BBIT)?'+':' ');
-            fprintf(st, "%05d%c|", h->bend & AMASK, (h->bend & BBIT)?'+':' ');
-            for(i = 0; i < h->dlen; i++)
-                fputc(mem_to_ascii[h->bdata[i]&077], st);
-            fputc('|', st);
-            fputc(' ', st);
-            for(i = 0; i< 15; i++)
-                sim_eval[i] = h->inst[i];
-            (void)fprint_sym(st, pc, sim_eval, &cpu_unit, SWMASK((h->ic & HIST_1401)?'N':'M'));
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+
+    if (h == NULL) {
+        fprintf(st, "IC     A     B    Aend  Bend   \n");
+        return;
+    }
+    pc = h->ic & HIST_MSK;
+    fprintf(st, "%05d ", pc);
+    fprintf(st, "%05d ", h->astart & AMASK);
+    fprintf(st, "%05d ", h->bstart & AMASK);
+    fprintf(st, "%05d%c", h->aend & AMASK, (h->aend & BBIT)?'+':' ');
+    fprintf(st, "%05d%c|", h->bend & AMASK, (h->bend & BBIT)?'+':' ');
+    for(i = 0; i < h->dlen; i++)
+        fputc(mem_to_ascii[h->bdata[i]&077], st);
+    fputc('|', st);
+    fputc(' ', st);
+    for(i = 0; i< 15; i++)
+        sim_eval[i] = h->inst[i];
+    (void)fprint_sym(st, pc, sim_eval, &cpu_unit, SWMASK((h->ic & HIST_1401)?'N':'M'));
 }
 
 
@@ -395,6 +395,21 @@ chan_read_char(int chan, uint8 * data, int flags)
     return DATA_OK;
 }
 
+/*
+ * The 701 moves every word through the CPU, so no block transfers.
+ */
+int
+chan_write_block(int chan, uint8 * buf, int len)
+{
+    return 0;
+}
+
+int
+chan_read_block(int chan, uint8 * buf, int len)
+{
+    return 0;
+}
+
 void
 chan9_set_error(int chan, uint32 mask)
 {
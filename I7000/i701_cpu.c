@@ -87,7 +87,6 @@
 #define HIST_MIN        64
 #define HIST_MAX        65536
 #define HIST_NOEA       0x40000000
-#define HIST_PC         0x10000
 
 struct InstHistory
 {
@@ -110,6 +109,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 t_stat              cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                         const char *cptr);
 const char          *cpu_description (DEVICE *dptr);
@@ -133,9 +133,6 @@ uint16              dev_pulse[NUM_CHAN];        /* SPRA device pulses */
 int                 cycle_time = 120;           /* Cycle time of 12us */
 
 /* History information */
-int32               hst_p = 0;                  /* History pointer */
-int32               hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;                 /* History stack */
 extern uint32       drum_addr;
 uint32              hsdrm_addr;
 extern UNIT         chan_unit[];
@@ -173,7 +170,7 @@ REG                 cpu_reg[] = {
 };
 
 MTAB                cpu_mod[] = {
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -243,16 +240,15 @@ sim_instr(void)
             temp = SR;
             if ((IC & 1) == 0)
                 temp >>= 18;
-            if (hst_lnt) {      /* history enabled? */
-                hst_p = (hst_p + 1);    /* next entry */
-                if (hst_p >= hst_lnt)
-                    hst_p = 0;
-                hst[hst_p].ic = IC | HIST_PC;
-                hst[hst_p].ea = 0;
-                hst[hst_p].op = temp & RMASK;
-                hst[hst_p].ac = AC;
-                hst[hst_p].mq = MQ;
-                hst[hst_p].sr = 0;
+            if (sim_hist_lnt) {      /* history enabled? */
+                struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                h->ic = IC;
+                h->ea = 0;
+                h->op = temp & RMASK;
+                h->ac = AC;
+                h->mq = MQ;
+                h->sr = 0;
             }
             IC = (IC + 1) & AMASK;
         }
@@ -265,9 +261,11 @@ sim_instr(void)
                 SR <<= 18;
            SR &= LMASK;
         }
-        if (hst_lnt) {  /* history enabled? */
-            hst[hst_p].sr = SR;
-            hst[hst_p].ea = MA;
+        if (sim_hist_lnt) {  /* history enabled? */
+            struct InstHistory *h = (struct InstHistory *)sim_hist_last();
+
+            h->sr = SR;
+            h->ea = MA;
         }
 
         switch (opcode & 037) {
@@ -410,8 +408,8 @@ store:
                     SR |= ibr;
                 }
                 WriteP(MA>>1, SR);
-                if (hst_lnt) {  /* history enabled? */
-                    hst[hst_p].sr = SR;
+                if (sim_hist_lnt) {  /* history enabled? */
+                    ((struct InstHistory *)sim_hist_last())->sr = SR;
                 }
                 sim_interval -= 6;
                 break;
@@ -828,34 +826,8 @@ cpu_dep(t_value val, t_addr addr, UNIT * uptr, int32 sw)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].ic = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -863,84 +835,71 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    char               *cptr = (char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                         (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
     t_value             sim_eval;
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st, "IC      AC            MQ            EA      SR\n\n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
-        }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->ic & HIST_PC) {  /* instruction? */
-            fprintf(st, "%06lo ", h->ic & AMASK);
-            switch (h->ac & (AMSIGN | AQSIGN | APSIGN)) {
-            case AMSIGN | AQSIGN | APSIGN:
-                fprintf(st, "-QP");
-                break;
-            case AMSIGN | AQSIGN:
-                fprintf(st, " -Q");
-                break;
-            case AMSIGN | APSIGN:
-                fprintf(st, " -P");
-                break;
-            case AMSIGN:
-                fprintf(st, "  -");
-                break;
-            case AQSIGN | APSIGN:
-                fprintf(st, " QP");
-                break;
-            case AQSIGN:
-                fprintf(st, "  Q");
-                break;
-            case APSIGN:
-                fprintf(st, "  P");
-                break;
-            case 0:
-                fprintf(st, "   ");
-                break;
-            }
-            fprint_val(st, h->ac & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            if (h->mq & MSIGN)
-                fputc('-', st);
-            else
-                fputc(' ', st);
-            fprint_val(st, h->mq & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->ea, 8, 12, PV_RZRO);
-            fputc(' ', st);
-            if (h->sr & MSIGN)
-                fputc('-', st);
-            else
-                fputc(' ', st);
-            fprint_val(st, h->sr & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            sim_eval = h->op;
-            if (
-                (fprint_sym
-                 (st, h->ic & AMASK, &sim_eval, &cpu_unit,
-                  SWMASK('M'))) > 0) fprintf(st, "(undefined) %012llo",
-                                             h->op);
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+
+    if (h == NULL) {
+        fprintf(st, "IC      AC            MQ            EA      SR\n\n");
+        return;
+    }
+    fprintf(st, "%06lo ", h->ic & AMASK);
+    switch (h->ac & (AMSIGN | AQSIGN | APSIGN)) {
+    case AMSIGN | AQSIGN | APSIGN:
+        fprintf(st, "-QP");
+        break;
+    case AMSIGN | AQSIGN:
+        fprintf(st, " -Q");
+        break;
+    case AMSIGN | APSIGN:
+        fprintf(st, " -P");
+        break;
+    case AMSIGN:
+        fprintf(st, "  -");
+        break;
+    case AQSIGN | APSIGN:
+        fprintf(st, " QP");
+        break;
+    case AQSIGN:
+        fprintf(st, "  Q");
+        break;
+    case APSIGN:
+        fprintf(st, "  P");
+        break;
+    case 0:
+        fprintf(st, "   ");
+        break;
+    }
+    fprint_val(st, h->ac & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    if (h->mq & MSIGN)
+        fputc('-', st);
+    else
+        fputc(' ', st);
+    fprint_val(st, h->mq & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->ea, 8, 12, PV_RZRO);
+    fputc(' ', st);
+    if (h->sr & MSIGN)
+        fputc('-', st);
+    else
+        fputc(' ', st);
+    fprint_val(st, h->sr & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    sim_eval = h->op;
+    if (
+        (fprint_sym
+         (st, h->ic & AMASK, &sim_eval, &cpu_unit,
+          SWMASK('M'))) > 0) fprintf(st, "(undefined) %012llo",
+                                     h->op);
 }
 
 const char *
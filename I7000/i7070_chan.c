@@ -1559,6 +1559,46 @@ done:
     return DATA_OK;
 }
 
+/*
+ * Write a block of chars to the assembly register.  Stops when the
+ * channel has not taken the last word.  The digit and alpha mode
+ * handling stays in chan_write_char, a char it does not take with
+ * DATA_OK ends the block uncounted so the device sees the status when
+ * it sends the char again.
+ */
+int
+chan_write_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+
+    while (n < len && (chan_flags[chan] & DEV_FULL) == 0) {
+        if (chan_write_char(chan, &buf[n], 0) != DATA_OK)
+            break;
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Read a block of chars from the assembly register.  Stops when the
+ * channel has no word ready.
+ */
+int
+chan_read_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+
+    while (n < len) {
+        chan_proc();
+        if ((chan_flags[chan] & DEV_FULL) == 0)
+            break;
+        if (chan_read_char(chan, &buf[n], 0) != DATA_OK)
+            break;
+        n++;
+    }
+    return n;
+}
+
 void
 chan_set_load_mode(int chan)
 {
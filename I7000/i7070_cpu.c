@@ -79,9 +79,9 @@
 #define HIST_NOEA       0x10000000
 #define HIST_NOAFT      0x20000000
 #define HIST_NOBEF      0x40000000
-#define HIST_PC         0x10000
 #define HIST_MIN        64
 #define HIST_MAX        65536
+#define HIST_LAST       ((struct InstHistory *)sim_hist_last())
 
 struct InstHistory
 {
@@ -103,6 +103,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 t_stat              cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                         const char *cptr);
 const char          *cpu_description (DEVICE *dptr);
@@ -128,11 +129,6 @@ uint8               pri_enb = 1;                /* Enable priority procs */
 uint8               lpr_chan9[NUM_CHAN];        /* Line printer on channel 9 */
 int                 cycle_time = 20;            /* Cycle time of 12us */
 
-/* History information */
-int32               hst_p = 0;                  /* History pointer */
-int32               hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;                 /* History stack */
-
 
 /* CPU data structures
 
@@ -174,7 +170,7 @@ MTAB                cpu_mod[] = {
     {OPTION_EXTEND, OPTION_EXTEND, "EXTEND", "EXTEND", NULL, NULL, NULL},
     {OPTION_TIMER, 0, NULL, "NOCLOCK", NULL, NULL, NULL},
     {OPTION_TIMER, OPTION_TIMER, "CLOCK", "CLOCK", NULL, NULL, NULL},
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -365,13 +361,12 @@ sim_instr(void)
                 iowait = 0;
             else {
                 MBR = ReadP(IC);
-                if (hst_lnt) {  /* history enabled? */
-                    hst_p = (hst_p + 1);        /* next entry */
-                    if (hst_p >= hst_lnt)
-                        hst_p = 0;
-                    hst[hst_p].ic = (IC) | HIST_PC;
-                    hst[hst_p].op = MBR;
-                    hst[hst_p].after = 0;
+                if (sim_hist_lnt) { /* history enabled? */
+                    struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                    h->ic = IC;
+                    h->op = MBR;
+                    h->after = 0;
                 }
                 IC++;
                 MA = MBR & 0xf;                 MBR >>= 4;
@@ -421,9 +416,9 @@ sim_instr(void)
                  IX = f2 + dscale[0][f1];
             /* Fetch data */
                  MBR = ReadP(MA);
-                 if (hst_lnt) {  /* history enabled? */
-                     hst[hst_p].ea = MA;
-                     hst[hst_p].before = MBR;
+                 if (sim_hist_lnt) { /* history enabled? */
+                     HIST_LAST->ea = MA;
+                     HIST_LAST->before = MBR;
                  }
              }
 
@@ -449,8 +444,8 @@ sim_instr(void)
 
                      AC[op2] = MBR;
                      sim_interval -= (CPU_MODEL == 0x0)? (f2 - f1)/3: 1;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[op2];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[op2];
                      }
                      break;
                 /* AC - memory */
@@ -503,8 +498,8 @@ sim_instr(void)
                         AC[op2] |= MSIGN;
                      else
                         AC[op2] |= PSIGN;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[op2];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[op2];
                      }
                      break;
                 /* |memory| + AC */
@@ -582,8 +577,8 @@ sim_instr(void)
                      MBR |= DMASK & temp << ((9 - f2) * 4);
                      MBR |= ((t_uint64)sign) << 40;
                      WriteP(MA, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
 
@@ -597,16 +592,16 @@ sim_instr(void)
                      case 1: inds |= 0x0000100000LL; break;
                      case 0: inds |= 0x0000010000LL; break;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[op2];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[op2];
                      }
                      break;
 
                 /* Clear Memory, store */
                 case OP_ZST1: case OP_ZST2: case OP_ZST3:
                      MBR = SMASK & AC[op2];     /* Same sign as AC */
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF;
                      }
                 /* Store digit */
                 case OP_STD1: case OP_STD2: case OP_STD3:
@@ -644,8 +639,8 @@ sim_instr(void)
                      /* Restore results */
                      MBR |= DMASK & (temp << ((9 - f2) * 4));
                      WriteP(MA, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
 
@@ -653,8 +648,8 @@ sim_instr(void)
                 case OP_BZ1: case OP_BZ2: case OP_BZ3:
                      if ((AC[op2] & DMASK) == 0)
                         IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Branch AC overflow */
@@ -663,16 +658,16 @@ sim_instr(void)
                         IC = MA;
                         inds &= ~(0xFLL << (4 * (3 - op2)));/* clear overflow */
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Branch AC minus */
                 case OP_BM1: case OP_BM2: case OP_BM3:
                      if ((AC[op2] & SMASK) == MSIGN)
                         IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Multiply */
@@ -705,8 +700,8 @@ sim_instr(void)
                      /* Set sign */
                      AC[1] |= ((t_uint64)sign) << 40;
                      AC[2] |= ((t_uint64)sign) << 40;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -740,8 +735,8 @@ sim_instr(void)
                      AC[2] |= ((t_uint64)sign) << 40;
                      AC[3] &= DMASK;
                      AC[3] |= ((t_uint64)sign) << 40;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -790,13 +785,13 @@ sim_instr(void)
                         }
                         break;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = AC[op2];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = AC[op2];
                      }
                      AC[op2] &= SMASK;
                      AC[op2] |= DMASK & temp;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[op2];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[op2];
                      }
                      break;
                 /* Coupled shift control */
@@ -806,8 +801,8 @@ sim_instr(void)
                         break;
                      op2 = (MA / 100) % 10;     /* Operand */
                      f2 += f1 * 10;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = AC[1];
                      }
                      switch (op2) {
                      default:
@@ -924,8 +919,8 @@ sim_instr(void)
                      }
                      AC[1] |= ((t_uint64)sign) << 40;
                      AC[2] |= ((t_uint64)sign) << 40;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
                 /* AC1 : |Memory | */
@@ -937,8 +932,8 @@ sim_instr(void)
                      case 1: inds |= 0x0000100000LL; break;
                      case 0: inds |= 0x0000010000LL; break;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
                 /* Compare digit */
@@ -952,8 +947,8 @@ sim_instr(void)
                         inds |= 0x0000001000LL;
                      else
                         inds |= 0x0000010000LL;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      break;
                 /* Branch load index */
@@ -962,32 +957,32 @@ sim_instr(void)
                 /* Branch */
                 case OP_B:
                      IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Branch low */
                 case OP_BL:
                      if (inds & 0x0000001000LL)
                         IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Branch high */
                 case OP_BH:
                      if (inds & 0x0000100000LL)
                         IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Branch equal */
                 case OP_BE:
                      if (inds & 0x0000010000LL)
                         IC = MA;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Extended memory on 7074 */
@@ -1006,8 +1001,8 @@ sim_instr(void)
                                 break;
                         }
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 case OP_HB:
@@ -1018,8 +1013,8 @@ sim_instr(void)
                      /* fall through */
                 case OP_NOP:
                      /* fall through */
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                      }
                      break;
                 /* Floating point option */
@@ -1142,8 +1137,8 @@ sim_instr(void)
                      } else {
                          AC[2] |= PSIGN;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -1220,8 +1215,8 @@ sim_instr(void)
                         AC[1] |= PSIGN;
                         AC[2] |= PSIGN;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -1231,8 +1226,8 @@ sim_instr(void)
                          reason = STOP_UUO;
                          break;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = AC[1];
                      }
                      if (((AC[2] >> 28) & 0xf) > 5) {
                         temp = AC[1] & SMASK;
@@ -1244,8 +1239,8 @@ sim_instr(void)
                         AC[1] |= temp;          /* Restore sign */
                      }
                      AC[2] = PSIGN;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -1423,8 +1418,8 @@ sim_instr(void)
                         AC[1] |= PSIGN;
                         AC[2] |= PSIGN;
                      }
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -1457,8 +1452,8 @@ sim_instr(void)
                      bin_dec(&AC[1], tmp, 8, 2);        /* Restore exponent */
                      AC[1] |= MBR & SMASK;
                      AC[2] |= MBR & SMASK;
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = AC[1];
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = AC[1];
                      }
                      break;
 
@@ -1489,51 +1484,51 @@ sim_instr(void)
                 /* Load index */
                 case OP_XL:
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      break;
                 /* Unload index */
                 case OP_XU:
                      MBR = ReadP(IX);
                      WriteP(MA, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Index zero subtract */
                 case OP_XZS:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      upd_idx(&MBR, MA);
                      MBR &= DMASK;
                      MBR |= MSIGN;
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Index zero add */
                 case OP_XZA:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      upd_idx(&MBR, MA);
                      MBR &= DMASK;
                      MBR |= PSIGN;
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Index subtract */
                 case OP_XS:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      temp = dec_bin_idx(MBR);
                      sign = (uint8)(((MBR & SMASK)>> 40) & 0xf);
@@ -1555,15 +1550,15 @@ sim_instr(void)
                      MBR |= ((t_uint64)sign) << 40;
                      upd_idx(&MBR, (uint32)temp);
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Index add */
                 case OP_XA:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      temp = 0;
                      upd_idx(&temp, MA);
@@ -1590,28 +1585,28 @@ sim_instr(void)
                      MBR &= (emode)?~IMASK2:~IMASK;
                      MBR |= temp;
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Index set non-indexing */
                 case OP_XSN:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      bin_dec(&MBR, MA, 0, 4);
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      break;
                 /* Branch if index word index = 0 */
                 case OP_BXN:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      if ((MBR & IMASK) != 0)
                         IC = MA;
@@ -1619,38 +1614,38 @@ sim_instr(void)
                 /* Branch decrement index */
                 case OP_BDX:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      temp = MBR & IMASK;
                      dec_add(&temp, (emode)?0x999990000LL:0x99990000LL);
                      MBR &= (emode)?~IMASK2:~IMASK;
                      MBR |= temp & (emode)?IMASK2:IMASK;
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      goto checkix;
                 /* Branch increment index */
                 case OP_BIX:
                      temp = MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
                      }
                      dec_add(&temp, 0x10000LL);
                      MBR &= (emode)?~IMASK2:~IMASK;
                      MBR |= temp & ((emode)?IMASK2:IMASK);
                      WriteP(IX, MBR);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].after = MBR;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->after = MBR;
                      }
                      goto checkix;
                 /* Branch compared index */
                 case OP_BCX:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                 checkix:
                      temp = (MBR & IMASK) >> 16;
@@ -1662,17 +1657,17 @@ sim_instr(void)
                 /* Branch if index word index minus */
                 case OP_BXM:
                      MBR = ReadP(IX);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].before = MBR;
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->before = MBR;
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      if ((MBR & SMASK) == MSIGN)
                         IC = MA;
                      break;
                 /* Field over flow control */
                 case OP_BFLD:
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                      }
                      switch (f2) {
                      case 0:
@@ -1686,8 +1681,8 @@ sim_instr(void)
                                 inds &= 0xFF0FFFFFFFFLL;
                                 inds |= 0x00500000000LL;
                            }
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOEA;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOEA;
                            }
                            break;
                      case 2:
@@ -1695,8 +1690,8 @@ sim_instr(void)
                                 reason = STOP_SIGN;
                            else
                                 inds &= 0xFF0FFFFFFFFLL;
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOEA;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOEA;
                            }
                            break;
                      }
@@ -1713,24 +1708,24 @@ sim_instr(void)
                                 inds |= 0x00000001000LL;
                            else
                                 inds |= 0x00000010000LL;
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOAFT;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOAFT;
                            }
                            break;
                       case 1:
                            MBR &= DMASK;
                            MBR |= ((t_uint64)f1) << 40;
                            WriteP(MA, MBR);
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].after = MBR;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->after = MBR;
                            }
                            break;
                       case 2:
                            if ((inds & 0xF000000000LL) == 0) {
                                 inds |= 0x5000000000LL;
                            }
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOEA|HIST_NOBEF|HIST_NOAFT;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOEA|HIST_NOBEF|HIST_NOAFT;
                            }
                            break;
                       case 3:
@@ -1738,8 +1733,8 @@ sim_instr(void)
                                 reason = STOP_SIGN;
                            else
                                 inds &= 0xF0FFFFFFFFFLL;
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOEA|HIST_NOBEF|HIST_NOAFT;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOEA|HIST_NOBEF|HIST_NOAFT;
                            }
                            break;
                       case 4:
@@ -1747,8 +1742,8 @@ sim_instr(void)
                                 IC = MA;
                                 inds ^= 0xF000000000LL;
                            }
-                           if (hst_lnt) {  /* history enabled? */
-                               hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                           if (sim_hist_lnt) { /* history enabled? */
+                               HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                            }
                            break;
                       }
@@ -1769,8 +1764,8 @@ sim_instr(void)
                                 utmp = 0;
                        }
                      } while ((MBR & SMASK) != MSIGN);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      break;
                 /* Record gather */
@@ -1788,8 +1783,8 @@ sim_instr(void)
                                utmp = 0;
                           }
                      } while ((MBR & SMASK) != MSIGN);
-                     if (hst_lnt) {  /* history enabled? */
-                         hst[hst_p].ic |= HIST_NOAFT;
+                     if (sim_hist_lnt) { /* history enabled? */
+                         HIST_LAST->ic |= HIST_NOAFT;
                      }
                      break;
                 /* Edit alpha to numeric */
@@ -1846,8 +1841,8 @@ sim_instr(void)
                                 WriteP(dst++, buffer);
                           }
                         } while ((MBR & SMASK) != MSIGN);
-                        if (hst_lnt) {  /* history enabled? */
-                             hst[hst_p].ic |= HIST_NOAFT;
+                        if (sim_hist_lnt) { /* history enabled? */
+                             HIST_LAST->ic |= HIST_NOAFT;
                         }
                         break;
                 case OP_EAN:
@@ -1879,16 +1874,16 @@ sim_instr(void)
                                    utmp = 0;
                           }
                         } while ((MBR & SMASK) != MSIGN);
-                        if (hst_lnt) {  /* history enabled? */
-                             hst[hst_p].ic |= HIST_NOAFT;
+                        if (sim_hist_lnt) { /* history enabled? */
+                             HIST_LAST->ic |= HIST_NOAFT;
                         }
                         break;
                 case OP_LL:
                 case OP_LE:
                 case OP_LEH:
                         /* Generate increment */
-                        if (hst_lnt) {  /* history enabled? */
-                             hst[hst_p].ic |= HIST_NOAFT;
+                        if (sim_hist_lnt) { /* history enabled? */
+                             HIST_LAST->ic |= HIST_NOAFT;
                         }
                         temp = M[98];
                         utmp = dec_bin_idx(temp);
@@ -1937,8 +1932,8 @@ sim_instr(void)
                         opcode -= OP_BSW21;
                         opcode += 101;
                         MBR = ReadP(opcode);
-                        if (hst_lnt) {  /* history enabled? */
-                            hst[hst_p].before = MBR;
+                        if (sim_hist_lnt) { /* history enabled? */
+                            HIST_LAST->before = MBR;
                         }
                         /* Compute mask */
                         f2 = 4 * (9 - f2);
@@ -1954,8 +1949,8 @@ sim_instr(void)
                             MBR &= ~(temp);
                         if (f1 & 1) /* Set flag */
                             MBR |= 0x1LL << f2;
-                        if (hst_lnt) {  /* history enabled? */
-                            hst[hst_p].after = MBR;
+                        if (sim_hist_lnt) { /* history enabled? */
+                            HIST_LAST->after = MBR;
                         }
                         WriteP(opcode, MBR);
                         break;
@@ -1980,8 +1975,8 @@ sim_instr(void)
                          pri_mask &= 0xFFC00;
                          pri_mask |= utmp;
                       }
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT;
                       }
                       break;
 
@@ -1998,8 +1993,8 @@ sim_instr(void)
                          if ((pri_latchs[f1] >> f2) & 1)
                              IC = MA;
                       }
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOBEF|HIST_NOAFT;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOBEF|HIST_NOAFT;
                       }
                       break;
 
@@ -2016,16 +2011,16 @@ sim_instr(void)
                              pri_latchs[f1] |= 1 << f2;
                              break;
                       }
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOEA;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOEA;
                       }
                       break;
 
                 /* Clear priority latches */
                 case OP_PRIOF:
                       pri_latchs[f1] &= ~(1 << f2);
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF|HIST_NOEA;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF|HIST_NOEA;
                       }
                       break;
 
@@ -2041,11 +2036,11 @@ sim_instr(void)
                              MBR |= PSIGN;
                              WriteP(97, MBR);
                              pri_enb = 0;
-                             if (hst_lnt) {  /* history enabled? */
-                                 hst[hst_p].after = MBR;
+                             if (sim_hist_lnt) { /* history enabled? */
+                                 HIST_LAST->after = MBR;
                              }
-                          } else if (hst_lnt) {  /* history enabled? */
-                              hst[hst_p].ic |= HIST_NOAFT;
+                          } else if (sim_hist_lnt) { /* history enabled? */
+                              HIST_LAST->ic |= HIST_NOAFT;
                           }
                           inds = PSIGN;
                           IC = tmp;
@@ -2056,8 +2051,8 @@ sim_instr(void)
                              IC = MA;
                           inds = ReadP(100);
                           pri_enb = 1;
-                          if (hst_lnt) {  /* history enabled? */
-                              hst[hst_p].ic |= HIST_NOAFT;
+                          if (sim_hist_lnt) { /* history enabled? */
+                              HIST_LAST->ic |= HIST_NOAFT;
                           }
                       }
                       break;
@@ -2077,15 +2072,15 @@ sim_instr(void)
                            if (chan_active(((f2 - 1) * 4) + f1))
                               IC = MA;
                       }
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                       break;
 
                 /* Inquiry station */
                 case OP_INQ:
-                      if (hst_lnt) { /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                       IX = 0;
                       if (f1 != 1) {    /* Only support group one */
@@ -2122,8 +2117,8 @@ sim_instr(void)
                       break;
                 /* Unit record I/O */
                 case OP_UREC:
-                      if (hst_lnt) { /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                       switch (f2) {
                       case 0:   utmp = (IO_TRS << 8); break;    /* US */
@@ -2205,8 +2200,8 @@ sim_instr(void)
                 case OP_TAPP2:
                 case OP_TAPP3:
                 case OP_TAPP4:
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                      /* If pending IRQ, wait for it to be processed */
                       if ((pri_latchs[opcode & 0xf] >> f1) & 1) {
@@ -2297,8 +2292,8 @@ sim_instr(void)
                 /* Binary tape read channel 1 */
                 case OP_TRN:
                 case OP_TRNP:
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                      /* If pending IRQ, wait for it to be processed */
                       if ((pri_latchs[1] >> f1) & 1) {
@@ -2388,8 +2383,8 @@ sim_instr(void)
                            WriteP(350 + ((utmp >> 8) & 0xf) - 4, MBR);
                            break;
                       }
-                      if (hst_lnt) {  /* history enabled? */
-                          hst[hst_p].ic |= HIST_NOAFT|HIST_NOBEF;
+                      if (sim_hist_lnt) { /* history enabled? */
+                          HIST_LAST->ic |= HIST_NOAFT|HIST_NOBEF;
                       }
                       break;
 
@@ -2882,34 +2877,8 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].ic = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -2917,68 +2886,55 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    char               *cptr = (char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory),
+                         &cpu_fprint_hist, (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
     t_value             sim_eval;
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st, "IC    EA    BEFORE      AFTER       INST\n\n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
+
+    if (h == NULL) {
+        fprintf(st, "IC    EA    BEFORE      AFTER       INST\n\n");
+        return;
+    }
+    fprintf(st, "%05d ", h->ic & 0xffff);
+    if (h->ic & HIST_NOEA)
+        fputs("       ", st);
+    else
+        fprintf(st, " %05d ", h->ea);
+    if (h->ic & HIST_NOBEF)
+        fputs("           ", st);
+    else {
+        switch (h->before & SMASK) {
+        case PSIGN: fputc('+', st); break;
+        case MSIGN: fputc('-', st); break;
+        case ASIGN: fputc('@', st); break;
+        default: fputc('#', st); break;
         }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->ic & HIST_PC) {  /* instruction? */
-            fprintf(st, "%05d ", h->ic & 0xffff);
-            if (h->ic & HIST_NOEA)
-                fputs("       ", st);
-            else
-                fprintf(st, " %05d ", h->ea);
-            if (h->ic & HIST_NOBEF)
-                fputs("           ", st);
-            else {
-                switch (h->before & SMASK) {
-                case PSIGN: fputc('+', st); break;
-                case MSIGN: fputc('-', st); break;
-                case ASIGN: fputc('@', st); break;
-                default: fputc('#', st); break;
-                }
-                fprint_val(st, h->before & DMASK, 16, 40, PV_RZRO);
-            }
-            fputc(' ', st);
-            if (h->ic & HIST_NOAFT)
-                fputs("           ", st);
-            else {
-                switch (h->after & SMASK) {
-                case PSIGN: fputc('+', st); break;
-                case MSIGN: fputc('-', st); break;
-                case ASIGN: fputc('@', st); break;
-                default: fputc('#', st); break;
-                }
-                fprint_val(st, h->after & DMASK, 16, 40, PV_RZRO);
-            }
-            fputc(' ', st);
-            sim_eval = h->op;
-            if (
-                (fprint_sym(st, h->ic & AMASK, &sim_eval, &cpu_unit,
-                  SWMASK('M'))) > 0) fputs("(undefined)", st);
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+        fprint_val(st, h->before & DMASK, 16, 40, PV_RZRO);
+    }
+    fputc(' ', st);
+    if (h->ic & HIST_NOAFT)
+        fputs("           ", st);
+    else {
+        switch (h->after & SMASK) {
+        case PSIGN: fputc('+', st); break;
+        case MSIGN: fputc('-', st); break;
+        case ASIGN: fputc('@', st); break;
+        default: fputc('#', st); break;
+        }
+        fprint_val(st, h->after & DMASK, 16, 40, PV_RZRO);
+    }
+    fputc(' ', st);
+    sim_eval = h->op;
+    if (
+        (fprint_sym(st, h->ic & AMASK, &sim_eval, &cpu_unit,
+          SWMASK('M'))) > 0) fputs("(undefined)", st);
 }
 
 t_stat
@@ -747,6 +747,7 @@ chan_proc()
                     M[addr++] = (assembly[chan] >> 18) & 077;
                     M[addr++] = (assembly[chan] >> 24) & 077;
                 }
+                assembly[chan] = 0;
                 if (addr > EMEMSIZE) {
                    cmd[chan] |= CHAN_SKIP;
                    chan_flags[chan] |= CHS_ATTN;
@@ -1229,6 +1230,244 @@ chan_read_char(int chan, uint8 * data, int flags)
     return DATA_OK;
 }
 
+/* Channel states a block transfer may run in, anything else is left to
+   the char routines and chan_proc */
+#define BLK_MASK        (STA_ACTIVE|STA_WAIT|DEV_DISCO|DEV_REOR|DEV_WEOR|\
+                         CHS_ATTN|CTL_CNTL|CTL_SNS|CTL_END|SNS_UEND)
+
+/*
+ * Write a block of chars to memory.  The 754 and unit record channels
+ * store straight to memory.  The 7621 and 7908 channels take whole groups
+ * of five chars, each group is stored as chan_proc would empty the buffer.
+ * Stops before the end of memory, a partial group or a busy buffer.
+ */
+int
+chan_write_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+    int         cnt;
+    int         unit;
+    int         i;
+    uint32      addr;
+    uint8       ch;
+
+    switch(CHAN_G_TYPE(chan_unit[chan].flags)) {
+    case CHAN_754:
+    case CHAN_UREC:
+        if ((chan_flags[chan] & BLK_MASK) != STA_ACTIVE)
+            break;
+        /* Stop before the char that runs off the end of memory */
+        cnt = EMEMSIZE + 1;
+        if (cnt > MEMSIZE - 1)
+            cnt = MEMSIZE - 1;
+        cnt -= (int)caddr[chan];
+        if (cnt <= 0)
+            break;
+        if (cnt > len)
+            cnt = len;
+        for (n = 0; n < cnt; n++) {
+            ch = buf[n];
+            if (ch == 0)
+                ch = 020;
+            if ((cmd[chan] & CHAN_SKIP) == 0)
+                M[caddr[chan]] = ch;
+            caddr[chan]++;
+        }
+        break;
+
+    case CHAN_7621:
+        if ((chan_flags[chan] & (BLK_MASK|DEV_SEL|DEV_WRITE)) !=
+                 (STA_ACTIVE|DEV_SEL) ||
+            (cmd[chan] & (CHAN_AFULL|CHAN_BFULL)) != 0 ||
+            !MEM_ADDR_OK(caddr[chan]))
+            break;
+        while ((len - n) >= 5) {
+            unit = 512 + chan_unit[chan].u3 * 32;
+            unit += (cmd[chan] & CHAN_BFLAG)? 16: 24;
+            /* Only start on an empty buffer */
+            if (AC[unit + 5] != 10 && AC[unit + 5] != 0)
+                break;
+            for (i = 0; i < 5; i++) {
+                ch = buf[n++];
+                if (ch == 0)
+                    ch = 020;
+                AC[unit + i] = ch & 077;
+            }
+            cmd[chan] ^= CHAN_BFLAG;
+            addr = chan_next_addr(chan);
+            if ((cmd[chan] & CHAN_SKIP) == 0) {
+                for (i = 0; i < 5; i++)
+                    M[addr++] = AC[unit + i];
+                if (addr > EMEMSIZE) {
+                    cmd[chan] |= CHAN_SKIP;
+                    chan_flags[chan] |= CHS_ERR;
+                    if (chan_dev.dctrl & (0x0100 << chan))
+                       sim_debug(DEBUG_EXP, &chan_dev, "read wrap %d\n", chan);
+                }
+                if (chan_dev.dctrl & (0x0100 << chan))
+                     sim_debug(DEBUG_DATA, &chan_dev,
+                            "chan %d (%d) < %c %02o%02o%02o%02o%02o\n",
+                             chan, addr-5, (cmd[chan] & CHAN_BFLAG)? 'a': 'b',
+                            AC[unit], AC[unit+1], AC[unit+2], AC[unit+3],
+                            AC[unit+4]);
+            }
+            AC[unit + 5] = 10;
+        }
+        break;
+
+    case CHAN_7908:
+        if ((chan_flags[chan] & (BLK_MASK|DEV_SEL|DEV_WRITE|DEV_FULL)) !=
+                 (STA_ACTIVE|DEV_SEL) || bcnt[chan] != 0 ||
+            !MEM_ADDR_OK(caddr[chan]))
+            break;
+        while ((len - n) >= 5 && (cmd[chan] & CHAN_SKIP) == 0) {
+            for (i = 0; i < 5; i++) {
+                ch = buf[n++];
+                if (ch == 0)
+                    ch = 020;
+                assembly[chan] |= ch << (6 * i);
+            }
+            addr = chan_next_addr(chan);
+            for (i = 0; i < 5; i++)
+                M[addr++] = (assembly[chan] >> (6 * i)) & 077;
+            assembly[chan] = 0;
+            if (addr > EMEMSIZE) {
+                cmd[chan] |= CHAN_SKIP;
+                chan_flags[chan] |= CHS_ATTN;
+            }
+        }
+        break;
+    }
+    return n;
+}
+
+/*
+ * Read a block of chars from memory.  The 754 and unit record channels
+ * fetch straight from memory.  The 7621 and 7908 channels hand out whole
+ * groups of five chars and refill the buffer as chan_proc would.  Stops
+ * before a group mark, a record count boundary or a buffer chan_proc has
+ * not filled.
+ */
+int
+chan_read_block(int chan, uint8 * buf, int len)
+{
+    int         n = 0;
+    int         unit;
+    int         i;
+    uint32      addr;
+    uint8       ch;
+
+    switch(CHAN_G_TYPE(chan_unit[chan].flags)) {
+    case CHAN_754:
+    case CHAN_UREC:
+        if ((chan_flags[chan] & BLK_MASK) != STA_ACTIVE)
+            break;
+        while (n < len && MEM_ADDR_OK(caddr[chan])) {
+            ch = M[caddr[chan]];
+            if (cmd[chan] & CHAN_NOREC) {
+                if (((caddr[chan] + 1) % 19999) == 0)
+                    break;
+            } else if (ch == CHR_GM)
+                break;
+            if (ch == CHR_BLANK)
+                ch = CHR_ABLANK;
+            if (cmd[chan] & CHAN_ZERO && ch != CHR_GM)
+                M[caddr[chan]] = CHR_BLANK;
+            if (chan_dev.dctrl & (0x0100 << chan))
+                   sim_debug(DEBUG_DATA, &chan_dev,
+                                 "%d > %02o (%d)\n", chan, ch, ch);
+            buf[n++] = ch;
+            caddr[chan]++;
+        }
+        break;
+
+    case CHAN_7621:
+        if ((chan_flags[chan] & (BLK_MASK|DEV_SEL|DEV_WRITE)) !=
+                 (STA_ACTIVE|DEV_SEL|DEV_WRITE))
+            break;
+        while ((len - n) >= 5 && (cmd[chan] & CHAN_END) == 0 &&
+               (cmd[chan] & (CHAN_AFULL|CHAN_BFULL)) ==
+                     (CHAN_AFULL|CHAN_BFULL)) {
+            unit = 512 + chan_unit[chan].u3 * 32;
+            unit += (cmd[chan] & CHAN_BFLAG)? 16: 24;
+            /* Only start on a fresh buffer */
+            if (AC[unit + 5] != 10)
+                break;
+            if ((cmd[chan] & CHAN_NOREC) == 0) {
+                for (i = 0; i < 5; i++) {
+                    if ((AC[unit + i] & 077) == CHR_GM)
+                        break;
+                }
+                if (i != 5)
+                    break;
+            }
+            for (i = 0; i < 5; i++) {
+                ch = AC[unit + i] & 077;
+                if (ch == CHR_BLANK)
+                    ch = CHR_ABLANK;
+                buf[n++] = ch;
+            }
+            cmd[chan] ^= CHAN_BFLAG;
+            addr = chan_next_addr(chan);
+            for (i = 0; i < 5; i++)
+                AC[unit + i] = M[addr++];
+            if (chan_dev.dctrl & (0x0100 << chan))
+                 sim_debug(DEBUG_DATA, &chan_dev,
+                        "chan %d (%d) > %c %02o%02o%02o%02o%02o\n",
+                        chan, addr-5, (cmd[chan] & CHAN_BFLAG)? 'a': 'b',
+                        AC[unit], AC[unit+1], AC[unit+2], AC[unit+3],
+                        AC[unit+4]);
+            if (cmd[chan] & CHAN_NOREC && (addr % 20000) == 0)
+               cmd[chan] |= CHAN_END;
+            /* Wrap around if over end of memory, set error */
+            if (addr > EMEMSIZE) {
+               chan_flags[chan] |= CHS_ERR;
+               if (chan_dev.dctrl & (0x0100 << chan))
+                   sim_debug(DEBUG_EXP, &chan_dev, "write wrap %d\n", chan);
+            }
+        }
+        break;
+
+    case CHAN_7908:
+        if ((chan_flags[chan] & (BLK_MASK|DEV_SEL|DEV_WRITE|DEV_FULL)) !=
+                 (STA_ACTIVE|DEV_SEL|DEV_WRITE|DEV_FULL) || bcnt[chan] != 0)
+            break;
+        while ((len - n) >= 5) {
+            if ((cmd[chan] & CHAN_NOREC) == 0) {
+                for (i = 0; i < 5; i++) {
+                    if ((uint8)(assembly[chan] >> (6 * i)) == CHR_GM)
+                        break;
+                }
+                if (i != 5)
+                    break;
+            }
+            for (i = 0; i < 5; i++) {
+                ch = (uint8)(assembly[chan] >> (6 * i));
+                if (ch == CHR_BLANK)
+                    ch = CHR_ABLANK;
+                buf[n++] = ch;
+            }
+            if (cmd[chan] & CHAN_END) {
+                /* chan_proc will not refill, leave it empty */
+                bcnt[chan] = 5;
+                chan_flags[chan] &= ~DEV_FULL;
+                break;
+            }
+            addr = chan_next_addr(chan);
+            assembly[chan] = M[addr++] & 077;
+            assembly[chan] |= (M[addr++] & 077) << 6;
+            assembly[chan] |= (M[addr++] & 077) << 12;
+            assembly[chan] |= (M[addr++] & 077) << 18;
+            assembly[chan] |= (M[addr++] & 077) << 24;
+            if (cmd[chan] & CHAN_NOREC && (addr % 20000) == 19999)
+               cmd[chan] |= CHAN_END;
+        }
+        break;
+    }
+    if (n != 0)
+        chan_flags[chan] |= DEV_WRITE;
+    return n;
+}
 
 void
 chan9_set_error(int chan, uint32 mask)
@@ -90,7 +90,6 @@
 #define HIST_MIN        64
 #define HIST_MAX        65536
 #define HIST_NOEA       0x40000000
-#define HIST_PC         0x80000
 
 struct InstHistory
 {
@@ -114,6 +113,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 t_stat              cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                         const char *cptr);
 const char          *cpu_description (DEVICE *dptr);
@@ -230,9 +230,6 @@ uint8               cpu_type;                   /* Current CPU type */
 int                 cycle_time = 45;            /* Cycle time is 4.5us */
 
 /* History information */
-int32               hst_p = 0;                  /* History pointer */
-int32               hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;                 /* History stack */
 extern uint32       drum_addr;
 extern UNIT         chan_unit[];
 
@@ -306,7 +303,7 @@ MTAB                cpu_mod[] = {
     {IOIRQ, IOIRQ, "IOIRQ", "IOIRQ", NULL, NULL, NULL},
     {EMU40K, 0, "NOEMU40K", "NOEMU40K", NULL, NULL, NULL},
     {EMU40K, EMU40K, "EMU40K", "EMU40K", NULL, NULL, NULL},
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -602,21 +599,20 @@ stop_cpu:
                          break;
                  }
 
-                 if (hst_lnt) {      /* history enabled? */
-                      hst_p = (hst_p + 1);   /* next entry */
-                      if (hst_p >= hst_lnt)
-                          hst_p = 0;
-                      hst[hst_p].ic = (IC - 5) | HIST_PC;
-                      hst[hst_p].op = opcode;
-                      hst[hst_p].ea = MAC;
-                      hst[hst_p].reg = reg;
-                      hst[hst_p].inst = Read5(IC-5, 0);
+                 if (sim_hist_lnt) {      /* history enabled? */
+                      struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                      h->ic = IC - 5;
+                      h->op = opcode;
+                      h->ea = MAC;
+                      h->reg = reg;
+                      h->inst = Read5(IC-5, 0);
 #if 0
                       addr = get_acstart(reg);
                       for (t = 0; t < 32; t++) {
-                             hst[hst_p].store[t] = AC[addr];
+                             h->store[t] = AC[addr];
                              addr = next_addr[addr];
-                             if (hst[hst_p].store[t] == 0)
+                             if (h->store[t] == 0)
                                 break;
                       }
 #endif
@@ -2277,13 +2273,15 @@ stop_cpu:
                      flags |= ANYFLAG|INSTFLAG;
                      break;
              }
-             if (hst_lnt) {  /* history enabled? */
-                  hst[hst_p].flags = flags;
+             if (sim_hist_lnt) {  /* history enabled? */
+                  struct InstHistory *h = (struct InstHistory *)sim_hist_last();
+
+                  h->flags = flags;
                   addr = spc;
                   for (t = 0; t < 254; t++) {
-                     hst[hst_p].store[t] = AC[addr];
+                     h->store[t] = AC[addr];
                      addr = next_addr[addr];
-                     if (hst[hst_p].store[t] == 0)
+                     if (h->store[t] == 0)
                         break;
                   }
              }
@@ -3453,34 +3451,8 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].ic = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -3488,66 +3460,53 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    char               *cptr = (char *) desc;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                         (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
     int                 len;
-    t_stat              r;
     t_value             sim_eval[50];
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st, "IC      OP   MA      REG\n\n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
+
+    if (h == NULL) {
+        fprintf(st, "IC      OP   MA      REG\n\n");
+        return;
+    }
+    fprintf(st, "%06d %c %06d %02d ", h->ic & 0x3ffff,
+                mem_to_ascii[h->op], h->ea, h->reg);
+    sim_eval[0] = (h->inst >> (4 * 6)) & 077;
+    sim_eval[1] = (h->inst >> (3 * 6)) & 077;
+    sim_eval[2] = (h->inst >> (2 * 6)) & 077;
+    sim_eval[3] = (h->inst >> (1 * 6)) & 077;
+    sim_eval[4] = h->inst & 077;
+    (void)fprint_sym (st, h->ic, sim_eval, &cpu_unit, SWMASK('M'));
+    for(len = 0; len < 256 && (h->store[len] & 077) != 0; len++);
+    fprintf(st, "\t%-2d %c%c %c%c %c@", len,
+            (h->flags & AZERO)?'Z':' ', (h->flags & ASIGN)?'-':'+',
+            (h->flags & BZERO)?'Z':' ', (h->flags & BSIGN)?'-':'+',
+            (h->flags & LOWFLAG)? 'l' :
+                ((h->flags & HIGHFLAG) ? 'h' : 'e'));
+
+    for(len--; len >= 0; len--) {
+        fputc(mem_to_ascii[h->store[len] & 077], st);
+        if (h->store[len] & 0100) {
+            fputc('|', st);
         }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->ic & HIST_PC) {  /* instruction? */
-            fprintf(st, "%06d %c %06d %02d ", h->ic & 0x3ffff,
-                        mem_to_ascii[h->op], h->ea, h->reg);
-            sim_eval[0] = (h->inst >> (4 * 6)) & 077;
-            sim_eval[1] = (h->inst >> (3 * 6)) & 077;
-            sim_eval[2] = (h->inst >> (2 * 6)) & 077;
-            sim_eval[3] = (h->inst >> (1 * 6)) & 077;
-            sim_eval[4] = h->inst & 077;
-            (void)fprint_sym (st, h->ic, sim_eval, &cpu_unit, SWMASK('M'));
-            for(len = 0; len < 256 && (h->store[len] & 077) != 0; len++);
-            fprintf(st, "\t%-2d %c%c %c%c %c@", len,
-                    (h->flags & AZERO)?'Z':' ', (h->flags & ASIGN)?'-':'+',
-                    (h->flags & BZERO)?'Z':' ', (h->flags & BSIGN)?'-':'+',
-                    (h->flags & LOWFLAG)? 'l' :
-                        ((h->flags & HIGHFLAG) ? 'h' : 'e'));
-
-            for(len--; len >= 0; len--) {
-                fputc(mem_to_ascii[h->store[len] & 077], st);
-                if (h->store[len] & 0100) {
-                    fputc('|', st);
-                }
-            }
-            fputc('@', st);
-            if (h->flags & 0x7f0) {
-                int     i;
-                fputc(' ', st);
-                for (i = 0; i < 7; i++) {
-                    if (h->flags & (0x10 << i))
-                        fputc('0' + i, st);
-                }
-            }
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+    }
+    fputc('@', st);
+    if (h->flags & 0x7f0) {
+        int     i;
+        fputc(' ', st);
+        for (i = 0; i < 7; i++) {
+            if (h->flags & (0x10 << i))
+                fputc('0' + i, st);
+        }
+    }
 }
 
 const char *
@@ -1654,6 +1654,181 @@ chan_read_char(int chan, uint8 * data, int flags)
     return DATA_OK;
 }
 
+/*
+ * Check if channel is doing a plain data transfer that chan_proc would
+ * just step through a word at a time.
+ */
+static int
+chan_blk_ok(int chan)
+{
+    switch (CHAN_G_TYPE(chan_unit[chan].flags)) {
+#ifdef I7090
+    case CHAN_7909:
+        /* Only a copy moving data to or from the device */
+        switch (cmd[chan]) {
+        case CPYP:
+        case CPYP2:
+        case CPYP3:
+        case CPYP4:
+        case CPYD:
+        case CPYDX:
+            break;
+        default:
+            return 0;
+        }
+        switch (chan_flags[chan] & (CTL_READ | CTL_WRITE | CTL_SNS |
+                 CTL_CNTL | CTL_END | SNS_UEND)) {
+        case CTL_READ:
+        case CTL_WRITE:
+            break;
+        default:
+            return 0;
+        }
+        break;
+    case CHAN_7289:
+        if ((chan_info[chan] & (CHAINF_RUN | CHAINF_START)) !=
+                (CHAINF_RUN | CHAINF_START))
+            return 0;
+        /* Fall through */
+#endif
+    case CHAN_7607:
+        if ((cmd[chan] & 070) == TCH)
+            return 0;
+        break;
+    default:
+        return 0;
+    }
+    if (chan_unit[chan].flags & UNIT_DIS)
+        return 0;
+    if ((chan_flags[chan] & (DEV_SEL | STA_ACTIVE | STA_WAIT | STA_TWAIT |
+            CHS_ATTN | DEV_DISCO | DEV_REOR | DEV_WEOR)) !=
+            (DEV_SEL | STA_ACTIVE))
+        return 0;
+    return 1;
+}
+
+/* Step the channel address as chan_proc would */
+static void
+chan_blk_next(int chan)
+{
+#ifdef I7090
+    if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_7909 &&
+            sms[chan] & 040) {  /* Read backward */
+        caddr[chan] = ((dualcore) ? (0100000 & caddr[chan]) : 0) |
+                      ((caddr[chan] - 1) & MEMMASK);
+        return;
+    }
+#endif
+    nxt_chan_addr(chan);
+}
+
+/*
+ * Write a block of chars to memory.  Full words are stored here as
+ * chan_proc would, the last word of the count is left for chan_proc.
+ */
+int
+chan_write_block(int chan, uint8 * buf, int len)
+{
+    int                 n = 0;
+    int                 cmask = 0x0100 << chan;
+
+    if (!chan_blk_ok(chan))
+        return 0;
+    while (n < len) {
+        if (chan_flags[chan] & DEV_FULL) {
+            if ((chan_flags[chan] & DEV_WRITE) || wcount[chan] <= 1 ||
+                 !chan_blk_ok(chan))
+                break;
+#ifdef I7090
+            if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_7909 &&
+                    sms[chan] & 020)    /* BCD Xlat mode */
+                bcd_xlat(chan, 1);
+#endif
+            if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_7909 ||
+                    (cmd[chan] & 1) == 0) {
+                if (chan_dev.dctrl & cmask)
+                     sim_debug(DEBUG_DATA, &chan_dev, "chan %d data < %012llo\n",
+                           chan, assembly[chan]);
+                M[caddr[chan]] = assembly[chan];
+            } else {
+                if (chan_dev.dctrl & cmask)
+                     sim_debug(DEBUG_DATA, &chan_dev, "chan %d data * %012llo\n",
+                           chan, assembly[chan]);
+            }
+            chan_blk_next(chan);
+            assembly[chan] = 0;
+            bcnt[chan] = 6;
+            wcount[chan]--;
+            chan_flags[chan] &= ~DEV_FULL;
+        }
+        /* Shift the char in as chan_write_char does */
+        assembly[chan] = ((assembly[chan] & 0007777777777LL) << 6) |
+                            (buf[n++] & 077);
+        if (--bcnt[chan] == 0) {
+            chan_flags[chan] |= DEV_FULL;
+            chan_flags[chan] &= ~DEV_WRITE;
+        }
+    }
+    return n;
+}
+
+/*
+ * Read a block of chars from memory.  Words are fetched here as
+ * chan_proc would while there is word count left.
+ */
+int
+chan_read_block(int chan, uint8 * buf, int len)
+{
+    int                 n = 0;
+    int                 cmask = 0x0100 << chan;
+    t_uint64            wd;
+
+    if (!chan_blk_ok(chan))
+        return 0;
+    while (n < len) {
+        if ((chan_flags[chan] & DEV_FULL) == 0) {
+            if ((chan_flags[chan] & DEV_WRITE) == 0 || wcount[chan] == 0 ||
+                 !chan_blk_ok(chan))
+                break;
+            if (CHAN_G_TYPE(chan_unit[chan].flags) != CHAN_7909 &&
+                    (cmd[chan] & 1)) {
+                assembly[chan] = 0;
+                if (chan_dev.dctrl & cmask)
+                    sim_debug(DEBUG_DATA, &chan_dev,
+                              "chan %d data > *\n", chan);
+            } else {
+                assembly[chan] = M[caddr[chan]];
+                if (chan_dev.dctrl & cmask)
+                    sim_debug(DEBUG_DATA, &chan_dev,
+                              "chan %d data > %012llo\n", chan,
+                              assembly[chan]);
+#ifdef I7090
+                if (CHAN_G_TYPE(chan_unit[chan].flags) == CHAN_7909 &&
+                        sms[chan] & 020)        /* BCD Xlat mode */
+                    bcd_xlat(chan, 0);
+#endif
+            }
+            chan_blk_next(chan);
+            bcnt[chan] = 6;
+            wcount[chan]--;
+            chan_flags[chan] |= DEV_FULL;
+        }
+        /* Rotate the next char out as chan_read_char does */
+        wd = assembly[chan];
+        buf[n++] = (uint8)(077 & (wd >> 30));
+        wd <<= 6;
+        wd |= 077 & (wd >> 36);
+        assembly[chan] = wd & 0777777777777LL;
+        if (--bcnt[chan] == 0) {
+            chan_flags[chan] &= ~DEV_FULL;
+            bcnt[chan] = 6;
+        }
+    }
+    if (n != 0)
+        chan_flags[chan] |= DEV_WRITE;
+    return n;
+}
+
 void
 chan9_seqcheck(int chan)
 {
@@ -188,7 +188,7 @@
 #define HIST_MIN        64
 #define HIST_MAX        1000000
 #define HIST_NOEA       0x40000000
-#define HIST_PC         0x10000
+#define HIST_LAST       ((struct InstHistory *)sim_hist_last())
 
 struct InstHistory
 {
@@ -214,6 +214,7 @@ t_stat              cpu_show_hist(FILE * st, UNIT * uptr, int32 val,
                                   CONST void *desc);
 t_stat              cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr,
                                  void *desc);
+void                cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 uint32              cpu_cmd(UNIT * uptr, uint16 cmd, uint16 dev);
 t_stat              cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag,
                         const char *cptr);
@@ -276,9 +277,6 @@ uint8               exe_KEYS = 0;               /* Execute one instruction
                                                    from KEYS, used by CPANEL */
 
 /* History information */
-int32               hst_p = 0;                  /* History pointer */
-int32               hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;                 /* History stack */
 extern uint32       drum_addr;
 
 #define DP_FLOAT        1
@@ -383,7 +381,7 @@ MTAB                cpu_mod[] = {
     {UNIT_DUALCORE, 0, NULL, "STANDARD", NULL, NULL, NULL},
     {UNIT_DUALCORE, UNIT_DUALCORE, "CTSS", "CTSS", NULL, NULL, NULL, "CTSS support"},
 #endif
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
      &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -860,19 +858,18 @@ sim_instr(void)
                         sim_debug(DEBUG_TRAP, &cpu_dev,
                           "Doing trap chan %c %o >%012llo loc %o %012llo IC=%06o %06o\n",
                                   shiftcnt + 'A' - 1, f, temp, MA, SR, IC, iotraps);
-                        if (hst_lnt) {  /* history enabled? */
-                            hst_p = (hst_p + 1);        /* next entry */
-                            if (hst_p >= hst_lnt)
-                                hst_p = 0;
-                            hst[hst_p].ic = MA | HIST_PC | (bcore << 18);
-                            hst[hst_p].ea = 0;
-                            hst[hst_p].op = SR;
-                            hst[hst_p].ac = AC;
-                            hst[hst_p].mq = MQ;
-                            hst[hst_p].xr1 = XR[1];
-                            hst[hst_p].xr2 = XR[2];
-                            hst[hst_p].xr4 = XR[4];
-                            hst[hst_p].sr = 0;
+                        if (sim_hist_lnt) { /* history enabled? */
+                            struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                            h->ic = MA | (bcore << 18);
+                            h->ea = 0;
+                            h->op = SR;
+                            h->ac = AC;
+                            h->mq = MQ;
+                            h->xr1 = XR[1];
+                            h->xr2 = XR[2];
+                            h->xr4 = XR[4];
+                            h->sr = 0;
                         }
                         goto next_xec;
                     }
@@ -908,19 +905,18 @@ sim_instr(void)
                 sim_debug(DEBUG_DETAIL, &cpu_dev,
                           "Doing timer trap >%012llo loc %o %012llo\n", temp,
                           MA, SR);
-                if (hst_lnt) {  /* history enabled? */
-                    hst_p = (hst_p + 1);        /* next entry */
-                    if (hst_p >= hst_lnt)
-                        hst_p = 0;
-                    hst[hst_p].ic = MA | HIST_PC | (bcore << 18);
-                    hst[hst_p].ea = 0;
-                    hst[hst_p].op = SR;
-                    hst[hst_p].ac = AC;
-                    hst[hst_p].mq = MQ;
-                    hst[hst_p].xr1 = XR[1];
-                    hst[hst_p].xr2 = XR[2];
-                    hst[hst_p].xr4 = XR[4];
-                    hst[hst_p].sr = 0;
+                if (sim_hist_lnt) { /* history enabled? */
+                    struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                    h->ic = MA | (bcore << 18);
+                    h->ea = 0;
+                    h->op = SR;
+                    h->ac = AC;
+                    h->mq = MQ;
+                    h->xr1 = XR[1];
+                    h->xr2 = XR[2];
+                    h->xr4 = XR[4];
+                    h->sr = 0;
                 }
                 goto next_xec;
             }
@@ -976,19 +972,18 @@ sim_instr(void)
             MA = IC;
             ReadMem(1, SR);
             temp = SR;
-            if (hst_lnt) {      /* history enabled? */
-                hst_p = (hst_p + 1);    /* next entry */
-                if (hst_p >= hst_lnt)
-                    hst_p = 0;
-                hst[hst_p].ic = MA | HIST_PC | (bcore << 18);
-                hst[hst_p].ea = 0;
-                hst[hst_p].op = SR;
-                hst[hst_p].ac = AC;
-                hst[hst_p].mq = MQ;
-                hst[hst_p].xr1 = XR[1];
-                hst[hst_p].xr2 = XR[2];
-                hst[hst_p].xr4 = XR[4];
-                hst[hst_p].sr = 0;
+            if (sim_hist_lnt) { /* history enabled? */
+                struct InstHistory *h = (struct InstHistory *)sim_hist_add();
+
+                h->ic = MA | (bcore << 18);
+                h->ea = 0;
+                h->op = SR;
+                h->ac = AC;
+                h->mq = MQ;
+                h->xr1 = XR[1];
+                h->xr2 = XR[2];
+                h->xr4 = XR[4];
+                h->sr = 0;
             }
             IC = memmask & (IC + 1);
         }
@@ -1004,8 +999,8 @@ sim_instr(void)
       next_xec:
         opcode = (uint16)(SR >> 24);
         IR = opcode;
-        if (hst_lnt) {  /* history enabled? */
-            hst[hst_p].op = SR;
+        if (sim_hist_lnt) { /* history enabled? */
+            HIST_LAST->op = SR;
         }
         MA = (uint16)(SR & AMASK);
         tag = (uint8)(SR >> 15) & 07;
@@ -1022,9 +1017,9 @@ sim_instr(void)
             decr &= memmask;
             xr += decr;
             xr &= memmask;
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = decr;
-                hst[hst_p].sr = xr;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = decr;
+                HIST_LAST->sr = xr;
             }
 
             /* Save register */
@@ -1034,9 +1029,9 @@ sim_instr(void)
 
         case (OP_TXH << 9):     /* Transfer on High Index XR[T] > D, IC <- Y */
             do_trapmode;
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = decr;
-                hst[hst_p].sr = xr;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = decr;
+                HIST_LAST->sr = xr;
             }
             xr &= memmask;
             decr &= memmask;
@@ -1045,9 +1040,9 @@ sim_instr(void)
             break;
         case (OP_TNX << 9):     /* Transfer No index XR[T]  */
             do_trapmode;
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = decr;
-                hst[hst_p].sr = xr;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = decr;
+                HIST_LAST->sr = xr;
             }
             xr &= memmask;
             decr &= memmask;
@@ -1060,9 +1055,9 @@ sim_instr(void)
             break;
         case (OP_TXL << 9):     /* Transfer on Low Index XR[T] <= D, IC <- Y */
             do_trapmode;
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = decr;
-                hst[hst_p].sr = xr;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = decr;
+                HIST_LAST->sr = xr;
             }
             xr &= memmask;
             decr &= memmask;
@@ -1071,9 +1066,9 @@ sim_instr(void)
             break;
         case (OP_TIX << 9):     /* Transfer and Index XR */
             do_trapmode;
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = decr;
-                hst[hst_p].sr = xr;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = decr;
+                HIST_LAST->sr = xr;
             }
             xr &= memmask;
             decr &= memmask;
@@ -1086,8 +1081,8 @@ sim_instr(void)
         case (OP_STR << 9):
             M[tbase] &= ~AMASK;
             M[tbase] |= IC & memmask;
-            if (hst_lnt)        /* history enabled? */
-                hst[hst_p].ea = tbase;
+            if (sim_hist_lnt)   /* history enabled? */
+                HIST_LAST->ea = tbase;
             IC = 2;
             break;
         case (4 << 9):          /* Neg opcodes */
@@ -1163,9 +1158,9 @@ prottrap:
             if (opinfo & (T_B | T_F | S_F)) {
                 ReadMem(opcode == OP_XEC, SR);
             }
-            if (hst_lnt) {      /* history enabled? */
-                hst[hst_p].ea = MA;
-                hst[hst_p].sr = SR;
+            if (sim_hist_lnt) { /* history enabled? */
+                HIST_LAST->ea = MA;
+                HIST_LAST->sr = SR;
             }
             switch (opcode) {
             case 0760:          /* PSE */
@@ -4277,34 +4272,8 @@ cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].ic = 0;
-        hst_p = 0;
-        return SCPE_OK;
-    }
-    lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free(hst);
-        hst_lnt = 0;
-        hst = NULL;
-    }
-    if (lnt) {
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-    }
-    return SCPE_OK;
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist,
+                        HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
@@ -4312,90 +4281,77 @@ cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc)
 t_stat
 cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    char               *cptr = (char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory),
+                         &cpu_fprint_hist, (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void
+cpu_fprint_hist(FILE * st, const void *rec, t_bool timed)
+{
+    const struct InstHistory *h = (const struct InstHistory *) rec;
     t_value             sim_eval;
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)
-        return SCPE_NOFNC;      /* enabled? */
-    if (cptr) {
-        lnt = (int32) get_uint(cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return SCPE_ARG;
-    } else
-        lnt = hst_lnt;
-    di = hst_p - lnt;           /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf(st,
+
+    if (h == NULL) {
+        fprintf(st,
 "IC      AC            MQ            EA      SR             XR1    XR2   XR4\n\n");
-    for (k = 0; k < lnt; k++) { /* print specified */
-        if (stop_cpu) {                 /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                      /* abandon remaining output */
-        }
-        h = &hst[(++di) % hst_lnt];     /* entry pointer */
-        if (h->ic & HIST_PC) {  /* instruction? */
-            fprintf(st, "%06o%c", h->ic & 077777, ((h->ic>>19)&1)?'b':' ');
-            switch ((h->ac & (AMSIGN | AQSIGN | APSIGN)) >> 35L) {
-            case (AMSIGN | AQSIGN | APSIGN) >> 35L:
-                fprintf(st, "-QP");
-                break;
-            case (AMSIGN | AQSIGN) >> 35L:
-                fprintf(st, " -Q");
-                break;
-            case (AMSIGN | APSIGN) >> 35L:
-                fprintf(st, " -P");
-                break;
-            case (AMSIGN) >> 35L:
-                fprintf(st, "  -");
-                break;
-            case (AQSIGN | APSIGN) >> 35L:
-                fprintf(st, " QP");
-                break;
-            case (AQSIGN) >> 35L:
-                fprintf(st, "  Q");
-                break;
-            case (APSIGN) >> 35L:
-                fprintf(st, "  P");
-                break;
-            case 0:
-                fprintf(st, "   ");
-                break;
-            }
-            fprint_val(st, h->ac & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            if (h->mq & MSIGN)
-                fputc('-', st);
-            else
-                fputc(' ', st);
-            fprint_val(st, h->mq & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->ea, 8, 16, PV_RZRO);
-            fputc(((h->ic>>18)&1)?'b':' ', st);
-            if (h->sr & MSIGN)
-                fputc('-', st);
-            else
-                fputc(' ', st);
-            fprint_val(st, h->sr & PMASK, 8, 35, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->xr1, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->xr2, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            fprint_val(st, h->xr4, 8, 15, PV_RZRO);
-            fputc(' ', st);
-            sim_eval = h->op;
-            if (
-                (fprint_sym
-                 (st, h->ic & AMASK, &sim_eval, &cpu_unit,
-                  SWMASK('M'))) > 0) fprintf(st, "(undefined) %012llo", h->op);
-            fputc('\n', st);    /* end line */
-        }                       /* end else instruction */
-    }                           /* end for */
-    return SCPE_OK;
+        return;
+    }
+    fprintf(st, "%06o%c", h->ic & 077777, ((h->ic>>19)&1)?'b':' ');
+    switch ((h->ac & (AMSIGN | AQSIGN | APSIGN)) >> 35L) {
+    case (AMSIGN | AQSIGN | APSIGN) >> 35L:
+        fprintf(st, "-QP");
+        break;
+    case (AMSIGN | AQSIGN) >> 35L:
+        fprintf(st, " -Q");
+        break;
+    case (AMSIGN | APSIGN) >> 35L:
+        fprintf(st, " -P");
+        break;
+    case (AMSIGN) >> 35L:
+        fprintf(st, "  -");
+        break;
+    case (AQSIGN | APSIGN) >> 35L:
+        fprintf(st, " QP");
+        break;
+    case (AQSIGN) >> 35L:
+        fprintf(st, "  Q");
+        break;
+    case (APSIGN) >> 35L:
+        fprintf(st, "  P");
+        break;
+    case 0:
+        fprintf(st, "   ");
+        break;
+    }
+    fprint_val(st, h->ac & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    if (h->mq & MSIGN)
+        fputc('-', st);
+    else
+        fputc(' ', st);
+    fprint_val(st, h->mq & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->ea, 8, 16, PV_RZRO);
+    fputc(((h->ic>>18)&1)?'b':' ', st);
+    if (h->sr & MSIGN)
+        fputc('-', st);
+    else
+        fputc(' ', st);
+    fprint_val(st, h->sr & PMASK, 8, 35, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->xr1, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->xr2, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    fprint_val(st, h->xr4, 8, 15, PV_RZRO);
+    fputc(' ', st);
+    sim_eval = h->op;
+    if (
+        (fprint_sym
+         (st, h->ic & AMASK, &sim_eval, &cpu_unit,
+          SWMASK('M'))) > 0) fprintf(st, "(undefined) %012llo", h->op);
 }
 
 const char *
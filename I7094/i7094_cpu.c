@@ -203,10 +203,7 @@ uint32 cpu_astop = 0;                                   /* address stop */
 uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
 uint32 hst_ch = 0;                                      /* channel history */
-InstHistory *hst = NULL;                                /* instruction history */
 
 extern uint32 ch_sta[NUM_CHAN];
 extern uint32 ch_flags[NUM_CHAN];
@@ -222,6 +219,7 @@ t_stat cpu_set_model (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_model (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_bool ReadI (uint32 va, t_uint64 *dat);
 t_bool Read (uint32 va, t_uint64 *dat);
 t_bool Write (uint32 va, t_uint64 dat);
@@ -339,7 +337,7 @@ MTAB cpu_mod[] = {
       &cpu_set_model, NULL, NULL },
     { MTAB_XTD | MTAB_VDV, I_9X, NULL, "7090",
       &cpu_set_model, NULL, NULL }, 
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -636,7 +634,7 @@ ind_reloc = ind_reloc & VA_BLK;                         /* canonical form */
 ind_start = ind_start & VA_BLK;
 ind_limit = (ind_limit & VA_BLK) | VA_OFF;
 chtr_pend = chtr_eval (NULL);                           /* eval chan traps */
-tracing = ((hst_lnt != 0) || DEBUG_PRS (cpu_dev));
+tracing = ((sim_hist_lnt != 0) || DEBUG_PRS (cpu_dev));
 
 if (ht_pend) {                                          /* HTR pending? */
     oldPC = (PC - 1) & AMASK;
@@ -718,11 +716,13 @@ while (reason == SCPE_OK) {                             /* loop until error */
         dec = GET_DEC (IR);                             /* get decrement */
         xr = get_xrx (tag);                             /* get xr, upd MTM */
         if (tracing) {                                  /* trace or history? */
-            if (hst_lnt)                                /* history enabled? */
+            if (sim_hist_lnt)                           /* history enabled? */
                 cpu_ent_hist (oldPC|HIST_PC, xr, IR, 0);
-            if (DEBUG_PRS (cpu_dev))
+            if (DEBUG_PRS (cpu_dev)) {
                 cpu_fprint_one_inst (sim_deb, oldPC|HIST_PC, 0, xr,
                     IR, AC, MQ, SI, 0);
+                fputc ('\n', sim_deb);
+                }
             }
         switch (op) {
 
@@ -824,11 +824,13 @@ while (reason == SCPE_OK) {                             /* loop until error */
                 continue;
             }
         if (tracing) {                                  /* tracing or history? */
-            if (hst_lnt)                                /* history enabled? */
+            if (sim_hist_lnt)                           /* history enabled? */
                 cpu_ent_hist (oldPC|HIST_PC, ea, IR, SR);
-            if (DEBUG_PRS (cpu_dev))
+            if (DEBUG_PRS (cpu_dev)) {
                 cpu_fprint_one_inst (sim_deb, oldPC|HIST_PC, 0, ea,
                     IR, AC, MQ, SI, SR);
+                fputc ('\n', sim_deb);
+                }
             }
         switch (op) {                                   /* case on opcode */
 
@@ -2326,16 +2328,16 @@ static uint32 inst_io_tab[32] = {
 
 void cpu_ent_hist (uint32 pc, uint32 ea, t_uint64 ir, t_uint64 opnd)
 {
-int32 prv_p;
+InstHistory *h = (InstHistory *) sim_hist_last ();
 
 if (pc & HIST_PC) {
-    if ((pc == hst[hst_p].pc) && (ir == hst[hst_p].ir)) {   /* repeat last? */
-        hst[hst_p].rpt++;
+    if ((pc == h->pc) && (ir == h->ir)) {                   /* repeat last? */
+        h->rpt++;
         return;
         }
-    prv_p = hst_p? hst_p - 1: hst_lnt - 1;
-    if ((pc == hst[prv_p].pc) && (ir == hst[prv_p].ir)) {   /* 2 line loop? */
-        hst[prv_p].rpt++;
+    h = (InstHistory *) sim_hist_prev ();
+    if ((pc == h->pc) && (ir == h->ir)) {                   /* 2 line loop? */
+        h->rpt++;
         return;
         }
     if (hst_ch & HIST_CH_I) {                               /* IO only? */
@@ -2345,17 +2347,15 @@ if (pc & HIST_PC) {
             return;
         }
     }
-hst_p = (hst_p + 1);                                        /* next entry */
-if (hst_p >= hst_lnt)
-    hst_p = 0;
-hst[hst_p].pc = pc;
-hst[hst_p].ir = ir;
-hst[hst_p].ac = AC;
-hst[hst_p].mq = MQ;
-hst[hst_p].si = SI;
-hst[hst_p].ea = ea;
-hst[hst_p].opnd = opnd;
-hst[hst_p].rpt = 0;
+h = (InstHistory *) sim_hist_add ();                        /* next entry */
+h->pc = pc;
+h->ir = ir;
+h->ac = AC;
+h->mq = MQ;
+h->si = SI;
+h->ea = ea;
+h->opnd = opnd;
+h->rpt = 0;
 return;
 }
 
@@ -2363,37 +2363,18 @@ return;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
 t_stat r;
 
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = hst_ch = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    if (sim_switches & SWMASK ('I'))
-        hst_ch = HIST_CH_I|HIST_CH_C;
-    else if (sim_switches & SWMASK ('C'))
-        hst_ch = HIST_CH_C;
-    else hst_ch = 0;
-    }
+r = sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
+if ((r != SCPE_OK) || (cptr == NULL))
+    return r;
+if (sim_hist_lnt == 0)
+    hst_ch = 0;
+else if (sim_switches & SWMASK ('I'))
+    hst_ch = HIST_CH_I|HIST_CH_C;
+else if (sim_switches & SWMASK ('C'))
+    hst_ch = HIST_CH_C;
+else hst_ch = 0;
 return SCPE_OK;
 }
 
@@ -2431,7 +2412,6 @@ if (pc & HIST_PC) {                                     /* instruction? */
         fprint_val (st, opnd, 8, 36, PV_RZRO);
         fputc (']', st);
         }
-    fputc ('\n', st);                                   /* end line */
     }                                                   /* end if instruction */
 else if ((ch = HIST_CH (pc))) {                         /* channel? */
     fprintf (st, "CH%c ", 'A' + ch - 1);
@@ -2443,7 +2423,6 @@ else if ((ch = HIST_CH (pc))) {                         /* channel? */
         fputs ("(undefined) ", st);
         fprint_val (st, ir, 8, 36, PV_RZRO);
         }
-    fputc ('\n', st);                                   /* end line */
     }                                                   /* end else channel */
 return SCPE_OK;
 }
@@ -2452,30 +2431,18 @@ return SCPE_OK;
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return SCPE_ARG;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "    PC    repeat AC            MQ           SI           EA     IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "    PC    repeat AC            MQ           SI           EA     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    cpu_fprint_one_inst (st, h->pc, h->rpt, h->ea, h->ir, h->ac, h->mq, h->si, h->opnd);
-    }                                                   /* end for */
-return SCPE_OK;
+cpu_fprint_one_inst (st, h->pc, h->rpt, h->ea, h->ir, h->ac, h->mq, h->si, h->opnd);
 }
@@ -199,10 +199,6 @@ uint32 IR;
 uint16 devnum = 0;
 uint8 cpu_onetime = 0;
 
-int32 hst_p = 0;                        /* history pointer */
-int32 hst_lnt = 0;                      /* history length */
-InstHistory *hst = NULL;                /* instruction history */
-
 static const char* i8080_desc(DEVICE *dptr) {
     return i8080_NAME;
 }
@@ -228,6 +224,7 @@ void    parity(int32 reg);
 int32   cond(int32 con);
 t_stat  cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat  cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat  i8080_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat  i8080_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 t_stat  i8080_reset (DEVICE *dptr);
@@ -289,7 +286,7 @@ MTAB i8080_mod[] = {
     { UNIT_8085, UNIT_8085, "8085", "8085", NULL },
     { UNIT_XACK, 0, "NOXACK", "NOXACK", NULL },
     { UNIT_XACK, UNIT_XACK, "XACK", "XACK", NULL },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Enable/Display instruction history" },
     { 0 }
 };
@@ -502,8 +499,8 @@ int32 sim_instr(void)
             break;
         }
 
-        if (hst_lnt) {                  /* record history? */
-            hst_ent = &hst[hst_p];
+        if (sim_hist_lnt) {             /* record history? */
+            hst_ent = (InstHistory *) sim_hist_add ();
             hst_ent->pc = PC;
             hst_ent->sp = SP;
             hst_ent->psw = PSW;
@@ -516,9 +513,6 @@ int32 sim_instr(void)
             hst_ent->l = (HL & 0xFF);
             for (i = 0; i < HIST_ILNT; i++)
                 hst_ent->inst[i] = (t_value)get_mbyte (PC + i);
-            hst_p = (hst_p + 1);
-            if (hst_p >= hst_lnt)
-                hst_p = 0;
         }
 
         sim_interval--;                 /* countdown clock */
@@ -1545,71 +1539,31 @@ t_stat parse_sym(CONST char *cptr, t_addr addr, UNIT *uptr, t_value *val, int32
 
 t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int i, lnt;
-    t_stat r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].pc = 0;
-        hst_p = 0;
-        return SCPE_OK;
-        }
-    lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free (hst);
-        hst_lnt = 0;
-        hst = NULL;
-        }
-    if (lnt) {
-        hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-        }
-    return SCPE_OK;
+    return sim_hist_set (&i8080_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-    int k, di, lnt, ir;
-    const char *cptr = (const char *) desc;
-    t_stat r;
-    InstHistory *h;
-
-    if (hst_lnt == 0)                       /* enabled? */
-        return SCPE_NOFNC;
-    if (cptr) {
-        lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
-        }
-    else lnt = hst_lnt;
-    di = hst_p - lnt;                       /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf (st, "PC   SP   CC A  B  C  D  E  F  H  L  Instruction\n\n");
-    for (k = 0; k < lnt; k++) {             /* print specified */
-        if (stop_cpu) {                     /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                          /* abandon remaining output */
-            }
-        h = &hst[(di++) % hst_lnt];         /* entry pointer */
-        ir = h->inst[0];
-        fprintf (st, "%04X %04X %02X ", h->pc , h->sp, h->psw);
-        fprintf (st, "%02X %02X %02X %02X %02X %02X %02X ", 
-            h->a, h->b, h->c, h->d, h->e, h->h, h->l);
-        if ((fprint_sym (st, h->pc, h->inst, &i8080_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %02X", h->inst[0]);
-        fputc ('\n', st);                               /* end line */
+    return sim_hist_show (st, &i8080_dev, sizeof (InstHistory), &cpu_fprint_hist, (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+static void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed)
+{
+    const InstHistory *h = (const InstHistory *) rec;
+
+    if (h == NULL) {
+        fprintf (st, "PC   SP   CC A  B  C  D  E  F  H  L  Instruction\n\n");
+        return;
         }
-    return SCPE_OK;
+    fprintf (st, "%04X %04X %02X ", h->pc , h->sp, h->psw);
+    fprintf (st, "%02X %02X %02X %02X %02X %02X %02X ", 
+        h->a, h->b, h->c, h->d, h->e, h->h, h->l);
+    if ((fprint_sym (st, h->pc, (t_value *) h->inst, &i8080_unit, SWMASK ('M'))) > 0)
+        fprintf (st, "(undefined) %02X", h->inst[0]);
 }
 
 /* Memory examine */
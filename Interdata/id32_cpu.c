@@ -177,7 +177,6 @@
 #define UNIT_8RS        (1 << UNIT_V_8RS)
 #define UNIT_TYPE       (UNIT_DPFP | UNIT_832)
 
-#define HIST_PC         0x40000000
 #define HIST_MIN        64
 #define HIST_MAX        65536
 
@@ -246,10 +245,7 @@ REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 uint32 dec_flgs = 0;                                    /* decode flags */
 uint32 fp_in_hwre = 0;                                  /* ucode vs hwre fp */
 uint32 pawidth = PAWIDTH32;                             /* addr mask */
-uint32 hst_p = 0;                                       /* history pointer */
-uint32 hst_lnt = 0;                                     /* history length */
 uint32 psw_reg_mask = 1;                                /* PSW reg mask */
-InstHistory *hst = NULL;                                /* instruction history */
 jmp_buf save_env;                                       /* abort handler */
 struct BlockIO blk_io;                                  /* block I/O status */
 uint32 (*dev_tab[DEVNO])(uint32 dev, uint32 op, uint32 datout) = { NULL };
@@ -273,6 +269,7 @@ t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_consint (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 void set_r_display (uint32 *rbase);
 
 extern t_bool devtab_init (void);
@@ -585,7 +582,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 1048756, NULL, "1M", &cpu_set_size },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, NULL, "CONSINT",
       &cpu_set_consint, NULL, NULL },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -809,17 +806,16 @@ while (reason == 0) {                                   /* loop until halted */
         return SCPE_IERR;
         }
 
-    if (hst_lnt) {                                      /* instruction history? */
-        hst[hst_p].pc = oPC | HIST_PC;                  /* save decode state */
-        hst[hst_p].ir1 = ir1;
-        hst[hst_p].ir2 = ir2;
-        hst[hst_p].ir3 = ir3;
-        hst[hst_p].r1 = R[r1];
-        hst[hst_p].ea = ea;
-        hst[hst_p].opnd = opnd;
-        hst_p = hst_p + 1;
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
+    if (sim_hist_lnt) {                                 /* instruction history? */
+        InstHistory *h = (InstHistory *) sim_hist_add ();
+
+        h->pc = oPC;                                    /* save decode state */
+        h->ir1 = ir1;
+        h->ir2 = ir2;
+        h->ir3 = ir3;
+        h->r1 = R[r1];
+        h->ea = ea;
+        h->opnd = opnd;
         }
     if (qevent & EV_MAC)                                /* MAC abort on fetch? */
         continue; 
@@ -2356,76 +2352,36 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-uint32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (uint32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 op, k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+int32 op;
 t_value sim_eval[3];
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC     r1       operand  ea     IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC     r1       operand  ea     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(di++) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        fprintf (st, "%06X %08X %08X ", h->pc & VAMASK32, h->r1, h->opnd);
-        op = (h->ir1 >> 8) & 0xFF;
-        if (OP_TYPE (op) >= OP_RX)
-            fprintf (st, "%06X ", h->ea);
-        else fprintf (st, "       ");
-        sim_eval[0] = h->ir1;
-        sim_eval[1] = h->ir2;
-        sim_eval[2] = h->ir3;
-        if ((fprint_sym (st, h->pc & VAMASK32, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %04X", h->ir1);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end if instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+fprintf (st, "%06X %08X %08X ", h->pc & VAMASK32, h->r1, h->opnd);
+op = (h->ir1 >> 8) & 0xFF;
+if (OP_TYPE (op) >= OP_RX)
+    fprintf (st, "%06X ", h->ea);
+else fprintf (st, "       ");
+sim_eval[0] = h->ir1;
+sim_eval[1] = h->ir2;
+sim_eval[2] = h->ir3;
+if ((fprint_sym (st, h->pc & VAMASK32, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %04X", h->ir1);
 }
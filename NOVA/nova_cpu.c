@@ -313,9 +313,6 @@ REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 struct ndev dev_table[64];                              /* dispatch table */
 int32 AMASK = 077777 ;                                  /* current memory address mask  */
                                                         /* (default to 32KW)  */
-static  int32    hist_p   = 0 ;                         /* history pointer */
-static  int32    hist_cnt = 0 ;                         /* history count   */
-static  Hist_entry * hist = NULL ;                      /* instruction history */
 
 
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
@@ -328,6 +325,7 @@ t_stat build_devtab (void);
 t_stat hist_set( UNIT * uptr, int32 val, CONST char * cptr, void * desc ) ;
 t_stat hist_show( FILE * st, UNIT * uptr, int32 val, CONST void * desc ) ;
 static int hist_save( int32 pc, int32 our_ir ) ;
+static void hist_fprintf( FILE * fp, const void * rec, t_bool timed ) ;
 char * devBitNames( int32 flags, char * ptr, char * sepStr ) ;
 
 void mask_out (int32 mask);
@@ -397,7 +395,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, (56 * 1024), NULL, "56K", &cpu_set_size },
     { UNIT_MSIZE, (60 * 1024), NULL, "60K", &cpu_set_size },
     { UNIT_MSIZE, (64 * 1024), NULL, "64K", &cpu_set_size },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &hist_set, &hist_show },
 
     { 0 }
@@ -475,7 +473,7 @@ while (reason == 0) {                                   /* loop until halted */
         }
 
     IR = M[PC];                                         /* fetch instr */
-    if ( hist_cnt )
+    if ( sim_hist_lnt )
         {
         hist_save( PC, IR ) ;                           /*  PC, int_req unchanged */
         }
@@ -1288,7 +1286,6 @@ typedef struct
 
 /*  generalized CPU execution trace  */
 
-#define HIST_IR_INVALID      -1
 #define HIST_MIN              0     /*  0 == deactivate history feature, else size of queue  */
 #define HIST_MAX        1000000     /*  completely arbitrary max size value  */
 
@@ -1298,15 +1295,9 @@ static int hist_save( int32 pc, int32 our_ir )
 {
 Hist_entry *    hist_ptr ;
 
-if ( hist )
-    if ( hist_cnt )
+if ( sim_hist_lnt )
     {
-        hist_p = (hist_p + 1) ;        /* next entry  */
-        if ( hist_p >= hist_cnt )
-        {
-        hist_p = 0 ;
-        }
-    hist_ptr = &hist[ hist_p ] ;
+    hist_ptr = (Hist_entry *) sim_hist_add() ;         /* next entry  */
 
     /*  (machine-specific stuff)  */
 
@@ -1324,7 +1315,7 @@ if ( hist )
     hist_ptr->devDisable = dev_disable ;
     hist_ptr->devIntr    = int_req ;
     /*  how 'bout state and AMASK?  */
-    return ( hist_p ) ;
+    return ( 0 ) ;
     }
 return ( -1 ) ;
 }    /*  end of 'hist_save'  */
@@ -1333,52 +1324,20 @@ return ( -1 ) ;
 
 t_stat hist_set( UNIT * uptr, int32 val, CONST char * cptr, void * desc )
 {
-int32   i, lnt ;
-t_stat  r ;
-
-if ( cptr == NULL )
-    {
-    for (i = 0 ; i < hist_cnt ; ++i )
-        {
-        hist[i].pc = 0 ;
-        hist[i].ir = HIST_IR_INVALID ;
-        }
-    hist_p = 0 ;
-    return ( SCPE_OK ) ;
-    }
-lnt = (int32) get_uint(cptr, 10, HIST_MAX, &r) ;
-if ( (r != SCPE_OK) || (lnt && (lnt < HIST_MIN)) )
-    {
-    return ( SCPE_ARG ) ;
-    }
-hist_p = 0;
-if ( hist_cnt )
-    {
-    free( hist ) ;
-    hist_cnt = 0 ;
-    hist = NULL ;
-    }
-if ( lnt )
-    {
-    hist = (Hist_entry *) calloc( lnt, sizeof(Hist_entry) ) ;
-    if ( hist == NULL )
-        {
-        return ( SCPE_MEM ) ;
-        }
-    hist_cnt = lnt ;
-    }
-return ( SCPE_OK ) ;
+return ( sim_hist_set( &cpu_dev, sizeof(Hist_entry), &hist_fprintf, HIST_MIN, HIST_MAX, cptr ) ) ;
 }   /*  end of 'hist_set'  */
 
 
-int hist_fprintf( FILE * fp, int itemNum, Hist_entry * hptr )
+static void hist_fprintf( FILE * fp, const void * rec, t_bool timed )
 {
-if ( hptr )
+const Hist_entry * hptr = (const Hist_entry *) rec ;
+
+if ( hptr == NULL )                                     /*  no column headings  */
+    {
+    fprintf( fp, "\n\n" ) ;
+    }
+else
     {
-    if ( itemNum == 0 )
-        {
-        fprintf( fp, "\n\n" ) ;
-        }
     fprintf( fp, "%05o / %06o   %06o  %06o  %06o  %06o  %o   ",
         (hptr->pc  & 0x7FFF),
         (hptr->ir  & 0xFFFF),
@@ -1390,7 +1349,7 @@ if ( hptr )
         ) ;
     if ( cpu_unit.flags & UNIT_STK  /* Nova 3 or Nova 4 */ ) 
         {
-        fprintf( fp, "%06o  %06o   ", SP, FP ) ;
+        fprintf( fp, "%06o  %06o   ", hptr->sp, hptr->fp ) ;
         }
 
     sim_eval[0] = (hptr->ir & 0xFFFF) ;
@@ -1410,10 +1369,7 @@ if ( hptr )
         devBitNames( hptr->devIntr, tmp, NULL ) ;
         fprintf( fp, "    %s", tmp ) ;
         }
-
-    fprintf( fp, "\n" ) ;
     }
-return ( 0 ) ;
 }   /*  end of 'hist_fprintf'  */
 
 
@@ -1421,43 +1377,7 @@ return ( 0 ) ;
 
 t_stat hist_show( FILE * st, UNIT * uptr, int32 val, CONST void * desc )
 {
-int32           k, di, lnt ;
-CONST char *    cptr = (CONST char *) desc ;
-t_stat          r ;
-Hist_entry *    hptr ;
-
-
-if (hist_cnt == 0)
-    {
-    return ( SCPE_NOFNC ) ;                             /* enabled? */
-    }
-if ( cptr )
-    {                                                   /*  number of entries specified  */
-    lnt = (int32) get_uint( cptr, 10, hist_cnt, &r ) ;
-    if ( (r != SCPE_OK) || (lnt == 0) )
-        {
-        return ( SCPE_ARG ) ;
-        }
-        }
-    else
-        {
-        lnt = hist_cnt ;                                /*  display all entries  */
-        }
-    di = hist_p - lnt;                                  /* work forward */
-    if ( di < 0 )
-        {
-        di = di + hist_cnt ;
-        }
-
-for ( k = 0 ; k < lnt ; ++k )
-    {                                                   /* print specified */
-    hptr = &hist[ (++di) % hist_cnt] ;                  /* entry pointer   */
-    if ( hptr->ir != HIST_IR_INVALID )                  /* valid entry?    */
-        {
-        hist_fprintf( st, k, hptr ) ;
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+return ( sim_hist_show( st, &cpu_dev, sizeof(Hist_entry), &hist_fprintf, (CONST char *) desc ) ) ;
 }    /*  end of 'hist_show'  */
 
 
@@ -284,10 +284,10 @@
 #define UNIT_1D45       (1 << UNIT_V_1D45)
 #define UNIT_MSIZE      (1 << UNIT_V_MSIZE)
 
-#define HIST_PC         0x40000000
 #define HIST_V_SHF      18
 #define HIST_MIN        64
 #define HIST_MAX        65536
+#define HIST_LAST       ((InstHistory *) sim_hist_last ())
 
 #define MA_GETBNK(x)    ((cpu_unit.flags & UNIT_1D45)? \
                          (((x) >> RM45_V_BNK) & RM45_M_BNK): \
@@ -334,9 +334,6 @@ int32 ind_max = 16;                                     /* ind limit */
 uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* inst history */
 
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat cpu_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
@@ -345,6 +342,7 @@ t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_1d (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat Ea (int32 IR);
 t_stat Ea_ch (int32 IR, int32 *byte_num);
 int32 inc_bp (int32 bp);
@@ -491,7 +489,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 32768, NULL, "32K", &cpu_set_size },
     { UNIT_MSIZE, 49152, NULL, "48K", &cpu_set_size },
     { UNIT_MSIZE, 65536, NULL, "64K", &cpu_set_size },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -595,14 +593,13 @@ while (reason == 0) {                                   /* loop until halted */
     PC = INCR_ADDR (PC);                                /* increment PC */
     xct_count = 0;                                      /* track XCT's */
     sim_interval = sim_interval - 1;
-    if (hst_lnt) {                                      /* history enabled? */
-        hst_p = (hst_p + 1);                            /* next entry */
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        hst[hst_p].pc = MA | HIST_PC;                   /* save state */
-        hst[hst_p].ir = IR;
-        hst[hst_p].ovac = (OV << HIST_V_SHF) | AC;
-        hst[hst_p].pfio = (PF << HIST_V_SHF) | IO;
+    if (sim_hist_lnt) {                                 /* history enabled? */
+        InstHistory *h = (InstHistory *) sim_hist_add ();
+
+        h->pc = MA;                                     /* save state */
+        h->ir = IR;
+        h->ovac = (OV << HIST_V_SHF) | AC;
+        h->pfio = (PF << HIST_V_SHF) | IO;
         }
 
     xct_instr:                                          /* label for XCT */
@@ -675,8 +672,8 @@ while (reason == 0) {                                   /* loop until halted */
 
     case 007:                                           /* CAL, JDA */
         MA = (PC & EPCMASK) | ((IR & IA)? (IR & DAMASK): 0100);
-        if (hst_p)                                      /* history enabled? */
-            hst[hst_p].ea = MA;
+        if (sim_hist_lnt)                               /* history enabled? */
+            HIST_LAST->ea = MA;
         PCQ_ENTRY;
         MB = AC;                                        /* save AC */
         AC = EPC_WORD;
@@ -861,8 +858,8 @@ while (reason == 0) {                                   /* loop until halted */
             OV = (MB >> 17) & 1;                        /* restore OV */
             extm = (MB >> 16) & 1;                      /* restore ext mode */
             PC = MB & AMASK;                            /* jmp i 00x1/5 */
-            if (hst_p)                                  /* history enabled? */
-                hst[hst_p].ea = PC;
+            if (sim_hist_lnt)                           /* history enabled? */
+                HIST_LAST->ea = PC;
             }
         else {                                          /* normal JMP */
             if ((reason = Ea (IR)))                     /* MA <- eff addr */
@@ -1390,8 +1387,8 @@ if (IR & IA) {                                          /* indirect addr? */
             return STOP_IND;
         }                                               /* end else !extm */
     }                                                   /* end if indirect */
-if (hst_p)                                              /* history enabled? */
-    hst[hst_p].ea = MA;
+if (sim_hist_lnt)                                       /* history enabled? */
+    HIST_LAST->ea = MA;
 return SCPE_OK;
 }
 
@@ -1428,8 +1425,8 @@ if (IR & IA) {                                          /* automatic mode? */
 if (extm)                                               /* final ea */
     MA = MB & AMASK;
 else MA = (PC & EPCMASK) | (MB & DAMASK);
-if (hst_p)                                              /* history enabled? */
-    hst[hst_p].ea = MA;
+if (sim_hist_lnt)                                       /* history enabled? */
+    HIST_LAST->ea = MA;
 return SCPE_OK;
 }
 
@@ -1456,15 +1453,15 @@ if (rm && !sbs_act) {                                   /* restrict check? */
         return set_rmv (0);
     }
 MB = M[MA];
-if (hst_p)                                              /* history enabled? */
-    hst[hst_p].opnd = MB;
+if (sim_hist_lnt)                                       /* history enabled? */
+    HIST_LAST->opnd = MB;
 return SCPE_OK;
 }
 
 t_stat Write (void)
 {
-if (hst_p)                                              /* hist? old contents */
-    hst[hst_p].opnd = M[MA];
+if (sim_hist_lnt)                                       /* hist? old contents */
+    HIST_LAST->opnd = M[MA];
 if (rm && !sbs_act) {                                   /* restrict check? */
     int32 bnk = MA_GETBNK (MA);                         /* get bank */
     if ((rmask << bnk) & SIGN)
@@ -1632,80 +1629,40 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 ov, pf, op, k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+int32 ov, pf, op;
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC      OV AC     IO      PF EA      IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC      OV AC     IO      PF EA      IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        ov = (h->ovac >> HIST_V_SHF) & 1;               /* overflow */
-        pf = (h->pfio >> HIST_V_SHF) & PF_VR_ALL;       /* prog flags */
-        op = ((h->ir >> 13) & 037);                     /* get opcode */
-        fprintf (st, "%06o  %o  %06o %06o %03o ",
-            h->pc & AMASK, ov, h->ovac & DMASK, h->pfio & DMASK, pf);
-        if ((op < 032) && (op != 007))                  /* mem ref instr */
-            fprintf (st, "%06o  ", h->ea);
-        else fprintf (st, "        ");
-        sim_eval[0] = h->ir;
-        if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %06o", h->ir);
-        else if (op < 030)                              /* mem ref instr */
-            fprintf (st, " [%06o]", h->opnd);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+ov = (h->ovac >> HIST_V_SHF) & 1;                       /* overflow */
+pf = (h->pfio >> HIST_V_SHF) & PF_VR_ALL;               /* prog flags */
+op = ((h->ir >> 13) & 037);                             /* get opcode */
+fprintf (st, "%06o  %o  %06o %06o %03o ",
+    h->pc & AMASK, ov, h->ovac & DMASK, h->pfio & DMASK, pf);
+if ((op < 032) && (op != 007))                          /* mem ref instr */
+    fprintf (st, "%06o  ", h->ea);
+else fprintf (st, "        ");
+sim_eval[0] = h->ir;
+if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %06o", h->ir);
+else if (op < 030)                                      /* mem ref instr */
+    fprintf (st, " [%06o]", h->opnd);
 }
 
 #ifdef USE_DISPLAY
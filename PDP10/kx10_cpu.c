@@ -97,16 +97,16 @@
 #include "kx10_defs.h"
 #include "sim_timer.h"
 
-#define HIST_PC         0x40000000
 #define HIST_PC2        0x80000000
 #define HIST_PCE        0x20000000
 #define HIST_MIN        64
 #define HIST_MAX        5000000
+#define HIST_LAST       ((InstHistory *) sim_hist_last ())
 #define TMR_RTC         0
 #define TMR_QUA         1
 
 
-uint64  M[MAXMEMSIZE];                        /* Memory */
+uint64  *M = NULL;                            /* Memory */
 #if KL | KS
 uint64  FM[128];                              /* Fast memory register */
 #elif KI
@@ -239,6 +239,12 @@ int     user_addr_cmp;                        /* User address compare flag */
 #if KI | KL | ITS | BBN | KS
 uint32  e_tlb[512];                           /* Executive TLB */
 uint32  u_tlb[546];                           /* User TLB */
+#if KL | KS
+uint32  e_tlb_key[512];                       /* TLB entry e_tlb_ptr was built for */
+uint32  u_tlb_key[546];                       /* TLB entry u_tlb_ptr was built for */
+uint64  *e_tlb_ptr[512];                      /* Host address of executive page */
+uint64  *u_tlb_ptr[546];                      /* Host address of user page */
+#endif
 int     page_enable;                          /* Enable paging */
 int     page_fault;                           /* Page fail */
 uint32  ac_stack;                             /* Register stack pointer */
@@ -376,10 +382,6 @@ typedef struct {
     uint16      prev_sect;
     } InstHistory;
 
-int32 hst_p = 0;                         /* history pointer */
-int32 hst_lnt = 0;                       /* history length */
-InstHistory *hst = NULL;                 /* instruction history */
-
 /* Forward and external declarations */
 
 #if KL | KS
@@ -391,6 +393,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 #if KI | KL | KS
 t_stat cpu_set_serial (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_serial (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
@@ -683,7 +686,7 @@ MTAB cpu_mod[] = {
     { UNIT_MAOFF, 0, NULL, "NOMAOFF", NULL, NULL, NULL,
              "No interrupt relocation"},
 #endif
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -1820,6 +1823,91 @@ sim_debug(DEBUG_DATAIO, &cpu_dev, "Rl=%06o Pl=%06o, Rh=%06o, Ph=%06o\n", Rl, Pl,
 }
 #endif
 
+#if KL | KS
+
+/*
+ * Host pointer fast path for paged memory references.
+ *
+ * Alongside each TLB entry we remember a pointer to the start of the
+ * page in M[], together with the TLB value it was computed from.
+ * page_lookup fills these on a successful translation. Nothing has
+ * to clear them: every path which invalidates or changes a TLB entry
+ * makes it differ from the saved key, which disables the pointer
+ * until page_lookup runs again.
+ *
+ * Only the plain case is handled here: paging on, no PI or
+ * user override, no XCT previous context mapping, and (on the KL)
+ * no address break, no public mode, and the right section. Anything
+ * else goes through page_lookup as before.
+ */
+static void tlb_ptr_clear()
+{
+    memset(e_tlb_key, 0, sizeof(e_tlb_key));
+    memset(u_tlb_key, 0, sizeof(u_tlb_key));
+}
+
+static void tlb_ptr_fill(int uf, int page, uint32 data)
+{
+    uint32   *tlb = (uf) ? u_tlb : e_tlb;
+    t_addr   base;
+
+    /* Only cache pages where a plain access has no side effects */
+    if (tlb[page] != data || (data & KL_PAG_A) == 0)
+        return;
+#if KL
+    if (data & KL_PAG_P)
+        return;
+    base = (data & 017777) << 9;
+#else
+    base = (data & 03777) << 9;
+#endif
+    if (base + 01000 > MEMSIZE)
+        return;
+    if (uf) {
+        u_tlb_key[page] = data;
+        u_tlb_ptr[page] = &M[base];
+    } else {
+        e_tlb_key[page] = data;
+        e_tlb_ptr[page] = &M[base];
+    }
+}
+
+static SIM_INLINE uint64 *tlb_ptr_lookup(t_addr addr, int flag, int wr, int fetch)
+{
+    int      page = (RMASK & addr) >> 9;
+    uint32   data;
+    uint64   *ptr;
+
+    if (flag || !page_enable || (xct_flag != 0 && !fetch))
+        return NULL;
+#if KL
+    if ((FLAGS & PUBLIC) != 0 || addr == brk_addr)
+        return NULL;
+#endif
+    if (FLAGS & USER) {
+        data = u_tlb[page];
+        if (data == 0 || data != u_tlb_key[page])
+            return NULL;
+        ptr = u_tlb_ptr[page];
+    } else {
+        /* Pages 340-377 via UBT */
+        if (!t20_page && (page & 0740) == 0340)
+            return NULL;
+        data = e_tlb[page];
+        if (data == 0 || data != e_tlb_key[page])
+            return NULL;
+        ptr = e_tlb_ptr[page];
+    }
+#if KL
+    if (QKLB && t20_page && ((data >> 18) & 037) != sect)
+        return NULL;
+#endif
+    if (wr && (data & KL_PAG_W) == 0)
+        return NULL;
+    return ptr + (addr & 0777);
+}
+#endif
+
 #if KS
 
 /*
@@ -2260,6 +2348,7 @@ int page_lookup(t_addr addr, int flag, t_addr *loc, int wr, int cur_context, int
         return 0;
     }
 
+    tlb_ptr_fill(uf | upmp, page, data);
     return 1;
 }
 
@@ -2272,6 +2361,7 @@ int page_lookup(t_addr addr, int flag, t_addr *loc, int wr, int cur_context, int
 
 int Mem_read(int flag, int cur_context, int fetch, int mod) {
     t_addr addr;
+    uint64 *ptr;
 
     if (AB < 020) {
         if (xct_flag != 0 && !fetch) {
@@ -2280,8 +2370,8 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
                 ((xct_flag & 2) != 0 && !cur_context && ptr_flg) ||
                 ((xct_flag & 1) != 0 && !cur_context && BYF5 )) {
                MB = FM[prev_ctx|AB];
-               if (fetch == 0 && hst_lnt) {
-                   hst[hst_p].mb = MB;
+               if (fetch == 0 && sim_hist_lnt) {
+                   HIST_LAST->mb = MB;
                }
                return 0;
             }
@@ -2290,14 +2380,17 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
         MB = get_reg(AB);
         UPDATE_MI(AB);
     } else {
-        if (!page_lookup(AB, flag, &addr, mod, cur_context, fetch))
+        ptr = tlb_ptr_lookup(AB, flag, mod, fetch);
+        if (ptr != NULL) {
+            addr = (t_addr)(ptr - M);
+        } else if (!page_lookup(AB, flag, &addr, mod, cur_context, fetch)) {
             return 1;
-        if (addr >= MEMSIZE) {
+        } else if (addr >= MEMSIZE) {
             irq_flags |= NXM_MEM;
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(addr, SWMASK('R')))
+        if (sim_brk_watch_test(addr, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -2305,14 +2398,15 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
         last_addr = addr;
         UPDATE_MI(addr);
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     return 0;
 }
 
 int Mem_write(int flag, int cur_context) {
     t_addr addr;
+    uint64 *ptr;
 
     if (AB < 020) {
         if (xct_flag != 0) {
@@ -2328,7 +2422,7 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch_test(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -2336,14 +2430,17 @@ int Mem_write(int flag, int cur_context) {
             return 0;
         }
 
-        if (!page_lookup(AB, flag, &addr, 1, cur_context, 0))
+        ptr = tlb_ptr_lookup(AB, flag, 1, 0);
+        if (ptr != NULL) {
+            addr = (t_addr)(ptr - M);
+        } else if (!page_lookup(AB, flag, &addr, 1, cur_context, 0)) {
             return 1;
-        if (addr >= MEMSIZE) {
+        } else if (addr >= MEMSIZE) {
             irq_flags |= NXM_MEM;
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(addr, SWMASK('W')))
+        if (sim_brk_watch_test(addr, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -2801,6 +2898,7 @@ int page_lookup(t_addr addr, int flag, t_addr *loc, int wr, int cur_context, int
     /* If fetching from public page, set public flag */
     if (fetch && ((data & KL_PAG_P) != 0))
         FLAGS |= PUBLIC;
+    tlb_ptr_fill(uf | upmp, page, data);
     return 1;
 }
 
@@ -2813,6 +2911,7 @@ int page_lookup(t_addr addr, int flag, t_addr *loc, int wr, int cur_context, int
 
 int Mem_read(int flag, int cur_context, int fetch, int mod) {
     t_addr addr;
+    uint64 *ptr;
 
     if (AB < 020 && ((QKLB && (glb_sect == 0 || sect == 0 ||
               (glb_sect && sect == 1))) || !QKLB)) {
@@ -2822,8 +2921,8 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
                 ((xct_flag & 2) != 0 && !cur_context && ptr_flg) ||
                 ((xct_flag & 1) != 0 && !cur_context && BYF5 )) {
                MB = FM[prev_ctx|AB];
-               if (fetch == 0 && hst_lnt) {
-                   hst[hst_p].mb = MB;
+               if (fetch == 0 && sim_hist_lnt) {
+                   HIST_LAST->mb = MB;
                }
                return 0;
             }
@@ -2839,13 +2938,16 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
         MB = get_reg(AB);
         UPDATE_MI(AB);
     } else {
-        if (!page_lookup(AB, flag, &addr, mod, cur_context, fetch))
+        ptr = tlb_ptr_lookup(AB, flag, mod, fetch);
+        if (ptr != NULL) {
+            addr = (t_addr)(ptr - M);
+        } else if (!page_lookup(AB, flag, &addr, mod, cur_context, fetch)) {
             return 1;
-        if (addr >= MEMSIZE) {
+        } else if (addr >= MEMSIZE) {
             irq_flags |= NXM_MEM;
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch_test(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -2853,14 +2955,15 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
         last_addr = addr;
         UPDATE_MI(addr);
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     return 0;
 }
 
 int Mem_write(int flag, int cur_context) {
     t_addr addr;
+    uint64 *ptr;
 
     if (AB < 020 && ((QKLB && (glb_sect == 0 || sect == 0 ||
                         (glb_sect && sect == 1))) || !QKLB)) {
@@ -2885,20 +2988,23 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch_test(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
             modify = 0;
             return 0;
         }
-        if (!page_lookup(AB, flag, &addr, 1, cur_context, 0))
+        ptr = tlb_ptr_lookup(AB, flag, 1, 0);
+        if (ptr != NULL) {
+            addr = (t_addr)(ptr - M);
+        } else if (!page_lookup(AB, flag, &addr, 1, cur_context, 0)) {
             return 1;
-        if (addr >= MEMSIZE) {
+        } else if (addr >= MEMSIZE) {
             irq_flags |= NXM_MEM;
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch_test(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -3265,8 +3371,8 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
                     MB = M[ub_ptr + ac_stack + AB];
                     --sim_interval;
                 }
-                if (fetch == 0 && hst_lnt) {
-                    hst[hst_p].mb = MB;
+                if (fetch == 0 && sim_hist_lnt) {
+                    HIST_LAST->mb = MB;
                 }
                 MB = get_reg(AB);
                 return 0;
@@ -3282,15 +3388,15 @@ read:
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch_test(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
         modify = mod;
         last_addr = addr;
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     UPDATE_MI(AB);
     return 0;
@@ -3322,7 +3428,7 @@ int Mem_write(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch_test(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -3337,7 +3443,7 @@ write:
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch_test(AB, SWMASK('W')))
             watch_stop = 1;
          sim_interval--;
         M[addr] = MB;
@@ -3531,8 +3637,8 @@ int Mem_read_its(int flag, int cur_context, int fetch, int mod) {
     if (AB < 020) {
         if ((xct_flag & 1) != 0 && !cur_context) {
            MB = M[(ac_stack & 01777777) + AB];
-           if (fetch == 0 && hst_lnt) {
-               hst[hst_p].mb = MB;
+           if (fetch == 0 && sim_hist_lnt) {
+               HIST_LAST->mb = MB;
            }
            return 0;
         }
@@ -3566,7 +3672,7 @@ int Mem_read_its(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch_test(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
@@ -3574,8 +3680,8 @@ int Mem_read_its(int flag, int cur_context, int fetch, int mod) {
         modify = mod;
         UPDATE_MI(addr);
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     return 0;
 }
@@ -3598,7 +3704,7 @@ int Mem_write_its(int flag, int cur_context) {
         UPDATE_MI(AB);
     } else {
         if (modify) {
-            if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+            if (sim_brk_watch_test(last_addr, SWMASK('W')))
                 watch_stop = 1;
             M[last_addr] = MB;
             UPDATE_MI(last_addr);
@@ -3633,7 +3739,7 @@ int Mem_write_its(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch_test(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -3910,8 +4016,8 @@ int Mem_read_bbn(int flag, int cur_context, int fetch, int mod) {
     /* If not doing any special access, just access register */
     if (AB < 020 && ((xct_flag == 0 || fetch || cur_context || (FLAGS & USER) != 0))) {
         MB = get_reg(AB);
-        if (fetch == 0 && hst_lnt) {
-            hst[hst_p].mb = MB;
+        if (fetch == 0 && sim_hist_lnt) {
+            HIST_LAST->mb = MB;
         }
         UPDATE_MI(AB);
         return 0;
@@ -3920,8 +4026,8 @@ int Mem_read_bbn(int flag, int cur_context, int fetch, int mod) {
         return 1;
     if (addr < 020) {
         MB = get_reg(AB);
-        if (fetch == 0 && hst_lnt) {
-            hst[hst_p].mb = MB;
+        if (fetch == 0 && sim_hist_lnt) {
+            HIST_LAST->mb = MB;
         }
         UPDATE_MI(AB);
         return 0;
@@ -3931,14 +4037,14 @@ int Mem_read_bbn(int flag, int cur_context, int fetch, int mod) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+    if (sim_brk_watch_test(AB, SWMASK('R')))
         watch_stop = 1;
     sim_interval--;
     MB = M[addr];
     last_addr = addr;
     modify = mod;
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     UPDATE_MI(addr);
     return 0;
@@ -3959,7 +4065,7 @@ int Mem_write_bbn(int flag, int cur_context) {
         return 0;
     }
     if (modify) {
-        if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+        if (sim_brk_watch_test(last_addr, SWMASK('W')))
             watch_stop = 1;
         M[last_addr] = MB;
         UPDATE_MI(AB);
@@ -3978,7 +4084,7 @@ int Mem_write_bbn(int flag, int cur_context) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+    if (sim_brk_watch_test(AB, SWMASK('W')))
         watch_stop = 1;
     sim_interval--;
     M[addr] = MB;
@@ -4034,8 +4140,8 @@ int Mem_read_waits(int flag, int cur_context, int fetch, int mod) {
 
     if (AB < 020 && ((xct_flag == 0 || fetch || cur_context || (FLAGS & USER) != 0))) {
         MB = get_reg(AB);
-        if (fetch == 0 && hst_lnt) {
-            hst[hst_p].mb = MB;
+        if (fetch == 0 && sim_hist_lnt) {
+            HIST_LAST->mb = MB;
         }
         UPDATE_MI(addr);
         return 0;
@@ -4047,14 +4153,14 @@ int Mem_read_waits(int flag, int cur_context, int fetch, int mod) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+    if (sim_brk_watch_test(AB, SWMASK('R')))
         watch_stop = 1;
     sim_interval--;
     MB = M[addr];
     modify = mod;
     last_addr = addr;
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     UPDATE_MI(addr);
     return 0;
@@ -4076,7 +4182,7 @@ int Mem_write_waits(int flag, int cur_context) {
         return 0;
     }
     if (modify) {
-        if (sim_brk_summ && sim_brk_test(last_addr, SWMASK('W')))
+        if (sim_brk_watch_test(last_addr, SWMASK('W')))
             watch_stop = 1;
         M[last_addr] = MB;
         modify = 0;
@@ -4090,7 +4196,7 @@ int Mem_write_waits(int flag, int cur_context) {
         check_apr_irq();
         return 1;
     }
-    if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+    if (sim_brk_watch_test(AB, SWMASK('W')))
         watch_stop = 1;
     sim_interval--;
     M[addr] = MB;
@@ -4137,13 +4243,13 @@ int Mem_read_ka(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch_test(AB, SWMASK('R')))
             watch_stop = 1;
         sim_interval--;
         MB = M[addr];
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     UPDATE_MI(addr);
     return 0;
@@ -4168,7 +4274,7 @@ int Mem_write_ka(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch_test(AB, SWMASK('W')))
             watch_stop = 1;
         sim_interval--;
         M[addr] = MB;
@@ -4310,12 +4416,12 @@ int Mem_read(int flag, int cur_context, int fetch, int mod) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('R')))
+        if (sim_brk_watch_test(AB, SWMASK('R')))
             watch_stop = 1;
         MB = M[addr];
     }
-    if (fetch == 0 && hst_lnt) {
-        hst[hst_p].mb = MB;
+    if (fetch == 0 && sim_hist_lnt) {
+        HIST_LAST->mb = MB;
     }
     UPDATE_MI(addr);
     return 0;
@@ -4341,7 +4447,7 @@ int Mem_write(int flag, int cur_context) {
             check_apr_irq();
             return 1;
         }
-        if (sim_brk_summ && sim_brk_test(AB, SWMASK('W')))
+        if (sim_brk_watch_test(AB, SWMASK('W')))
             watch_stop = 1;
         M[addr] = MB;
     }
@@ -4472,6 +4578,10 @@ if (sim_step != 0) {
 
 RUN = 1;
 prog_stop = 0;
+#if KL | KS
+/* Memory size or TLB may have been changed from SCP */
+tlb_ptr_clear();
+#endif
 #if KS
 reason = SCPE_OK;
 #else
@@ -4910,24 +5020,21 @@ st_pi:
     }
 
     /* Update history */
-    if (hst_lnt) {
-            if (PC != 017)
-                hst_p = hst_p + 1;
-            if (hst_p >= hst_lnt) {
-                hst_p = 0;
-            }
-            hst[hst_p].pc = HIST_PC | ((BYF5)? (HIST_PC2|PC) : IA);
-            hst[hst_p].ea = AB;
+    if (sim_hist_lnt) {
+            InstHistory *h = (PC != 017) ? (InstHistory *) sim_hist_add () : HIST_LAST;
+
+            h->pc = ((BYF5)? (HIST_PC2|PC) : IA);
+            h->ea = AB;
 #if KL | KS
             if (extend)
-               hst[hst_p].pc |= HIST_PCE;
+               h->pc |= HIST_PCE;
 #endif
 #if KL
-            hst[hst_p].pc |= (pc_sect << 18);
-            hst[hst_p].ea |= (sect << 18);
+            h->pc |= (pc_sect << 18);
+            h->ea |= (sect << 18);
 #endif
-            hst[hst_p].ir = AD;
-            hst[hst_p].flags = (FLAGS << 5)
+            h->ir = AD;
+            h->flags = (FLAGS << 5)
 #if KA | KI | PDP6
                                 |(clk_flg << 2) | (nxm_flag << 1)
 #if KA | PDP6
@@ -4943,10 +5050,10 @@ st_pi:
 
                        ;
 #if KL
-            hst[hst_p].prev_sect = prev_sect;
+            h->prev_sect = prev_sect;
 #endif
-            hst[hst_p].mb = AR;
-            hst[hst_p].ac = get_reg(AC);
+            h->mb = AR;
+            h->ac = get_reg(AC);
     }
 
 
@@ -6397,8 +6504,8 @@ dpnorm:
               if (QITS) {
                   BR = AR & RMASK;
                   AR = get_reg(AC);
-                  if (hst_lnt) {
-                      hst[hst_p].mb = AR;
+                  if (sim_hist_lnt) {
+                      HIST_LAST->mb = AR;
                   }
                   MQ = get_reg(AC + 1);
                   SC = ((AB & RSIGN) ? (0777 ^ AB) + 1 : AB) & 0777;
@@ -6423,8 +6530,8 @@ dpnorm:
               if (QWAITS) {   /* WAITS FIX instruction */
                   AR &= RMASK;
                   BR = get_reg(AC);
-                  if (hst_lnt) {
-                      hst[hst_p].mb = AR;
+                  if (sim_hist_lnt) {
+                      HIST_LAST->mb = AR;
                   }
                   MQ = 0;
                   AR = AR << 18;  /* Move to upper half */
@@ -9013,8 +9120,8 @@ jrstf:
               }
 #endif
               AB = BR & RMASK;
-              if (hst_lnt)
-                  hst[hst_p].mb = MB;
+              if (sim_hist_lnt)
+                  HIST_LAST->mb = MB;
               if (Mem_write(uuo_cycle | pi_cycle, 0))
                  goto last;
 #if !PDP6
@@ -9074,8 +9181,8 @@ jrstf:
 #endif
               AB = BR & RMASK;
               MB = AR;
-              if (hst_lnt)
-                  hst[hst_p].mb = MB;
+              if (sim_hist_lnt)
+                  HIST_LAST->mb = MB;
               if (Mem_write(0, 0))
                  goto last;
               AR = BR & FMASK;
@@ -9105,8 +9212,8 @@ jrstf:
               AB = BR & RMASK;
               if (Mem_read(0, 0, 0, 0))
                   goto last;
-              if (hst_lnt)
-                  hst[hst_p].mb = MB;
+              if (sim_hist_lnt)
+                  HIST_LAST->mb = MB;
 
               /* Save in location */
               AB = AR & RMASK;
@@ -9183,11 +9290,11 @@ jrstf:
 #endif
               BR = SOB(BR);
 
-              if (hst_lnt) {
+              if (sim_hist_lnt) {
 #if KL
-                  hst[hst_p].ea = AB | (sect << 18);
+                  HIST_LAST->ea = AB | (sect << 18);
 #else
-                  hst[hst_p].ea = AB;
+                  HIST_LAST->ea = AB;
 #endif
               }
               if (Mem_read(0, 0, 0, 0))
@@ -11922,8 +12029,8 @@ fetch_opr:
                           if (Mem_read(pi_cycle, 0, 0, 0))
                               goto last;
                           AR = MB;
-                          if (hst_lnt) {
-                                  hst[hst_p].mb = AR;
+                          if (sim_hist_lnt) {
+                                  HIST_LAST->mb = AR;
                           }
                           AC |= 1;    /* Make into DATAI/DATAO */
                           AR = AOB(AR);
@@ -12029,8 +12136,8 @@ fetch_opr:
              break;
     }
 
-    if (hst_lnt) {
-        hst[hst_p].fmb = AR;
+    if (sim_hist_lnt) {
+        HIST_LAST->fmb = AR;
     }
 
 last:
@@ -13643,6 +13750,12 @@ t_stat cpu_reset (DEVICE *dptr)
          }
 #endif
     }
+    if (M == NULL) {
+        M = (uint64 *) sim_mem_alloc (MAXMEMSIZE * sizeof (uint64));
+        if (M == NULL)
+            return SCPE_MEM;
+        cpu_unit[0].filebuf = M;                     /* lets SAVE skip untouched memory */
+    }
     sim_debug(DEBUG_CONO, dptr, "CPU reset\n");
     RUN = BYF5 = uuo_cycle = 0;
 #if KA | PDP6
@@ -13816,8 +13929,11 @@ if ((val <= 0) || ((val * 16 * 1024) > MAXMEMSIZE))
 val = val * 16 * 1024;
 if (val < (int32)MEMSIZE) {
     uint64 mc = 0;
-    for (i = val-1; i < (int32)MEMSIZE; i++)
-        mc = mc | M[i];
+    if (!sim_mem_untouched (M, (size_t)val * sizeof (uint64),
+                            (size_t)(MEMSIZE - val) * sizeof (uint64))) {
+        for (i = val-1; i < (int32)MEMSIZE; i++)
+            mc = mc | M[i];
+        }
     if ((mc != 0) && (!get_yn ("Really truncate memory [N]?", FALSE)))
         return SCPE_OK;
 }
@@ -14008,105 +14124,69 @@ return SCPE_OK;
 /* Set history */
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if ((r != SCPE_OK) || (lnt && (lnt < HIST_MIN)))
-    return SCPE_ARG;
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 k, di, lnt;
-char *cptr = (char *) desc;
-t_stat r;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
 t_value sim_eval;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return SCPE_ARG;
-    }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC       AC             EA        AR            RES           FLAGS IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC       AC             EA        AR            RES           FLAGS IR\n\n");
+    return;
+    }
 #if KL
-        if (QKLB)
-            fprintf(st, "%08o ", h->pc & 0777777777);
-        else
+if (QKLB)
+    fprintf(st, "%08o ", h->pc & 0777777777);
+else
 #endif
-        fprintf (st, "%06o   ", h->pc & 0777777);
-        fprint_val (st, h->ac, 8, 36, PV_RZRO);
-        fputs ("  ", st);
+fprintf (st, "%06o   ", h->pc & 0777777);
+fprint_val (st, h->ac, 8, 36, PV_RZRO);
+fputs ("  ", st);
 #if KL
-        if (QKLB)
-            fprintf(st, "%08o ", h->ea & 077777777);
-        else
+if (QKLB)
+    fprintf(st, "%08o ", h->ea & 077777777);
+else
 #endif
 #if KS
-        fprintf (st, "%c", (h->ea & 07000000) ? ((h->ea >> 18) & 07) + '0': ' ');
-        fprintf (st, "%06o   ", h->ea & 0777777);
+fprintf (st, "%c", (h->ea & 07000000) ? ((h->ea >> 18) & 07) + '0': ' ');
+fprintf (st, "%06o   ", h->ea & 0777777);
 #else
-        fprintf (st, "%06o   ", h->ea);
+fprintf (st, "%06o   ", h->ea);
 #endif
-        fputs ("  ", st);
-        fprint_val (st, h->mb, 8, 36, PV_RZRO);
-        fputs ("  ", st);
-        fprint_val (st, h->fmb, 8, 36, PV_RZRO);
-        fputs ("  ", st);
+fputs ("  ", st);
+fprint_val (st, h->mb, 8, 36, PV_RZRO);
+fputs ("  ", st);
+fprint_val (st, h->fmb, 8, 36, PV_RZRO);
+fputs ("  ", st);
 #if KI | KL
-        fprintf (st, "%c%06o  ", ((h->flags & (PRV_PUB << 5))? 'p':' '), h->flags & 0777777);
+fprintf (st, "%c%06o  ", ((h->flags & (PRV_PUB << 5))? 'p':' '), h->flags & 0777777);
 #if KL
-        fprintf (st, "%02o ", h->prev_sect);
+fprintf (st, "%02o ", h->prev_sect);
 #endif
 #else
-        fprintf (st, "%06o  ", h->flags);
-#endif
-        if ((h->pc & HIST_PCE) != 0) {
-            sim_eval = h->ir;
-            fprint_val (st, sim_eval, 8, 36, PV_RZRO);
-        } else if ((h->pc & HIST_PC2) == 0) {
-            sim_eval = h->ir;
-            fprint_val (st, sim_eval, 8, 36, PV_RZRO);
-            fputs ("  ", st);
-            if ((fprint_sym (st, h->pc & RMASK, &sim_eval, &cpu_unit[0], SWMASK ('M'))) > 0) {
-                fputs ("(undefined) ", st);
-                fprint_val (st, h->ir, 8, 36, PV_RZRO);
-            }
-        }
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+fprintf (st, "%06o  ", h->flags);
+#endif
+if ((h->pc & HIST_PCE) != 0) {
+    sim_eval = h->ir;
+    fprint_val (st, sim_eval, 8, 36, PV_RZRO);
+} else if ((h->pc & HIST_PC2) == 0) {
+    sim_eval = h->ir;
+    fprint_val (st, sim_eval, 8, 36, PV_RZRO);
+    fputs ("  ", st);
+    if ((fprint_sym (st, h->pc & RMASK, &sim_eval, &cpu_unit[0], SWMASK ('M'))) > 0) {
+        fputs ("(undefined) ", st);
+        fprint_val (st, h->ir, 8, 36, PV_RZRO);
+    }
+}
 }
 
 t_stat
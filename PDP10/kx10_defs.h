@@ -830,7 +830,7 @@ extern t_bool sim_idle_enab;
 #if !KS
 extern struct rh_dev rh[];
 #endif
-extern t_uint64   M[MAXMEMSIZE];
+extern t_uint64   *M;
 extern t_uint64   FM[];
 extern uint32   PC;
 extern uint32   FLAGS;
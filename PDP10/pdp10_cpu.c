@@ -143,7 +143,6 @@
 #define PCQ_MASK        (PCQ_SIZE - 1)
 #define PCQ_ENTRY       pcq[pcq_p = (pcq_p - 1) & PCQ_MASK] = PC
 
-#define HIST_PC         0x40000000
 #define HIST_MIN        64
 #define HIST_MAX        65536
 
@@ -165,6 +164,7 @@ a10 epta, upta;                                         /* proc tbl addr (dyn) *
 a10 saved_PC = 0;                                       /* scp: saved PC */
 d10 pager_word = 0;                                     /* pager: error word */
 a10 pager_PC = 0;                                       /* pager: saved PC */
+int32 cpu_brk_watch = 0;                                /* data watchpoint hit */
 int32 pager_flags = 0;                                  /* pager: trap flags */
 t_bool pager_pi = FALSE;                                /* pager: in pi seq */
 t_bool pager_tc = FALSE;                                /* pager: trap cycle */
@@ -200,9 +200,6 @@ a10 pcq[PCQ_SIZE] = { 0 };                              /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 jmp_buf save_env;
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 int32 apr_serial = -1;                                  /* CPU Serial number */
 
 /* Forward and external declarations */
@@ -213,6 +210,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_bool cpu_is_pc_a_subroutine_call (t_addr **ret_addrs);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_set_serial (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_serial (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 
@@ -401,9 +399,14 @@ MTAB cpu_mod[] = {
     { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "IOSPACE", NULL,
       NULL, &show_iospace },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { MTAB_XTD|MTAB_VDV|MTAB_VALR, 0, "SERIAL", "SERIAL", &cpu_set_serial, &cpu_show_serial },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 0, "MEMBACKING", "MEMBACKING",
+      &sim_set_mem_backing, &sim_show_mem_backing },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 1, "NUMANODE", "NUMANODE",
+      &sim_set_numa_node, &sim_show_numa_node },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NONUMANODE", &sim_set_numa_node, NULL },
     { 0 }
     };
 
@@ -636,6 +639,7 @@ t_stat r;
 if ((r = build_dib_tab ()) != SCPE_OK)                  /* build, chk dib_tab */
     return r;
 pager_PC = PC = saved_PC & AMASK;                       /* load local PC */
+cpu_brk_watch = 0;                                      /* no watch hit yet */
 set_dyn_ptrs ();                                        /* set up local ptrs */
 pager_tc = FALSE;                                       /* not in trap cycle */
 pager_pi = FALSE;                                       /* not in pi sequence */
@@ -831,9 +835,14 @@ if (TSTF (F_T1 | F_T2) && PAGING) {
 /* Test for instruction breakpoint */
 
 else {
-    if (sim_brk_summ &&
-        sim_brk_test (PC, SWMASK ('E'))) {              /* breakpoint? */
-        ABORT (STOP_IBKPT);                             /* stop simulation */
+    if (sim_brk_summ) {
+        if (cpu_brk_watch) {                            /* data watchpoint hit? */
+            cpu_brk_watch = 0;                          /* stop after the instr */
+            sim_messagef (STOP_IBKPT, "\r\n%s", sim_brk_message ());
+            ABORT (STOP_IBKPT);
+            }
+        if (sim_brk_test (PC, SWMASK ('E')))            /* breakpoint? */
+            ABORT (STOP_IBKPT);                         /* stop simulation */
         }
 
 /* Ready (at last) to get an instruction */
@@ -867,14 +876,13 @@ for (indrct = inst, i = 0; ; i++) {                     /* calc eff addr */
         }
     else break;
     }
-if (hst_lnt) {                                          /* history enabled? */
-    hst_p = (hst_p + 1);                                /* next entry */
-    if (hst_p >= hst_lnt)
-        hst_p = 0;
-    hst[hst_p].pc = pager_PC | HIST_PC;
-    hst[hst_p].ea = ea;
-    hst[hst_p].ir = inst;
-    hst[hst_p].ac = AC(ac);
+if (sim_hist_lnt) {                                     /* history enabled? */
+    InstHistory *h = (InstHistory *) sim_hist_add ();
+
+    h->pc = pager_PC;
+    h->ea = ea;
+    h->ir = inst;
+    h->ac = AC(ac);
     }
 switch (op) {                                           /* case on opcode */
 
@@ -2377,10 +2385,12 @@ hsb = (Q_ITS)? UC_HSBITS: UC_HSBDEC;                    /* set HSB */
 set_dyn_ptrs ();
 set_ac_display (ac_cur);
 pi_eval ();
-if (M == NULL)
-    M = (d10 *) calloc (MAXMEMSIZE, sizeof (d10));
-if (M == NULL)
-    return SCPE_MEM;
+if (M == NULL) {
+    M = (d10 *) sim_mem_alloc (MAXMEMSIZE * sizeof (d10));
+    if (M == NULL)
+        return SCPE_MEM;
+    cpu_unit.filebuf = M;                               /* lets SAVE skip untouched memory */
+    }
 sim_vm_pc_value = &pdp10_pc_value;
 sim_vm_is_subroutine_call = &cpu_is_pc_a_subroutine_call;
 sim_clock_precalibrate_commands = pdp10_clock_precalibrate_commands;
@@ -2391,7 +2401,8 @@ if (pcq_r)
     pcq_r->qptr = 0;
 else
     return SCPE_IERR;
-sim_brk_types = sim_brk_dflt = SWMASK ('E');
+sim_brk_dflt = SWMASK ('E');
+sim_brk_types = sim_brk_dflt | SWMASK ('R') | SWMASK ('W');
 return SCPE_OK;
 }
 
@@ -2514,76 +2525,35 @@ return;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) { /* Clear History */
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC      AC            EA      IR\n\n");
+    return;
+    }
+fprintf (st, "%06o  ", h->pc & AMASK);
+fprint_val (st, h->ac, 8, 36, PV_RZRO);
+fputs ("  ", st);
+fprintf (st, "%06o  ", h->ea);
+sim_eval[0] = h->ir;
+if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
+    fputs ("(undefined) ", st);
+    fprint_val (st, h->ir, 8, 36, PV_RZRO);
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC      AC            EA      IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        fprintf (st, "%06o  ", h->pc & AMASK);
-        fprint_val (st, h->ac, 8, 36, PV_RZRO);
-        fputs ("  ", st);
-        fprintf (st, "%06o  ", h->ea);
-        sim_eval[0] = h->ir;
-        if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0) {
-            fputs ("(undefined) ", st);
-            fprint_val (st, h->ir, 8, 36, PV_RZRO);
-            }
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
 }
 
 /* Set serial */
@@ -101,6 +101,7 @@ extern d10 ebr, ubr, hsb;
 extern d10 spt, cst, cstm, pur;
 extern a10 dbr1, dbr2, dbr3, dbr4;
 extern d10 pcst, quant;
+extern int32 cpu_brk_watch;
 extern int32 test_int (void);
 extern int32 pi_eval (void);
 
@@ -151,12 +152,18 @@ DEVICE pag_dev = {
    WriteE - write exec
    WriteP - write physical
    AccChk - test accessibility of virtual address
+
+   The virtual routines note references to data watchpoints (R and W
+   breakpoints, including memory references to 0-17 and instruction
+   fetches); the CPU stops after the instruction.
 */
 
 d10 Read (a10 ea, int32 prv)
 {
 int32 pa, vpn, xpte;
 
+if (sim_brk_watch_test (ea, SWMASK ('R')))              /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (ea < AC_NUM)                                        /* AC request */
     return (prv? ac_prv[ea]: ac_cur[ea]);
 vpn = PAG_GETVPN (ea);                                  /* get page num */
@@ -173,6 +180,8 @@ d10 ReadM (a10 ea, int32 prv)
 {
 int32 pa, vpn, xpte;
 
+if (sim_brk_watch_test (ea, SWMASK ('R')))              /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (ea < AC_NUM)                                        /* AC request */
     return (prv? ac_prv[ea]: ac_cur[ea]);
 vpn = PAG_GETVPN (ea);                                  /* get page num */
@@ -189,6 +198,8 @@ d10 ReadE (a10 ea)
 {
 int32 pa, vpn, xpte;
 
+if (sim_brk_watch_test (ea, SWMASK ('R')))              /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (ea < AC_NUM)                                        /* AC? use current */
     return AC(ea);
 if (!PAGING)                                            /* phys? no mapping */
@@ -216,6 +227,8 @@ void Write (a10 ea, d10 val, int32 prv)
 {
 int32 pa, vpn, xpte;
 
+if (sim_brk_watch_test (ea, SWMASK ('W')))              /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (ea < AC_NUM) {                                      /* AC request */
     if (prv)                                            /* write AC */
         ac_prv[ea] = val;
@@ -238,6 +251,8 @@ void WriteE (a10 ea, d10 val)
 {
 int32 pa, vpn, xpte;
 
+if (sim_brk_watch_test (ea, SWMASK ('W')))              /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (ea < AC_NUM)                                        /* AC? use current */
     AC(ea) = val;
 else if (!PAGING)                                       /* phys? no mapping */
@@ -264,7 +264,6 @@
 
 #define HIST_MIN        64
 #define HIST_MAX        (1u << 18)
-#define HIST_VLD        1                               /* make PC odd */
 #define HIST_ILNT       4                               /* max inst length */
 
 typedef struct {
@@ -320,9 +319,6 @@ uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 jmp_buf save_env;                                       /* abort handler */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 int32 dsmask[4] = { MMR3_KDS, MMR3_SDS, 0, MMR3_UDS };  /* dspace enables */
 int16 inst_pc;                                          /* PC of current instr */
 int32 inst_psw;                                         /* PSW at instr. start */
@@ -343,6 +339,7 @@ t_stat cpu_boot (int32 unitno, DEVICE *dptr);
 t_bool cpu_is_pc_a_subroutine_call (t_addr **ret_addrs);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_show_virt (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, const char *cptr);
 const char *cpu_description (DEVICE *dptr);
@@ -691,7 +688,7 @@ MTAB cpu_mod[] = {
       NULL, &show_iospace, NULL, "Show I/O space address assignments" },
     { MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &sim_set_idle, &sim_show_idle, NULL, "Enable/Display idle detection" },
     { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL, NULL, "Disable idle detection" },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Enable/Display instruction history" },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "VIRTUAL", NULL,
       NULL, &cpu_show_virt, NULL, "Display address translation" },
@@ -988,15 +985,15 @@ while (reason == 0)  {
     dstspec = IR & 077;
     srcreg = (srcspec <= 07);                           /* src, dst = rmode? */
     dstreg = (dstspec <= 07);
-    if (hst_lnt) {                                      /* record history? */
+    if (sim_hist_lnt) {                                 /* record history? */
         t_value val;
         uint32 i;
         static int32 swmap[4] = {
             SWMASK ('K') | SWMASK ('V'), SWMASK ('S') | SWMASK ('V'),
             SWMASK ('U') | SWMASK ('V'), SWMASK ('U') | SWMASK ('V')
             };
-        hst_ent = &hst[hst_p];
-        hst_ent->pc = PC | HIST_VLD;
+        hst_ent = (InstHistory *) sim_hist_add ();
+        hst_ent->pc = PC;
         hst_ent->sp = SP;
         hst_ent->psw = get_PSW ();
         hst_ent->src = 0;
@@ -1007,9 +1004,6 @@ while (reason == 0)  {
                 hst_ent->inst[i] = 0;
             else hst_ent->inst[i] = (uint16) val;
             }
-        hst_p = (hst_p + 1);
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
         }
     PC = (PC + 2) & 0177777;                            /* incr PC, mod 65k */
     switch ((IR >> 12) & 017) {                         /* decode IR<15:12> */
@@ -2643,8 +2637,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 pa = relocR (va);                                       /* relocate */
 if (BPT_SUMM_RD &&
-    (sim_brk_test (va & 0177777, BPT_RDVIR) ||
-     sim_brk_test (pa, BPT_RDPHY)))                     /* read breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RDVIR) ||
+     sim_brk_watch_test (pa, BPT_RDPHY)))               /* read breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 if (ADDR_IS_MEM (pa))                                   /* memory address? */
     return RdMemW (pa);
@@ -2670,8 +2664,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 pa = relocR (va);                                       /* relocate */
 if (BPT_SUMM_RD &&
-    (sim_brk_test (va & 0177777, BPT_RDVIR) ||
-     sim_brk_test (pa, BPT_RDPHY)))                     /* read breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RDVIR) ||
+     sim_brk_watch_test (pa, BPT_RDPHY)))               /* read breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 return PReadW (pa);
 }
@@ -2682,8 +2676,8 @@ int32 pa;
 
 pa = relocR (va);                                       /* relocate */
 if (BPT_SUMM_RD &&
-    (sim_brk_test (va & 0177777, BPT_RDVIR) ||
-     sim_brk_test (pa, BPT_RDPHY)))                     /* read breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RDVIR) ||
+     sim_brk_watch_test (pa, BPT_RDPHY)))               /* read breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 return PReadB (pa);
 }
@@ -2701,8 +2695,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 pa = relocR (va);                                       /* relocate */
 if (BPT_SUMM_RD &&
-    (sim_brk_test (va & 0177777, BPT_RDVIR) ||
-     sim_brk_test (pa, BPT_RDPHY)))                     /* read breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RDVIR) ||
+     sim_brk_watch_test (pa, BPT_RDPHY)))               /* read breakpoint? */
     reason = STOP_IBKPT;                                /* report that */
 return PReadW (pa);
 }
@@ -2715,8 +2709,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 last_pa = relocW (va);                                  /* reloc, wrt chk */
 if (BPT_SUMM_RW &&
-    (sim_brk_test (va & 0177777, BPT_RWVIR) ||
-     sim_brk_test (last_pa, BPT_RWPHY)))                /* read or write breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RWVIR) ||
+     sim_brk_watch_test (last_pa, BPT_RWPHY)))          /* read or write breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 return PReadW (last_pa);
 }
@@ -2725,8 +2719,8 @@ int32 ReadMB (int32 va)
 {
 last_pa = relocW (va);                                  /* reloc, wrt chk */
 if (BPT_SUMM_RW &&
-    (sim_brk_test (va & 0177777, BPT_RWVIR) ||
-     sim_brk_test (last_pa, BPT_RWPHY)))                /* read or write breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_RWVIR) ||
+     sim_brk_watch_test (last_pa, BPT_RWPHY)))          /* read or write breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 return PReadB (last_pa);
 }
@@ -2784,8 +2778,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 pa = relocW (va);                                       /* relocate */
 if (BPT_SUMM_WR &&
-    (sim_brk_test (va & 0177777, BPT_WRVIR) ||
-     sim_brk_test (pa, BPT_WRPHY)))                     /* write breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_WRVIR) ||
+     sim_brk_watch_test (pa, BPT_WRPHY)))               /* write breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 PWriteW (data, pa);
 }
@@ -2796,8 +2790,8 @@ int32 pa;
 
 pa = relocW (va);                                       /* relocate */
 if (BPT_SUMM_WR &&
-    (sim_brk_test (va & 0177777, BPT_WRVIR) ||
-     sim_brk_test (pa, BPT_WRPHY)))                     /* write breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_WRVIR) ||
+     sim_brk_watch_test (pa, BPT_WRPHY)))               /* write breakpoint? */
     ABORT (ABRT_BKPT);                                  /* stop simulation */
 PWriteB (data, pa);
 }
@@ -2815,8 +2809,8 @@ if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     }
 pa = relocW (va);                                       /* relocate */
 if (BPT_SUMM_WR &&
-    (sim_brk_test (va & 0177777, BPT_WRVIR) ||
-     sim_brk_test (pa, BPT_WRPHY)))                     /* write breakpoint? */
+    (sim_brk_watch_test (va & 0177777, BPT_WRVIR) ||
+     sim_brk_watch_test (pa, BPT_WRPHY)))               /* write breakpoint? */
     reason = STOP_IBKPT;                                /* report that */
 PWriteW (data, pa);
 }
@@ -3626,82 +3620,42 @@ return;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 j, k, di, lnt, ir;
-const char *cptr = (const char *) desc;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history record, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
 t_value sim_eval[HIST_ILNT];
-t_stat r;
-InstHistory *h;
+int32 j, ir;
 
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+if (h == NULL) {
+    fprintf (st, "PC     SP     PSW     src    dst     IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC     SP     PSW     src    dst     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(di++) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_VLD) {                             /* instruction? */
-        ir = h->inst[0];
-        fprintf (st, "%06o %06o %06o|", h->pc & ~HIST_VLD, h->sp, h->psw);
-        if (((ir & 0070000) != 0) ||                    /* dops, eis, fpp */
-            ((ir & 0177000) == 0004000))                /* jsr */
-            fprintf (st, "%06o %06o  ", h->src, h->dst);
-        else if ((ir >= 0000100) &&                     /* not no opnd */
-            (((ir & 0007700) <  0000300) ||             /* not branch */
-             ((ir & 0007700) >= 0004000)))
-            fprintf (st, "       %06o  ", h->dst);
-        else fprintf (st, "               ");
-        for (j = 0; j < HIST_ILNT; j++)
-            sim_eval[j] = h->inst[j];
-        if ((fprint_sym (st, h->pc & ~HIST_VLD, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %06o", h->inst[0]);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+ir = h->inst[0];
+fprintf (st, "%06o %06o %06o|", h->pc, h->sp, h->psw);
+if (((ir & 0070000) != 0) ||                            /* dops, eis, fpp */
+    ((ir & 0177000) == 0004000))                        /* jsr */
+    fprintf (st, "%06o %06o  ", h->src, h->dst);
+else if ((ir >= 0000100) &&                             /* not no opnd */
+    (((ir & 0007700) <  0000300) ||                     /* not branch */
+     ((ir & 0007700) >= 0004000)))
+    fprintf (st, "       %06o  ", h->dst);
+else fprintf (st, "               ");
+for (j = 0; j < HIST_ILNT; j++)
+    sim_eval[j] = h->inst[j];
+if ((fprint_sym (st, h->pc, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %06o", h->inst[0]);
 }
 
 /* Virtual address translation */
@@ -3789,9 +3743,16 @@ fprintf (st, "This is controlled by the SET CPU HISTORY and SHOW CPU HISTORY com
 fprintf (st, "     SET CPU HISTORY          clear history buffer\n");
 fprintf (st, "     SET CPU HISTORY=0        disable history\n");
 fprintf (st, "     SET CPU HISTORY=n        enable history, length = n\n");
+fprintf (st, "     SET CPU HISTORY=n:file   enable history, length = n, and log it to file\n");
 fprintf (st, "     SHOW CPU HISTORY         print CPU history\n");
-fprintf (st, "     SHOW CPU HISTORY=n       print first n entries of CPU history\n\n");
-fprintf (st, "The maximum length for the history is 262144 entries.\n\n");
+fprintf (st, "     SHOW CPU HISTORY=n       print last n entries of CPU history\n");
+fprintf (st, "     SHOW CPU HISTORY=file    print the history logged to file with -B\n\n");
+fprintf (st, "The maximum length for the history is 262144 entries.  The log is written\n");
+fprintf (st, "as text each time the history fills; with -O each write replaces the last.\n");
+fprintf (st, "With -B it is written in binary, in the background, and is decoded by\n");
+fprintf (st, "SHOW CPU HISTORY=file (SHOW -n CPU HISTORY=file for the last n entries);\n");
+fprintf (st, "-O then keeps only the last n entries.  With -T each entry is time\n");
+fprintf (st, "stamped.\n\n");
 
 fprintf (st, "Unibus and Qbus DMA Devices\n\n");
 fprintf (st, "DMA peripherals function differently, depending on whether the CPU type\n");
@@ -258,6 +258,10 @@ return FALSE;
 
     1. If a packet is not yet available, then the pbuf address returned is
        NULL, but success (SCPE_OK) is returned
+    2. On datagram (UDP) lines each datagram carries one message.  The
+       datagrams are taken from the line's packet queue, which reads every
+       datagram waiting on the socket at once, so a caller looping here
+       consumes all of them in a single poll rather than one per poll.
 */
 
 static t_stat ddcmp_tmxr_get_packet_ln (TMLN *lp, const uint8 **pbuf, uint16 *psize, int32 corruptrate)
@@ -266,6 +270,49 @@ int32 c;
 size_t payloadsize;
 char msg[32];
 
+if (lp->datagram && !lp->loopback) {
+    const uint8 *dbuf;
+    size_t dsize, msgsize;
+    t_stat r;
+
+    while ((SCPE_OK == (r = tmxr_get_packet_ln (lp, &dbuf, &dsize))) && (dbuf != NULL)) {
+        while ((dsize > 0) && ((*dbuf == DDCMP_SYN) || (*dbuf == DDCMP_DEL))) {
+            ++dbuf;
+            --dsize;
+            }
+        if ((dsize < DDCMP_HEADER_SIZE) ||
+            ((dbuf[0] != DDCMP_SOH) && (dbuf[0] != DDCMP_ENQ) && (dbuf[0] != DDCMP_DLE))) {
+            tmxr_debug (DDCMP_DBG_PRCV, lp, "Ignoring unexpected datagram in DDCMP mode", (char *)dbuf, dsize);
+            continue;
+            }
+        msgsize = DDCMP_HEADER_SIZE;
+        if (dbuf[0] != DDCMP_ENQ) {                     /* Data or Maintenance Message? */
+            msgsize = 10 + (((dbuf[2] & 0x3F) << 8)| dbuf[1]);
+            if (dsize < msgsize) {
+                tmxr_debug (DDCMP_DBG_PRCV, lp, "Ignoring truncated datagram in DDCMP mode", (char *)dbuf, dsize);
+                continue;
+                }
+            }
+        if (lp->rxpbsize < msgsize) {
+            lp->rxpbsize = (uint32)msgsize;
+            lp->rxpb = (uint8 *)realloc (lp->rxpb, lp->rxpbsize);
+            }
+        memcpy (lp->rxpb, dbuf, msgsize);               /* the troll may alter the message */
+        *pbuf = lp->rxpb;
+        *psize = (uint16)msgsize;
+        if (lp->mp->lines > 1)
+            sprintf (msg, "Line%d: <<< RCV Packet", (int)(lp-lp->mp->ldsc));
+        else
+            strcpy (msg, "<<< RCV Packet");
+        ddcmp_packet_trace (DDCMP_DBG_PRCV, lp->mp->dptr, msg, lp->rxpb, *psize);
+        if (ddcmp_feedCorruptionTroll (lp, lp->rxpb, TRUE, corruptrate))
+            continue;
+        return SCPE_OK;
+        }
+    *pbuf = NULL;
+    *psize = 0;
+    return r;
+    }
 while (TMXR_VALID & (c = tmxr_getc_ln (lp))) {
     c &= ~TMXR_VALID;
     if (lp->rxpboffset + 1 > lp->rxpbsize) {
@@ -378,9 +378,6 @@ int16 pcq[PCQ_SIZE] = { 0 };                            /* PC queue */
 #endif
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 
 t_bool build_dev_tab (void);
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
@@ -389,6 +386,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 void cpu_caf (void);
 void cpu_inst_hist (int32 addr, int32 inst);
 void cpu_intr_hist (int32 flag, int32 lvl);
@@ -561,7 +559,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 114688, NULL, "112K", &cpu_set_size },
     { UNIT_MSIZE, 131072, NULL, "128K", &cpu_set_size },
 #endif
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -676,7 +674,7 @@ while (reason == 0) {                                   /* loop until halted */
 
     if (api_int && !ion_defer) {                        /* API intr? */
         int32 i, lvl = api_int - 1;                     /* get req level */
-        if (hst_lnt)                                    /* record */
+        if (sim_hist_lnt)                               /* record */
             cpu_intr_hist (HIST_API, lvl);
         api_act = api_act | (API_ML0 >> lvl);           /* set level active */
         if (lvl >= API_HLVL) {                          /* software req? */
@@ -708,7 +706,7 @@ while (reason == 0) {                                   /* loop until halted */
     if (int_pend && ion && !ion_defer &&                /* int pending, enabled? */
         !(api_enb && (api_act & API_MASKPI))) {         /* API off or not masking PI? */
         PCQ_ENTRY;                                      /* save old PC */
-        if (hst_lnt)                                    /* record */
+        if (sim_hist_lnt)                               /* record */
             cpu_intr_hist (HIST_PI, 0);
         MB = Jms_word (usmd);                           /* save state */
         ion = 0;                                        /* interrupts off */
@@ -746,7 +744,7 @@ while (reason == 0) {                                   /* loop until halted */
     PC = Incr_addr (PC);                                /* increment PC */
 
     xct_instr:                                          /* label for API, XCT */
-    if (hst_lnt)                                        /* history? */
+    if (sim_hist_lnt)                                   /* history? */
         cpu_inst_hist (MA, IR);
     if (ion_defer)                                      /* count down defer */
         ion_defer = ion_defer - 1;
@@ -2319,117 +2317,73 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 l, j, k, di, lnt;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
 
-CONST char *cptr = (CONST char *) desc;
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+int32 l, j;
 t_value sim_eval[2];
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+
+if (h == NULL) {
+    fprintf (st, "PC      L AC      MQ      IR\n\n");
+    return;
+    }
+if (h->pc & HIST_PC) {                                  /* instruction? */
+    l = (h->lac >> 18) & 1;                             /* link */
+    fprintf (st, "%06o  %o %06o  %06o  ", h->pc & AMASK, l, h->lac & DMASK, h->mq);
+    sim_eval[0] = h->ir;
+    sim_eval[1] = h->ir1;
+    if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+        fprintf (st, "(undefined) %06o", h->ir);
+    }                                                   /* end else instruction */
+else if (h->pc & (HIST_API | HIST_PI)) {                /* interrupt event? */
+    if (h->pc & HIST_PI)                                /* PI? */
+        fprintf (st, "%06o  PI LVL 0-4 =", h->pc & AMASK);
+        else fprintf (st, "%06o  API %d LVL 0-4 =", h->pc & AMASK, h->mq);
+    for (j = API_HLVL; j >= 0; j--)
+        fprintf (st, " %02o", (h->ir >> (j * HIST_V_LVL)) & HIST_M_LVL);
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC      L AC      MQ      IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(di++) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        l = (h->lac >> 18) & 1;                         /* link */
-        fprintf (st, "%06o  %o %06o  %06o  ", h->pc & AMASK, l, h->lac & DMASK, h->mq);
-        sim_eval[0] = h->ir;
-        sim_eval[1] = h->ir1;
-        if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %06o", h->ir);
-        }                                               /* end else instruction */
-    else if (h->pc & (HIST_API | HIST_PI)) {            /* interrupt event? */
-        if (h->pc & HIST_PI)                            /* PI? */
-            fprintf (st, "%06o  PI LVL 0-4 =", h->pc & AMASK);
-            else fprintf (st, "%06o  API %d LVL 0-4 =", h->pc & AMASK, h->mq);
-        for (j = API_HLVL; j >= 0; j--)
-            fprintf (st, " %02o", (h->ir >> (j * HIST_V_LVL)) & HIST_M_LVL);
-        }
-    else continue;                                      /* invalid */
-    fputc ('\n', st);                                   /* end line */
-    }                                                   /* end for */
-return SCPE_OK;
 }
 
 /* Record events in history table */
 
 void cpu_inst_hist (int32 addr, int32 inst)
 {
+InstHistory *h = (InstHistory *) sim_hist_add ();
 t_value word = 0;
 
-hst[hst_p].pc = addr | HIST_PC;
-hst[hst_p].ir = inst;
+h->pc = addr | HIST_PC;
+h->ir = inst;
 if (cpu_ex (&word, (addr + 1) & AMASK, &cpu_unit, SWMASK ('V')))
-    hst[hst_p].ir1 = 0;
-else hst[hst_p].ir1 = word;
-hst[hst_p].lac = LAC;
-hst[hst_p].mq = MQ;
-hst_p = (hst_p + 1);
-if (hst_p >= hst_lnt)
-    hst_p = 0;
+    h->ir1 = 0;
+else h->ir1 = word;
+h->lac = LAC;
+h->mq = MQ;
 return;
 }
 
 void cpu_intr_hist (int32 flag, int32 lvl)
 {
+InstHistory *h = (InstHistory *) sim_hist_add ();
 int32 j;
 
-hst[hst_p].pc = PC | flag;
-hst[hst_p].ir = 0;
+h->pc = PC | flag;
+h->ir = 0;
 for (j = 0; j < API_HLVL+1; j++)
-    hst[hst_p].ir = (hst[hst_p].ir << HIST_V_LVL) | (int_hwre[j] & HIST_M_LVL);
-hst[hst_p].ir1 = 0;
-hst[hst_p].lac = 0;
-hst[hst_p].mq = lvl;
-hst_p = (hst_p + 1);
-if (hst_p >= hst_lnt)
-    hst_p = 0;
+    h->ir = (h->ir << HIST_V_LVL) | (int_hwre[j] & HIST_M_LVL);
+h->ir1 = 0;
+h->lac = 0;
+h->mq = lvl;
 return;
 }
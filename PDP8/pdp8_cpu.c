@@ -205,7 +205,6 @@
 #define UNIT_MSIZE      (1 << UNIT_V_MSIZE)
 #define OP_KSF          06031                           /* for idle */
 
-#define HIST_PC         0x40000000
 #define HIST_MIN        64
 #define HIST_MAX        65536
 
@@ -244,9 +243,6 @@ int32 int_enable = INT_INIT_ENABLE;                     /* intr enables */
 int32 int_req = 0;                                      /* intr requests */
 int32 stop_inst = 0;                                    /* trap on ill inst */
 int32 (*dev_tab[DEV_MAX])(int32 IR, int32 dat);         /* device dispatch */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat cpu_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
@@ -254,6 +250,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_bool build_dev_tab (void);
 
 /* CPU data structures
@@ -309,7 +306,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 24576, NULL, "24K", &cpu_set_size },
     { UNIT_MSIZE, 28672, NULL, "28K", &cpu_set_size },
     { UNIT_MSIZE, 32768, NULL, "32K", &cpu_set_size },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -399,16 +396,14 @@ while (reason == 0) {                                   /* loop until halted */
    Note that MA contains IF'PC.
 */
 
-    if (hst_lnt) {                                      /* history enabled? */
+    if (sim_hist_lnt) {                                 /* history enabled? */
         int32 ea;
+        InstHistory *h = (InstHistory *) sim_hist_add ();
 
-        hst_p = (hst_p + 1);                            /* next entry */
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        hst[hst_p].pc = MA | HIST_PC;                   /* save PC, IR, LAC, MQ */
-        hst[hst_p].ir = IR;
-        hst[hst_p].lac = LAC;
-        hst[hst_p].mq = MQ;
+        h->pc = MA;                                     /* save PC, IR, LAC, MQ */
+        h->ir = IR;
+        h->lac = LAC;
+        h->mq = MQ;
         if (IR < 06000) {                               /* mem ref? */
             if (IR & 0200)
                 ea = (MA & 077600) | (IR & 0177);
@@ -425,8 +420,8 @@ while (reason == 0) {                                   /* loop until halted */
                     else ea = IB | ((M[ea] + 1) & 07777);
                     }
                 }
-            hst[hst_p].ea = ea;                         /* save eff addr */
-            hst[hst_p].opnd = M[ea];                    /* save operand */
+            h->ea = ea;                                 /* save eff addr */
+            h->opnd = M[ea];                            /* save operand */
             }
         }
 
@@ -1567,75 +1562,35 @@ return FALSE;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 l, k, di, lnt;
-const char *cptr = (const char *) desc;
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+int32 l;
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC     L AC    MQ    ea     IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "PC     L AC    MQ    ea     IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        l = (h->lac >> 12) & 1;                         /* link */
-        fprintf (st, "%05o  %o %04o  %04o  ", h->pc & ADDRMASK, l, h->lac & 07777, h->mq);
-        if (h->ir < 06000)
-            fprintf (st, "%05o  ", h->ea);
-        else fprintf (st, "       ");
-        sim_eval[0] = h->ir;
-        if ((fprint_sym (st, h->pc & ADDRMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %04o", h->ir);
-        if (h->ir < 04000)
-            fprintf (st, "  [%04o]", h->opnd);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+l = (h->lac >> 12) & 1;                                 /* link */
+fprintf (st, "%05o  %o %04o  %04o  ", h->pc & ADDRMASK, l, h->lac & 07777, h->mq);
+if (h->ir < 06000)
+    fprintf (st, "%05o  ", h->ea);
+else fprintf (st, "       ");
+sim_eval[0] = h->ir;
+if ((fprint_sym (st, h->pc & ADDRMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %04o", h->ir);
+if (h->ir < 04000)
+    fprintf (st, "  [%04o]", h->opnd);
 }
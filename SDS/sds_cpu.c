@@ -150,6 +150,7 @@
 #define HIST_TRP        3                               /* trap cycle */
 #define HIST_MIN        64
 #define HIST_MAX        65536
+#define HIST_LAST       ((InstHistory *) sim_hist_last ())
 #define HIST_NOEA       0x40000000
 
 typedef struct {
@@ -193,10 +194,7 @@ int32 stop_inviop = 1;                                  /* stop inv io op */
 uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
 uint32 hst_exclude = BAD_MODE;                          /* cpu_mode excluded from history */
-InstHistory *hst = NULL;                                /* instruction history */
 int32 rtc_pie = 0;                                      /* rtc pulse ie */
 int32 rtc_tps = 60;                                     /* rtc ticks/sec */
 
@@ -208,6 +206,7 @@ t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_type (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat Ea (uint32 wd, uint32 *va);
 t_stat EaSh (uint32 wd, uint32 *va);
 t_stat Read (uint32 va, uint32 *dat);
@@ -291,7 +290,7 @@ MTAB cpu_mod[] = {
     { UNIT_MSIZE, 32768, NULL, "32K", &cpu_set_size },
     { UNIT_MSIZE, 49152, NULL, "48K", &cpu_set_size },
     { UNIT_MSIZE, 65536, NULL, "64K", &cpu_set_size },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -411,7 +410,7 @@ while (reason == 0) {                                   /* loop until halted */
         tinst = ReadP (pa);                             /* get inst */
         save_mode = cpu_mode;                           /* save mode */
         cpu_mode = MON_MODE;                            /* switch to mon */
-        if (hst_lnt)                                    /* record inst */
+        if (sim_hist_lnt)                               /* record inst */
             inst_hist (tinst, P, HIST_INT);
         if (pa != VEC_RTCP) {                           /* normal intr? */
             tr = one_inst (tinst, P, save_mode, &tmp);  /* exec intr inst */
@@ -468,7 +467,7 @@ while (reason == 0) {                                   /* loop until halted */
         P = (P + 1) & VA_MASK;                          /* incr PC */
         if (reason == SCPE_OK) {                        /* fetch ok? */
             ion_defer = 0;                              /* clear ion */
-            if (hst_lnt)
+            if (sim_hist_lnt)
                 inst_hist (C, save_P, HIST_XCT);
             reason = one_inst (C, save_P, cpu_mode, &trap_P); /* exec inst */
             Read (P, &C);
@@ -495,7 +494,7 @@ while (reason == 0) {                                   /* loop until halted */
             save_mode = cpu_mode;                       /* save mode */
             cpu_mode = MON_MODE;                        /* switch to mon */
             mon_usr_trap = 0;
-            if (hst_lnt)
+            if (sim_hist_lnt)
                 inst_hist (tinst, save_P, HIST_TRP);
             
             /* Use previously recorded trap address if memory acccess trap.
@@ -1159,8 +1158,8 @@ for (i = 0; i < ind_lim; i++) {                         /* count indirects */
         va = (va & VA_USR) | ((va + X) & VA_MASK);
     *addr = va;
     if ((wd & I_IND) == 0) {                            /* end of ind chain? */
-        if (hst_lnt)                                    /* record */
-            hst[hst_p].ea = *addr;
+        if (sim_hist_lnt)                               /* record */
+            HIST_LAST->ea = *addr;
         return SCPE_OK;
         }
     if ((r = Read (va, &wd)))                           /* read ind; fails? */
@@ -1184,8 +1183,8 @@ for (i = 0; i < ind_lim; i++) {                         /* count indirects */
         if (wd & I_IDX)                                 /* 9b indexing */
             *addr = (va & (VA_MASK & ~I_SHFMSK)) | ((va + X) & I_SHFMSK);
         else *addr = va & VA_MASK;
-        if (hst_lnt)                                    /* record */
-            hst[hst_p].ea = *addr;
+        if (sim_hist_lnt)                               /* record */
+            HIST_LAST->ea = *addr;
         return SCPE_OK;
         }
     if (wd & I_IDX)
@@ -1847,18 +1846,18 @@ return SCPE_OK;
 
 void inst_hist (uint32 c, uint32 pc, uint32 tp)
 {
+InstHistory *h;
+
 if (cpu_mode == hst_exclude)
     return;
-hst_p = (hst_p + 1);                                    /* next entry */
-if (hst_p >= hst_lnt)
-    hst_p = 0;
-hst[hst_p].typ = tp | (OV << 4) | (cpu_mode << 5);
-hst[hst_p].pc = pc;
-hst[hst_p].c = c;
-hst[hst_p].a = A;
-hst[hst_p].b = B;
-hst[hst_p].x = X;
-hst[hst_p].ea = HIST_NOEA;
+h = (InstHistory *) sim_hist_add ();                    /* next entry */
+h->typ = tp | (OV << 4) | (cpu_mode << 5);
+h->pc = pc;
+h->c = c;
+h->a = A;
+h->b = B;
+h->x = X;
+h->ea = HIST_NOEA;
 return;
 }
 
@@ -1866,21 +1865,11 @@ return;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
 t_stat r;
 
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].typ = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
+r = sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
+if ((r != SCPE_OK) || (cptr == NULL))
+    return r;
 if (sim_switches & SWMASK('M'))
     hst_exclude = MON_MODE;
 else if (sim_switches & SWMASK('N'))
@@ -1889,17 +1878,6 @@ else if (sim_switches & SWMASK('U'))
     hst_exclude = USR_MODE;
 else
     hst_exclude = BAD_MODE;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
 return SCPE_OK;
 }
 
@@ -1907,43 +1885,29 @@ return SCPE_OK;
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 ov, k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
-t_stat r;
-InstHistory *h;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+int32 ov;
 static const char *cyc[] = { "   ", "   ", "INT", "TRP" };
 static const char *modes = "NMU?";
+const InstHistory *h = (const InstHistory *) rec;
 
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+if (h == NULL) {
+    fprintf (st, "CYC PC    MD OV A        B        X        EA      C\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-fprintf (st, "CYC PC    MD OV A        B        X        EA      C\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->typ) {                                       /* instruction? */
-        ov = (h->typ >> 4) & 1;                         /* overflow */
-        fprintf (st, "%s %05o %c  %o  %08o %08o %08o ", cyc[h->typ & 3],
-            h->pc, modes[(h->typ >> 5) & 3], ov, h->a, h->b, h->x);
-        if (h->ea & HIST_NOEA)
-            fprintf (st, "      ");
-        else fprintf (st, "%05o ", h->ea);
-        sim_eval[0] = h->c;
-        if ((fprint_sym (st, h->pc, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %08o", h->c);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+ov = (h->typ >> 4) & 1;                                 /* overflow */
+fprintf (st, "%s %05o %c  %o  %08o %08o %08o ", cyc[h->typ & 3],
+    h->pc, modes[(h->typ >> 5) & 3], ov, h->a, h->b, h->x);
+if (h->ea & HIST_NOEA)
+    fprintf (st, "      ");
+else fprintf (st, "%05o ", h->ea);
+sim_eval[0] = h->c;
+if ((fprint_sym (st, h->pc, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %08o", h->c);
 }
@@ -98,6 +98,8 @@ CHANP   *find_chanp_ptr(uint16 chsa);           /* find chanp pointer */
 UNIT    *find_unit_ptr(uint16 chsa);            /* find unit pointer */
 int     chan_read_byte(uint16 chsa, uint8 *data);
 int     chan_write_byte(uint16 chsa, uint8 *data);
+int     chan_read_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt);
+int     chan_write_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt);
 void    set_devattn(uint16 chsa, uint16 flags);
 void    set_devwake(uint16 chsa, uint16 flags); /* wakeup O/S for async line */
 void    chan_end(uint16 chsa, uint16 flags);
@@ -927,6 +929,153 @@ int chan_write_byte(uint16 chsa, uint8 *data)
     return 0;
 }
 
+/* Block transfers between a device buffer and memory.
+ *
+ * chan_read_block/chan_write_block move up to len bytes with the same
+ * results as the equivalent chan_read_byte/chan_write_byte loop.  Data
+ * is copied a span at a time, where a span runs to the end of the current
+ * IOCD count or of memory.  Everything else (count exhausted, data
+ * chaining, program checks, skip and read backward) is handed to the byte
+ * routines, one byte at a time.
+ * Return 0 if all len bytes were moved.
+ * Return 1 on the same condition the byte routine would have returned 1,
+ * with *cnt set to the number of bytes moved before it.
+ */
+
+/* copy cnt bytes from memory at addr to buf */
+static void chan_get_mem(uint32 addr, uint8 *buf, uint32 cnt)
+{
+    uint32  w;
+
+    while (cnt && (addr & 3)) {                 /* leading bytes */
+        *buf++ = RMB(addr);
+        addr++;
+        cnt--;
+    }
+    while (cnt >= 4) {                          /* whole words */
+        w = M[addr>>2];
+        buf[0] = (uint8)(w >> 24);
+        buf[1] = (uint8)(w >> 16);
+        buf[2] = (uint8)(w >> 8);
+        buf[3] = (uint8)w;
+        buf += 4;
+        addr += 4;
+        cnt -= 4;
+    }
+    while (cnt) {                               /* trailing bytes */
+        *buf++ = RMB(addr);
+        addr++;
+        cnt--;
+    }
+}
+
+/* copy cnt bytes from buf to memory at addr */
+static void chan_put_mem(uint32 addr, uint8 *buf, uint32 cnt)
+{
+    while (cnt && (addr & 3)) {                 /* leading bytes */
+        WMB(addr, *buf);
+        buf++;
+        addr++;
+        cnt--;
+    }
+    while (cnt >= 4) {                          /* whole words */
+        M[addr>>2] = ((uint32)buf[0] << 24) | ((uint32)buf[1] << 16) |
+            ((uint32)buf[2] << 8) | (uint32)buf[3];
+        buf += 4;
+        addr += 4;
+        cnt -= 4;
+    }
+    while (cnt) {                               /* trailing bytes */
+        WMB(addr, *buf);
+        buf++;
+        addr++;
+        cnt--;
+    }
+}
+
+/* return number of bytes that can be copied at the current ccw address */
+static uint32 chan_span(CHANP *chp, uint32 len)
+{
+    uint32  addr = chp->ccw_addr & MASK24;      /* channel buffer address */
+    uint32  span = chp->ccw_count;              /* bytes left in this IOCD */
+
+    if ((chp->chan_status & STATUS_ERROR) ||    /* channel error */
+        (chp->chan_byte == BUFF_CHNEND) ||      /* or end of data */
+        !MEM_ADDR_OK(addr))                     /* or bad address */
+        return 0;                               /* let byte routine handle it */
+    if (span > len)
+        span = len;                             /* no more than requested */
+    if (span > (MEMSIZE - addr))
+        span = MEMSIZE - addr;                  /* stop at end of memory */
+    return span;
+}
+
+/* read block from memory */
+/* write to device */
+int chan_read_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt)
+{
+    CHANP   *chp = find_chanp_ptr(chsa);        /* get channel prog pointer */
+    uint32  n = 0;
+    uint32  span;
+
+    while (n < len) {
+        span = chan_span(chp, len - n);         /* get contiguous span */
+        if (span == 0) {                        /* iocd boundary or error */
+            if (chan_read_byte(chsa, &buf[n])) {
+                *cnt = n;                       /* bytes transferred */
+                return 1;                       /* return error */
+            }
+            n++;
+            continue;
+        }
+        chan_get_mem(chp->ccw_addr & MASK24, &buf[n], span);
+        sim_debug(DEBUG_DATA, &cpu_dev,
+            "chan_read_block transferred %04x bytes from %06x\n",
+            span, chp->ccw_addr & MASK24);
+        chp->ccw_addr += span;                  /* next byte address */
+        chp->ccw_count -= span;                 /* chars less to process */
+        n += span;
+    }
+    *cnt = n;                                   /* bytes transferred */
+    return 0;                                   /* good return */
+}
+
+/* write block to memory */
+/* read from device */
+int chan_write_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt)
+{
+    CHANP   *chp = find_chanp_ptr(chsa);        /* get channel prog pointer */
+    uint32  n = 0;
+    uint32  span;
+
+    while (n < len) {
+        span = 0;
+        if ((chp->ccw_cmd & 0xff) != CMD_RDBWD) /* backward is done by bytes */
+            span = chan_span(chp, len - n);     /* get contiguous span */
+        if (span == 0) {                        /* iocd boundary or error */
+            if (chan_write_byte(chsa, &buf[n])) {
+                *cnt = n;                       /* bytes transferred */
+                return 1;                       /* return error */
+            }
+            n++;
+            continue;
+        }
+        /* see if we want to skip writing data to memory */
+        if ((chp->ccw_flags & FLAG_SKIP) == 0) {
+            chan_put_mem(chp->ccw_addr & MASK24, &buf[n], span);
+            sim_debug(DEBUG_DATA, &cpu_dev,
+                "chan_write_block transferred %04x bytes to %06x\n",
+                span, chp->ccw_addr & MASK24);
+        }
+        chp->ccw_addr += span;                  /* next byte address */
+        chp->ccw_count -= span;                 /* reduce count */
+        chp->chan_byte = BUFF_BUSY;             /* busy, but no data */
+        n += span;
+    }
+    *cnt = n;                                   /* bytes transferred */
+    return 0;                                   /* good return */
+}
+
 /* post wakeup interrupt for specified async line */
 void set_devwake(uint16 chsa, uint16 flags)
 {
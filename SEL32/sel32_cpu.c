@@ -177,6 +177,7 @@ t_stat cpu_reset(DEVICE * dptr);
 t_stat cpu_set_size(UNIT * uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist(FILE * st, UNIT * uptr, int32 val, CONST void *desc);
 t_stat cpu_set_hist(UNIT * uptr, int32 val, CONST char *cptr, void *desc);
+void cpu_fprint_hist(FILE * st, const void *rec, t_bool timed);
 uint32 cpu_cmd(UNIT * uptr, uint16 cmd, uint16 dev);
 t_stat cpu_help (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, const char *cptr);
 const char *cpu_description (DEVICE *dptr);
@@ -226,9 +227,7 @@ extern uint32   s_normfw(uint32 mem, uint32 *cc);
 extern t_uint64 s_normfd(t_uint64 mem, uint32 *cc);
 
 /* History information */
-int32           hst_p = 0;                  /* History pointer */
-int32           hst_lnt = 0;                /* History length */
-struct InstHistory *hst = NULL;             /* History stack */
+#define HIST_LAST   ((struct InstHistory *)sim_hist_last())     /* Latest history entry */
 
 /* CPU data structures
 
@@ -336,7 +335,7 @@ MTAB cpu_mod[] = {
     {UNIT_MSIZE, MEMAMOUNT(10),  NULL,  "16M", &cpu_set_size},
     {MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &sim_set_idle, &sim_show_idle},
     {MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL},
-    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP, 0, "HISTORY", "HISTORY",
+    {MTAB_XTD | MTAB_VDV | MTAB_NMO | MTAB_SHP | MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
         &cpu_set_hist, &cpu_show_hist},
     {0}
 };
@@ -2188,13 +2187,12 @@ exec:
             PC, PSD1, PSD2, IR, drop_nop);
 
         /* Update history for this instruction */
-        if (hst_lnt) {
-            hst_p += 1;                             /* next history location */
-            if (hst_p >= hst_lnt)                   /* check for wrap */
-                hst_p = 0;                          /* start over at beginning */
-            hst[hst_p].opsd1 = OPSD1;               /* set original psd1 */ 
-            hst[hst_p].opsd2 = OPSD2;               /* set original psd2 */ 
-            hst[hst_p].oir = OIR;                   /* set original instruction */ 
+        if (sim_hist_lnt) {
+            struct InstHistory *h = (struct InstHistory *)sim_hist_add();   /* next history location */
+
+            h->opsd1 = OPSD1;                       /* set original psd1 */ 
+            h->opsd2 = OPSD2;                       /* set original psd2 */ 
+            h->oir = OIR;                           /* set original instruction */ 
         }
 
         opr = (IR >> 16) & MASK16;                  /* use upper half of instruction */
@@ -5034,15 +5032,15 @@ meoa:       /* merge point for eor, and, or */
             OPSD1 &= 0x87FFFFFE;                    /* clear the old PSD CC's */
             OPSD1 |= PSD1 & 0x78000000;             /* update the CC's in the old PSD */
             /* TODO Update other history information for this instruction */
-            if (hst_lnt) {
-                hst[hst_p].opsd1 = OPSD1;           /* update the CC in opsd1 */
-                hst[hst_p].npsd1 = PSD1;            /* save new psd1 */
-                hst[hst_p].npsd2 = PSD2;            /* save new psd2 */
-                hst[hst_p].modes = MODES;           /* save current mode bits */
-                hst[hst_p].modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
+            if (sim_hist_lnt) {
+                HIST_LAST->opsd1 = OPSD1;           /* update the CC in opsd1 */
+                HIST_LAST->npsd1 = PSD1;            /* save new psd1 */
+                HIST_LAST->npsd2 = PSD2;            /* save new psd2 */
+                HIST_LAST->modes = MODES;           /* save current mode bits */
+                HIST_LAST->modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
                 for (ix=0; ix<8; ix++) {
-                    hst[hst_p].reg[ix] = GPR[ix];   /* save reg */
-                    hst[hst_p].reg[ix+8] = BR[ix];  /* save breg */
+                    HIST_LAST->reg[ix] = GPR[ix];   /* save reg */
+                    HIST_LAST->reg[ix+8] = BR[ix];  /* save breg */
                 }
             }
 
@@ -5529,15 +5527,15 @@ skipdqe2:
                 OPSD1 &= 0x87FFFFFE;                /* clear the old CC's */
                 OPSD1 |= PSD1 & 0x78000000;         /* update the CC's in the PSD */
                 /* TODO Update other history information for this instruction */
-                if (hst_lnt) {
-                    hst[hst_p].opsd1 = OPSD1;       /* update the CC in opsd1 */
-                    hst[hst_p].npsd1 = PSD1;        /* save new psd1 */
-                    hst[hst_p].npsd2 = PSD2;        /* save new psd2 */
-                    hst[hst_p].modes = MODES;       /* save current mode bits */
-                    hst[hst_p].modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
+                if (sim_hist_lnt) {
+                    HIST_LAST->opsd1 = OPSD1;       /* update the CC in opsd1 */
+                    HIST_LAST->npsd1 = PSD1;        /* save new psd1 */
+                    HIST_LAST->npsd2 = PSD2;        /* save new psd2 */
+                    HIST_LAST->modes = MODES;       /* save current mode bits */
+                    HIST_LAST->modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
                     for (ix=0; ix<8; ix++) {
-                        hst[hst_p].reg[ix] = GPR[ix];   /* save reg */
-                        hst[hst_p].reg[ix+8] = BR[ix];  /* save breg */
+                        HIST_LAST->reg[ix] = GPR[ix];   /* save reg */
+                        HIST_LAST->reg[ix+8] = BR[ix];  /* save breg */
                     }
                 }
                 /* DEBUG_INST support code */
@@ -7018,15 +7016,15 @@ mcheck:
         OPSD1 &= 0x87FFFFFE;                        /* clear the old CC's */
         OPSD1 |= PSD1 & 0x78000000;                 /* update the CC's in the PSD */
         /* TODO Update other history information for this instruction */
-        if (hst_lnt) {
-            hst[hst_p].opsd1 = OPSD1;               /* update the CC in opsd1 */
-            hst[hst_p].npsd1 = PSD1;                /* save new psd1 */
-            hst[hst_p].npsd2 = PSD2;                /* save new psd2 */
-            hst[hst_p].modes = MODES;               /* save current mode bits */
-            hst[hst_p].modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
+        if (sim_hist_lnt) {
+            HIST_LAST->opsd1 = OPSD1;               /* update the CC in opsd1 */
+            HIST_LAST->npsd1 = PSD1;                /* save new psd1 */
+            HIST_LAST->npsd2 = PSD2;                /* save new psd2 */
+            HIST_LAST->modes = MODES;               /* save current mode bits */
+            HIST_LAST->modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
             for (ix=0; ix<8; ix++) {
-                hst[hst_p].reg[ix] = GPR[ix];       /* save reg */
-                hst[hst_p].reg[ix+8] = BR[ix];      /* save breg */
+                HIST_LAST->reg[ix] = GPR[ix];       /* save reg */
+                HIST_LAST->reg[ix+8] = BR[ix];      /* save breg */
             }
         }
 
@@ -7303,15 +7301,15 @@ newpsd:
         OPSD1 &= 0x87FFFFFF;                        /* clear the old CC's */
         OPSD1 |= PSD1 & 0x78000000;                 /* update the CC's in the PSD */
         /* Update other history information for this instruction */
-        if (hst_lnt) {
-            hst[hst_p].opsd1 = OPSD1;               /* update the CC in opsd1 */
-            hst[hst_p].npsd1 = PSD1;                /* save new psd1 */
-            hst[hst_p].npsd2 = PSD2;                /* save new psd2 */
-            hst[hst_p].modes = MODES;               /* save current mode bits */
-            hst[hst_p].modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
+        if (sim_hist_lnt) {
+            HIST_LAST->opsd1 = OPSD1;               /* update the CC in opsd1 */
+            HIST_LAST->npsd1 = PSD1;                /* save new psd1 */
+            HIST_LAST->npsd2 = PSD2;                /* save new psd2 */
+            HIST_LAST->modes = MODES;               /* save current mode bits */
+            HIST_LAST->modes |= (CPUSTATUS & BIT24);    /* save blocking mode bit */
             for (ix=0; ix<8; ix++) {
-                hst[hst_p].reg[ix] = GPR[ix];       /* save reg */
-                hst[hst_p].reg[ix+8] = BR[ix];      /* save breg */
+                HIST_LAST->reg[ix] = GPR[ix];       /* save reg */
+                HIST_LAST->reg[ix+8] = BR[ix];      /* save breg */
             }
         }
 
@@ -7537,91 +7535,49 @@ t_stat cpu_set_size(UNIT *uptr, int32 sval, CONST char *cptr, void *desc)
 t_stat
 cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int32               i, lnt;
-    t_stat              r;
-
-    if (cptr == NULL) {                             /* check for any user options */
-        for (i = 0; i < hst_lnt; i++)               /* none, so just zero the history */
-            hst[i].opsd1 = 0;                       /* just psd1 for now */
-        hst_p = 0;                                  /* start at the beginning */
-        return SCPE_OK;                             /* all OK */
-    }
-    /* the user has specified options, process them */
-    lnt = (int32)get_uint(cptr, 10, HIST_MAX, &r);
-    if (r != SCPE_OK)
-        return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-    if (lnt && (lnt < HIST_MIN))
-        return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;                                      /* start at beginning */
-    if (hst_lnt) {                                  /* if a new length was input, resize history buffer */
-        free(hst);                                  /* out with the old */
-        hst_lnt = 0;                                /* no length anymore */
-        hst = NULL;                                 /* and no pointer either */
-    }
-    if (lnt) {                                      /* see if new size specified, if so get new resized bfer */
-        hst = (struct InstHistory *)calloc(sizeof(struct InstHistory), lnt);
-        if (hst == NULL)
-            return SCPE_MEM;                        /* allocation error, so tell user */
-        hst_lnt = lnt;                              /* set new length */
-    }
-    return SCPE_OK;                                 /* we are good to go */
+    return sim_hist_set(&cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 t_stat cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-    int32               k, di, lnt;
-    char               *cptr = (char *) desc;
-    t_stat              r;
+    return sim_hist_show(st, &cpu_dev, sizeof(struct InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry */
+void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed)
+{
     uint8               BM, MM, BK;                 /* basemode, mapped mode, blocked mode */
-    struct InstHistory *h;
-
-    if (hst_lnt == 0)                               /* see if show history is enabled */
-        return SCPE_NOFNC;                          /* no, so we are out of here */
-    if (cptr) {                                     /* see if user provided a display count */
-        lnt = (int32)get_uint(cptr, 10, hst_lnt, &r);   /* get the count */
-        if ((r != SCPE_OK) || (lnt == 0))           /* if error or 0 count */
-            return SCPE_ARG;                        /* report argument error */
-    } else
-        lnt = hst_lnt;                              /* dump all the entries */
-    di = hst_p - lnt;                               /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;                          /* wrap */
-    for (k = 0; k < lnt; k++) {                     /* print specified entries */
-        if (stop_cpu) {                             /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                                  /* abandon remaining output */
-        }
-        h = &hst[(++di) % hst_lnt];                 /* entry pointer */
-        /* display the instruction and results */
-        if (MODES & BASEBIT)
-            BM = 'B';
-        else
-            BM = 'N';
-        if (MODES & MAPMODE)
-            MM = 'M';
-        else
-            MM = 'U';
-        if (MODES & 0x80)                           /* get blocked bit */
-            BK = 'B';
-        else
-            BK = 'U';
-        fprintf(st, "%c%c%c %.8x %.8x %.8x ", BM, MM, BK, h->opsd1, h->npsd2, h->oir);
-        if (h->modes & BASEBIT)
-            fprint_inst(st, h->oir, SWMASK('M'));   /* display basemode instruction */
-        else
-            fprint_inst(st, h->oir, SWMASK('N'));   /* display non basemode instruction */
-        fprintf(st, "\n");
-        fprintf(st, "\tR0=%.8x R1=%.8x R2=%.8x R3=%.8x", h->reg[0], h->reg[1], h->reg[2], h->reg[3]);
-        fprintf(st, " R4=%.8x R5=%.8x R6=%.8x R7=%.8x", h->reg[4], h->reg[5], h->reg[6], h->reg[7]);
-        if (h->modes & BASEBIT) {
-            fprintf(st, "\n");
-            fprintf(st, "\tB0=%.8x B1=%.8x B2=%.8x B3=%.8x", h->reg[8], h->reg[9], h->reg[10], h->reg[11]);
-            fprintf(st, " B4=%.8x B5=%.8x B6=%.8x B7=%.8x", h->reg[12], h->reg[13], h->reg[14], h->reg[15]);
-        }
+    const struct InstHistory *h = (const struct InstHistory *) rec;
+
+    if (h == NULL)                                  /* no column headings */
+        return;
+    /* display the instruction and results */
+    if (MODES & BASEBIT)
+        BM = 'B';
+    else
+        BM = 'N';
+    if (MODES & MAPMODE)
+        MM = 'M';
+    else
+        MM = 'U';
+    if (MODES & 0x80)                           /* get blocked bit */
+        BK = 'B';
+    else
+        BK = 'U';
+    fprintf(st, "%c%c%c %.8x %.8x %.8x ", BM, MM, BK, h->opsd1, h->npsd2, h->oir);
+    if (h->modes & BASEBIT)
+        fprint_inst(st, h->oir, SWMASK('M'));   /* display basemode instruction */
+    else
+        fprint_inst(st, h->oir, SWMASK('N'));   /* display non basemode instruction */
+    fprintf(st, "\n");
+    fprintf(st, "\tR0=%.8x R1=%.8x R2=%.8x R3=%.8x", h->reg[0], h->reg[1], h->reg[2], h->reg[3]);
+    fprintf(st, " R4=%.8x R5=%.8x R6=%.8x R7=%.8x", h->reg[4], h->reg[5], h->reg[6], h->reg[7]);
+    if (h->modes & BASEBIT) {
         fprintf(st, "\n");
-    }                                               /* end for */
-    return SCPE_OK;                                 /* all is good */
+        fprintf(st, "\tB0=%.8x B1=%.8x B2=%.8x B3=%.8x", h->reg[8], h->reg[9], h->reg[10], h->reg[11]);
+        fprintf(st, " B4=%.8x B5=%.8x B6=%.8x B7=%.8x", h->reg[12], h->reg[13], h->reg[14], h->reg[15]);
+    }
 }
 
 /* return description for the specified device */
@@ -509,6 +509,8 @@ extern  t_stat  show_dev_addr(FILE * st, UNIT *uptr, int32 v, CONST void *desc);
 extern  void    chan_end(uint16 chan, uint16 flags);
 extern  int     chan_read_byte(uint16 chsa, uint8 *data);
 extern  int     chan_write_byte(uint16 chsa, uint8 *data);
+extern  int     chan_read_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt);
+extern  int     chan_write_block(uint16 chsa, uint8 *buf, uint32 len, uint32 *cnt);
 extern  void    set_devattn(uint16 addr, uint16 flags);
 extern  void    set_devwake(uint16 chsa, uint16 flags);
 extern  t_stat  chan_boot(uint16 addr, DEVICE *dptr);
@@ -1254,6 +1254,7 @@ t_stat hsdp_srv(UNIT *uptr)
     int             len = chp->ccw_count;
     int             i,j,k;
     uint32          mema, ecc, cecc, tstar;         /* memory address */
+    uint32          cnt;                            /* bytes moved by channel */
     uint8           ch;
     uint16          ssize = hsdp_type[type].ssiz * 4;   /* disk sector size in bytes */
     uint32          tstart;
@@ -2068,22 +2069,19 @@ iha_error:
 
             uptr->CHS++;                        /* next sector number */
             /* process the next sector of data */
-            for (i=0; i<len; i++) {
-                ch = buf[i];                    /* get a char from buffer */
-                if (chan_write_byte(chsa, &ch)) {   /* put a byte to memory */
-                    if (chp->chan_status & STATUS_PCHK) /* test for memory error */
-                        uptr->SNS |= SNS_INAD;  /* invalid address */
-                    sim_debug(DEBUG_CMD, dptr,
-                        "HSDP Read %04x bytes leaving %04x from diskfile /%04x/%02x/%02x\n",
-                        i, chp->ccw_count, ((uptr->CHS)>>16)&0xffff,
-                        ((uptr->CHS)>>8)&0xff, (uptr->CHS)&0xff);
-                    uptr->CMD &= LMASK;         /* remove old status bits & cmd */
-                    if (chp->chan_status & STATUS_PCHK) /* test for memory error */
-                        chan_end(chsa, SNS_CHNEND|SNS_DEVEND|STATUS_PCHK);
-                    else
-                        chan_end(chsa, SNS_CHNEND|SNS_DEVEND);
-                    return SCPE_OK;
-                }
+            if (chan_write_block(chsa, buf, len, &cnt)) {   /* put sector to memory */
+                if (chp->chan_status & STATUS_PCHK) /* test for memory error */
+                    uptr->SNS |= SNS_INAD;      /* invalid address */
+                sim_debug(DEBUG_CMD, dptr,
+                    "HSDP Read %04x bytes leaving %04x from diskfile /%04x/%02x/%02x\n",
+                    cnt, chp->ccw_count, ((uptr->CHS)>>16)&0xffff,
+                    ((uptr->CHS)>>8)&0xff, (uptr->CHS)&0xff);
+                uptr->CMD &= LMASK;             /* remove old status bits & cmd */
+                if (chp->chan_status & STATUS_PCHK) /* test for memory error */
+                    chan_end(chsa, SNS_CHNEND|SNS_DEVEND|STATUS_PCHK);
+                else
+                    chan_end(chsa, SNS_CHNEND|SNS_DEVEND);
+                return SCPE_OK;
             }
 
             /* get current sector offset */
@@ -2266,26 +2264,24 @@ iha_error:
 
             /* process the next sector of data */
             tcyl = 0;                           /* used here as a flag for short read */
-            for (i=0; i<ssize; i++) {
-                if (chan_read_byte(chsa, &ch)) {    /* get a byte from memory */
+            if (chan_read_block(chsa, buf2, ssize, &cnt)) { /* get sector from memory */
+                if (chp->chan_status & STATUS_PCHK) /* test for memory error */
+                    uptr->SNS |= SNS_INAD;      /* invalid address */
+                /* if error on reading 1st byte, we are done writing */
+                if ((cnt == 0) || (chp->chan_status & STATUS_PCHK)) {
+                    uptr->CMD &= LMASK;         /* remove old status bits & cmd */
+                    sim_debug(DEBUG_CMD, dptr,
+                        "HSDP Wrote %04x bytes to diskfile cyl %04x hds %02x sec %02x\n",
+                        ssize, STAR2CYL(uptr->CHS), ((uptr->CHS) >> 8)&0xff, (uptr->CHS&0xff));
                     if (chp->chan_status & STATUS_PCHK) /* test for memory error */
-                        uptr->SNS |= SNS_INAD;  /* invalid address */
-                    /* if error on reading 1st byte, we are done writing */
-                    if ((i == 0) || (chp->chan_status & STATUS_PCHK)) {
-                        uptr->CMD &= LMASK;     /* remove old status bits & cmd */
-                        sim_debug(DEBUG_CMD, dptr,
-                            "HSDP Wrote %04x bytes to diskfile cyl %04x hds %02x sec %02x\n",
-                            ssize, STAR2CYL(uptr->CHS), ((uptr->CHS) >> 8)&0xff, (uptr->CHS&0xff));
-                        if (chp->chan_status & STATUS_PCHK) /* test for memory error */
-                            chan_end(chsa, SNS_CHNEND|SNS_DEVEND|STATUS_PCHK);
-                        else
-                            chan_end(chsa, SNS_CHNEND|SNS_DEVEND);
-                        return SCPE_OK;
-                    }
-                    ch = 0;                     /* finish out the sector with zero */
-                    tcyl++;                     /* show we have no more data to write */
+                        chan_end(chsa, SNS_CHNEND|SNS_DEVEND|STATUS_PCHK);
+                    else
+                        chan_end(chsa, SNS_CHNEND|SNS_DEVEND);
+                    return SCPE_OK;
                 }
-                buf2[i] = ch;                   /* save the char */
+                for (i=cnt; i<ssize; i++)
+                    buf2[i] = 0;                /* finish out the sector with zero */
+                tcyl++;                         /* show we have no more data to write */
             }
 
             /* get file offset in sectors */
@@ -819,6 +819,7 @@ t_stat mt_srv(UNIT *uptr)
     int         i;
     char        *bufp;
     uint32      mema, m, skip;
+    uint32      cnt;                        /* bytes moved by channel */
     uint16      len;
     uint8       ch;
 
@@ -1020,6 +1021,13 @@ reread:
             bufp = dump_mem(m+32, 16);
             sim_debug(DEBUG_CMD, dptr, "mt_srv READ mem %s\n", bufp);
         }
+        /* move all but the last char of the record in one transfer */
+        /* an error here is seen again for the same char below */
+        if ((uint32)uptr->POS + 1 < uptr->hwmark) {
+            chan_write_block(chsa, &mt_buffer[bufnum][uptr->POS],
+                uptr->hwmark - uptr->POS - 1, &cnt);
+            uptr->POS += cnt;               /* chars sent to memory */
+        }
         /* get a char from the buffer */
         ch = mt_buffer[bufnum][uptr->POS++];
 
@@ -1075,6 +1083,16 @@ reread:
             break;
         }
 
+        /* Grab what the channel has in one transfer */
+        /* the end or error is seen again below */
+        if ((uint32)uptr->POS < BUFFSIZE) {
+            chan_read_block(chsa, &mt_buffer[bufnum][uptr->POS],
+                BUFFSIZE - uptr->POS, &cnt);
+            if (cnt != 0) {
+                uptr->POS += cnt;           /* chars read in */
+                uptr->hwmark = uptr->POS;   /* set high water mark */
+            }
+        }
 rewrite:
         /* Grab data until channel has no more */
         if (chan_read_byte(chsa, &ch)) {
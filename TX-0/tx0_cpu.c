@@ -233,7 +233,6 @@ See TX-0 memo M-5001-19 for a simple formula for cry, used in the code below.
 
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 
-#define HIST_PC         0x40000000
 #define HIST_V_SHF      18
 #define HIST_MIN        64
 #define HIST_MAX        65536
@@ -272,9 +271,6 @@ int32 mode_rdin = 1;                                    /* Read-In Mode Flip-flo
 uint16 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* inst history */
 
 int32 fpc_MA;                                           /* shadow ma for FPC access */
 int32 fpc_OP;                                           /* shadow op for FPC access */
@@ -291,6 +287,7 @@ static t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 static t_stat cpu_set_ext (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 static t_stat cpu_set_noext (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 static t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat Read (void);
 t_stat Write (void);
 
@@ -347,7 +344,7 @@ MTAB cpu_mod[] = {
     { UNIT_MODE, 0, "NORMAL", "NORMAL", &cpu_set_mode },
     { UNIT_MODE, UNIT_MODE_TEST, "TEST", "TEST", &cpu_set_mode },
     { UNIT_MODE, UNIT_MODE_READIN, "READIN", "READIN", &cpu_set_mode }, 
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -548,12 +545,12 @@ t_stat sim_instr (void)
             MAR = MBR & YMASK; /* 13-bit address field */
         }
 
-        if (hst_lnt) {                                      /* history enabled? */
-            hst_p = (hst_p + 1);                            /* next entry */
-            if (hst_p >= hst_lnt) hst_p = 0;
-            hst[hst_p].pc = MAR | HIST_PC;                   /* save state */
-            hst[hst_p].ir = IR;
-            hst[hst_p].ovac = (OV << HIST_V_SHF) | AC;
+        if (sim_hist_lnt) {                                 /* history enabled? */
+            InstHistory *h = (InstHistory *) sim_hist_add ();
+
+            h->pc = MAR;                                    /* save state */
+            h->ir = IR;
+            h->ovac = (OV << HIST_V_SHF) | AC;
         }
 
         PC = INCR_ADDR (PC);                                /* increment PC */
@@ -1131,76 +1128,40 @@ int32 cpu_get_mode (void)
 
 static t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++) hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL) return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 static t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 ov, pf, op, k, di, lnt;
-const char *cptr = (const char *) desc;
-t_stat r;
-InstHistory *h;
-
-if (hst_lnt == 0) return SCPE_NOFNC;                    /* enabled? */
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+int32 ov, pf, op;
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC      OV AC     IO      PF EA      IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0) di = di + hst_lnt;
-fprintf (st, "PC      OV AC     IO      PF EA      IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        ov = (h->ovac >> HIST_V_SHF) & 1;               /* overflow */
-        pf = 0;
-        op = ((h->ir >> 13) & 037);                     /* get opcode */
-        fprintf (st, "%06o  %o  %06o %06o %03o ",
-            h->pc & AMASK, ov, h->ovac & DMASK, h->pfio & DMASK, pf);
-        if ((op < 032) && (op != 007))                  /* mem ref instr */
-            fprintf (st, "%06o  ", h->ea);
-        else fprintf (st, "        ");
-        sim_eval[0] = h->ir;
-        if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %06o", h->ir);
-        else if (op < 030)                              /* mem ref instr */
-            fprintf (st, " [%06o]", h->opnd);
-        fputc ('\n', st);                               /* end line */
-        }                                               /* end else instruction */
-    }                                                   /* end for */
-return SCPE_OK;
+ov = (h->ovac >> HIST_V_SHF) & 1;                       /* overflow */
+pf = 0;
+op = ((h->ir >> 13) & 037);                             /* get opcode */
+fprintf (st, "%06o  %o  %06o %06o %03o ",
+    h->pc & AMASK, ov, h->ovac & DMASK, h->pfio & DMASK, pf);
+if ((op < 032) && (op != 007))                          /* mem ref instr */
+    fprintf (st, "%06o  ", h->ea);
+else fprintf (st, "        ");
+sim_eval[0] = h->ir;
+if ((fprint_sym (st, h->pc & AMASK, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
+    fprintf (st, "(undefined) %06o", h->ir);
+else if (op < 030)                                      /* mem ref instr */
+    fprintf (st, " [%06o]", h->opnd);
 }
 
 #ifdef USE_DISPLAY
@@ -265,6 +265,7 @@ int32 badabo = 0;
 int32 cpu_instruction_set = CPU_INSTRUCTION_SET;        /* Instruction Groups  */
 int32 cpu_astop = 0;
 int32 mchk_va, mchk_ref;                                /* mem ref param */
+int32 cpu_brk_watch = 0;                                /* data watchpoint hit */
 int32 ibufl, ibufh;                                     /* prefetch buf */
 int32 ibcnt, ppc;                                       /* prefetch ctl */
 uint32 cpu_idle_mask =                                  /* idle mask */
@@ -279,12 +280,6 @@ int32 extra_bytes;                                      /* bytes referenced by c
 jmp_buf save_env;
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 int32 pcq[PCQ_SIZE] = { 0 };                            /* PC queue */
-InstHistory *hst = NULL;                                /* instruction history */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-int32 hst_switches;                                     /* history option switches */
-FILE *hst_log;                                          /* history log file */
-int32 hst_log_p;                                        /* history last log written pointer */
 int32 step_out_nest_level = 0;                          /* step to call return - nest level */
 
 const uint32 byte_mask[33] = { 0x00000000,
@@ -331,8 +326,8 @@ const char *cpu_description (DEVICE *dptr);
 int32 cpu_get_vsw (int32 sw);
 static SIM_INLINE int32 get_istr (int32 lnt, int32 acc);
 int32 ReadOcta (int32 va, int32 *opnd, int32 j, int32 acc);
-t_bool cpu_show_opnd (FILE *st, InstHistory *h, int32 line);
-t_stat cpu_show_hist_records (FILE *st, t_bool do_header, int32 start, int32 count);
+t_bool cpu_show_opnd (FILE *st, const InstHistory *h, int32 line, t_bool timed);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 int32 cpu_emulate_exception (int32 *opnd, int32 cc, int32 opc, int32 acc);
 void cpu_idle (void);
 
@@ -433,10 +428,22 @@ MTAB cpu_mod[] = {
     { MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE{=VMS|ULTRIX|ULTRIX-1.X|ULTRIXOLD|NETBSD|NETBSDOLD|OPENBSD|OPENBSDOLD|QUASIJARUS|32V|ELN|MDM|INFOSERVER}{:n}", &cpu_set_idle, &cpu_show_idle, NULL, "Display idle detection mode" },
     { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL, NULL,  "Disables idle detection" },
     MEM_MODIFIERS,   /* Model specific memory modifiers from vaxXXX_defs.h */
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n",
+    { MTAB_XTD|MTAB_VDV, 1, "FP", "HOSTFP",
+      &fp_set_host, &fp_show_host, NULL, "Use the host FPU for F and G floating arithmetic" },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NOHOSTFP",
+      &fp_set_host, NULL, NULL, "Use only the simulated FPU" },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, NULL, "FPTEST{=n}",
+      &fp_set_test, NULL, NULL, "Compare host and simulated FPU results" },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Enable/Display instruction history" },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "VIRTUAL", NULL,
       NULL, &cpu_show_virt, NULL, "show translation for address arg in KESU mode" },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 0, "MEMBACKING", "MEMBACKING=HUGE|NORMAL",
+      &sim_set_mem_backing, &sim_show_mem_backing, NULL, "Set/Display host pages backing memory" },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 1, "NUMANODE", "NUMANODE=n",
+      &sim_set_numa_node, &sim_show_numa_node, NULL, "Bind memory and simulator to a NUMA node" },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NONUMANODE",
+      &sim_set_numa_node, NULL, NULL, "Remove NUMA node binding" },
     CPU_MODEL_MODIFIERS  /* Model specific cpu modifiers from vaxXXX_defs.h */
     CPU_INST_MODIFIERS   /* Model specific cpu instruction modifiers from vaxXXX_defs.h */
     { 0 }
@@ -516,15 +523,12 @@ set_map_reg ();                                         /* set map reg */
 GET_CUR;                                                /* set access mask */
 SET_IRQL;                                               /* eval interrupts */
 FLUSH_ISTR;                                             /* clear prefetch */
+cpu_brk_watch = 0;                                      /* no watch hit yet */
 
 abortval = setjmp (save_env);                           /* set abort hdlr */
 if (abortval > 0) {                                     /* sim stop? */
     PSL = PSL | cc;                                     /* put PSL together */
     pcq_r->qptr = pcq_p;                                /* update pc q ptr */
-    if (hst_log) {                                      /* auto logging history? */
-        cpu_show_hist_records (hst_log, FALSE, hst_log_p, (hst_p < hst_log_p) ? hst_lnt - (hst_log_p - hst_p) : hst_p - hst_log_p);
-        hst_log_p = hst_p;                              /* record everything logged */
-        }
     return abortval;                                    /* return to SCP */
     }
 else if (abortval < 0) {                                /* mm or rsrv or int */
@@ -611,8 +615,8 @@ for ( ;; ) {
 
 /* Optionally record instruction history results from prior instruction */
 
-    if (hst_lnt) {
-        InstHistory *hlast = &hst[hst_p ? hst_p-1 : hst_lnt -1];
+    if (sim_hist_lnt && sim_hist_last ()) {
+        InstHistory *hlast = (InstHistory *) sim_hist_last ();
 
         switch (DR_GETRES(drom[hlast->opc][0]) << DR_V_RESMASK) {
             case RB_O:
@@ -721,9 +725,14 @@ for ( ;; ) {
             }
         }                                               /* end PSL event */
 
-    if (sim_brk_summ &&
-        sim_brk_test ((uint32) PC, SWMASK ('E'))) {     /* breakpoint? */
-        ABORT (STOP_IBKPT);                             /* stop simulation */
+    if (sim_brk_summ) {
+        if (cpu_brk_watch) {                            /* data watchpoint hit? */
+            cpu_brk_watch = 0;                          /* stop after the instr */
+            sim_messagef (STOP_IBKPT, "\r\n%s", sim_brk_message ());
+            ABORT (STOP_IBKPT);
+            }
+        if (sim_brk_test ((uint32) PC, SWMASK ('E')))   /* breakpoint? */
+            ABORT (STOP_IBKPT);                         /* stop simulation */
         }
 
     sim_interval = sim_interval - (1 + (extra_bytes>>5));/* count instr */
@@ -1560,10 +1569,10 @@ for ( ;; ) {
 
 /* Optionally record instruction history */
 
-    if (hst_lnt) {
+    if (sim_hist_lnt) {
         int32 lim;
         t_value wd;
-        InstHistory *h = &hst[hst_p];
+        InstHistory *h = (InstHistory *) sim_hist_add ();
 
         h->iPC = fault_PC;
         h->PSL = PSL | cc;
@@ -1581,13 +1590,6 @@ for ( ;; ) {
                 break;
                 }
             }
-        if (hst_switches & SWMASK('T'))
-            h->time = sim_gtime();
-        hst_p = hst_p + 1;
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        if (hst_log && (hst_p == hst_log_p))    /* File Logging and Full, then write all records*/
-            cpu_show_hist_records (hst_log, ((hst_switches & SWMASK('O')) != 0), hst_log_p, hst_lnt);
         }
 
 /* Dispatch to instructions */
@@ -3162,7 +3164,7 @@ for ( ;; ) {
     case MULH2: case MULH3: case DIVH2: case DIVH3:
     case ACBH: case POLYH: case EMODH:
         cc = op_octa (opnd, cc, opc, acc, spec, va, 
-                      (hst_lnt ? &hst[hst_p ? hst_p-1 : hst_lnt -1] : NULL) );
+                      (sim_hist_lnt ? (InstHistory *) sim_hist_last () : NULL) );
         if (cc & LSIGN) {                               /* ACBH branch? */
             BRANCHW (brdisp);
             cc = cc & CC_MASK;                          /* mask off flag */
@@ -3342,7 +3344,8 @@ mapen = 0;
 FLUSH_ISTR;                             /* init I-stream */
 if (M == NULL) {                        /* first time init? */
     vax_init();
-    sim_brk_types = sim_brk_dflt = SWMASK ('E');
+    sim_brk_dflt = SWMASK ('E');
+    sim_brk_types = sim_brk_dflt | SWMASK ('R') | SWMASK ('W');
     sim_vm_is_subroutine_call = cpu_is_pc_a_subroutine_call;
     sim_clock_precalibrate_commands = vax_clock_precalibrate_commands;
     sim_clock_precalibrate_cleanup_commands = vax_clock_precalibrate_cleanup_commands;
@@ -3351,9 +3354,10 @@ if (M == NULL) {                        /* first time init? */
     if (pcq_r == NULL)
         return SCPE_IERR;
     pcq_r->qptr = 0;
-    M = (uint32 *) calloc (((uint32) MEMSIZE) >> 2, sizeof (uint32));
+    M = (uint32 *) sim_mem_alloc ((size_t) MEMSIZE);
     if (M == NULL)
         return SCPE_MEM;
+    cpu_unit.filebuf = M;                               /* lets SAVE skip untouched memory */
     auto_config(NULL, 0);               /* do an initial auto configure */
     }
 return build_dib_tab ();
@@ -3456,23 +3460,22 @@ return SCPE_NXM;
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
 int32 mc = 0;
-uint32 i, clim, uval = (uint32)val;
+uint32 i, uval = (uint32)val;
 uint32 *nM = NULL;
 
 if ((val <= 0) || (val > MAXMEMSIZE_X))
     return SCPE_ARG;
-for (i = val; i < MEMSIZE; i = i + 4)
-    mc = mc | M[i >> 2];
+if ((uval < MEMSIZE) && !sim_mem_untouched (M, uval, (size_t)(MEMSIZE - uval))) {
+    for (i = val; i < MEMSIZE; i = i + 4)
+        mc = mc | M[i >> 2];
+    }
 if ((mc != 0) && !get_yn ("Really truncate memory [N]?", FALSE))
     return SCPE_OK;
-nM = (uint32 *) calloc (uval >> 2, sizeof (uint32));
+nM = (uint32 *) sim_mem_realloc (M, (size_t) uval);     /* copies only touched pages */
 if (nM == NULL)
     return SCPE_MEM;
-clim = (uint32)((uval < MEMSIZE)? uval: MEMSIZE);
-for (i = 0; i < clim; i = i + 4)
-    nM[i >> 2] = M[i >> 2];
-free (M);
 M = nM;
+cpu_unit.filebuf = M;
 MEMSIZE = uval; 
 reset_all (0);
 return SCPE_OK;
@@ -3534,135 +3537,51 @@ return ACC_MASK (md);
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-char gbuf[CBUFSIZE];
-t_stat r;
-
-if (cptr == NULL) { /* Clear History */
-    if (hst_log) {
-        sim_set_fsize (hst_log, (t_addr)0);
-        rewind (hst_log);
-        hst_log_p = 0;
-        cpu_show_hist_records (hst_log, TRUE, 0, 0);
-        }
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].iPC = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-cptr = get_glyph (cptr, gbuf, ':');
-lnt = (int32) get_uint (gbuf, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", gbuf, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    if (hst_log) {
-        fclose (hst_log);
-        hst_log = NULL;
-        }
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-            return SCPE_MEM;
-    hst_lnt = lnt;
-    hst_switches = sim_switches;
-    if (cptr && *cptr) {
-        hst_log = sim_fopen (cptr, "w");
-        if (hst_log)
-            cpu_show_hist_records (hst_log, TRUE, 0, 0);
-        else {
-            free (hst);
-            hst_lnt = 0;
-            hst = NULL;
-            return sim_messagef(SCPE_OPENERR, "Unable to open file '%s': %s\n", cptr, strerror (errno));
-            }            
-        }
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 di, lnt;
-const char *cptr = (const char *) desc;
-t_stat r;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
-    }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0)
-    di = di + hst_lnt;
-return cpu_show_hist_records (st, TRUE, di, lnt);
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
 }
 
-t_stat cpu_show_hist_records (FILE *st, t_bool do_header, int32 start, int32 count)
+/* Print one history record, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
 {
-int32 i, k, numspec;
-InstHistory *h;
-
-if (hst_lnt == 0)                                       /* enabled? */
-    return SCPE_NOFNC;
-if (do_header) {
-    if (hst_switches & SWMASK('O')) {
-        sim_set_fsize (hst_log, (t_addr)0);
-        rewind (hst_log);
-        }
-    if (hst_switches & SWMASK('T'))
-        fprintf (st," TIME       ");
+const InstHistory *h = (const InstHistory *) rec;
+int32 i, numspec;
+
+if (h == NULL) {
     fprintf (st, "PC       PSL       IR\n\n");
+    return;
     }
-for (k = 0; k < count; k++) {                           /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(start++) % hst_lnt];                      /* entry pointer */
-    if (h->iPC == 0)                                    /* filled in? */
-        continue;
-    if (hst_switches & SWMASK('T'))                     /* sim_time */
-        fprintf(st, "%10.0f  ", h->time);
-    fprintf(st, "%08X %08X| ", h->iPC, h->PSL);         /* PC, PSL */
-    numspec = DR_GETNSP (drom[h->opc][0]);              /* #specifiers */
-    if (opcode[h->opc] == NULL)                         /* undefined? */
+fprintf(st, "%08X %08X| ", h->iPC, h->PSL);             /* PC, PSL */
+numspec = DR_GETNSP (drom[h->opc][0]);                  /* #specifiers */
+if (opcode[h->opc] == NULL)                             /* undefined? */
+    fprintf (st, "%03X (undefined)", h->opc);
+else if (h->PSL & PSL_FPD)                              /* FPD set? */
+    fprintf (st, "%s FPD set", opcode[h->opc]);
+else {                                                  /* normal */
+    for (i = 0; i < INST_SIZE; i++)
+        sim_eval[i] = h->inst[i];
+    if ((fprint_sym (st, h->iPC, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
         fprintf (st, "%03X (undefined)", h->opc);
-    else if (h->PSL & PSL_FPD)                          /* FPD set? */
-        fprintf (st, "%s FPD set", opcode[h->opc]);
-    else {                                              /* normal */
-        for (i = 0; i < INST_SIZE; i++)
-            sim_eval[i] = h->inst[i];
-        if ((fprint_sym (st, h->iPC, sim_eval, &cpu_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "%03X (undefined)", h->opc);
-        if ((numspec > 1) ||
-            ((numspec == 1) && (drom[h->opc][1] < BB))) {
-            if (cpu_show_opnd (st, h, 0)) {             /* operands; more? */
-                if (cpu_show_opnd (st, h, 1)) {         /* 2nd line; more? */
-                    cpu_show_opnd (st, h, 2);           /* octa, 3rd/4th */
-                    cpu_show_opnd (st, h, 3);
-                    }
+    if ((numspec > 1) ||
+        ((numspec == 1) && (drom[h->opc][1] < BB))) {
+        if (cpu_show_opnd (st, h, 0, timed)) {          /* operands; more? */
+            if (cpu_show_opnd (st, h, 1, timed)) {      /* 2nd line; more? */
+                cpu_show_opnd (st, h, 2, timed);        /* octa, 3rd/4th */
+                cpu_show_opnd (st, h, 3, timed);
                 }
             }
-        }                                               /* end else */
-    fputc ('\n', st);                                   /* end line */
-    }                                                   /* end for */
-fflush (st);
-return SCPE_OK;
+        }
+    }                                                   /* end else */
 }
 
-t_bool cpu_show_opnd (FILE *st, InstHistory *h, int32 line)
+t_bool cpu_show_opnd (FILE *st, const InstHistory *h, int32 line, t_bool timed)
 {
 
 int32 numspec, i, j, disp;
@@ -3670,7 +3589,7 @@ t_bool more;
 
 numspec = drom[h->opc][0] & DR_NSPMASK;                 /* #specifiers */
 fputs ("\n                  ", st);                     /* space */
-if (hst_switches & SWMASK('T'))
+if (timed)
     fputs ("            ", st);
 for (i = 1, j = 0, more = FALSE; i <= numspec; i++) {   /* loop thru specs */
     disp = drom[h->opc][i];                             /* specifier type */
@@ -3980,6 +3899,9 @@ fprintf (st, "The CPU also implements a command to display a virtual to physical
 fprintf (st, "translation:\n\n");
 fprintf (st, "   sim> SHOW {-kesu} CPU VIRTUAL=n      show translation for address n\n");
 fprintf (st, "                                        in kernel/exec/supervisor/user mode\n\n");
+fprintf (st, "Breakpoints may be E (execution), R (data read) or W (data write), at\n");
+fprintf (st, "virtual addresses.  A data watchpoint (BREAK -R/-W or WATCH) stops the\n");
+fprintf (st, "simulator after the instruction which made the reference.\n\n");
 fprintf (st, "Memory can be loaded with a binary byte stream using the LOAD command.  The\n");
 fprintf (st, "LOAD command recognizes these switches:\n\n");
 fprintf (st, "      -o      origin argument follows file name\n");
@@ -4022,10 +3944,13 @@ fprintf (st, "The CPU can maintain a history of the most recently executed instr
 fprintf (st, "This is controlled by the SET CPU HISTORY and SHOW CPU HISTORY commands:\n\n");
 fprintf (st, "   sim> SET CPU HISTORY                    clear history buffer\n");
 fprintf (st, "   sim> SET CPU HISTORY=0                  disable history\n");
-fprintf (st, "   sim> SET CPU {-T} {-O} HISTORY=n{:file} enable history, length = n\n");
+fprintf (st, "   sim> SET CPU {-T} {-O} {-B} HISTORY=n{:file}\n");
+fprintf (st, "                                           enable history, length = n\n");
 fprintf (st, "   sim> SHOW CPU HISTORY                   print CPU history\n");
 fprintf (st, "   sim> SHOW CPU HISTORY=n                 print most recent n entries of\n");
-fprintf (st, "                                           history\n\n");
+fprintf (st, "                                           history\n");
+fprintf (st, "   sim> SHOW {-n} CPU HISTORY=file         print history written to file\n");
+fprintf (st, "                                           with -B\n\n");
 fprintf (st, "The -T switch causes simulator time to be recorded (and displayed)\n");
 fprintf (st, "with each history entry.  This may be useful when correlating history\n");
 fprintf (st, "with debug output.\n");
@@ -4035,7 +3960,21 @@ fprintf (st, "may be comsumed.\n");
 fprintf (st, "Consumption of prodigious amounts of disk space can be avoided, if the\n");
 fprintf (st, "-O switch is specified which will cause each buffer flush to overwrite\n");
 fprintf (st, "any previously output history.\n");
+fprintf (st, "The -B switch writes the file in binary, in the background, which is\n");
+fprintf (st, "much faster; 'n' is then the number of entries that may be waiting to be\n");
+fprintf (st, "written, and -O makes the file hold only the most recent n entries.\n");
+fprintf (st, "SHOW CPU HISTORY=file decodes a binary file (the last n entries of it\n");
+fprintf (st, "with SHOW -n CPU HISTORY=file).\n");
 fprintf (st, "The maximum length for the history is %d entries.\n\n", HIST_MAX);
+fprintf (st, "On Linux hosts, large memories can be backed by huge pages, which cuts\n");
+fprintf (st, "the host's address translation overhead, and kept on one NUMA node of a\n");
+fprintf (st, "multi-socket host together with the simulator:\n\n");
+fprintf (st, "   sim> SET CPU MEMBACKING=HUGE            reserved or transparent huge pages\n");
+fprintf (st, "   sim> SET CPU MEMBACKING=NORMAL          host default pages\n");
+fprintf (st, "   sim> SET CPU NUMANODE=n                 bind memory and simulator to node n\n");
+fprintf (st, "   sim> SET CPU NONUMANODE                 remove the binding\n\n");
+fprintf (st, "Reserved huge pages (vm.nr_hugepages) are used when enough are free;\n");
+fprintf (st, "otherwise transparent huge pages are requested.\n\n");
 fprintf (st, "Different VAX systems implemented different VAX architecture instructions\n");
 fprintf (st, "in hardware with other instructions possibly emulated by software in the\n");
 fprintf (st, "system.  The instructions that a particular simulator implements can be\n");
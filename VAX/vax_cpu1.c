@@ -781,6 +781,188 @@ return 0;                                               /* q can't be empty */
 #define MVC_M_STATE     3
 #define MVC_V_CC        2
 
+/* Page-at-a-time string helpers
+
+   Each helper processes the longest run of the current string state that
+   stays within one page of every operand, using host memory directly.
+   All pages are mapped (and any fault taken) before the registers are
+   updated, so a fault leaves the FPD state exactly as the byte loops
+   would at that page boundary.  A helper returns FALSE when there is
+   nothing left to do, when a page is not host addressable main memory,
+   or when the string terminates inside the run; the caller then finishes
+   with the original byte/longword loops, which resume from the registers.
+*/
+
+#define STR_PAGREM(x)   (VA_PAGSIZE - VA_GETOFF (x))    /* bytes left in page */
+
+static t_bool movc_frwd_page (int32 acc)
+{
+uint32 n = (uint32) R[2];
+uint8 *src, *dst;
+
+if (n == 0)
+    return FALSE;
+if (n > STR_PAGREM (R[1]))
+    n = STR_PAGREM (R[1]);
+if (n > STR_PAGREM (R[3]))
+    n = STR_PAGREM (R[3]);
+if (((src = StrMap (R[1], RA)) == NULL) ||              /* map src, dst */
+    ((dst = StrMap (R[3], WA)) == NULL))
+    return FALSE;
+memmove (dst, src, n);
+R[1] = R[1] + n;                                        /* inc src addr */
+R[3] = R[3] + n;                                        /* inc dst addr */
+R[2] = R[2] - n;                                        /* dec move lnt */
+extra_bytes = extra_bytes + (n >> 2);
+return TRUE;
+}
+
+static t_bool movc_back_page (int32 acc)
+{
+uint32 n = (uint32) R[2];
+uint8 *src, *dst;
+
+if (n == 0)
+    return FALSE;
+if (n > VA_GETOFF (R[1] - 1) + 1)
+    n = VA_GETOFF (R[1] - 1) + 1;
+if (n > VA_GETOFF (R[3] - 1) + 1)
+    n = VA_GETOFF (R[3] - 1) + 1;
+if (((src = StrMap (R[1] - n, RA)) == NULL) ||          /* map src, dst */
+    ((dst = StrMap (R[3] - n, WA)) == NULL))
+    return FALSE;
+memmove (dst, src, n);
+R[1] = R[1] - n;                                        /* dec src addr */
+R[3] = R[3] - n;                                        /* dec dst addr */
+R[2] = R[2] - n;                                        /* dec move lnt */
+extra_bytes = extra_bytes + (n >> 2);
+return TRUE;
+}
+
+static t_bool movc_fill_page (int32 fill, int32 acc)
+{
+uint32 n = (uint32) R[4];
+uint8 *dst;
+
+if (R[4] <= 0)
+    return FALSE;
+if (n > STR_PAGREM (R[3]))
+    n = STR_PAGREM (R[3]);
+if ((dst = StrMap (R[3], WA)) == NULL)                  /* map dst */
+    return FALSE;
+memset (dst, fill & BMASK, n);
+R[3] = R[3] + n;                                        /* inc dst addr */
+R[4] = R[4] - n;                                        /* dec fill lnt */
+extra_bytes = extra_bytes + (n >> 2);
+return TRUE;
+}
+
+static t_bool cmpc_page (int32 fill, int32 acc)
+{
+uint32 l1 = R[0] & STR_LNMASK;
+uint32 l2 = R[2] & STR_LNMASK;
+uint32 n, i;
+uint8 *s1 = NULL, *s2 = NULL;
+
+if ((l1 | l2) == 0)                                     /* done? */
+    return FALSE;
+n = (l1 == 0)? l2: ((l2 == 0)? l1: ((l1 < l2)? l1: l2));
+if (l1 && (n > STR_PAGREM (R[1])))
+    n = STR_PAGREM (R[1]);
+if (l2 && (n > STR_PAGREM (R[3])))
+    n = STR_PAGREM (R[3]);
+if ((l1 && ((s1 = StrMap (R[1], RA)) == NULL)) ||       /* map src1, src2 */
+    (l2 && ((s2 = StrMap (R[3], RA)) == NULL)))
+    return FALSE;
+fill = fill & BMASK;
+if (s1 && s2) {
+    if (memcmp (s1, s2, n) == 0)
+        i = n;
+    else for (i = 0; s1[i] == s2[i]; i++) ;
+    }
+else if (s1)
+    for (i = 0; (i < n) && (s1[i] == fill); i++) ;
+else for (i = 0; (i < n) && (s2[i] == fill); i++) ;
+if (l1) {                                               /* if src1, decr */
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+    R[1] = R[1] + i;
+    }
+if (l2) {                                               /* if src2, decr */
+    R[2] = (R[2] - i) & STR_LNMASK;
+    R[3] = R[3] + i;
+    }
+extra_bytes = extra_bytes + i;
+return (i == n);                                        /* mismatch? stop */
+}
+
+static t_bool locskp_page (int32 match, int32 skpc, int32 acc)
+{
+uint32 n = R[0] & STR_LNMASK;
+uint32 i;
+uint8 *src, *hit;
+
+if (n == 0)                                             /* done? */
+    return FALSE;
+if (n > STR_PAGREM (R[1]))
+    n = STR_PAGREM (R[1]);
+if ((src = StrMap (R[1], RA)) == NULL)                  /* map src */
+    return FALSE;
+match = match & BMASK;
+if (skpc)
+    for (i = 0; (i < n) && (src[i] == match); i++) ;
+else {
+    hit = (uint8 *) memchr (src, match, n);
+    i = (hit == NULL)? n: (uint32) (hit - src);
+    }
+R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+R[1] = R[1] + i;                                        /* incr src1adr */
+extra_bytes = extra_bytes + i;
+return (i == n);                                        /* found? stop */
+}
+
+/* Pick up a SCANC/SPANC table, which may cross a page boundary; the
+   table is only probed, since the instruction need not touch all of it */
+
+static t_bool scnspn_table (uint32 va, uint8 *tbl, int32 acc)
+{
+uint32 n = STR_PAGREM (va);
+uint8 *t0, *t1;
+
+if ((t0 = StrProbe (va, RA)) == NULL)
+    return FALSE;
+if (n >= 256) {
+    memcpy (tbl, t0, 256);
+    return TRUE;
+    }
+if ((t1 = StrProbe (va + n, RA)) == NULL)
+    return FALSE;
+memcpy (tbl, t0, n);
+memcpy (tbl + n, t1, 256 - n);
+return TRUE;
+}
+
+static t_bool scnspn_page (const uint8 *tbl, int32 mask, int32 spanc, int32 acc)
+{
+uint32 n = R[0] & STR_LNMASK;
+uint32 i;
+uint8 *src;
+
+if (n == 0)                                             /* done? */
+    return FALSE;
+if (n > STR_PAGREM (R[1]))
+    n = STR_PAGREM (R[1]);
+if ((src = StrMap (R[1], RA)) == NULL)                  /* map src */
+    return FALSE;
+mask = mask & BMASK;
+if (spanc)
+    for (i = 0; (i < n) && (tbl[src[i]] & mask); i++) ;
+else for (i = 0; (i < n) && !(tbl[src[i]] & mask); i++) ;
+R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+R[1] = R[1] + i;
+extra_bytes = extra_bytes + i;
+return (i == n);                                        /* found? stop */
+}
+
 /* MOVC3, MOVC5
 
    if PSL<fpd> = 0 and MOVC3,
@@ -859,6 +1041,7 @@ else {
 switch (R[5] & MVC_M_STATE) {                           /* case on state */
 
     case MVC_FRWD:                                      /* move forward */
+        while (movc_frwd_page (acc)) ;                  /* whole pages */
         mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
         if (mlnt[0] > R[2])                             /* cant exceed total */
             mlnt[0] = R[2];
@@ -877,6 +1060,7 @@ switch (R[5] & MVC_M_STATE) {                           /* case on state */
         goto FILL;                                      /* check for fill */
 
     case MVC_BACK:                                      /* move backward */
+        while (movc_back_page (acc)) ;                  /* whole pages */
         mlnt[0] = R[3] & 03;                            /* length to align */
         if (mlnt[0] > R[2])                             /* cant exceed total */
             mlnt[0] = R[2];
@@ -900,6 +1084,7 @@ switch (R[5] & MVC_M_STATE) {                           /* case on state */
         if (R[4] <= 0)                                  /* any fill? */
             break;
         R[5] = R[5] | MVC_FILL;                         /* set state */
+        while (movc_fill_page (fill, acc)) ;            /* whole pages */
         mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
         if (mlnt[0] > R[4])                             /* cant exceed total */
             mlnt[0] = R[4];
@@ -974,6 +1159,7 @@ else {
     PSL = PSL | PSL_FPD;
     }
 R[2] = R[2] & STR_LNMASK;                               /* mask src2len */
+while (cmpc_page (fill, acc)) ;                         /* whole pages */
 for (s1 = s2 = 0; ((R[0] | R[2]) & STR_LNMASK) != 0; extra_bytes++) {
     if (R[0] & STR_LNMASK)                              /* src1? read */
         s1 = Read (R[1], L_BYTE, RA);
@@ -1024,6 +1210,7 @@ else {
     R[1] = opnd[2];                                     /* src addr */
     PSL = PSL | PSL_FPD;
     }
+while (locskp_page (match, skpc, acc)) ;                /* whole pages */
 for ( ; (R[0] & STR_LNMASK) != 0; extra_bytes++ ) {    /* loop thru string */
     c = Read (R[1], L_BYTE, RA);                        /* get src byte */
     if ((c == match) ^ skpc)                            /* match & locc? */
@@ -1053,6 +1240,7 @@ return (R[0]? 0: CC_Z);                                 /* set cc's */
 int32 op_scnspn (int32 *opnd, int32 spanc, int32 acc)
 {
 int32 c, t, mask;
+uint8 tbl[256];
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -1065,6 +1253,8 @@ else {
     R[0] = STR_PACK (mask, opnd[0]);                    /* srclen + FPD data */
     PSL = PSL | PSL_FPD;
     }
+if ((R[0] & STR_LNMASK) && scnspn_table (R[3], tbl, acc))
+    while (scnspn_page (tbl, mask, spanc, acc)) ;       /* whole pages */
 for ( ; (R[0] & STR_LNMASK) != 0; extra_bytes++ ) {    /* loop thru string */
     c = Read (R[1], L_BYTE, RA);                        /* get byte */
     t = Read (R[3] + c, L_BYTE, RA);                    /* get table ent */
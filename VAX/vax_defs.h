@@ -853,7 +853,6 @@ void cpu_idle (void);
 #define INST_SIZE       52
 
 typedef struct {
-    double              time;
     int32               iPC;
     int32               PSL;
     int32               opc;
@@ -952,6 +951,10 @@ extern int32 op_divg (int32 *opnd, int32 *rh);
 extern void op_polyf (int32 *opnd, int32 acc);
 extern void op_polyd (int32 *opnd, int32 acc);
 extern void op_polyg (int32 *opnd, int32 acc);
+extern int32 fp_host;
+extern t_stat fp_set_host (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+extern t_stat fp_show_host (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+extern t_stat fp_set_test (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 
 /* vax_octa.c externals */
 extern int32 op_octa (int32 *opnd, int32 cc, int32 opc, int32 acc, int32 spec, int32 va, InstHistory *hst);
@@ -54,10 +54,14 @@
         - 64 bit arithmetic (ASHQ, EMUL, EDIV)
         - single precision floating point
         - double precision floating point, D and G format
+
+   F and G format add, subtract, multiply and divide use the host
+   floating point unit when the result is known to be identical.
 */
 
 #include "vax_defs.h"
 #include <setjmp.h>
+#include <float.h>
 
 #if defined (USE_INT64)
 
@@ -1314,6 +1318,249 @@ return r->sign | (r->exp << G_V_EXP) |
 
 #endif
 
+/* Host floating point
+
+   F_floating and G_floating values map directly onto host IEEE double
+   and single/double precision formats: the fraction has the same hidden
+   bit and width, and only the exponent bias differs (the VAX fraction is
+   0.1f, the IEEE significand is 1.f).  F operands are widened to host
+   double, where add, subtract and multiply are exact and divide is
+   correctly rounded to far more than 24 bits; G operands are used as is.
+
+   The simulated FPU (below) returns the exact result rounded to nearest,
+   ties away from zero, while the host rounds ties to even.  F results
+   are rounded from the double by hand.  G add and multiply detect an
+   exact tie and defer to the simulated FPU; a G quotient is never a tie.
+   Zero and reserved operands, operands which would be host denormals,
+   and results which overflow or underflow the VAX format are also left
+   to the simulated FPU, which takes the appropriate fault.
+
+   The host path requires 64b integers and host arithmetic evaluated in
+   the declared precision (no x87 extended intermediates).
+*/
+
+#if defined (USE_INT64) && defined (FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+#define VAX_HOST_FP     1
+#endif
+
+#define HFP_ADD         0                               /* host op codes */
+#define HFP_SUB         1                               /* must be ADD+1 */
+#define HFP_MUL         2
+#define HFP_DIV         3
+
+#if defined (VAX_HOST_FP)
+
+int32 fp_host = 1;                                      /* use host FP */
+
+#define HFP_SIGN        0x8000000000000000              /* IEEE double */
+#define HFP_V_EXP       52
+#define HFP_M_EXP       0x7FF
+#define HFP_FRAC        0x000FFFFFFFFFFFFF
+#define HFP_HB          0x0010000000000000              /* hidden bit */
+#define HFP_F_ADJ       (1023 - (FD_BIAS + 1))          /* F to double exp */
+#define HFP_F_RND       0x0000000010000000              /* F round bit */
+#define HFP_G_ADJ       2                               /* G to double exp */
+#define HFP_GETEXP(x)   ((int32) (((x) >> HFP_V_EXP) & HFP_M_EXP))
+
+static t_bool hfp_unpackf (int32 val, t_uint64 *bits)
+{
+int32 exp = FD_GETEXP (val);
+
+if (exp == 0)                                           /* zero or rsvd op? */
+    return FALSE;
+*bits = (((t_uint64) (val & FPSIGN)) << 48) |
+    (((t_uint64) (exp + HFP_F_ADJ)) << HFP_V_EXP) |
+    (((t_uint64) (val & FD_FRACW)) << 45) |
+    (((t_uint64) ((val >> 16) & WMASK)) << 29);
+return TRUE;
+}
+
+static t_bool hfp_packf (double r, int32 *res)
+{
+t_uint64 bits;
+int32 exp;
+
+memcpy (&bits, &r, sizeof (bits));
+if ((bits & ~HFP_SIGN) == 0) {                          /* exact zero? */
+    *res = 0;
+    return TRUE;
+    }
+bits = bits + HFP_F_RND;                                /* round, ties away */
+exp = HFP_GETEXP (bits) - HFP_F_ADJ;
+if ((exp <= 0) || (exp > FD_M_EXP))                     /* unflo or ovflo? */
+    return FALSE;
+*res = (int32) (((bits >> 48) & FPSIGN) | (exp << FD_V_EXP) |
+    ((bits >> 45) & FD_FRACW) | (((bits >> 29) & WMASK) << 16));
+return TRUE;
+}
+
+static t_bool hfp_unpackg (int32 hi, int32 lo, t_uint64 *bits)
+{
+if (G_GETEXP (hi) <= HFP_G_ADJ)                         /* zero, rsvd, denorm? */
+    return FALSE;
+*bits = UNSCRAM (hi, lo) - (((t_uint64) HFP_G_ADJ) << HFP_V_EXP);
+return TRUE;
+}
+
+static t_bool hfp_packg (double r, int32 *rh, int32 *res)
+{
+t_uint64 bits;
+int32 exp;
+
+memcpy (&bits, &r, sizeof (bits));
+if ((bits & ~HFP_SIGN) == 0) {                          /* exact zero? */
+    *rh = *res = 0;
+    return TRUE;
+    }
+exp = HFP_GETEXP (bits);
+if ((exp == 0) || (exp > (G_M_EXP - HFP_G_ADJ)))        /* unflo or ovflo? */
+    return FALSE;
+bits = bits + (((t_uint64) HFP_G_ADJ) << HFP_V_EXP);
+*rh = (int32) (((bits >> 16) & WMASK) | ((bits & WMASK) << 16));
+*res = (int32) (((bits >> 48) & WMASK) | ((bits >> 16) & 0xFFFF0000));
+return TRUE;
+}
+
+/* Test for a possible tie in a G sum, given the sum and its exact error */
+
+static t_bool hfp_tie_add (double s, double err)
+{
+t_uint64 sb, eb;
+int32 se;
+
+if (err == 0.0)                                         /* exact? */
+    return FALSE;
+memcpy (&sb, &s, sizeof (sb));
+memcpy (&eb, &err, sizeof (eb));
+se = HFP_GETEXP (sb);
+if (se <= 54)                                           /* err may be denorm */
+    return TRUE;
+if (eb & HFP_FRAC)                                      /* not a power of 2? */
+    return FALSE;
+return ((HFP_GETEXP (eb) == (se - 53)) ||               /* half ulp, or half */
+    (HFP_GETEXP (eb) == (se - 54)));                    /* ulp of binade below */
+}
+
+/* Test for a tie in a G product
+
+   The product of the significands, stripped of trailing zeros, is the
+   product of two odd numbers; it is a tie exactly when it is 54 bits
+   long.  That needs at least 51 trailing zeros between the operands.
+*/
+
+static t_bool hfp_tie_mul (t_uint64 ab, t_uint64 bb)
+{
+t_uint64 ma = (ab & HFP_FRAC) | HFP_HB;
+t_uint64 mb = (bb & HFP_FRAC) | HFP_HB;
+int32 tz = 0;
+
+if ((ma & 0x3FFFFFF) && (mb & 0x3FFFFFF))               /* < 51 zeros? */
+    return FALSE;
+for ( ; (ma & 1) == 0; tz++)                            /* strip zeros */
+    ma = ma >> 1;
+for ( ; (mb & 1) == 0; tz++)
+    mb = mb >> 1;
+if ((tz != 51) && (tz != 52))                           /* can't be 54b? */
+    return FALSE;
+return ((ma * mb) >> 53) == 1;
+}
+
+/* F and G arithmetic - result = s2 op s1, as in the VAX instructions */
+
+static t_bool hfp_opf (int32 s1, int32 s2, int32 op, int32 *res)
+{
+t_uint64 ab, bb;
+double a, b, r;
+
+if (!hfp_unpackf (s1, &ab) || !hfp_unpackf (s2, &bb))
+    return FALSE;
+memcpy (&a, &ab, sizeof (a));
+memcpy (&b, &bb, sizeof (b));
+switch (op) {
+    case HFP_ADD:
+        r = b + a;
+        break;
+    case HFP_SUB:
+        r = b - a;
+        break;
+    case HFP_MUL:
+        r = b * a;
+        break;
+    default:
+        r = b / a;
+        break;
+        }
+return hfp_packf (r, res);
+}
+
+static t_bool hfp_opg (int32 *opnd, int32 op, int32 *rh, int32 *res)
+{
+t_uint64 ab, bb;
+double a, b, r, big, sml;
+
+if (!hfp_unpackg (opnd[0], opnd[1], &ab) || !hfp_unpackg (opnd[2], opnd[3], &bb))
+    return FALSE;
+if (op == HFP_SUB) {                                    /* sub? -s1 */
+    ab = ab ^ HFP_SIGN;
+    op = HFP_ADD;
+    }
+memcpy (&a, &ab, sizeof (a));
+memcpy (&b, &bb, sizeof (b));
+switch (op) {
+    case HFP_ADD:
+        r = b + a;
+        if ((ab & ~HFP_SIGN) > (bb & ~HFP_SIGN)) {      /* order by magnitude */
+            big = a;
+            sml = b;
+            }
+        else {
+            big = b;
+            sml = a;
+            }
+        if (hfp_tie_add (r, sml - (r - big)))           /* exact error */
+            return FALSE;
+        break;
+    case HFP_MUL:
+        if (hfp_tie_mul (ab, bb))
+            return FALSE;
+        r = b * a;
+        break;
+    default:
+        r = b / a;
+        break;
+        }
+return hfp_packg (r, rh, res);
+}
+
+#else
+
+int32 fp_host = 0;                                      /* not available */
+
+#define hfp_opf(s1,s2,op,res)       FALSE
+#define hfp_opg(opnd,op,rh,res)     FALSE
+
+#endif
+
+/* Set/show host floating point */
+
+t_stat fp_set_host (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+if (cptr)
+    return SCPE_ARG;
+#if !defined (VAX_HOST_FP)
+if (val)
+    return sim_messagef (SCPE_NOFNC, "Host floating point is not available in this build\n");
+#endif
+fp_host = val;
+return SCPE_OK;
+}
+
+t_stat fp_show_host (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+fprintf (st, "%s", fp_host? "host FP": "simulated FP");
+return SCPE_OK;
+}
+
 /* Floating point instructions */
 
 /* Move/test/move negated floating
@@ -1391,7 +1638,10 @@ return rpackfd (&a, NULL);
 int32 op_addf (int32 *opnd, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (fp_host && hfp_opf (opnd[0], opnd[1], HFP_ADD + sub, &r))
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1415,7 +1665,10 @@ return rpackfd (&a, rh);
 int32 op_addg (int32 *opnd, int32 *rh, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (fp_host && hfp_opg (opnd, HFP_ADD + sub, rh, &r))
+    return r;
 unpackg (opnd[0], opnd[1], &a);
 unpackg (opnd[2], opnd[3], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1429,7 +1682,10 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_mulf (int32 *opnd)
 {
 UFP a, b;
-    
+int32 r;
+
+if (fp_host && hfp_opf (opnd[0], opnd[1], HFP_MUL, &r))
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fmul (&a, &b, 0, FD_BIAS, 0, 0);                    /* do multiply */
@@ -1449,7 +1705,10 @@ return rpackfd (&a, rh);                                /* round and pack */
 int32 op_mulg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (fp_host && hfp_opg (opnd, HFP_MUL, rh, &r))
+    return r;
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fmul (&a, &b, 1, G_BIAS, 0, 0);                     /* do multiply */
@@ -1461,7 +1720,10 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_divf (int32 *opnd)
 {
 UFP a, b;
+int32 r;
 
+if (fp_host && hfp_opf (opnd[0], opnd[1], HFP_DIV, &r))
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fdiv (&a, &b, 26, FD_BIAS);                         /* do divide */
@@ -1481,7 +1743,10 @@ return rpackfd (&b, rh);                                /* round and pack */
 int32 op_divg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (fp_host && hfp_opg (opnd, HFP_DIV, rh, &r))
+    return r;
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fdiv (&a, &b, 55, G_BIAS);                          /* do divide */
@@ -1592,3 +1857,174 @@ R[4] = 0;
 R[5] = 0;
 return;
 }
+
+/* Host floating point differential test
+
+   SET CPU FPTEST{=n} runs n samples (default 100000) of each of ADDF,
+   SUBF, MULF, DIVF, ADDG, SUBG, MULG and DIVG through both the host
+   and the simulated FPU.  Operands mix random bit patterns across the
+   full exponent range, nearby exponents (cancellation), short fractions
+   (integers, exact products and ties) and edge exponents.  Whenever the
+   host path produces a result, the simulated FPU must produce the same
+   result without faulting.
+*/
+
+#if defined (VAX_HOST_FP)
+
+static t_uint64 hfp_test_seed;
+
+static t_uint64 hfp_test_rand (void)
+{
+hfp_test_seed ^= hfp_test_seed << 13;                   /* xorshift64 */
+hfp_test_seed ^= hfp_test_seed >> 7;
+hfp_test_seed ^= hfp_test_seed << 17;
+return hfp_test_seed;
+}
+
+/* Make a random operand: exp and frac width in bits, nearby to another */
+
+static t_uint64 hfp_test_opnd (int32 nexp, int32 nfrac, int32 bias, t_uint64 near)
+{
+t_uint64 rnd = hfp_test_rand ();
+t_uint64 sign = (rnd & 1)? 1: 0;
+t_uint64 frac = hfp_test_rand () >> (64 - nfrac);
+int32 mexp = (1 << nexp) - 1;
+int32 exp;
+
+switch ((rnd >> 1) & 7) {
+    case 0:                                             /* any exponent */
+    case 1:
+        exp = (int32) ((rnd >> 8) & mexp);
+        if ((exp == 0) && (rnd & 0x10))                 /* mostly nonzero */
+            exp = 1;
+        break;
+    case 2:                                             /* edge exponents */
+        exp = (int32) ((rnd >> 8) & 3);
+        if (rnd & 0x10)
+            exp = mexp - exp;
+        break;
+    case 3:                                             /* short fraction */
+        frac = frac & ~(((t_uint64) 1 << (nfrac - ((rnd >> 16) % nfrac))) - 1);
+        exp = bias + (int32) ((rnd >> 8) & 0x3F);
+        break;
+    case 4:                                             /* near other opnd */
+        if (near) {
+            sign = near >> (nexp + nfrac);
+            exp = (int32) ((near >> nfrac) & mexp) + (int32) ((rnd >> 8) & 3);
+            if (exp > mexp)
+                exp = mexp;
+            frac = (near & ((((t_uint64) 1) << nfrac) - 1)) ^ (frac >> ((rnd >> 16) % nfrac));
+            if (rnd & 0x20)
+                sign = sign ^ 1;
+            break;
+            }
+    default:                                            /* moderate range */
+        exp = bias - 40 + (int32) ((rnd >> 8) & 0x4F);
+        break;
+        }
+return (sign << (nexp + nfrac)) | (((t_uint64) exp) << nfrac) | frac;
+}
+
+/* Run the simulated FPU, catching faults */
+
+static t_bool hfp_test_soft (int32 op, t_bool g, int32 *opnd, int32 *rh, int32 *res)
+{
+jmp_buf save;
+int32 save_p1 = p1;
+int32 save_host = fp_host;
+t_bool ok = FALSE;
+
+memcpy (save, save_env, sizeof (save));
+fp_host = 0;
+if (setjmp (save_env) == 0) {
+    *rh = 0;
+    switch (op) {
+        case HFP_ADD:
+        case HFP_SUB:
+            *res = g? op_addg (opnd, rh, op == HFP_SUB): op_addf (opnd, op == HFP_SUB);
+            break;
+        case HFP_MUL:
+            *res = g? op_mulg (opnd, rh): op_mulf (opnd);
+            break;
+        default:
+            *res = g? op_divg (opnd, rh): op_divf (opnd);
+            break;
+            }
+    ok = TRUE;
+    }
+fp_host = save_host;
+memcpy (save_env, save, sizeof (save));
+p1 = save_p1;
+return ok;
+}
+
+t_stat fp_set_test (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+static const char *opname[2][4] = {
+    { "ADDF", "SUBF", "MULF", "DIVF" },
+    { "ADDG", "SUBG", "MULG", "DIVG" }
+    };
+int32 n = 100000;
+int32 i, g, op, opnd[4], r, rh, sr, srh;
+uint32 nhost, nbad = 0;
+t_uint64 s1, s2;
+t_stat st;
+
+if (cptr) {
+    n = (int32) get_uint (cptr, 10, 100000000, &st);
+    if ((st != SCPE_OK) || (n == 0))
+        return SCPE_ARG;
+    }
+hfp_test_seed = 0x2545F4914F6CDD1D;
+for (g = 0; g < 2; g++) {
+    for (op = HFP_ADD; op <= HFP_DIV; op++) {
+        for (i = 0, nhost = 0; i < n; i++) {
+            if (g) {
+                s1 = hfp_test_opnd (11, 52, G_BIAS, 0);
+                s2 = hfp_test_opnd (11, 52, G_BIAS, s1);
+                if ((i & 0xFF) == 0) {                  /* known G tie */
+                    s1 = (((t_uint64) G_BIAS + 1) << 52) | 1;
+                    s2 = (((t_uint64) G_BIAS + 1) << 52) | (((t_uint64) 1) << 51);
+                    }
+                opnd[0] = (int32) (((s1 >> 48) & WMASK) | ((s1 >> 16) & 0xFFFF0000));
+                opnd[1] = (int32) (((s1 >> 16) & WMASK) | ((s1 & WMASK) << 16));
+                opnd[2] = (int32) (((s2 >> 48) & WMASK) | ((s2 >> 16) & 0xFFFF0000));
+                opnd[3] = (int32) (((s2 >> 16) & WMASK) | ((s2 & WMASK) << 16));
+                if (!hfp_opg (opnd, op, &rh, &r))
+                    continue;
+                }
+            else {
+                s1 = hfp_test_opnd (8, 23, FD_BIAS, 0);
+                s2 = hfp_test_opnd (8, 23, FD_BIAS, s1);
+                opnd[0] = (int32) (((s1 >> 16) & WMASK) | ((s1 & WMASK) << 16));
+                opnd[1] = (int32) (((s2 >> 16) & WMASK) | ((s2 & WMASK) << 16));
+                rh = 0;
+                if (!hfp_opf (opnd[0], opnd[1], op, &r))
+                    continue;
+                }
+            nhost++;
+            if (!hfp_test_soft (op, g, opnd, &srh, &sr) ||
+                (r != sr) || (rh != srh)) {
+                if (nbad++ < 10)
+                    sim_printf ("%s %08X %08X, %08X %08X: host %08X %08X, simulated %08X %08X\n",
+                                opname[g][op], opnd[0], g? opnd[1]: 0, g? opnd[2]: opnd[1], g? opnd[3]: 0,
+                                r, rh, sr, srh);
+                }
+            }
+        if (!(sim_switches & SWMASK ('Q')))
+            sim_printf ("%s: %d samples, %u on host\n", opname[g][op], n, nhost);
+        }
+    }
+if (nbad)
+    return sim_messagef (SCPE_IERR, "Host floating point differential test: %u mismatches\n", nbad);
+return sim_messagef (SCPE_OK, "Host floating point differential test passed\n");
+}
+
+#else
+
+t_stat fp_set_test (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+return sim_messagef (SCPE_OK, "Host floating point is not available in this build\n");
+}
+
+#endif
@@ -42,6 +42,8 @@
         ReadB(W)        -       read aligned physical byte (word)
         WriteB(W)       -       write aligned physical byte (word)
         Test            -       test acccess
+        StrMap          -       map virtual page to host memory (string instructions)
+        StrProbe        -       map virtual page to host memory, no fault
 
 */
 
@@ -62,6 +64,7 @@ extern DEVICE cpu_dev;
 extern int32 mapen;                                     /* map enable */
 
 extern int32 mchk_va, mchk_ref;                         /* for mcheck */
+extern int32 cpu_brk_watch;                             /* data watchpoint hit */
 extern TLBENT stlb[VA_TBSIZE], ptlb[VA_TBSIZE];
 
 static const int32 insert[4] = {
@@ -123,6 +126,8 @@ int32 pa1, bo, sc, wl, wh;
 TLBENT xpte;
 
 mchk_va = va;
+if (sim_brk_watch_test_range (va, lnt, SWMASK ('R')))  /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (mapen) {                                            /* mapping on? */
     vpn = VA_GETVPN (va);                               /* get vpn, offset */
     off = VA_GETOFF (va);
@@ -189,6 +194,8 @@ int32 pa1, bo, sc;
 TLBENT xpte;
 
 mchk_va = va;
+if (sim_brk_watch_test_range (va, lnt, SWMASK ('W')))  /* data watchpoint? */
+    cpu_brk_watch = 1;                                  /* stop after instr */
 if (mapen) {
     vpn = VA_GETVPN (va);
     off = VA_GETOFF (va);
@@ -264,6 +271,68 @@ if (mapen) {                                            /* mapping on? */
 return va & PAMASK;                                     /* ret phys addr */
 }
 
+/* Map virtual to host memory for string instructions
+
+   Inputs:
+        va      =       virtual address
+        acc     =       access code (KESU), as for Read or Write
+   Output:
+        pointer to the byte at va in host memory, valid through the end
+        of the page containing va, or NULL
+
+   The address is translated exactly as Read or Write would, so any
+   fault is taken before the page is referenced.  NULL is returned if
+   the page is not main memory, if memory bytes are not host addressable
+   (big endian host), or if the page holds a data watchpoint; the caller
+   must then use Read/Write.
+*/
+
+static SIM_INLINE uint8 *StrMap (uint32 va, int32 acc)
+{
+int32 vpn, tbi, pa;
+TLBENT xpte;
+
+if (!sim_end ||                                         /* bytes not in host order? */
+    ((sim_brk_summ & (SWMASK ('R') | SWMASK ('W'))) &&  /* or watched page? */
+     sim_brk_watch_page (va)))
+    return NULL;
+mchk_va = va;
+if (mapen) {                                            /* mapping on? */
+    vpn = VA_GETVPN (va);
+    tbi = VA_GETTBI (vpn);
+    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
+    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
+        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
+        xpte = fill (va, L_BYTE, acc, NULL);            /* fill if needed */
+    pa = (xpte.pte & TLB_PFN) | VA_GETOFF (va);
+    }
+else pa = va & PAMASK;
+if (!ADDR_IS_MEM (pa | VA_M_OFF))                       /* I/O or register? */
+    return NULL;
+return ((uint8 *) M) + pa;
+}
+
+/* Map virtual to host memory for string instructions, without faulting
+
+   As StrMap, for a read reference, but a page which is not accessible
+   returns NULL rather than faulting.  Used to pick up tables which the
+   instruction may not reference in full.
+*/
+
+static SIM_INLINE uint8 *StrProbe (uint32 va, int32 acc)
+{
+int32 pa, status;
+
+if (!sim_end ||                                         /* bytes not in host order? */
+    ((sim_brk_summ & SWMASK ('R')) &&                   /* or watched page? */
+     sim_brk_watch_page (va)))
+    return NULL;
+pa = Test (va, acc, &status);
+if ((status != PR_OK) || !ADDR_IS_MEM (pa | VA_M_OFF))
+    return NULL;
+return ((uint8 *) M) + pa;
+}
+
 /* Read aligned physical (in virtual context, unless indicated)
 
    Inputs:
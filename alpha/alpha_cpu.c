@@ -129,7 +129,6 @@
 #define UNIT_CONH       (1 << UNIT_V_CONH)
 #define UNIT_MSIZE      (1 << UNIT_V_MSIZE)
 
-#define HIST_PC         0x2
 #define HIST_MIN        64
 #define HIST_MAX        (1 << 18)
 
@@ -181,9 +180,6 @@ REG *pcq_r = NULL;                                      /* PC queue reg ptr */
 t_uint64 pcq[PCQ_SIZE] = { 0 };                         /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 uint32 cpu_astop = 0;
-uint32 hst_p = 0;                                       /* history pointer */
-uint32 hst_lnt = 0;                                     /* history length */
-InstHistory *hst = NULL;                                /* instruction history */
 jmp_buf save_env;
 
 const t_uint64 byte_mask[8] = {
@@ -207,6 +203,7 @@ t_stat cpu_dep (t_value val, t_addr exta, UNIT *uptr, int32 sw);
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_show_virt (FILE *of, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_fprint_one_inst (FILE *st, uint32 ir, t_uint64 pc, t_uint64 ra, t_uint64 rb);
 
@@ -233,6 +230,7 @@ extern t_stat pal_proc_trap (uint32 type);
 extern t_stat pal_proc_intr (uint32 type);
 extern t_stat pal_proc_inst (uint32 fnc);
 extern uint32 tlb_set_cm (int32 cm);
+extern void tlb_flush_host (void);
 
 /* CPU data structures
 
@@ -344,8 +342,13 @@ MTAB cpu_mod[] = {
       NULL, &cpu_show_tlb },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 1, "DTLB", NULL,
       NULL, &cpu_show_tlb },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 0, "MEMBACKING", "MEMBACKING",
+      &sim_set_mem_backing, &sim_show_mem_backing },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_VALR, 1, "NUMANODE", "NUMANODE",
+      &sim_set_numa_node, &sim_show_numa_node },
+    { MTAB_XTD|MTAB_VDV, 0, NULL, "NONUMANODE", &sim_set_numa_node, NULL },
     { 0 }
     };
 
@@ -378,7 +381,7 @@ if (abortval != 0) {                                    /* exception? */
     }
 else reason = 0;
 tlb_set_cm (-1);                                        /* resync cm */
-tracing = ((hst_lnt != 0) || DEBUG_PRS (cpu_dev));
+tracing = ((sim_hist_lnt != 0) || DEBUG_PRS (cpu_dev));
 
 intr_summ = pal_eval_intr (1);                          /* eval interrupts */
 
@@ -421,16 +424,18 @@ while (reason == 0) {
     rb = I_GETRB (ir);                                  /* get rb */
 
     if (tracing) {                                      /* trace or history? */
-        if (hst_lnt) {                                  /* history enabled? */
-            hst_p = (hst_p + 1);                        /* next entry */
-            if (hst_p >= hst_lnt) hst_p = 0;
-            hst[hst_p].pc = PC | pc_align | HIST_PC;    /* save PC */
-            hst[hst_p].ir = ir;                         /* save ir */
-            hst[hst_p].ra = R[ra];                      /* save Ra */
-            hst[hst_p].rb = R[rb];                      /* save Rb */
+        if (sim_hist_lnt) {                             /* history enabled? */
+            InstHistory *h = (InstHistory *) sim_hist_add ();
+
+            h->pc = PC | pc_align;                      /* save PC */
+            h->ir = ir;                                 /* save ir */
+            h->ra = R[ra];                              /* save Ra */
+            h->rb = R[rb];                              /* save Rb */
             }
-        if (DEBUG_PRS (cpu_dev))                        /* trace enabled? */
+        if (DEBUG_PRS (cpu_dev)) {                      /* trace enabled? */
             cpu_fprint_one_inst (sim_deb, ir, PC | pc_align, R[ra], R[rb]);
+            fputc ('\n', sim_deb);                      /* end line */
+            }
         }
 
     PC = (PC + 4) & M64;                                /* advance PC */
@@ -1657,8 +1662,11 @@ vax_flag = 0;
 lock_flag = 0;
 trap_summ = 0;
 trap_mask = 0;
-if (M == NULL) M = (t_uint64 *) calloc (((uint32) MEMSIZE) >> 3, sizeof (t_uint64));
-if (M == NULL) return SCPE_MEM;
+if (M == NULL) {
+    M = (t_uint64 *) sim_mem_alloc ((size_t) MEMSIZE);
+    if (M == NULL) return SCPE_MEM;
+    cpu_unit.filebuf = M;                               /* lets SAVE skip untouched memory */
+    }
 pcq_r = find_reg ("PCQ", NULL, dptr);
 if (pcq_r) pcq_r->qptr = 0;
 else return SCPE_IERR;
@@ -1709,19 +1717,20 @@ return SCPE_NXM;
 t_stat cpu_set_size (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
 t_uint64 mc = 0;
-uint32 i, clim;
+uint32 i;
 t_uint64 *nM = NULL;
 
-for (i = val; i < MEMSIZE; i = i + 8) mc = mc | M[i >> 3];
+if ((((uint32) val) < MEMSIZE) && !sim_mem_untouched (M, (size_t) val, (size_t) (MEMSIZE - val))) {
+    for (i = val; i < MEMSIZE; i = i + 8) mc = mc | M[i >> 3];
+    }
 if ((mc != 0) && !get_yn ("Really truncate memory [N]?", FALSE))
     return SCPE_OK;
-nM = (t_uint64 *) calloc (val >> 3, sizeof (t_uint64));
+nM = (t_uint64 *) sim_mem_realloc (M, (size_t) val);    /* copies only touched pages */
 if (nM == NULL) return SCPE_MEM;
-clim = (uint32) ((((uint32) val) < MEMSIZE)? val: MEMSIZE);
-for (i = 0; i < clim; i = i + 8) nM[i >> 3] = M[i >>3];
-free (M);
 M = nM;
+cpu_unit.filebuf = M;
 MEMSIZE = val;
+tlb_flush_host ();                                      /* host ptrs stale */
 return SCPE_OK;
 }
 
@@ -1759,31 +1768,7 @@ return SCPE_OK;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-uint32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++) hst[i].pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (uint32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL) return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Print instruction trace */
@@ -1804,7 +1789,6 @@ static const int h_fmt[64] = {
     H_BRA, H_BRA, H_BRA, H_BRA, H_BRA, H_BRA, H_BRA, H_BRA
     };
 
-pc = pc & ~HIST_PC;
 fprint_val (st, pc, 16, 64, PV_RZRO);
 fputc (' ', st);
 op = I_GETOP (ir);                                      /* get opcode */
@@ -1834,7 +1818,6 @@ if (pc & 4) sim_val = ((t_uint64) ir) << 32;
 else sim_val = ir;
 if ((fprint_sym (st, pc & ~03, &sim_val, &cpu_unit, SWMASK ('M'))) > 0)
     fprintf (st, "(undefined) %08X", ir);
-fputc ('\n', st);                                       /* end line */
 return SCPE_OK;
 }
 
@@ -1842,30 +1825,18 @@ return SCPE_OK;
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 k, di, lnt;
-CONST char *cptr = (CONST char *) desc;
-t_stat r;
-InstHistory *h;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
 
-if (hst_lnt == 0) return SCPE_NOFNC;                    /* enabled? */
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "PC               Ra               Rb               IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0) di = di + hst_lnt;
-fprintf (st, "PC               Ra               Rb               IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->pc & HIST_PC) {                              /* instruction? */
-        cpu_fprint_one_inst (st, h->ir, h->pc, h->ra, h->rb);
-        }                                               /* end if */
-    }                                                   /* end for */
-return SCPE_OK;
+cpu_fprint_one_inst (st, h->ir, h->pc, h->ra, h->rb);
 }
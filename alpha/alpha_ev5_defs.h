@@ -55,7 +55,7 @@
 #define VA_GETOFF(x)    (((uint32) (x)) & VA_M_OFF)
 #define VA_GETVPN(x)    (((uint32) ((x) >> VA_V_VPN)) & VA_M_VPN)
 #define VA_GETSEXT(x)   (((uint32) ((x) >> VA_V_SEXT)) & VA_M_SEXT)
-#define PHYS_ADDR(p,v)  (((((t_uint64) (p)) < VA_N_OFF) | VA_GETOFF (v)) & EV5_PA_MASK)
+#define PHYS_ADDR(p,v)  (((((t_uint64) (p)) << VA_N_OFF) | VA_GETOFF (v)) & EV5_PA_MASK)
 
 /* 43b and 32b superpages - present in all implementations */
 
@@ -87,6 +87,21 @@ typedef struct {
     uint32                      pte;                    /* swre/pte */
     } TLBENT;
 
+/* Host translation cache - direct mapped by VPN, a subset of the TLB */
+
+#define XTC_WIDTH               11
+#define XTC_SIZE                (1u << XTC_WIDTH)
+#define XTC_M_IDX               (XTC_SIZE - 1)
+#define XTC_IDX(v)              (((v) ^ ((v) >> XTC_WIDTH)) & XTC_M_IDX)
+
+typedef struct {
+    uint32                      tag;                    /* vpn */
+    uint32                      asn;                    /* addr space # */
+    uint32                      pte;                    /* swre/pte */
+    t_uint64                    pa;                     /* page phys addr */
+    t_uint64                    *mp;                    /* page in M, or NULL */
+    } XTCENT;
+
 /* Register shadow */
 
 #define PALSHAD_SIZE            8
@@ -423,6 +438,7 @@ void dtlb_set_spage (uint32 spage);
 TLBENT *dtlb_lookup (uint32 vpn);
 TLBENT *dtlb_load (uint32 vpn, t_uint64 pte);
 t_uint64 dtlb_read (void);
+void tlb_flush_host (void);
 
 #endif
 
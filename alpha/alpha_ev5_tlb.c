@@ -46,6 +46,17 @@
         tlb_ia                  TLB invalidate all
         tlb_is                  TLB invalidate single
         tlb_set_cm              TLB set current mode
+        tlb_flush_host          flush host translation caches
+        trans_im                translate instruction address to host memory
+        trans_dm                translate data address to host memory
+
+   In front of each TLB is a direct mapped host translation cache (XTC),
+   indexed by VPN and tagged with VPN and ASN.  Each entry is a copy of a
+   translation found in the TLB, together with the physical page address
+   and, for main memory, a pointer to the page in M.  The XTC is kept a
+   subset of the TLB: whenever a TLB entry is replaced or invalidated, the
+   XTC entries for all pages it maps are invalidated.  ASN changes need no
+   action, since entries are tagged with the ASN (or are ASM).
 */
 
 #include "alpha_defs.h"
@@ -68,6 +79,8 @@ uint32 dtlb_asn = 0;
 uint32 dtlb_nlu = 0;
 TLBENT d_mini_tlb;
 TLBENT dtlb[DTLB_SIZE];
+XTCENT ixtc[XTC_SIZE];                                  /* host xlate caches */
+XTCENT dxtc[XTC_SIZE];
 
 uint32 cm_eacc = ACC_E (MODE_K);                        /* precomputed */
 uint32 cm_racc = ACC_R (MODE_K);                        /* access checks */
@@ -75,10 +88,16 @@ uint32 cm_wacc = ACC_W (MODE_K);
 uint32 cm_macc = ACC_M (MODE_K);
 
 extern t_uint64 p1;
+extern t_uint64 *M;
 extern jmp_buf save_env;
+extern UNIT cpu_unit;
 
 uint32 mm_exc (uint32 macc);
 void tlb_inval (TLBENT *tlbp);
+TLBENT *tlb_find (TLBENT *tlb, int32 size, uint32 asn, uint32 vpn);
+void xtc_fill (XTCENT *xp, uint32 vpn, uint32 asn, TLBENT *tlbp);
+void xtc_inval (XTCENT *xtc, uint32 tag, uint32 gh_mask);
+void xtc_flush (XTCENT *xtc);
 t_stat itlb_reset (void);
 t_stat dtlb_reset (void);
 int tlb_comp (const void *e1, const void *e2);
@@ -130,6 +149,7 @@ t_uint64 trans_i (t_uint64 va)
 uint32 va_sext = VA_GETSEXT (va);
 uint32 vpn = VA_GETVPN (va);
 TLBENT *tlbp;
+XTCENT *xp;
 
 if ((va_sext != 0) && (va_sext != VA_M_SEXT))           /* invalid virt addr? */
     ABORT1 (va, EXC_BVA + EXC_E);
@@ -141,8 +161,16 @@ if ((itlb_spage & SPEN_32) && (VPN_GETSP32 (vpn) == 0x1FFE)) {
     if (itlb_cm != MODE_K) ABORT1 (va, EXC_ACV + EXC_E);
     return (va & SP32_MASK);                            /* 32b superpage? */
     }
+xp = &ixtc[XTC_IDX (vpn)];
+if ((xp->tag == vpn) &&                                 /* in host cache? */
+    ((xp->asn == itlb_asn) || (xp->pte & PTE_ASM))) {
+    if (cm_eacc & ~xp->pte)                             /* check access */
+        ABORT1 (va, mm_exc (cm_eacc & ~xp->pte) | EXC_E);
+    return xp->pa | VA_GETOFF (va);
+    }
 if (!(tlbp = itlb_lookup (vpn)))                        /* lookup vpn; miss? */
     ABORT1 (va, EXC_TBM + EXC_E);                       /* abort reference */
+xtc_fill (xp, vpn, itlb_asn, tlbp);                     /* cache translation */
 if (cm_eacc & ~tlbp->pte)                               /* check access */
     ABORT1 (va, mm_exc (cm_eacc & ~tlbp->pte) | EXC_E);
 return PHYS_ADDR (tlbp->pfn, va);                       /* return phys addr */
@@ -153,6 +181,7 @@ t_uint64 trans_d (t_uint64 va, uint32 acc)
 uint32 va_sext = VA_GETSEXT (va);
 uint32 vpn = VA_GETVPN (va);
 TLBENT *tlbp;
+XTCENT *xp;
 
 if ((va_sext != 0) && (va_sext != VA_M_SEXT))           /* invalid virt addr? */
     ABORT1 (va, EXC_BVA + MM_RW (acc));
@@ -164,13 +193,64 @@ if ((dtlb_spage & SPEN_32) && (VPN_GETSP32 (vpn) == 0x1FFE)) {
     if (dtlb_cm != MODE_K) ABORT1 (va, EXC_ACV + MM_RW (acc));
     return (va & SP32_MASK);                            /* 32b superpage? */
     }
+xp = &dxtc[XTC_IDX (vpn)];
+if ((xp->tag == vpn) &&                                 /* in host cache? */
+    ((xp->asn == dtlb_asn) || (xp->pte & PTE_ASM))) {
+    if (acc & ~xp->pte)                                 /* check access */
+        ABORT1 (va, mm_exc (acc & ~xp->pte) | MM_RW (acc));
+    return xp->pa | VA_GETOFF (va);
+    }
 if (!(tlbp = dtlb_lookup (vpn)))                        /* lookup vpn; miss? */
     ABORT1 (va, EXC_TBM + MM_RW (acc));                 /* abort reference */
+xtc_fill (xp, vpn, dtlb_asn, tlbp);                     /* cache translation */
 if (acc & ~tlbp->pte)                                   /* check access */
     ABORT1 (va, mm_exc (acc & ~tlbp->pte) | MM_RW (acc));
 return PHYS_ADDR (tlbp->pfn, va);                       /* return phys addr */
 }
 
+/* Translate address to host memory, instruction and data
+
+   Inputs:
+        va      =       virtual address
+        acc     =       (data only) access mode
+   Outputs:
+        pointer to the quadword in M containing va, or NULL
+
+   Only translations already in the host cache, for main memory, and
+   passing the access check are returned; anything else returns NULL and
+   the caller uses trans_i or trans_d, which take any fault and fill the
+   cache.  Superpage references are never cached, since the cache is
+   flushed whenever the superpage enables change.
+*/
+
+t_uint64 *trans_im (t_uint64 va)
+{
+uint32 va_sext = VA_GETSEXT (va);
+uint32 vpn = VA_GETVPN (va);
+XTCENT *xp = &ixtc[XTC_IDX (vpn)];
+
+if ((xp->tag != vpn) || (xp->mp == NULL) ||             /* not cached mem? */
+    ((xp->asn != itlb_asn) && !(xp->pte & PTE_ASM)) ||
+    (cm_eacc & ~xp->pte) ||                             /* access fails? */
+    ((va_sext != 0) && (va_sext != VA_M_SEXT)))         /* invalid virt addr? */
+    return NULL;
+return xp->mp + (VA_GETOFF (va) >> 3);
+}
+
+t_uint64 *trans_dm (t_uint64 va, uint32 acc)
+{
+uint32 va_sext = VA_GETSEXT (va);
+uint32 vpn = VA_GETVPN (va);
+XTCENT *xp = &dxtc[XTC_IDX (vpn)];
+
+if ((xp->tag != vpn) || (xp->mp == NULL) ||             /* not cached mem? */
+    ((xp->asn != dtlb_asn) && !(xp->pte & PTE_ASM)) ||
+    (acc & ~xp->pte) ||                                 /* access fails? */
+    ((va_sext != 0) && (va_sext != VA_M_SEXT)))         /* invalid virt addr? */
+    return NULL;
+return xp->mp + (VA_GETOFF (va) >> 3);
+}
+
 /* Generate a memory management error code, based on the access check bits not
    set in PTE
 
@@ -198,12 +278,14 @@ uint32 vpn = VA_GETVPN (va);
 TLBENT *itlbp, *dtlbp;
 
 if ((va_sext != 0) && (va_sext != VA_M_SEXT)) return;
-if ((flags & TLB_CI) && (itlbp = itlb_lookup (vpn))) {
+if ((flags & TLB_CI) && (itlbp = tlb_find (itlb, ITLB_SIZE, itlb_asn, vpn))) {
+    xtc_inval (ixtc, itlbp->tag, itlbp->gh_mask);
     tlb_inval (itlbp);
     tlb_inval (&i_mini_tlb);
     ITLB_SORT;
     }
-if ((flags & TLB_CD) && (dtlbp = dtlb_lookup (vpn))) {
+if ((flags & TLB_CD) && (dtlbp = tlb_find (dtlb, DTLB_SIZE, dtlb_asn, vpn))) {
+    xtc_inval (dxtc, dtlbp->tag, dtlbp->gh_mask);
     tlb_inval (dtlbp);
     tlb_inval (&d_mini_tlb);
     DTLB_SORT;
@@ -227,6 +309,7 @@ if (flags & TLB_CI) {
         if (!(itlb[i].pte & PTE_ASM)) tlb_inval (&itlb[i]);
         }
     tlb_inval (&i_mini_tlb);
+    xtc_flush (ixtc);
     ITLB_SORT;
     }
 if (flags & TLB_CD) {
@@ -234,34 +317,32 @@ if (flags & TLB_CD) {
         if (!(dtlb[i].pte & PTE_ASM)) tlb_inval (&dtlb[i]);
         }
     tlb_inval (&d_mini_tlb);
+    xtc_flush (dxtc);
     DTLB_SORT;
     }
 return;
 }
 
-/* TLB lookup */
+/* TLB lookup - mini TLB, then binary search of the sorted TLB
 
-TLBENT *itlb_lookup (uint32 vpn)
+   The lookup routines return a copy of the matching entry in the mini
+   TLB; tlb_find returns the matching entry in the TLB itself.
+*/
+
+TLBENT *tlb_find (TLBENT *tlb, int32 size, uint32 asn, uint32 vpn)
 {
 int32 p, hi, lo;
 
-if (vpn == i_mini_tlb.tag) return &i_mini_tlb;
 lo = 0;                                                 /* initial bounds */
-hi = ITLB_SIZE - 1;
+hi = size - 1;
 do {
     p = (lo + hi) >> 1;                                 /* probe */
-    if ((itlb_asn == itlb[p].asn) && 
-        (((vpn ^ itlb[p].tag) &
-         ~((uint32) itlb[p].gh_mask)) == 0)) {          /* match to TLB? */
-        i_mini_tlb.tag = vpn;
-        i_mini_tlb.pte = itlb[p].pte;
-        i_mini_tlb.pfn = itlb[p].pfn;
-        itlb_nlu = itlb[p].idx + 1;
-        if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
-        return &i_mini_tlb;
-        }
-    if ((itlb_asn < itlb[p].asn) ||
-        ((itlb_asn == itlb[p].asn) && (vpn < itlb[p].tag)))
+    if ((asn == tlb[p].asn) && 
+        (((vpn ^ tlb[p].tag) &
+         ~((uint32) tlb[p].gh_mask)) == 0))             /* match to TLB? */
+        return &tlb[p];
+    if ((asn < tlb[p].asn) ||
+        ((asn == tlb[p].asn) && (vpn < tlb[p].tag)))
         hi = p - 1;                                     /* go down? p is upper */
     else lo = p + 1;                                    /* go up? p is lower */
     }
@@ -269,32 +350,32 @@ while (lo <= hi);
 return NULL;
 }
 
+TLBENT *itlb_lookup (uint32 vpn)
+{
+TLBENT *tlbp;
+
+if (vpn == i_mini_tlb.tag) return &i_mini_tlb;
+if (!(tlbp = tlb_find (itlb, ITLB_SIZE, itlb_asn, vpn))) return NULL;
+i_mini_tlb.tag = vpn;
+i_mini_tlb.pte = tlbp->pte;
+i_mini_tlb.pfn = tlbp->pfn;
+itlb_nlu = tlbp->idx + 1;
+if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
+return &i_mini_tlb;
+}
+
 TLBENT *dtlb_lookup (uint32 vpn)
 {
-int32 p, hi, lo;
+TLBENT *tlbp;
 
 if (vpn == d_mini_tlb.tag) return &d_mini_tlb;
-lo = 0;                                                 /* initial bounds */
-hi = DTLB_SIZE - 1;
-do {
-    p = (lo + hi) >> 1;                                 /* probe */
-    if ((dtlb_asn == dtlb[p].asn) && 
-        (((vpn ^ dtlb[p].tag) &
-         ~((uint32) dtlb[p].gh_mask)) == 0)) {          /* match to TLB? */
-        d_mini_tlb.tag = vpn;
-        d_mini_tlb.pte = dtlb[p].pte;
-        d_mini_tlb.pfn = dtlb[p].pfn;
-        dtlb_nlu = dtlb[p].idx + 1;
-        if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
-        return &d_mini_tlb;
-        }
-    if ((dtlb_asn < dtlb[p].asn) ||
-        ((dtlb_asn == dtlb[p].asn) && (vpn < dtlb[p].tag)))
-        hi = p - 1;                                     /* go down? p is upper */
-    else lo = p + 1;                                    /* go up? p is lower */
-    }
-while (lo <= hi);
-return NULL;
+if (!(tlbp = tlb_find (dtlb, DTLB_SIZE, dtlb_asn, vpn))) return NULL;
+d_mini_tlb.tag = vpn;
+d_mini_tlb.pte = tlbp->pte;
+d_mini_tlb.pfn = tlbp->pfn;
+dtlb_nlu = tlbp->idx + 1;
+if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
+return &d_mini_tlb;
 }
 
 /* Load TLB entry at NLU pointer, advance NLU pointer */
@@ -308,12 +389,14 @@ for (i = 0; i < ITLB_SIZE; i++) {
         TLBENT *tlbp = itlb + i;
         itlb_nlu = itlb_nlu + 1;
         if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
+        xtc_inval (ixtc, tlbp->tag, tlbp->gh_mask);     /* uncache old entry */
         tlbp->tag = vpn;
         tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
         tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
         tlbp->asn = itlb_asn;
         gh = PTE_GETGH (tlbp->pte);
         tlbp->gh_mask = (1u << (3 * gh)) - 1;
+        xtc_inval (ixtc, vpn, tlbp->gh_mask);           /* and pages it maps */
         tlb_inval (&i_mini_tlb);
         ITLB_SORT;
         return tlbp;
@@ -333,12 +416,14 @@ for (i = 0; i < DTLB_SIZE; i++) {
         TLBENT *tlbp = dtlb + i;
         dtlb_nlu = dtlb_nlu + 1;
         if (dtlb_nlu >= ITLB_SIZE) dtlb_nlu = 0;
+        xtc_inval (dxtc, tlbp->tag, tlbp->gh_mask);     /* uncache old entry */
         tlbp->tag = vpn;
         tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
         tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
         tlbp->asn = dtlb_asn;
         gh = PTE_GETGH (tlbp->pte);
         tlbp->gh_mask = (1u << (3 * gh)) - 1;
+        xtc_inval (dxtc, vpn, tlbp->gh_mask);           /* and pages it maps */
         tlb_inval (&d_mini_tlb);
         DTLB_SORT;
         return tlbp;
@@ -419,12 +504,16 @@ return;
 
 void itlb_set_spage (uint32 spage)
 {
+if (spage != itlb_spage)                                /* superpages mask */
+    xtc_flush (ixtc);                                   /* the TLB */
 itlb_spage = spage;
 return;
 }
 
 void dtlb_set_spage (uint32 spage)
 {
+if (spage != dtlb_spage)
+    xtc_flush (dxtc);
 dtlb_spage = spage;
 return;
 }
@@ -470,6 +559,55 @@ tlbp->gh_mask = 0;
 return;
 }
 
+/* Host translation cache routines */
+
+void xtc_fill (XTCENT *xp, uint32 vpn, uint32 asn, TLBENT *tlbp)
+{
+xp->tag = vpn;
+xp->asn = asn;
+xp->pte = tlbp->pte;
+xp->pa = PHYS_ADDR (tlbp->pfn, 0);
+xp->mp = ADDR_IS_MEM (xp->pa)? M + (xp->pa >> 3): NULL;
+return;
+}
+
+/* Invalidate the cached pages mapped by a TLB entry, in any ASN */
+
+void xtc_inval (XTCENT *xtc, uint32 tag, uint32 gh_mask)
+{
+uint32 vpn, n;
+XTCENT *xp;
+
+if (tag == INV_TAG)                                     /* entry not in use? */
+    return;
+if (gh_mask >= XTC_M_IDX) {                             /* covers the cache? */
+    xtc_flush (xtc);
+    return;
+    }
+for (vpn = tag & ~gh_mask, n = 0; n <= gh_mask; vpn++, n++) {
+    xp = &xtc[XTC_IDX (vpn)];
+    if (xp->tag == vpn)
+        xp->tag = INV_TAG;
+    }
+return;
+}
+
+void xtc_flush (XTCENT *xtc)
+{
+uint32 i;
+
+for (i = 0; i < XTC_SIZE; i++)
+    xtc[i].tag = INV_TAG;
+return;
+}
+
+void tlb_flush_host (void)
+{
+xtc_flush (ixtc);
+xtc_flush (dxtc);
+return;
+}
+
 /* Compare routine for qsort */
 
 int tlb_comp (const void *e1, const void *e2)
@@ -500,6 +638,7 @@ for (i = 0; i < ITLB_SIZE; i++) {
     itlb[i].idx = i;
     }
 tlb_inval (&i_mini_tlb);
+xtc_flush (ixtc);
 return SCPE_OK;
 }
 /* DTLB reset */
@@ -518,6 +657,7 @@ for (i = 0; i < DTLB_SIZE; i++) {
     dtlb[i].idx = i;
     }
 tlb_inval (&d_mini_tlb);
+xtc_flush (dxtc);
 return SCPE_OK;
 }
 
@@ -46,12 +46,18 @@
 
    43b superpage                0xFFFFFC0000000000:0xFFFFFDFFFFFFFFFF
    32b superpage                0xFFFFFFFF80000000:0xFFFFFFFFBFFFFFFF
+
+   The normal virtual references first try trans_im/trans_dm, which return
+   a host pointer into M for pages in the TLB's host translation cache,
+   and fall back to trans_i/trans_d and the physical routines otherwise.
 */
 
 #include "alpha_defs.h"
 
 extern t_uint64 trans_i (t_uint64 va);
 extern t_uint64 trans_d (t_uint64 va, uint32 acc);
+extern t_uint64 *trans_im (t_uint64 va);
+extern t_uint64 *trans_dm (t_uint64 va, uint32 acc);
 
 extern t_uint64 *M;
 extern t_uint64 p1;
@@ -70,39 +76,55 @@ extern UNIT cpu_unit;
 
 t_uint64 ReadB (t_uint64 va)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
-if (dmapen) pa = trans_d (va, cm_racc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_racc)) != NULL)          /* cached mem page? */
+        return (((*mp >> ((((uint32) va) & 07) << 3))) & M8);
+    pa = trans_d (va, cm_racc);
+    }
 else pa = va;
 return ReadPB (pa);
 }
 
 t_uint64 ReadW (t_uint64 va)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 1) ABORT1 (va, EXC_ALIGN);                     /* must be W aligned */
-if (dmapen) pa = trans_d (va, cm_racc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_racc)) != NULL)          /* cached mem page? */
+        return (((*mp >> ((((uint32) va) & 06) << 3))) & M16);
+    pa = trans_d (va, cm_racc);
+    }
 else pa = va;
 return ReadPW (pa);
 }
 
 t_uint64 ReadL (t_uint64 va)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 3) ABORT1 (va, EXC_ALIGN);                     /* must be L aligned */
-if (dmapen) pa = trans_d (va, cm_racc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_racc)) != NULL)          /* cached mem page? */
+        return (((*mp >> ((((uint32) va) & 04) << 3))) & M32);
+    pa = trans_d (va, cm_racc);
+    }
 else pa = va;
 return ReadPL (pa);
 }
 
 t_uint64 ReadQ (t_uint64 va)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 7) ABORT1 (va, EXC_ALIGN);                     /* must be Q aligned */
-if (dmapen) pa = trans_d (va, cm_racc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_racc)) != NULL)          /* cached mem page? */
+        return *mp;
+    pa = trans_d (va, cm_racc);
+    }
 else pa = va;
 return ReadPQ (pa);
 }
@@ -133,9 +155,13 @@ return ReadPQ (pa);
 
 uint32 ReadI (t_uint64 va)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
-if (!pal_mode) pa = trans_i (va);                       /* mapping on? */
+if (!pal_mode) {                                        /* mapping on? */
+    if ((mp = trans_im (va)) != NULL)                   /* cached mem page? */
+        return (uint32) (*mp >> ((((uint32) va) & 04) << 3));
+    pa = trans_i (va);
+    }
 else pa = va;
 return (uint32) ReadPL (pa);
 }
@@ -151,9 +177,17 @@ return (uint32) ReadPL (pa);
 
 void WriteB (t_uint64 va, t_uint64 dat)
 {
-t_uint64 pa;
-
-if (dmapen) pa = trans_d (va, cm_wacc);                 /* mapping on? */
+t_uint64 pa, *mp;
+
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_wacc)) != NULL) {        /* cached mem page? */
+        uint32 bo = ((uint32) va) & 07;
+        *mp = (*mp & ~(((t_uint64) M8) << (bo << 3))) |
+            ((dat & M8) << (bo << 3));
+        return;
+        }
+    pa = trans_d (va, cm_wacc);
+    }
 else pa = va;
 WritePB (pa, dat);
 return;
@@ -161,10 +195,18 @@ return;
 
 void WriteW (t_uint64 va, t_uint64 dat)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 1) ABORT1 (va, EXC_ALIGN);                     /* must be W aligned */
-if (dmapen) pa = trans_d (va, cm_wacc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_wacc)) != NULL) {        /* cached mem page? */
+        uint32 bo = ((uint32) va) & 07;
+        *mp = (*mp & ~(((t_uint64) M16) << (bo << 3))) |
+            ((dat & M16) << (bo << 3));
+        return;
+        }
+    pa = trans_d (va, cm_wacc);
+    }
 else pa = va;
 WritePW (pa, dat);
 return;
@@ -172,10 +214,17 @@ return;
 
 void WriteL (t_uint64 va, t_uint64 dat)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 3) ABORT1 (va, EXC_ALIGN);                     /* must be L aligned */
-if (dmapen) pa = trans_d (va, cm_wacc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_wacc)) != NULL) {        /* cached mem page? */
+        if (va & 4) *mp = (*mp & M32) | ((dat & M32) << 32);
+        else *mp = (*mp & ~((t_uint64) M32)) | (dat & M32);
+        return;
+        }
+    pa = trans_d (va, cm_wacc);
+    }
 else pa = va;
 WritePL (pa, dat);
 return;
@@ -183,10 +232,16 @@ return;
 
 void WriteQ (t_uint64 va, t_uint64 dat)
 {
-t_uint64 pa;
+t_uint64 pa, *mp;
 
 if (va & 7) ABORT1 (va, EXC_ALIGN);                     /* must be Q aligned */
-if (dmapen) pa = trans_d (va, cm_wacc);                 /* mapping on? */
+if (dmapen) {                                           /* mapping on? */
+    if ((mp = trans_dm (va, cm_wacc)) != NULL) {        /* cached mem page? */
+        *mp = dat;
+        return;
+        }
+    pa = trans_d (va, cm_wacc);
+    }
 else pa = va;
 WritePQ (pa, dat);
 return;
@@ -71,12 +71,11 @@ typedef struct {
   uint16 AC;
   uint16 L;
 } HISTORY;
-static HISTORY *history = NULL;
-static uint32 history_i, history_m, history_n;
 
 /* Function declaration. */
 static t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 static t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 static t_stat cpu_ex (t_value *vptr, t_addr ea, UNIT *uptr, int32 sw);
 static t_stat cpu_dep (t_value val, t_addr ea, UNIT *uptr, int32 sw);
 static t_stat cpu_reset (DEVICE *dptr);
@@ -104,7 +103,7 @@ static MTAB cpu_mod[] = {
   { UNIT_MSIZE, 4, "16K", "16K", &cpu_set_size },
   { MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &sim_set_idle, &sim_show_idle },
   { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
-  { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+  { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
     &cpu_set_hist, &cpu_show_hist },
   { 0 }
 };
@@ -356,10 +355,12 @@ cpu_insn (void)
     }
   }
 
-  if (history) {
-    history[history_i].PC = PC;
-    history[history_i].IR = IR;
-    history[history_i].MA = MA;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_add ();
+
+    h->PC = PC;
+    h->IR = IR;
+    h->MA = MA;
   }
 
   pcinc (1);
@@ -442,13 +443,12 @@ cpu_insn (void)
     break;
   }
 
-  if (history) {
-    history[history_i].MB = MB;
-    history[history_i].AC = AC;
-    history[history_i].L = L;
-    history_i = (history_i + 1) % history_m;
-    if (history_n < history_m)
-      history_n++;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_last ();
+
+    h->MB = MB;
+    h->AC = AC;
+    h->L = L;
   }
 }
 
@@ -501,58 +501,35 @@ t_stat sim_instr (void)
 static t_stat
 cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-  t_stat r;
-  uint32 x;
-
-  if (cptr == NULL)
-    return SCPE_ARG;
-
-  x = get_uint (cptr, 10, 1000000, &r);
-  if (r != SCPE_OK)
-    return r;
-
-  history = (HISTORY *)calloc (x, sizeof (*history));
-  if (history == NULL)
-    return SCPE_MEM;
-
-  history_m = x;
-  history_n = 0;
-  history_i = 0;
-  return SCPE_OK;
+  return sim_hist_set (&cpu_dev, sizeof (HISTORY), &cpu_fprint_hist, 0, 1000000, cptr);
 }
 
 static t_stat
 cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-  t_value insn;
-  uint32 i, j;
-
-  fprintf (st, "PC____ IR____ MA____ MB____ AC____ L\n");
+  return sim_hist_show (st, &cpu_dev, sizeof (HISTORY), &cpu_fprint_hist, (CONST char *)desc);
+}
 
-  if (history_i >= history_n)
-    j = history_i - history_n;
-  else
-    j = history_m + history_i - history_n;
+static void
+cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+  const HISTORY *h = (const HISTORY *)rec;
+  t_value insn;
 
-  for (i = 0; i < history_n; i++) {
-    if (stop_cpu) {                 /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                      /* abandon remaining output */
-    }
-    fprintf (st, "%06o %06o %06o %06o %06o %d  ",
-             history[j].PC,
-             history[j].IR,
-             history[j].MA,
-             history[j].MB,
-             history[j].AC,
-             history[j].L);
-    insn = history[j].IR;
-    fprint_sym (st, history[j].PC, &insn, NULL, SWMASK ('M'));
-    fputc ('\n', st);
-    j = (j + 1) % history_m;
+  if (h == NULL) {
+    fprintf (st, "PC____ IR____ MA____ MB____ AC____ L\n");
+    return;
   }
 
-  return SCPE_OK;
+  fprintf (st, "%06o %06o %06o %06o %06o %d  ",
+           h->PC,
+           h->IR,
+           h->MA,
+           h->MB,
+           h->AC,
+           h->L);
+  insn = h->IR;
+  fprint_sym (st, h->PC, &insn, NULL, SWMASK ('M'));
 }
 
 static t_stat cpu_ex (t_value *vptr, t_addr ea, UNIT *uptr, int32 sw)
@@ -70,8 +70,6 @@ typedef struct {
   uint16 A;
   uint16 L;
 } HISTORY;
-static HISTORY *history = NULL;
-static uint32 history_i, history_m, history_n;
 
 /* Function declaration. */
 static t_stat cpu_ex(t_value *vptr, t_addr ea, UNIT *uptr, int32 sw);
@@ -79,6 +77,7 @@ static t_stat cpu_dep(t_value val, t_addr ea, UNIT *uptr, int32 sw);
 static t_stat cpu_reset(DEVICE *dptr);
 static t_stat cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 static t_stat cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist(FILE *st, const void *rec, t_bool timed);
 static t_stat linc_boot(int32 flag, CONST char *ptr);
 static t_stat linc_do(int32 flag, CONST char *ptr);
 
@@ -110,7 +109,7 @@ REG cpu_reg[] = {
 };
 
 static MTAB cpu_mod[] = {
-  { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+  { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
     &cpu_set_hist, &cpu_show_hist },
   { 0 }
 };
@@ -658,10 +657,12 @@ cpu_insn(void)
   if ((C & 07000) == 01000)
     cpu_indexing();
 
-  if (history) {
-    history[history_i].P = P;
-    history[history_i].C = C;
-    history[history_i].S = S;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_add();
+
+    h->P = P;
+    h->C = C;
+    h->S = S;
   }
 
   /* Cycle 2, or O. */
@@ -775,13 +776,12 @@ cpu_insn(void)
     break;
   }
 
-  if (history) {
-    history[history_i].B = B;
-    history[history_i].A = A;
-    history[history_i].L = L;
-    history_i = (history_i + 1) % history_m;
-    if (history_n < history_m)
-      history_n++;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_last();
+
+    h->B = B;
+    h->A = A;
+    h->L = L;
   }
 }
 
@@ -850,10 +850,12 @@ static void cpu_interrupt(void)
   cpu_set_S(021);
   cpu_mem_read();
   C = B;
-  if (history) {
-    history[history_i].P = 07777;
-    history[history_i].C = C;
-    history[history_i].S = S;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_add();
+
+    h->P = 07777;
+    h->C = C;
+    h->S = S;
   }
 
   ENI = 0; /* Except for OPR. */
@@ -867,12 +869,11 @@ static void cpu_interrupt(void)
   else
     sim_debug(DBG_INT, &cpu_dev, "Invalid interrupt instruction.\n");
 
-  if (history) {
-    history[history_i].B = B;
-    history[history_i].A = A;
-    history_i = (history_i + 1) % history_m;
-    if (history_n < history_m)
-      history_n++;
+  if (sim_hist_lnt) {
+    HISTORY *h = (HISTORY *)sim_hist_last();
+
+    h->B = B;
+    h->A = A;
   }
 }
 
@@ -948,57 +949,38 @@ static t_stat cpu_dep(t_value val, t_addr ea, UNIT *uptr, int32 sw)
 static t_stat
 cpu_set_hist(UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-  t_stat r;
-  uint32 x;
-
-  if (cptr == NULL)
-    return SCPE_ARG;
-
-  x = get_uint (cptr, 10, 1000000, &r);
-  if (r != SCPE_OK)
-    return r;
-
-  history = (HISTORY *)calloc (x, sizeof (*history));
-  if (history == NULL)
-    return SCPE_MEM;
-
-  history_m = x;
-  history_n = 0;
-  history_i = 0;
-  return SCPE_OK;
+  return sim_hist_set(&cpu_dev, sizeof(HISTORY), &cpu_fprint_hist, 0, 1000000, cptr);
 }
 
 static t_stat
 cpu_show_hist(FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-  t_value insn;
-  uint32 i, j;
-
-  fprintf (st, "P___ C___ S___ B___ A___ L\n");
+  return sim_hist_show(st, &cpu_dev, sizeof(HISTORY), &cpu_fprint_hist, (CONST char *)desc);
+}
 
-  if (history_i >= history_n)
-    j = history_i - history_n;
-  else
-    j = history_m + history_i - history_n;
+static void
+cpu_fprint_hist(FILE *st, const void *rec, t_bool timed)
+{
+  const HISTORY *h = (const HISTORY *)rec;
+  t_value insn;
 
-  for (i = 0; i < history_n; i++) {
-    if (history[j].P == 07777)
-      fprintf (st, "---- ");
-    else
-      fprintf (st, "%04o ", history[j].P);
-    fprintf (st, "%04o %04o %04o %04o %d  ",
-             history[j].C,
-             history[j].S,
-             history[j].B,
-             history[j].A,
-             history[j].L);
-    insn = history[j].C;
-    fprint_sym(st, history[j].P, &insn, NULL, SWMASK('M'));
-    fputc('\n', st);
-    j = (j + 1) % history_m;
+  if (h == NULL) {
+    fprintf(st, "P___ C___ S___ B___ A___ L\n");
+    return;
   }
 
-  return SCPE_OK;
+  if (h->P == 07777)
+    fprintf (st, "---- ");
+  else
+    fprintf (st, "%04o ", h->P);
+  fprintf (st, "%04o %04o %04o %04o %d  ",
+           h->C,
+           h->S,
+           h->B,
+           h->A,
+           h->L);
+  insn = h->C;
+  fprint_sym(st, h->P, &insn, NULL, SWMASK('M'));
 }
 
 static t_stat
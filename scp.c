@@ -438,6 +438,7 @@ sim_asynch_check = 0;                             /* try to force check */
 if (sim_idle_wait) {
     sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "wakeup from idle due to async event on %s after %d %s\n", sim_uname(uptr), event_time, sim_vm_interval_units);
     pthread_cond_signal (&sim_asynch_wake);
+    sim_idle_wakeup ();
     }
 }
 
@@ -534,6 +535,7 @@ t_stat sim_brk_showall (FILE *st, int32 sw);
 CONST char *sim_brk_getact (char *buf, int32 size);
 BRKTAB *sim_brk_new (t_addr loc, uint32 btyp);
 char *sim_brk_clract (void);
+static void _sim_hist_close (void);
 
 FILE *stdnul;
 
@@ -543,6 +545,7 @@ SCHTAB *get_rsearch (CONST char *cptr, int32 radix, SCHTAB *schptr);
 SCHTAB *get_asearch (CONST char *cptr, int32 radix, SCHTAB *schptr);
 int32 test_search (t_value *val, SCHTAB *schptr);
 static const char *get_glyph_gen (const char *iptr, char *optr, char mchar, t_bool ws_match, t_bool uc, t_bool quote, char escape_char);
+static char *_sim_read_line_trim (char *cptr, int32 size);
 typedef enum {
     SW_ERROR,           /* Parse Error */
     SW_BITMASK,         /* Bitmask Value or Not a switch */
@@ -641,6 +644,7 @@ t_addr sim_brk_match_addr;
 char *sim_brk_act[MAX_DO_NEST_LVL];
 char *sim_brk_act_buf[MAX_DO_NEST_LVL];
 BRKTAB **sim_brk_tab = NULL;
+uint32 sim_brk_pages[SIM_BRK_N_PAGE / 32];          /* pages holding breakpoints */
 int32 sim_brk_ent = 0;
 int32 sim_brk_lnt = 0;
 int32 sim_brk_ins = 0;
@@ -678,7 +682,24 @@ char *sim_deb_buffer = NULL;                            /* debug memory buffer *
 size_t sim_debug_buffer_offset = 0;                     /* debug memory buffer insertion offset */
 size_t sim_debug_buffer_inuse = 0;                      /* debug memory buffer inuse count */
 char *sim_prompt = NULL;                                /* prompt string */
-static FILE *sim_gotofile;                              /* the currently open do file */
+typedef struct DO_LINE {
+    char        *text;                                  /* trimmed line */
+    char        *cmd_name;                              /* command name last looked up */
+    CTAB        *cmdp;                                  /* command it resolved to */
+    } DO_LINE;
+typedef struct DO_LABEL {
+    char        *name;                                  /* label (upper case) */
+    int32       line;                                   /* index of the label's line */
+    struct DO_LABEL *next;                              /* hash chain */
+    } DO_LABEL;
+#define DO_LABEL_HASH_SIZE 64                           /* label hash buckets (power of 2) */
+typedef struct DO_SCRIPT {
+    DO_LINE     *lines;                                 /* script lines */
+    int32       count;                                  /* number of lines */
+    int32       next;                                   /* index of next line to execute */
+    DO_LABEL    *labels[DO_LABEL_HASH_SIZE];            /* label index */
+    } DO_SCRIPT;
+static DO_SCRIPT *sim_do_script;                        /* the currently executing do file */
 static int32 sim_goto_line[MAX_DO_NEST_LVL+1];          /* the current line number in the currently open do file */
 static int32 sim_do_echo = 0;                           /* the echo status of the currently open do file */
 static int32 sim_on_inherit = 0;                        /* the inherit status of on state and conditions when executing do files */
@@ -777,6 +798,21 @@ DEVICE sim_expect_dev = {
     NULL, NULL, NULL, NULL, NULL, NULL,
     sim_int_expect_description};
 
+static const char *sim_int_journal_description (DEVICE *dptr)
+{
+return "Input journal checkpoints";
+}
+
+static t_stat sim_jrn_svc (UNIT *uptr);
+static UNIT sim_jrn_unit = { UDATA (&sim_jrn_svc, 0, 0) };
+DEVICE sim_jrn_dev = {
+    "INT-JOURNAL", &sim_jrn_unit, NULL, NULL,
+    1, 0, 0, 0, 0, 0,
+    NULL, NULL, NULL, NULL, NULL, NULL,
+    NULL, DEV_NOSAVE, 0,
+    NULL, NULL, NULL, NULL, NULL, NULL,
+    sim_int_journal_description};
+
 static const char *sim_int_flush_description (DEVICE *dptr)
 {
 return "Open File Flush facility";
@@ -873,6 +909,7 @@ const struct scp_error {
          {"RUNTIME",   "Run time limit exhausted"},
          {"INCOMPDSK", "Incompatible Disk Container"},
          {"AMBASSIGN", "Ambiguous logical name"},
+         {"CHECKPOINT","Journal checkpoint"},
     };
 
 const size_t size_map[] = { sizeof (int8),
@@ -1085,6 +1122,52 @@ static const char simh_help1[] =
       " multiplexer devices, but the listening ports will be restored across a\n"
       " save/restore.\n"
        /***************** 80 character line width template *************************/
+      "2Recording and Replaying Input\n"
+      " A simulated system is deterministic apart from its input: console\n"
+      " keystrokes, multiplexer connections and data, received Ethernet frames\n"
+      " and the host clock.  The RECORD command journals that input so that a\n"
+      " run can be reproduced exactly with REPLAY, and so that execution can be\n"
+      " stepped backwards with STEP -B and CONTINUE -B.\n"
+#define HLP_RECORD      "*Commands Recording_and_Replaying_Input RECORD"
+      "3RECORD\n"
+      " The RECORD command saves the current state in a journal file and then\n"
+      " appends all input delivered to the simulated system to it:\n\n"
+      "++RECORD <filename> {checkpoint-interval}\n\n"
+      " Recording uses the pseudo clock, so if calibration is enabled RECORD\n"
+      " first does SET CLOCK NOCALIBRATE (which also disables asynchronous I/O).\n"
+      " While recording, the state is also saved (in temporary files) every\n"
+      " checkpoint-interval %Is, 10,000,000 by default, and the\n"
+      " latest 16 of these checkpoints are kept for reverse execution.\n"
+#define HLP_NORECORD    "*Commands Recording_and_Replaying_Input NORECORD"
+      "3NORECORD\n"
+      " The NORECORD command closes the journal and discards the checkpoints.\n"
+#define HLP_REPLAY      "*Commands Recording_and_Replaying_Input REPLAY"
+      "3REPLAY\n"
+      " The REPLAY command restores the state saved at the start of a journal\n"
+      " and then supplies the recorded input, at the recorded times, instead of\n"
+      " live input:\n\n"
+      "++REPLAY <filename>\n\n"
+      " Devices are not detached or attached, so the same files should be\n"
+      " attached as when the journal was recorded.  When the journal is used up\n"
+      " the simulator continues with live input.\n"
+      "3Reverse Execution\n"
+      " While recording or replaying, STEP -B {n} moves back n %Is\n"
+      " (1 by default) and CONTINUE -B moves back to the most recent point at\n"
+      " which execution would have stopped (a breakpoint, for example).  Both\n"
+      " restore a checkpoint and quietly replay forward from it, so they can\n"
+      " only reach back as far as the oldest checkpoint kept.  After moving\n"
+      " back, running forward replays the journal until its end and then\n"
+      " carries on recording.\n"
+      "4Notes:\n"
+      " 1) Live input received while replaying is discarded, as is output to\n"
+      " multiplexer lines.\n"
+      " 2) The contents of attached files are not part of the checkpoints, so\n"
+      " moving back over writes to them does not undo those writes.\n"
+      " 3) Breakpoint actions and counts are not honoured when moving back.\n"
+      " 4) If the simulator's behavior stops matching the journal while\n"
+      " replaying, replay ends there and, while recording, the unmatched part of\n"
+      " the journal is discarded.\n"
+       /***************** 80 character line width template *************************/
       "2Running A Simulated Program\n"
 #define HLP_RUN         "*Commands Running_A_Simulated_Program RUN"
       "3RUN {start_pc_addr} {UNTIL stop_pc_addr|\"output-string\"}\n"
@@ -1109,7 +1192,9 @@ static const char simh_help1[] =
 #define HLP_CONTINUE    "*Commands Running_A_Simulated_Program CONTINUE"
       "3CONTINUE\n"
       " The CONT command (abbreviated CO) does not reset devices and resumes\n"
-      " execution at the current PC.\n\n"
+      " execution at the current PC.  With the -B switch, while recording or\n"
+      " replaying input, execution moves back to the most recent stop condition\n"
+      " (see RECORD).\n\n"
 #define HLP_STEP        "*Commands Running_A_Simulated_Program STEP"
       "3STEP\n"
       " The STEP command (abbreviated S) resumes execution at the current PC for\n"
@@ -1118,6 +1203,8 @@ static const char simh_help1[] =
       "4Switches\n"
       " If the STEP command is invoked with the -T switch, the step command will\n"
       " cause execution to run for microseconds rather than %I.\n"
+      " With the -B switch, while recording or replaying input, execution moves\n"
+      " back by the number of %Is given (see RECORD).\n"
 #define HLP_NEXT        "*Commands Running_A_Simulated_Program NEXT"
       "3NEXT\n"
       " The NEXT command (abbreviated N) resumes execution at the current PC for\n"
@@ -1186,6 +1273,28 @@ static const char simh_help1[] =
       "++HELP CPU BREAK              display the breakpoint types supported\n"
       "+++++++++by the CPU device\n\n"
        /***************** 80 character line width template *************************/
+#define HLP_WATCH       "*Commands Stopping_The_Simulator User_Specified_Stop_Conditions WATCH"
+#define HLP_NOWATCH     "*Commands Stopping_The_Simulator User_Specified_Stop_Conditions WATCH"
+      "4Watchpoints\n"
+      " Simulators which support R (read) and W (write) breakpoints can stop\n"
+      " when a data reference touches a watched address.  Watchpoints are\n"
+      " breakpoints of those types, and are set and cleared with the WATCH and\n"
+      " NOWATCH commands:\n\n"
+      "++WATCH <addr range>{[count]}{,addr range...} {R|W|RW}{;action;action...}\n"
+      "++NOWATCH <addr range>{,addr range...} {R|W|RW}\n\n"
+      " If no access type is given, both reads and writes are watched.  Watched\n"
+      " addresses are displayed with SHOW BREAK.  Watching costs the simulator\n"
+      " nothing until a watchpoint is set, and then only for references to the\n"
+      " few pages which hold watched addresses.\n\n"
+      " Depending on the simulator, simulation stops at the reference (PDP-11)\n"
+      " or after the instruction which made it (VAX, PDP-10).\n"
+      "5Examples\n"
+      "++WATCH 1000                  stop on any reference to 1000\n"
+      "++WATCH 2000-2007 W           stop on writes to 2000 through 2007\n"
+      "++WATCH 300[5] R;EX 300       stop on the fifth read of 300 and\n"
+      "+++++++++display it\n"
+      "++NOWATCH ALL                 remove all watchpoints\n\n"
+       /***************** 80 character line width template *************************/
 #define HLP_DEBUG       "*Commands Stopping_The_Simulator User_Specified_Stop_Conditions DEBUG"
 #define HLP_NODEBUG     "*Commands Stopping_The_Simulator User_Specified_Stop_Conditions DEBUG"
       "4Debug\n"
@@ -1402,6 +1511,11 @@ static const char simh_help1[] =
       "+SET CONSOLE DBSIGNAL        enable gdb debugger signals via the\n"
       "++++++++                     specified DBGINT character\n"
       "+SET CONSOLE NODBSIGNAL      disable gdb debugger signals\n"
+      "+SET CONSOLE BATCH           write console output and read console input\n"
+      "++++++++                     through threads (stdin feeds the console\n"
+      "++++++++                     while the simulator runs; commands should\n"
+      "++++++++                     come from a DO script)\n"
+      "+SET CONSOLE NOBATCH         console I/O directly on the simulator thread\n"
        /***************** 80 character line width template *************************/
 #define HLP_SET_REMOTE "*Commands SET REMOTE"
       "3Remote\n"
@@ -1493,7 +1607,10 @@ static const char simh_help1[] =
       "+SET THROTTLE x%%             occupy x percent of the host capacity\n"
       "++++++++executing instructions\n"
       "+SET THROTTLE x/t            sleep for t milliseconds after executing x\n"
-      "++++++++%C\n\n"
+      "++++++++%C\n"
+      "+SET THROTTLE xM PACED{=u}   execute x million %C per second paced\n"
+      "++++++++in slices of u microseconds (default 100)\n"
+      "+SET THROTTLE xK PACED{=u}   execute x thousand %C per second paced\n\n"
       "+SET NOTHROTTLE              set simulation rate to maximum\n\n"
       " Throttling is only available on host systems that implement a precision\n"
       " real-time delay function.\n\n"
@@ -1502,6 +1619,11 @@ static const char simh_help1[] =
       " to wall clock time.  Very short running programs may complete before\n"
       " calibration completes and therefore before the simulated execution rate\n"
       " can match the desired rate.\n\n"
+      " The PACED option holds execution to a schedule on the host's monotonic\n"
+      " clock.  No calibration is needed, the rate is correct from the start,\n"
+      " and host sleep overshoot is absorbed by the following slices rather\n"
+      " than accumulating.  This gives steady period accurate pacing, which\n"
+      " matters for display and game programs.\n\n"
       " The SET NOTHROTTLE command turns off throttling.  The SHOW THROTTLE\n"
       " command shows the current settings for throttling and the calibration\n"
       " results\n\n"
@@ -1704,6 +1826,7 @@ static const char simh_help2[] =
       "+sh{ow} <dev> {arg,...}       show device parameters\n"
       "+sh{ow} <unit> {arg,...}      show unit parameters\n"
       "+sh{ow} ethernet              show ethernet devices\n"
+      "+sh{ow} ethernet statistics   show open ethernet device traffic statistics\n"
       "+sh{ow} serial                show serial devices\n"
       "+sh{ow} synchronous           show DDCMP synchronous interface devices\n"
       "+sh{ow} multiplexer {dev}     show open multiplexer device info\n"
@@ -2737,6 +2860,8 @@ static CTAB cmd_table[] = {
     { "BOOT",       &run_cmd,       RU_BOOT,    HLP_BOOT,       NULL, &run_cmd_message },
     { "BREAK",      &brk_cmd,       SSH_ST,     HLP_BREAK,      NULL, NULL },
     { "NOBREAK",    &brk_cmd,       SSH_CL,     HLP_NOBREAK,    NULL, NULL },
+    { "WATCH",      &watch_cmd,     SSH_ST,     HLP_WATCH,      NULL, NULL },
+    { "NOWATCH",    &watch_cmd,     SSH_CL,     HLP_NOWATCH,    NULL, NULL },
     { "DEBUG",      &debug_cmd,     1,          HLP_DEBUG,      NULL, NULL },
     { "NODEBUG",    &debug_cmd,     0,          HLP_NODEBUG,    NULL, NULL },
     { "ATTACH",     &attach_cmd,    0,          HLP_ATTACH,     NULL, NULL },
@@ -2746,6 +2871,9 @@ static CTAB cmd_table[] = {
     { "SAVE",       &save_cmd,      0,          HLP_SAVE,       NULL, NULL },
     { "RESTORE",    &restore_cmd,   0,          HLP_RESTORE,    NULL, NULL },
     { "GET",        &restore_cmd,   0,          NULL,           NULL, NULL },
+    { "RECORD",     &record_cmd,    1,          HLP_RECORD,     NULL, NULL },
+    { "NORECORD",   &record_cmd,    0,          HLP_NORECORD,   NULL, NULL },
+    { "REPLAY",     &replay_cmd,    0,          HLP_REPLAY,     NULL, NULL },
     { "LOAD",       &load_cmd,      0,          HLP_LOAD,       NULL, NULL },
     { "DUMP",       &load_cmd,      1,          HLP_DUMP,       NULL, NULL },
     { "EXIT",       &exit_cmd,      0,          HLP_EXIT,       NULL, NULL },
@@ -3195,6 +3323,7 @@ sim_register_internal_device (&sim_expect_dev);
 sim_register_internal_device (&sim_step_dev);
 sim_register_internal_device (&sim_flush_dev);
 sim_register_internal_device (&sim_runlimit_dev);
+sim_register_internal_device (&sim_jrn_dev);
 
 if ((stat = sim_ttinit ()) != SCPE_OK) {
     fprintf (stderr, "Fatal terminal initialization error\n%s\n",
@@ -3382,6 +3511,7 @@ cleanup_and_exit:
 
 sim_debug (SIM_DBG_SHUTDOWN, &sim_scp_dev, "Shutting Down: Status = %d - %s\n", SCPE_BARE_STATUS (stat), sim_error_text (stat));
 detach_all (0, TRUE);                                   /* close files */
+_sim_hist_close ();                                     /* close instruction history */
 if (sim_deb) {                                          /* If debugging */
     sim_switches |= SWMASK ('Q');                       /*   close debugging quietly */
     sim_set_deboff (0, NULL);                           /*   and cleanly */
@@ -4470,11 +4600,167 @@ snprintf (cbuf, sizeof (cbuf), "%s%s%s-%d", sim_relative_path (sim_do_filename[s
 return cbuf;
 }
 
+/* DO script images
+
+   A DO file is read into memory once, when the DO (or CALL) starts.  Each
+   line is stored trimmed exactly as read_line would return it, and the
+   script's labels are entered into a hash index, so GOTO and CALL find
+   their targets without rereading the file.  Argument and variable
+   substitution still happens as each line executes since its result
+   depends on the arguments and environment at that moment.  Each line
+   remembers the command its (substituted) command name last resolved to,
+   so lines executed repeatedly skip the command table search as long as
+   the name is unchanged.
+*/
+
+static uint32 _sim_do_label_hash (const char *label)
+{
+uint32 h = 0;
+
+while (*label)
+    h = (h * 31) + (uint8)*label++;
+return h & (DO_LABEL_HASH_SIZE - 1);
+}
+
+static void _sim_do_script_free (DO_SCRIPT *sp)
+{
+int32 i;
+
+if (sp == NULL)
+    return;
+for (i = 0; i < sp->count; i++) {
+    free (sp->lines[i].text);
+    free (sp->lines[i].cmd_name);
+    }
+free (sp->lines);
+for (i = 0; i < DO_LABEL_HASH_SIZE; i++) {
+    while (sp->labels[i]) {
+        DO_LABEL *lbl = sp->labels[i];
+
+        sp->labels[i] = lbl->next;
+        free (lbl->name);
+        free (lbl);
+        }
+    }
+free (sp);
+}
+
+static t_stat _sim_do_script_add_label (DO_SCRIPT *sp, const char *text, int32 line)
+{
+char gbuf[CBUFSIZE];
+DO_LABEL *lbl;
+uint32 h;
+
+++text;                                                 /* skip : */
+while (sim_isspace (*text))                             /* skip blanks */
+    ++text;
+get_glyph (text, gbuf, 0);                              /* get label glyph */
+h = _sim_do_label_hash (gbuf);
+for (lbl = sp->labels[h]; lbl != NULL; lbl = lbl->next)
+    if (strcmp (lbl->name, gbuf) == 0)                  /* first definition wins */
+        return SCPE_OK;
+lbl = (DO_LABEL *)malloc (sizeof (*lbl));
+if (lbl == NULL)
+    return SCPE_MEM;
+lbl->name = (char *)malloc (1 + strlen (gbuf));
+if (lbl->name == NULL) {
+    free (lbl);
+    return SCPE_MEM;
+    }
+strcpy (lbl->name, gbuf);
+lbl->line = line;
+lbl->next = sp->labels[h];
+sp->labels[h] = lbl;
+return SCPE_OK;
+}
+
+static DO_SCRIPT *_sim_do_script_load (FILE *fpin)
+{
+DO_SCRIPT *sp = (DO_SCRIPT *)calloc (1, sizeof (*sp));
+char cbuf[4*CBUFSIZE];
+char *cptr;
+int32 alloc = 0;
+
+if (sp == NULL)
+    return NULL;
+while (fgets (cbuf, sizeof (cbuf), fpin)) {
+    if (sp->count == alloc) {                           /* need more room? */
+        DO_LINE *nlines;
+
+        alloc = alloc ? 2 * alloc : 64;
+        nlines = (DO_LINE *)realloc (sp->lines, alloc * sizeof (*sp->lines));
+        if (nlines == NULL)
+            break;
+        sp->lines = nlines;
+        }
+    cptr = _sim_read_line_trim (cbuf, sizeof (cbuf));
+    memset (&sp->lines[sp->count], 0, sizeof (*sp->lines));
+    sp->lines[sp->count].text = (char *)malloc (1 + strlen (cptr));
+    if (sp->lines[sp->count].text == NULL)
+        break;
+    strcpy (sp->lines[sp->count].text, cptr);
+    ++sp->count;
+    if ((*cptr == ':') &&                               /* label? */
+        (_sim_do_script_add_label (sp, cptr, sp->count - 1) != SCPE_OK))
+        break;
+    }
+if (!feof (fpin)) {                                     /* stopped early? */
+    _sim_do_script_free (sp);
+    return NULL;
+    }
+return sp;
+}
+
+/* Return the next script line as read_line would, NULL at the end */
+
+static char *_sim_do_script_read (DO_SCRIPT *sp, char *cbuf, size_t size)
+{
+if (sp->next >= sp->count)
+    return NULL;
+strlcpy (cbuf, sp->lines[sp->next++].text, size);
+if ((*cbuf == ';') || (*cbuf == '#')) {                 /* ignore comment */
+    if (sim_do_echo)                                    /* echo comments if -v */
+        sim_printf("%s> %s\n", do_position(), cbuf);
+    *cbuf = 0;
+    }
+return cbuf;
+}
+
+/* Return the index of the line defining label, or -1 if it isn't defined */
+
+static int32 _sim_do_script_find_label (DO_SCRIPT *sp, const char *label)
+{
+DO_LABEL *lbl;
+
+for (lbl = sp->labels[_sim_do_label_hash (label)]; lbl != NULL; lbl = lbl->next)
+    if (strcmp (lbl->name, label) == 0)
+        return lbl->line;
+return -1;
+}
+
+/* Look up the command named on the line just read */
+
+static CTAB *_sim_do_script_find_cmd (DO_SCRIPT *sp, const char *gbuf)
+{
+DO_LINE *lp = &sp->lines[sp->next - 1];
+
+if ((lp->cmd_name == NULL) || (strcmp (lp->cmd_name, gbuf) != 0)) {
+    free (lp->cmd_name);
+    lp->cmdp = find_cmd (gbuf);
+    lp->cmd_name = (char *)malloc (1 + strlen (gbuf));
+    if (lp->cmd_name == NULL)                           /* can't remember it? */
+        return lp->cmdp;                                /* just return it */
+    strcpy (lp->cmd_name, gbuf);
+    }
+return lp->cmdp;
+}
+
 t_stat do_cmd_label (int32 flag, CONST char *fcptr, CONST char *label)
 {
 char cbuf[4*CBUFSIZE], gbuf[CBUFSIZE], abuf[4*CBUFSIZE], quote, *c, *do_arg[11];
 CONST char *cptr;
 FILE *fpin = NULL;
+DO_SCRIPT *script = NULL;
 CTAB *cmdp = NULL;
 int32 echo, nargs, errabort, i;
 int32 saved_sim_do_echo = sim_do_echo,
@@ -4529,6 +4815,13 @@ if ((strcasecmp (do_arg[0], "<stdin>") != 0) &&
     }
 else
     strlcpy (cbuf, do_arg[0], sizeof (cbuf));           /* store name of successfully opened file */
+if (fpin) {
+    script = _sim_do_script_load (fpin);                /* read the whole script */
+    fclose (fpin);
+    fpin = NULL;
+    if (script == NULL)
+        return sim_messagef (SCPE_MEM, "Can't load DO file %s\n", cbuf);
+    }
 if (flag >= 0) {                                        /* Only bump nesting from command or nested */
     ++sim_do_depth;
     if (sim_on_inherit) {                               /* inherit ON condition actions? */
@@ -4544,7 +4837,7 @@ if (flag >= 0) {                                        /* Only bump nesting fro
                     sim_on_check[sim_do_depth] = 0;
                     sim_brk_clract ();                  /* defang breakpoint actions */
                     --sim_do_depth;                     /* unwind nesting */
-                    fclose (fpin);
+                    _sim_do_script_free (script);
                     return SCPE_MEM;
                     }
                 strcpy(sim_on_actions[sim_do_depth][i], sim_on_actions[sim_do_depth-1][i]);
@@ -4564,7 +4857,7 @@ free (c);
 sim_do_label[sim_do_depth] = label;                     /* stash away do label for possible use in messages */
 sim_goto_line[sim_do_depth] = 0;
 if (label) {
-    sim_gotofile = fpin;
+    sim_do_script = script;
     sim_do_echo = echo;
     stat = goto_cmd (0, label);
     if (stat != SCPE_OK) {
@@ -4593,7 +4886,7 @@ do {
         }
     sim_do_ocptr[sim_do_depth] = cptr = sim_brk_getact (cbuf, sizeof(cbuf)); /* get bkpt action */
     if (!sim_do_ocptr[sim_do_depth]) {                  /* no pending action? */
-        sim_do_ocptr[sim_do_depth] = cptr = read_line (cbuf, sizeof(cbuf), fpin);/* get cmd line */
+        sim_do_ocptr[sim_do_depth] = cptr = _sim_do_script_read (script, cbuf, sizeof(cbuf));/* get cmd line */
         sim_goto_line[sim_do_depth] += 1;
         sim_cptr_is_action[sim_do_depth] = FALSE;
         }
@@ -4615,14 +4908,18 @@ do {
         continue;
     cptr = get_glyph_cmd (cptr, gbuf);                  /* get command glyph */
     sim_switches = 0;                                   /* init switches */
-    sim_gotofile = fpin;
+    sim_do_script = script;
     sim_do_echo = echo;
     if (!sim_cptr_is_action[sim_do_depth]) {
         sim_if_cmd_last[sim_do_depth] = sim_if_cmd[sim_do_depth];
         sim_if_result_last[sim_do_depth] = sim_if_result[sim_do_depth];
         sim_if_result[sim_do_depth] = sim_if_cmd[sim_do_depth] = FALSE;
         }
-    if ((cmdp = find_cmd (gbuf))) {                     /* lookup command */
+    if (sim_cptr_is_action[sim_do_depth])
+        cmdp = find_cmd (gbuf);                         /* lookup command */
+    else
+        cmdp = _sim_do_script_find_cmd (script, gbuf);  /* lookup command (remembered) */
+    if (cmdp) {
         if (cmdp->action == &return_cmd)                /* RETURN command? */
             break;                                      /*    done! */
         if (strcmp (cmdp->name, "DO") == 0) {           /* DO command? */
@@ -4695,9 +4992,8 @@ do {
         (*sim_vm_post) (TRUE);
     } while (staying);
 Cleanup_Return:
-if (fpin)
-    fclose (fpin);                                      /* close file */
-sim_gotofile = NULL;
+_sim_do_script_free (script);                           /* release script */
+sim_do_script = NULL;
 if (flag >= 0) {
     sim_do_echo = saved_sim_do_echo;                    /* restore echo state we entered with */
     sim_show_message = saved_sim_show_message;          /* restore message display state we entered with */
@@ -6080,54 +6376,30 @@ return SCPE_OK;
 
 t_stat goto_cmd (int32 flag, CONST char *fcptr)
 {
-char cbuf[CBUFSIZE], gbuf[CBUFSIZE], gbuf1[CBUFSIZE];
-const char *cptr;
-long fpos;
-int32 saved_do_echo = sim_do_echo;
-int32 saved_goto_line = sim_goto_line[sim_do_depth];
+char gbuf1[CBUFSIZE];
+int32 line;
 
-if ((NULL == sim_gotofile) ||
+if ((NULL == sim_do_script) ||
     (0 == strcasecmp (sim_do_filename[sim_do_depth], "<stdin>")))
     return SCPE_UNK;                                    /* only valid inside of do_cmd */
 
 get_glyph (fcptr, gbuf1, 0);
 if ('\0' == gbuf1[0])                                   /* unspecified goto target */
     return sim_messagef (SCPE_ARG, "Missing goto target\n");
-fpos = ftell(sim_gotofile);                             /* Save start position */
-if (fpos < 0)
-    return sim_messagef (SCPE_IERR, "goto ftell error: %s\n", strerror (errno));
 if (strcasecmp(":EOF", gbuf1) == 0) {
-    if (fseek (sim_gotofile, 0, SEEK_END))
-        return sim_messagef (SCPE_IERR, "goto seek error: %s\n", strerror (errno));
+    sim_do_script->next = sim_do_script->count;         /* position at end */
     sim_brk_clract ();                                  /* goto defangs current actions */
-    sim_do_echo = saved_do_echo;                        /* restore echo mode */
     return SCPE_OK;
     }
-rewind(sim_gotofile);                                   /* start search for label */
-sim_goto_line[sim_do_depth] = 0;                        /* reset line number */
-sim_do_echo = 0;                                        /* Don't echo while searching for label */
-while (1) {
-    cptr = read_line (cbuf, sizeof(cbuf), sim_gotofile);/* get cmd line */
-    if (cptr == NULL) break;                            /* exit on eof */
-    sim_goto_line[sim_do_depth] += 1;                   /* record line number */
-    if (*cptr == 0) continue;                           /* ignore blank */
-    if (*cptr != ':') continue;                         /* ignore non-labels */
-    ++cptr;                                             /* skip : */
-    while (sim_isspace (*cptr)) ++cptr;                 /* skip blanks */
-    get_glyph (cptr, gbuf, 0);                          /* get label glyph */
-    if (0 == strcmp(gbuf, gbuf1)) {
-        sim_brk_clract ();                              /* goto defangs current actions */
-        sim_do_echo = saved_do_echo;                    /* restore echo mode */
-        if (sim_do_echo)                                /* echo if -v */
-            sim_printf("%s> %s\n", do_position(), cbuf);
-        return SCPE_OK;
-        }
-    }
-sim_do_echo = saved_do_echo;                            /* restore echo mode */
-sim_goto_line[sim_do_depth] = saved_goto_line;          /* restore start line number */
-if (fseek(sim_gotofile, fpos, SEEK_SET))                /* restore start position */
-    return sim_messagef (SCPE_IERR, "goto seek error: %s\n", strerror (errno));
-return sim_messagef (SCPE_ARG, "goto target '%s' not found\n", gbuf1);
+line = _sim_do_script_find_label (sim_do_script, gbuf1);
+if (line < 0)
+    return sim_messagef (SCPE_ARG, "goto target '%s' not found\n", gbuf1);
+sim_do_script->next = line + 1;                         /* continue after the label */
+sim_goto_line[sim_do_depth] = line + 1;                 /* record line number */
+sim_brk_clract ();                                      /* goto defangs current actions */
+if (sim_do_echo)                                        /* echo if -v */
+    sim_printf("%s> %s\n", do_position(), sim_do_script->lines[line].text);
+return SCPE_OK;
 }
 
 /* Return command */
@@ -6164,7 +6436,7 @@ t_stat call_cmd (int32 flag, CONST char *fcptr)
 char cbuf[2*CBUFSIZE], gbuf[CBUFSIZE];
 const char *cptr;
 
-if (NULL == sim_gotofile) return SCPE_UNK;              /* only valid inside of do_cmd */
+if (NULL == sim_do_script) return SCPE_UNK;            /* only valid inside of do_cmd */
 cptr = get_glyph (fcptr, gbuf, 0);
 if ('\0' == gbuf[0]) return SCPE_ARG;                   /* unspecified goto target */
 snprintf (cbuf, sizeof (cbuf), "%s%s%s %s", (NULL != strchr (sim_do_filename[sim_do_depth], ' ')) ? "\"" : "",
@@ -6841,12 +7113,17 @@ if ((*cptr == 0) || (*cptr == ';') || (*cptr == '#')) { /* now eol? */
 GET_SWITCHES (cptr);                                    /* get more switches */
 
 while (*cptr != 0) {                                    /* do all mods */
-    cptr = get_glyph (cptr, gbuf, ',');                 /* get modifier */
+    cptr = get_glyph (svptr = cptr, gbuf, ',');         /* get modifier */
     if ((cvptr = strchr (gbuf, '=')))                   /* = value? */
         *cvptr++ = 0;
     for (mptr = dptr->modifiers; mptr && (mptr->mask != 0); mptr++) {
         if ((mptr->disp) && (mptr->pstring) &&          /* display routine and match string */
             (MATCH_CMD (gbuf, mptr->pstring) == 0)) {   /* matches option? */
+            if (cvptr && MODMASK(mptr,MTAB_NC)) {       /* argument case matters (file name)? */
+                get_glyph_nc (svptr, gbuf, ',');
+                if ((cvptr = strchr (gbuf, '=')))
+                    *cvptr++ = 0;
+                }
             if (mptr->mask & MTAB_XTD) {                /* extended? */
                 if (((lvl & mptr->mask) & ~MTAB_XTD) == 0)
                     return sim_messagef (SCPE_ARG, "Non-existant %s parameter: %s\n", (lvl & MTAB_VUN) ? "Device" : "Unit", mptr->pstring);
@@ -8592,6 +8869,47 @@ GET_SWITCHES (cptr);                                    /* get switches */
 return ssh_break (NULL, cptr, flg);                     /* call common code */
 }
 
+/* Data watchpoint commands
+
+   WATCH and NOWATCH are a front end to the breakpoint table for simulators
+   which support R (read) and W (write) breakpoints on data references.  The
+   access type follows the address ranges:
+
+        WATCH {<addr range>{[count]},{addr range...}} {R|W|RW}{;action...}
+*/
+
+t_stat watch_cmd (int32 flg, CONST char *cptr)
+{
+char gbuf[4*CBUFSIZE], *aptr, *eptr, *tptr;
+const int32 rw = SWMASK ('R') | SWMASK ('W');
+int32 typ = rw;
+
+if ((sim_brk_types & rw) != rw)
+    return sim_messagef (SCPE_NOFNC, "No data watchpoint support in this simulator\n");
+strlcpy (gbuf, cptr, sizeof (gbuf));
+aptr = strchr (gbuf, ';');                              /* ;action? */
+eptr = aptr ? aptr : gbuf + strlen (gbuf);
+while ((eptr > gbuf) && sim_isspace (eptr[-1]))         /* end of last argument */
+    --eptr;
+for (tptr = eptr; (tptr > gbuf) && !sim_isspace (tptr[-1]); --tptr)
+    ;                                                   /* start of last argument */
+if (tptr > gbuf) {                                      /* access type given? */
+    if ((eptr - tptr == 1) && (sim_toupper (*tptr) == 'R'))
+        typ = SWMASK ('R');
+    else if ((eptr - tptr == 1) && (sim_toupper (*tptr) == 'W'))
+        typ = SWMASK ('W');
+    else if ((eptr - tptr == 2) && (sim_toupper (tptr[0]) == 'R') && (sim_toupper (tptr[1]) == 'W'))
+        typ = rw;
+    else
+        tptr = eptr;                                    /* no, all address */
+    memmove (tptr, eptr, strlen (eptr) + 1);            /* drop it */
+    }
+if ((gbuf[0] == 0) || (gbuf[0] == ';'))                 /* need an address */
+    return sim_messagef (SCPE_2FARG, "Missing watchpoint address\n");
+sim_switches = typ;
+return ssh_break (NULL, gbuf, flg);                     /* call common code */
+}
+
 t_stat ssh_break (FILE *st, const char *cptr, int32 flg)
 {
 char gbuf[CBUFSIZE], *aptr, abuf[4*CBUFSIZE];
@@ -9367,9 +9685,9 @@ if (!(uptr->flags & UNIT_ATT)) {                        /* not attached? */
     }
 if ((dptr = find_dev_from_unit (uptr)) == NULL)
     return SCPE_OK;
-if ((dptr->flags & DEV_DISK) && ((dptr->flags & DEV_TAPE) == 0))
+if (DEV_TYPE (dptr) == DEV_DISK)                        /* DEV_CARD includes the DEV_DISK bit */
     return sim_disk_detach (uptr);
-if ((dptr->flags & DEV_TAPE) && ((dptr->flags & DEV_DISK) == 0))
+if (DEV_TYPE (dptr) == DEV_TAPE)
     return sim_tape_detach (uptr);
 if ((uptr->flags & UNIT_BUF) && (uptr->filebuf)) {
     uint32 cap = (uptr->hwmark + dptr->aincr - 1) / dptr->aincr;
@@ -9572,6 +9890,28 @@ fclose (sfile);
 return r;
 }
 
+/* Memory that was never written can be skipped by SAVE and RESTORE without
+   examining or depositing it.  A memory unit can tell when its filebuf
+   points at its simulated memory and that came from sim_mem_alloc. */
+
+static t_bool sim_save_nomem = FALSE;                   /* leave such memory out (journal checkpoints) */
+
+static t_bool _sim_mem_unit (DEVICE *dptr, UNIT *uptr)
+{
+return (((uptr->flags & (UNIT_FIX + UNIT_ATTABLE)) == UNIT_FIX) &&
+        (dptr->examine != NULL) && (uptr->capac != 0) &&
+        (sim_mem_size (uptr->filebuf) != 0));
+}
+
+static t_bool _sim_mem_unit_untouched (DEVICE *dptr, UNIT *uptr, t_addr addr, t_addr count)
+{
+size_t bpa = SZ_D (dptr) / dptr->aincr;                 /* host bytes per address */
+
+if ((sim_mem_size (uptr->filebuf) == 0) || (bpa == 0))
+    return FALSE;
+return sim_mem_untouched (uptr->filebuf, (size_t)addr * bpa, (size_t)(count * dptr->aincr) * bpa);
+}
+
 t_stat sim_save (FILE *sfile)
 {
 void *mbuf;
@@ -9662,6 +10002,7 @@ for (i = 0; i < (device_count + sim_internal_device_count); i++) {/* loop thru d
         fputc ('\n', sfile);
         if (((uptr->flags & (UNIT_FIX + UNIT_ATTABLE)) == UNIT_FIX) &&
              (dptr->examine != NULL) &&
+             !(sim_save_nomem && _sim_mem_unit (dptr, uptr)) &&
              ((high = uptr->capac) != 0)) {             /* memory-like unit? */
             WRITE_I (high);                             /* [V2.5] write size */
             sz = SZ_D (dptr);
@@ -9670,6 +10011,15 @@ for (i = 0; i < (device_count + sim_internal_device_count); i++) {/* loop thru d
                 return SCPE_MEM;
                 }
             for (k = 0; k < high; ) {                   /* loop thru mem */
+                l = (int32)((high - k + dptr->aincr - 1) / dptr->aincr);
+                if (l > SRBSIZ)
+                    l = SRBSIZ;
+                if (_sim_mem_unit_untouched (dptr, uptr, k, l)) {/* never written? */
+                    k = k + l * dptr->aincr;
+                    l = -l;                             /* zero block */
+                    WRITE_I (l);
+                    continue;
+                    }
                 zeroflg = TRUE;
                 for (l = 0; (l < SRBSIZ) && (k < high); l++,
                      k = k + (dptr->aincr)) {           /* check for 0 block */
@@ -9787,7 +10137,8 @@ sim_switches &= ~(SWMASK ('F') | SWMASK ('D') | SWMASK ('Q'));  /* remove digest
     goto Cleanup_Return;                                                \
     }
 
-if (fstat (fileno (rfile), &rstat)) {
+if ((fileno (rfile) >= 0) &&                            /* a file (not a memory stream)? */
+    fstat (fileno (rfile), &rstat)) {
     r = SCPE_IOERR;
     goto Cleanup_Return;
     }
@@ -9899,8 +10250,8 @@ for ( ;; ) {                                            /* device loop */
         READ_I (time);                                  /* event time */
         uptr = (dptr->units) + unitno;
         sim_cancel (uptr);
-        if (time > 0)
-            sim_activate (uptr, time - 1);
+        if (time > 0)                                   /* stopped: clocks queue directly */
+            _sim_activate (uptr, time - 1);
         READ_I (uptr->u3);                              /* device specific */
         READ_I (uptr->u4);
         READ_I (uptr->u5);                              /* [V3.0+] more dev spec */
@@ -9919,8 +10270,17 @@ for ( ;; ) {                                            /* device loop */
             READ_I (uptr->capac);
             }
         if (v40) {
+            double usecs_remaining = 0.0;
+
             READ_S (buf);
-            sscanf (buf, "%lf", &uptr->usecs_remaining);
+            sscanf (buf, "%lf", &usecs_remaining);
+            if ((usecs_remaining > 0.0) && (time > 0)) {/* saved time includes remaining wait? */
+                int32 qtime = time - 1 - (int32)((usecs_remaining * sim_timer_inst_per_sec ()) / 1000000.0);
+
+                sim_cancel (uptr);
+                _sim_activate (uptr, (qtime > 0) ? qtime : 0);
+                }
+            uptr->usecs_remaining = usecs_remaining;
             READ_I (uptr->pos);
             }
         if (!v32)
@@ -9997,6 +10357,11 @@ for ( ;; ) {                                            /* device loop */
                     r = SCPE_IOERR;
                     goto Cleanup_Return;
                     }
+                if ((blkcnt < 0) &&                     /* zeros over memory */
+                    _sim_mem_unit_untouched (dptr, uptr, k, limit)) {/* never written? */
+                    k = k + limit * dptr->aincr;
+                    continue;
+                    }
                 for (j = 0; j < limit; j++, k = k + (dptr->aincr)) {
                     if (blkcnt < 0)                     /* compressed? */
                         val = 0;
@@ -10162,138 +10527,1048 @@ return SCPE_OK;
 }
 
 
-/* Run, go, boot, cont, step, next commands
+/* Input journal (RECORD/REPLAY) and reverse execution
 
-   ru[n] [new PC]       reset and start simulation
-   go [new PC]          start simulation
-   co[nt]               start simulation
-   s[tep] [step limit]  start simulation for 'limit' instructions
-   next                 start simulation for 1 instruction
-                        stepping over subroutine calls
-   b[oot] device        bootstrap from device and start simulation
+   re[cord] file {interval}     start recording input to a journal
+   norec[ord]                   stop recording
+   rep[lay] file                replay a recorded journal
 
-   switches:
-    -Q                  quiet return status
-    -T                  (only for step), causes the step limit to
-                        be a number of microseconds to run for
+   A journal starts with a few header lines (the pseudo clock parameters and
+   checkpoint interval) followed by a SAVE image of the starting state and
+   then a stream of input records.  Each record is a type byte and three
+   variable length integers: the simulated time since the previous record,
+   a channel number and a data length, followed by the data.  Channel numbers
+   are assigned in order of first use by SIM_JRN_CHAN records which carry the
+   channel name (e.g. "CON" or "DZ:3").
+
+   Recording requires the deterministic pseudo clock (SET CLOCK NOCALIBRATE,
+   which also disables asynchronous I/O) so that everything other than the
+   journaled input is a function of the simulated time.  While journaling,
+   a checkpoint is taken every 'interval' time units and the most recent
+   SIM_JRN_SNAPS are kept in memory.  STEP -B and CONTINUE -B restore one of
+   these and replay forward to reach an earlier point.
+
+   A checkpoint is a SAVE image of everything except the memories that come
+   from sim_mem_alloc.  Those are tracked a page at a time: a reference copy
+   holds them as of the latest checkpoint, and each older checkpoint keeps
+   the old contents of the pages that changed before the next one.  Taking a
+   checkpoint costs a compare of the touched pages, and restoring one puts
+   back the reference copy and then the saved pages, newest first.
 */
 
-t_stat run_cmd (int32 flag, CONST char *cptr)
-{
-char gbuf[CBUFSIZE] = "";
-CONST char *tptr;
-uint32 i, j;
-int32 sim_next = 0;
-int32 unitno;
-t_value new_pcv, orig_pcv;
-t_stat r;
-DEVICE *dptr;
-UNIT *uptr;
+#define SIM_JRN_MAGIC       "SIMH-JOURNAL 1"
+#define SIM_JRN_SNAPS       16                          /* checkpoints kept */
+#define SIM_JRN_INTERVAL    10000000                    /* default checkpoint interval */
+#define SIM_JRN_PAGE        4096                        /* memory tracking granularity */
+#define SIM_JRN_CHUNK       (64 * SIM_JRN_PAGE)         /* untouched memory test granularity */
+
+int32 sim_jrn_mode = SIM_JRN_OFF;                       /* journal mode */
+t_bool sim_jrn_quiet = FALSE;                           /* suppress console output */
+static FILE *sim_jrn_file = NULL;                       /* journal file */
+static char *sim_jrn_filename = NULL;
+static t_bool sim_jrn_writable = FALSE;                 /* RECORD journal (vs REPLAY) */
+static t_bool sim_jrn_warned = FALSE;                   /* late delivery reported */
+static uint32 sim_jrn_interval = SIM_JRN_INTERVAL;      /* checkpoint interval */
+static t_uint64 sim_jrn_base;                           /* time of first checkpoint */
+static t_uint64 sim_jrn_last;                           /* time of previous record */
+static char **sim_jrn_chans = NULL;                     /* channel names */
+static int32 sim_jrn_nchans = 0;
+static t_bool sim_jrn_have = FALSE;                     /* replay: next record buffered */
+static t_offset sim_jrn_recpos;                         /*   its position */
+static int32 sim_jrn_rtype;                             /*   its type */
+static t_uint64 sim_jrn_rtime;                          /*   its time */
+static int32 sim_jrn_rchan;                             /*   its channel */
+static t_uint64 sim_jrn_rprev;                          /*   time of the record before it */
+static size_t sim_jrn_rlen;                             /*   its data length */
+static uint8 *sim_jrn_rdata = NULL;                     /*   its data */
+static size_t sim_jrn_rsize = 0;
+typedef struct {
+    int32       mem;                                    /* sim_jrn_mem index */
+    size_t      off;                                    /* byte offset of page */
+    uint8       data[SIM_JRN_PAGE];                     /* contents at the checkpoint */
+    } SIM_JRN_PAGE_SAVE;
+typedef struct {
+    UNIT        *uptr;                                  /* memory unit */
+    uint8       *mem;                                   /* its sim_mem_alloc memory */
+    size_t      size;
+    uint8       *ref;                                   /* contents at the latest checkpoint */
+    } SIM_JRN_MEM;
+static SIM_JRN_MEM *sim_jrn_mem = NULL;
+static int32 sim_jrn_nmem = 0;
+static const uint8 sim_jrn_zero[SIM_JRN_PAGE] = { 0 };
+static struct {
+    char        *img;                                   /* SAVE image, less tracked memory */
+    size_t      imglen;
+    SIM_JRN_PAGE_SAVE *pages;                           /* pages changed before the next one */
+    size_t      npages;
+    size_t      maxpages;
+    t_uint64    time;                                   /* simulated time taken */
+    t_offset    pos;                                    /* journal position */
+    t_uint64    last;                                   /* record time base at pos */
+    void        *timer;                                 /* clock state (not in SAVE) */
+    } sim_jrn_snap[SIM_JRN_SNAPS];
+static int32 sim_jrn_nsnap = 0;                         /* checkpoints held, oldest first */
 
-if (sim_runlimit_enabled &&                             /* If the run limit has been hit? */
-    (!sim_is_active (&sim_runlimit_unit))) {
-    sim_messagef (SCPE_RUNTIME, "Execution limit exceeded, can't proceed.  Exiting...\n");
-    exit (SCPE_RUNTIME);                                /* Execution can't proceed */
+static void _sim_jrn_close (void);
+
+#define SIM_JRN_NOW ((t_uint64)sim_gtime ())
+
+static void _sim_jrn_put_num (t_uint64 val)
+{
+while (val >= 0x80) {
+    fputc ((int)(0x80 | (val & 0x7F)), sim_jrn_file);
+    val >>= 7;
     }
-GET_SWITCHES (cptr);                                    /* get switches */
-sim_step = 0;
-if ((flag == RU_RUN) || (flag == RU_GO)) {              /* run or go */
-    t_bool new_pc = FALSE;
+fputc ((int)val, sim_jrn_file);
+}
 
-    new_pcv = orig_pcv = get_rval (sim_PC, 0);          /* get current PC value */
-    if (*cptr != 0) {                                   /* argument? */
-        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
-        if (MATCH_CMD (gbuf, "UNTIL") != 0) {
-            if (sim_vm_parse_addr)                      /* address parser? */
-                new_pcv = sim_vm_parse_addr (sim_dflt_dev, gbuf, &tptr);
-            else
-                new_pcv = strtotv (gbuf, &tptr, sim_PC->radix);/* parse PC */
-            if ((tptr == gbuf) || (*tptr != 0) ||       /* error? */
-                (new_pcv > ((sim_PC->maxval > 0)
-                            ? sim_PC->maxval
-                            : (width_mask[sim_PC->width]))))
-                return sim_messagef (SCPE_ARG, "Invalid UNTIL argument: %s\n", gbuf);
-            new_pc = TRUE;
-            }
-        }
-    put_rval_pcchk (sim_PC, 0, new_pcv, new_pc);        /* Save in PC in case reset references PC */
-    if ((flag == RU_RUN) &&                             /* run? */
-        ((r = sim_run_boot_prep (flag)) != SCPE_OK)) {  /* reset sim */
-        put_rval_pcchk (sim_PC, 0, orig_pcv, FALSE);    /* restore original PC */
-        return r;
-        }
-    if ((*cptr) || (MATCH_CMD (gbuf, "UNTIL") == 0)) {  /* should be end */
-        int32 saved_switches = sim_switches;
+static t_bool _sim_jrn_get_num (t_uint64 *val)
+{
+int c, shift = 0;
 
-        if (MATCH_CMD (gbuf, "UNTIL") != 0)
-            cptr = get_glyph (cptr, gbuf, 0);           /* get next glyph */
-        if (MATCH_CMD (gbuf, "UNTIL") != 0)
-            return sim_messagef (SCPE_2MARG, "Unexpected %s command argument: %s %s\n",
-                                             (flag == RU_RUN) ? "RUN" : "GO", gbuf, cptr);
-        sim_switches = 0;
-        GET_SWITCHES (cptr);
-        if (((*cptr == '\'') || (*cptr == '"')) ||      /* Expect UNTIL condition */
-            (!sim_strncasecmp(cptr, "HALTAFTER=", 10))) {
-            r = expect_cmd (1, cptr);
-            if (r != SCPE_OK)
-                return r;
-            }
-        else {                                          /* BREAK UNTIL condition */
-            if (sim_switches == 0)
-                sim_switches = sim_brk_dflt;
-            sim_switches |= BRK_TYP_TEMP;               /* make this a one-shot breakpoint */
-            sim_brk_types |= BRK_TYP_TEMP;
-            r = ssh_break (NULL, cptr, SSH_ST);
-            if (r != SCPE_OK)
-                return sim_messagef (r, "Unable to establish breakpoint at: %s\n", cptr);
+*val = 0;
+do {
+    if ((c = fgetc (sim_jrn_file)) == EOF)
+        return FALSE;
+    *val |= ((t_uint64)(c & 0x7F)) << shift;
+    shift += 7;
+    } while ((c & 0x80) && (shift < 64));
+return TRUE;
+}
+
+static void _sim_jrn_put_rec (int32 type, int32 chan, const void *data, size_t len)
+{
+t_uint64 now = SIM_JRN_NOW;
+
+fputc (type, sim_jrn_file);
+_sim_jrn_put_num (now - sim_jrn_last);
+_sim_jrn_put_num ((t_uint64)chan);
+_sim_jrn_put_num ((t_uint64)len);
+if (len)
+    sim_fwrite ((void *)data, 1, len, sim_jrn_file);
+sim_jrn_last = now;
+}
+
+static int32 _sim_jrn_chan_add (const char *name)
+{
+sim_jrn_chans = (char **)realloc (sim_jrn_chans, (sim_jrn_nchans + 1) * sizeof (*sim_jrn_chans));
+sim_jrn_chans[sim_jrn_nchans] = (char *)malloc (1 + strlen (name));
+strcpy (sim_jrn_chans[sim_jrn_nchans], name);
+return sim_jrn_nchans++;
+}
+
+/* Read the next record, digesting channel definitions */
+
+static t_bool _sim_jrn_peek (void)
+{
+int c;
+t_uint64 delta, chan, len;
+
+while (!sim_jrn_have) {
+    sim_jrn_recpos = sim_ftell (sim_jrn_file);
+    sim_jrn_rprev = sim_jrn_last;
+    if (((c = fgetc (sim_jrn_file)) == EOF) ||
+        !_sim_jrn_get_num (&delta) ||
+        !_sim_jrn_get_num (&chan) ||
+        !_sim_jrn_get_num (&len))
+        return FALSE;
+    if (len > sim_jrn_rsize) {
+        sim_jrn_rdata = (uint8 *)realloc (sim_jrn_rdata, (size_t)len);
+        sim_jrn_rsize = (size_t)len;
+        }
+    if ((len != 0) &&
+        (sim_fread (sim_jrn_rdata, 1, (size_t)len, sim_jrn_file) != (size_t)len))
+        return FALSE;
+    sim_jrn_last += delta;
+    if (c == SIM_JRN_CHAN) {
+        if (chan == (t_uint64)sim_jrn_nchans) {
+            sim_jrn_rdata[len ? len - 1 : 0] = '\0';
+            _sim_jrn_chan_add ((char *)sim_jrn_rdata);
             }
-        sim_switches = saved_switches;
+        continue;
         }
-    put_rval_pcchk (sim_PC, 0, new_pcv, new_pc);        /* Save in PC again in case reset changed it */
+    if (chan >= (t_uint64)sim_jrn_nchans)
+        return FALSE;
+    sim_jrn_rtype = c;
+    sim_jrn_rtime = sim_jrn_last;
+    sim_jrn_rchan = (int32)chan;
+    sim_jrn_rlen = (size_t)len;
+    sim_jrn_have = TRUE;
     }
+return TRUE;
+}
 
-else if ((flag == RU_STEP) ||
-         ((flag == RU_NEXT) && !sim_vm_is_subroutine_call)) { /* step */
-    static t_bool not_implemented_message = FALSE;
+/* In-memory SAVE images.  Hosts without memory streams go through a
+   temporary file on the way in and out. */
 
-    if ((!not_implemented_message) && (flag == RU_NEXT)) {
-        sim_printf ("This simulator does not have subroutine call detection.\nPerforming a STEP instead\n");
-        not_implemented_message = TRUE;
-        flag = RU_STEP;
-        }
-    if (*cptr != 0) {                                   /* argument? */
-        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
-        if (*cptr != 0)                                 /* should be end */
-            return SCPE_2MARG;
-        sim_step = (int32) get_uint (gbuf, 0, INT_MAX, &r);
-        if ((r != SCPE_OK) || (sim_step <= 0))          /* error? */
-            return sim_messagef (SCPE_ARG, "Invalid step specification: %s\n", gbuf);
-        }
-    else
-        sim_step = 1;
-    }
-else if (flag == RU_NEXT) {                             /* next */
-    t_addr *addrs;
+#if defined (_WIN32) || defined (VMS)
+static FILE *_sim_jrn_img_create (char **img, size_t *len)
+{
+*img = NULL;
+*len = 0;
+return tmpfile ();
+}
 
-    if (*cptr != 0) {                                   /* argument? */
-        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
-        if (*cptr != 0)                                 /* should be end */
-            return SCPE_2MARG;
-        sim_next = (int32) get_uint (gbuf, 0, INT_MAX, &r);
-        if ((r != SCPE_OK) || (sim_next <= 0))          /* error? */
-            return sim_messagef (SCPE_ARG, "Invalid next specification: %s\n", gbuf);
-        }
-    else
-        sim_next = 1;
-    if (sim_vm_is_subroutine_call(&addrs)) {
-        sim_brk_types |= BRK_TYP_DYN_STEPOVER;
-        for (i=0; addrs[i]; i++)
-            sim_brk_set (addrs[i], BRK_TYP_DYN_STEPOVER, 0, NULL);
-        }
-    else
-        sim_step = 1;
+static t_stat _sim_jrn_img_finish (FILE *f, char **img, size_t *len)
+{
+t_offset size = sim_ftell (f);
+
+rewind (f);
+if ((size <= 0) || ((*img = (char *)malloc ((size_t)size)) == NULL) ||
+    (fread (*img, 1, (size_t)size, f) != (size_t)size)) {
+    fclose (f);
+    return SCPE_IOERR;
     }
-else if (flag == RU_BOOT) {                             /* boot */
+*len = (size_t)size;
+fclose (f);
+return SCPE_OK;
+}
+
+static FILE *_sim_jrn_img_open (char *img, size_t len)
+{
+FILE *f = tmpfile ();
+
+if (f == NULL)
+    return NULL;
+if (fwrite (img, 1, len, f) != len) {
+    fclose (f);
+    return NULL;
+    }
+rewind (f);
+return f;
+}
+#else
+static FILE *_sim_jrn_img_create (char **img, size_t *len)
+{
+*img = NULL;
+*len = 0;
+return open_memstream (img, len);
+}
+
+static t_stat _sim_jrn_img_finish (FILE *f, char **img, size_t *len)
+{
+t_bool err = ferror (f);
+
+if ((fclose (f) != 0) || err)
+    return SCPE_IOERR;
+return SCPE_OK;
+}
+
+static FILE *_sim_jrn_img_open (char *img, size_t len)
+{
+return fmemopen (img, len, "rb");
+}
+#endif
+
+/* Tracked memory */
+
+static t_bool _sim_jrn_mem_same (void)
+{
+uint32 i, j, device_count;
+int32 n = 0;
+DEVICE *dptr;
+UNIT *uptr;
+
+for (device_count = 0; sim_devices[device_count]; device_count++);
+for (i = 0; i < (device_count + sim_internal_device_count); i++) {
+    dptr = (i < device_count) ? sim_devices[i] : sim_internal_devices[i - device_count];
+    if (dptr->flags & DEV_NOSAVE)
+        continue;
+    for (j = 0; j < dptr->numunits; j++) {
+        uptr = dptr->units + j;
+        if (!_sim_mem_unit (dptr, uptr))
+            continue;
+        if ((n >= sim_jrn_nmem) ||
+            (sim_jrn_mem[n].uptr != uptr) ||
+            (sim_jrn_mem[n].mem != uptr->filebuf) ||
+            (sim_jrn_mem[n].size != sim_mem_size (uptr->filebuf)))
+            return FALSE;
+        ++n;
+        }
+    }
+return (n == sim_jrn_nmem);
+}
+
+static void _sim_jrn_mem_free (void)
+{
+int32 i;
+
+for (i = 0; i < sim_jrn_nmem; i++)
+    sim_mem_free (sim_jrn_mem[i].ref);
+free (sim_jrn_mem);
+sim_jrn_mem = NULL;
+sim_jrn_nmem = 0;
+}
+
+/* Make dst match src a page at a time, saving the old contents of changed
+   pages in checkpoint 'snap' (if >= 0).  Chunks never written on either
+   side are skipped without reading them. */
+
+static t_stat _sim_jrn_mem_copy (int32 i, uint8 *dst, const uint8 *src, int32 snap)
+{
+size_t size = sim_jrn_mem[i].size;
+size_t off, end, p, len;
+t_bool du, su;
+const uint8 *d, *s;
+
+for (off = 0; off < size; off = end) {
+    end = (size - off < SIM_JRN_CHUNK) ? size : off + SIM_JRN_CHUNK;
+    du = sim_mem_untouched (dst, off, end - off);
+    su = sim_mem_untouched (src, off, end - off);
+    if (du && su)                                       /* both still zero */
+        continue;
+    for (p = off; p < end; p += len) {
+        len = (end - p < SIM_JRN_PAGE) ? end - p : SIM_JRN_PAGE;
+        d = du ? sim_jrn_zero : dst + p;
+        s = su ? sim_jrn_zero : src + p;
+        if (memcmp (d, s, len) == 0)
+            continue;
+        if (snap >= 0) {
+            if (sim_jrn_snap[snap].npages == sim_jrn_snap[snap].maxpages) {
+                size_t max = sim_jrn_snap[snap].maxpages ? 2 * sim_jrn_snap[snap].maxpages : 64;
+                SIM_JRN_PAGE_SAVE *pages = (SIM_JRN_PAGE_SAVE *)realloc (sim_jrn_snap[snap].pages, max * sizeof (*pages));
+
+                if (pages == NULL)
+                    return SCPE_MEM;
+                sim_jrn_snap[snap].pages = pages;
+                sim_jrn_snap[snap].maxpages = max;
+                }
+            sim_jrn_snap[snap].pages[sim_jrn_snap[snap].npages].mem = i;
+            sim_jrn_snap[snap].pages[sim_jrn_snap[snap].npages].off = p;
+            memcpy (sim_jrn_snap[snap].pages[sim_jrn_snap[snap].npages++].data, d, len);
+            }
+        memcpy (dst + p, s, len);
+        }
+    }
+return SCPE_OK;
+}
+
+/* Put back the pages saved with checkpoint n, in the reference copy or in
+   the live memory */
+
+static void _sim_jrn_mem_undo (int32 n, t_bool ref)
+{
+SIM_JRN_PAGE_SAVE *pg;
+size_t k, len;
+
+for (k = 0; k < sim_jrn_snap[n].npages; k++) {
+    pg = &sim_jrn_snap[n].pages[k];
+    len = sim_jrn_mem[pg->mem].size - pg->off;
+    if (len > SIM_JRN_PAGE)
+        len = SIM_JRN_PAGE;
+    memcpy ((ref ? sim_jrn_mem[pg->mem].ref : sim_jrn_mem[pg->mem].mem) + pg->off, pg->data, len);
+    }
+}
+
+static void _sim_jrn_free_pages (int32 n)
+{
+free (sim_jrn_snap[n].pages);
+sim_jrn_snap[n].pages = NULL;
+sim_jrn_snap[n].npages = sim_jrn_snap[n].maxpages = 0;
+}
+
+static void _sim_jrn_free_snap (int32 n)
+{
+free (sim_jrn_snap[n].img);
+sim_jrn_snap[n].img = NULL;
+_sim_jrn_free_pages (n);
+free (sim_jrn_snap[n].timer);
+sim_jrn_snap[n].timer = NULL;
+}
+
+/* Forget the checkpoints after 'after'; the reference copy goes back to
+   the one that is now the latest */
+
+static void _sim_jrn_drop_snaps (t_uint64 after)
+{
+while ((sim_jrn_nsnap > 0) && (sim_jrn_snap[sim_jrn_nsnap - 1].time > after)) {
+    _sim_jrn_free_snap (--sim_jrn_nsnap);
+    if (sim_jrn_nsnap > 0) {
+        _sim_jrn_mem_undo (sim_jrn_nsnap - 1, TRUE);
+        _sim_jrn_free_pages (sim_jrn_nsnap - 1);
+        }
+    }
+}
+
+/* Replay has used up the journal (or stopped matching it).  A RECORD journal
+   carries on recording from here, dropping whatever followed; a REPLAY
+   journal is closed and the simulator continues on live input. */
+
+static void _sim_jrn_replay_end (t_bool diverged)
+{
+t_uint64 now = SIM_JRN_NOW;
+
+if (diverged && !sim_jrn_quiet)
+    sim_printf ("\nReplay diverged from the journal at time %.0f\n", (double)now);
+if (sim_jrn_writable) {
+    if (diverged) {                                     /* drop the unreplayed rest */
+        sim_fseeko (sim_jrn_file, sim_jrn_recpos, SEEK_SET);
+        sim_set_fsize (sim_jrn_file, (t_addr)sim_jrn_recpos);
+        sim_jrn_last = sim_jrn_rprev;
+        _sim_jrn_drop_snaps (now);
+        }
+    else
+        sim_fseeko (sim_jrn_file, 0, SEEK_END);
+    sim_jrn_have = FALSE;
+    sim_jrn_mode = SIM_JRN_RECORD;
+    tmxr_jrn_replay_done ();
+    return;
+    }
+if (!sim_jrn_quiet)
+    sim_printf ("\nReplay of %s complete\n", sim_jrn_filename);
+_sim_jrn_close ();
+}
+
+t_stat sim_jrn_put (int32 type, const char *chan, const void *data, size_t len)
+{
+int32 i;
+
+if (sim_jrn_mode != SIM_JRN_RECORD)
+    return SCPE_OK;
+for (i = 0; i < sim_jrn_nchans; i++)
+    if (strcmp (sim_jrn_chans[i], chan) == 0)
+        break;
+if (i == sim_jrn_nchans)
+    _sim_jrn_put_rec (SIM_JRN_CHAN, _sim_jrn_chan_add (chan), chan, 1 + strlen (chan));
+_sim_jrn_put_rec (type, i, data, len);
+_sim_jrn_drop_snaps (sim_jrn_last);                     /* later checkpoints are now another future */
+return ferror (sim_jrn_file) ? SCPE_IOERR : SCPE_OK;
+}
+
+/* Deliver the next recorded input if it is of the requested type and channel
+   and is due now.  On entry *len is the size of the data buffer, on return it
+   is the length delivered. */
+
+t_bool sim_jrn_get (int32 type, const char *chan, void *data, size_t *len)
+{
+t_uint64 now;
+
+if (sim_jrn_mode != SIM_JRN_REPLAY)
+    return FALSE;
+if (!_sim_jrn_peek ()) {
+    _sim_jrn_replay_end (FALSE);
+    return FALSE;
+    }
+now = SIM_JRN_NOW;
+if (sim_jrn_rtime > now)                                /* not yet due? */
+    return FALSE;
+if ((sim_jrn_rtype != type) ||
+    (strcmp (sim_jrn_chans[sim_jrn_rchan], chan) != 0)) {
+    if (sim_jrn_rtime < now)                            /* missed? */
+        _sim_jrn_replay_end (TRUE);
+    return FALSE;
+    }
+if ((sim_jrn_rtime < now) && !sim_jrn_warned && !sim_jrn_quiet) {
+    sim_printf ("\nReplay of %s delivered late %s input at time %.0f (recorded at %.0f)\n",
+                sim_jrn_filename, chan, (double)now, (double)sim_jrn_rtime);
+    sim_jrn_warned = TRUE;
+    }
+if (sim_jrn_rlen < *len)
+    *len = sim_jrn_rlen;
+if (*len)
+    memcpy (data, sim_jrn_rdata, *len);
+sim_jrn_have = FALSE;
+return TRUE;
+}
+
+/* Checkpoints */
+
+static void _sim_jrn_sched (void)
+{
+t_uint64 now = SIM_JRN_NOW;
+t_uint64 next;
+
+sim_cancel (&sim_jrn_unit);
+if (sim_jrn_mode == SIM_JRN_OFF)
+    return;
+next = sim_jrn_base + ((now - sim_jrn_base) / sim_jrn_interval + 1) * sim_jrn_interval;
+sim_activate_abs (&sim_jrn_unit, (int32)(next - now));
+}
+
+static t_stat sim_jrn_svc (UNIT *uptr)
+{
+return SCPE_CHECKPOINT;
+}
+
+/* Add a checkpoint of the current state */
+
+static t_stat _sim_jrn_snap_take (t_uint64 time, t_offset pos, t_uint64 last)
+{
+char *img = NULL;
+size_t len = 0;
+int32 i;
+FILE *f;
+t_stat r;
+
+if ((f = _sim_jrn_img_create (&img, &len)) == NULL)
+    return SCPE_MEM;
+sim_save_nomem = TRUE;
+r = sim_save (f);
+sim_save_nomem = FALSE;
+if (r == SCPE_OK)
+    r = _sim_jrn_img_finish (f, &img, &len);
+else
+    _sim_jrn_img_finish (f, &img, &len);
+for (i = 0; (r == SCPE_OK) && (i < sim_jrn_nmem); i++)
+    if (sim_jrn_nsnap == 0)                             /* no history: refresh the copy */
+        r = _sim_jrn_mem_copy (i, sim_jrn_mem[i].ref, sim_jrn_mem[i].mem, -1);
+    else
+        r = _sim_jrn_mem_copy (i, sim_jrn_mem[i].ref, sim_jrn_mem[i].mem, sim_jrn_nsnap - 1);
+if (r != SCPE_OK) {
+    free (img);
+    return r;
+    }
+if (sim_jrn_nsnap == SIM_JRN_SNAPS) {                   /* full? drop oldest */
+    _sim_jrn_free_snap (0);
+    memmove (&sim_jrn_snap[0], &sim_jrn_snap[1], (SIM_JRN_SNAPS - 1) * sizeof (sim_jrn_snap[0]));
+    memset (&sim_jrn_snap[SIM_JRN_SNAPS - 1], 0, sizeof (sim_jrn_snap[0]));
+    --sim_jrn_nsnap;
+    }
+sim_jrn_snap[sim_jrn_nsnap].img = img;
+sim_jrn_snap[sim_jrn_nsnap].imglen = len;
+sim_jrn_snap[sim_jrn_nsnap].time = time;
+sim_jrn_snap[sim_jrn_nsnap].pos = pos;
+sim_jrn_snap[sim_jrn_nsnap].last = last;
+sim_jrn_snap[sim_jrn_nsnap].timer = sim_timer_get_state ();
+++sim_jrn_nsnap;
+return SCPE_OK;
+}
+
+/* Start tracking the memory units afresh, which loses any history */
+
+static t_stat _sim_jrn_mem_init (void)
+{
+uint32 i, j, device_count;
+DEVICE *dptr;
+UNIT *uptr;
+
+while (sim_jrn_nsnap > 0)
+    _sim_jrn_free_snap (--sim_jrn_nsnap);
+_sim_jrn_mem_free ();
+for (device_count = 0; sim_devices[device_count]; device_count++);
+for (i = 0; i < (device_count + sim_internal_device_count); i++) {
+    dptr = (i < device_count) ? sim_devices[i] : sim_internal_devices[i - device_count];
+    if (dptr->flags & DEV_NOSAVE)
+        continue;
+    for (j = 0; j < dptr->numunits; j++) {
+        uptr = dptr->units + j;
+        if (!_sim_mem_unit (dptr, uptr))
+            continue;
+        sim_jrn_mem = (SIM_JRN_MEM *)realloc (sim_jrn_mem, (sim_jrn_nmem + 1) * sizeof (*sim_jrn_mem));
+        sim_jrn_mem[sim_jrn_nmem].uptr = uptr;
+        sim_jrn_mem[sim_jrn_nmem].mem = (uint8 *)uptr->filebuf;
+        sim_jrn_mem[sim_jrn_nmem].size = sim_mem_size (uptr->filebuf);
+        sim_jrn_mem[sim_jrn_nmem].ref = (uint8 *)sim_mem_alloc (sim_jrn_mem[sim_jrn_nmem].size);
+        if (sim_jrn_mem[sim_jrn_nmem++].ref == NULL) {
+            _sim_jrn_mem_free ();
+            return SCPE_MEM;
+            }
+        }
+    }
+return SCPE_OK;
+}
+
+static t_stat _sim_jrn_checkpoint (void)
+{
+t_uint64 now = SIM_JRN_NOW;
+t_uint64 last;
+t_offset pos;
+t_stat r;
+
+if ((sim_jrn_nsnap > 0) &&                              /* already have this one? */
+    (sim_jrn_snap[sim_jrn_nsnap - 1].time >= now))
+    return SCPE_OK;
+if (sim_jrn_mode == SIM_JRN_REPLAY) {                   /* position is where replay is */
+    if (!_sim_jrn_peek ())
+        _sim_jrn_replay_end (FALSE);
+    }
+if (sim_jrn_mode == SIM_JRN_OFF)
+    return SCPE_OK;
+if (!_sim_jrn_mem_same ()) {                            /* memory resized? */
+    if ((r = _sim_jrn_mem_init ()) != SCPE_OK)
+        return r;
+    if (!sim_jrn_quiet)
+        sim_printf ("\nMemory was resized, earlier checkpoints discarded\n");
+    }
+if (sim_jrn_mode == SIM_JRN_REPLAY) {
+    pos = sim_jrn_recpos;
+    last = sim_jrn_rprev;
+    }
+else {
+    fflush (sim_jrn_file);
+    pos = sim_ftell (sim_jrn_file);
+    last = sim_jrn_last;
+    }
+if ((r = _sim_jrn_snap_take (now, pos, last)) != SCPE_OK)
+    return r;
+if (sim_jrn_mode == SIM_JRN_RECORD)
+    tmxr_jrn_put_lines ();
+return SCPE_OK;
+}
+
+/* Take a due checkpoint from the run loop and reschedule the next one */
+
+static t_stat sim_jrn_checkpoint (void)
+{
+t_stat r = _sim_jrn_checkpoint ();
+
+_sim_jrn_sched ();
+return r;
+}
+
+/* Go back to checkpoint n and replay from there */
+
+static t_stat _sim_jrn_restore (int32 n)
+{
+t_stat r;
+int32 i, saved_switches = sim_switches;
+FILE *f;
+
+if (!_sim_jrn_mem_same ())
+    return sim_messagef (SCPE_INCOMP, "Memory was resized since the last checkpoint\n");
+sim_cancel (&sim_jrn_unit);
+if ((f = _sim_jrn_img_open (sim_jrn_snap[n].img, sim_jrn_snap[n].imglen)) == NULL)
+    return SCPE_MEM;
+sim_switches = SWMASK ('D') | SWMASK ('Q') | SWMASK ('F');
+r = sim_rest (f);
+sim_switches = saved_switches;
+fclose (f);
+if (r != SCPE_OK)
+    return r;
+for (i = 0; i < sim_jrn_nmem; i++)                      /* memory as of the latest */
+    _sim_jrn_mem_copy (i, sim_jrn_mem[i].mem, sim_jrn_mem[i].ref, -1);
+for (i = sim_jrn_nsnap - 2; i >= n; --i)                /* then back to checkpoint n */
+    _sim_jrn_mem_undo (i, FALSE);
+if (sim_jrn_snap[n].timer)
+    sim_timer_set_state (sim_jrn_snap[n].timer);
+if (sim_jrn_mode == SIM_JRN_RECORD)
+    fflush (sim_jrn_file);
+sim_fseeko (sim_jrn_file, sim_jrn_snap[n].pos, SEEK_SET);
+sim_jrn_last = sim_jrn_snap[n].last;
+sim_jrn_have = FALSE;
+sim_jrn_mode = SIM_JRN_REPLAY;
+tmxr_jrn_get_lines ();
+return SCPE_OK;
+}
+
+/* Run forward, quietly, for 'count' time units.  Stops short of the target
+   are stepped over and the latest one is returned in *stop_time/*stop_r. */
+
+static t_stat _sim_jrn_run (t_uint64 count, t_uint64 *stop_time, t_stat *stop_r)
+{
+t_uint64 target = SIM_JRN_NOW + count;
+t_uint64 now, last = (t_uint64)-1;
+char gbuf[32];
+t_stat r;
+
+while ((now = SIM_JRN_NOW) < target) {
+    t_uint64 steps = target - now;
+
+    if (steps > INT_MAX)
+        steps = INT_MAX;
+    sprintf (gbuf, "%u", (uint32)steps);
+    sim_switches = 0;
+    sim_jrn_quiet = TRUE;
+    r = run_cmd (RU_STEP, gbuf);
+    sim_jrn_quiet = FALSE;
+    sim_brk_clract ();                                  /* breakpoint actions aren't replayed */
+    r = SCPE_BARE_STATUS (r);
+    if (r == SCPE_STEP)
+        continue;
+    if ((r == SCPE_STOP) || (r == SCPE_SIGTERM))        /* interrupted? */
+        return r;
+    now = SIM_JRN_NOW;
+    if (now == last)                                    /* can't get past this stop */
+        return r;
+    last = now;
+    if (stop_time) {
+        *stop_time = now;
+        *stop_r = r;
+        }
+    }
+return SCPE_OK;
+}
+
+/* STEP -B {n} and CONTINUE -B */
+
+static t_stat sim_jrn_reverse (int32 flag, CONST char *cptr)
+{
+char gbuf[CBUFSIZE];
+t_uint64 now = SIM_JRN_NOW;
+t_uint64 target, stop_time, limit;
+t_stat r, stop_r = SCPE_OK;
+int32 n;
+
+if ((sim_jrn_mode == SIM_JRN_OFF) || (sim_jrn_nsnap == 0))
+    return sim_messagef (SCPE_NOFNC, "Reverse execution requires a RECORD or REPLAY journal\n");
+if (flag == RU_STEP) {
+    uint32 count = 1;
+
+    if (*cptr != 0) {
+        cptr = get_glyph (cptr, gbuf, 0);
+        if (*cptr != 0)
+            return SCPE_2MARG;
+        count = (uint32) get_uint (gbuf, 10, INT_MAX, &r);
+        if ((r != SCPE_OK) || (count == 0))
+            return sim_messagef (SCPE_ARG, "Invalid step specification: %s\n", gbuf);
+        }
+    if ((t_uint64)count > now - sim_jrn_snap[0].time)
+        return sim_messagef (SCPE_ARG, "Only %.0f %s of history are available\n",
+                             (double)(now - sim_jrn_snap[0].time), sim_vm_interval_units);
+    target = now - count;
+    for (n = sim_jrn_nsnap - 1; sim_jrn_snap[n].time > target; --n)
+        ;
+    if ((r = _sim_jrn_restore (n)) != SCPE_OK)
+        return r;
+    if ((r = _sim_jrn_run (target - sim_jrn_snap[n].time, NULL, NULL)) != SCPE_OK)
+        return r;
+    return SCPE_STEP;
+    }
+if (flag != RU_CONT)
+    return sim_messagef (SCPE_NOFNC, "Only STEP and CONTINUE can run backwards\n");
+if (*cptr != 0)
+    return sim_messagef (SCPE_2MARG, "CONTINUE command takes no arguments\n");
+limit = now;
+for (n = sim_jrn_nsnap - 1; n >= 0; --n) {              /* search back for the latest stop */
+    if (sim_jrn_snap[n].time >= limit)
+        continue;
+    if ((r = _sim_jrn_restore (n)) != SCPE_OK)
+        return r;
+    stop_time = limit;
+    if ((r = _sim_jrn_run (limit - sim_jrn_snap[n].time, &stop_time, &stop_r)) != SCPE_OK)
+        return r;
+    if (stop_time < limit) {                            /* found one, go there */
+        if (((r = _sim_jrn_restore (n)) != SCPE_OK) ||
+            ((r = _sim_jrn_run (stop_time - sim_jrn_snap[n].time, NULL, NULL)) != SCPE_OK))
+            return r;
+        return stop_r;
+        }
+    limit = sim_jrn_snap[n].time;
+    }
+if ((r = _sim_jrn_restore (0)) != SCPE_OK)
+    return r;
+return sim_messagef (SCPE_OK, "Reached the oldest checkpoint, %.0f %s before the start point\n",
+                     (double)(now - sim_jrn_snap[0].time), sim_vm_interval_units);
+}
+
+static void _sim_jrn_close (void)
+{
+int32 i;
+
+sim_cancel (&sim_jrn_unit);
+if (sim_jrn_mode == SIM_JRN_REPLAY)
+    tmxr_jrn_replay_done ();
+sim_jrn_mode = SIM_JRN_OFF;
+while (sim_jrn_nsnap > 0)
+    _sim_jrn_free_snap (--sim_jrn_nsnap);
+_sim_jrn_mem_free ();
+if (sim_jrn_file)
+    fclose (sim_jrn_file);
+sim_jrn_file = NULL;
+free (sim_jrn_filename);
+sim_jrn_filename = NULL;
+for (i = 0; i < sim_jrn_nchans; i++)
+    free (sim_jrn_chans[i]);
+free (sim_jrn_chans);
+sim_jrn_chans = NULL;
+sim_jrn_nchans = 0;
+sim_jrn_have = sim_jrn_warned = FALSE;
+}
+
+t_stat record_cmd (int32 flag, CONST char *cptr)
+{
+char gbuf[4*CBUFSIZE];
+struct timespec base;
+uint32 ips, interval = SIM_JRN_INTERVAL;
+char *img = NULL;
+size_t len = 0;
+t_stat r;
+FILE *f;
+
+GET_SWITCHES (cptr);                                    /* get switches */
+if (flag == 0) {                                        /* NORECORD */
+    if (*cptr != 0)
+        return SCPE_2MARG;
+    if (!sim_jrn_writable)
+        return sim_messagef (SCPE_NOFNC, "Not recording\n");
+    _sim_jrn_close ();
+    sim_jrn_writable = FALSE;
+    return SCPE_OK;
+    }
+if (*cptr == 0)                                         /* must be more */
+    return SCPE_2FARG;
+cptr = get_glyph_nc (cptr, gbuf, 0);                    /* get file name */
+if (*cptr != 0) {                                       /* checkpoint interval? */
+    char ibuf[CBUFSIZE];
+
+    cptr = get_glyph (cptr, ibuf, 0);
+    if (*cptr != 0)
+        return SCPE_2MARG;
+    interval = (uint32) get_uint (ibuf, 10, INT_MAX, &r);
+    if ((r != SCPE_OK) || (interval == 0))
+        return sim_messagef (SCPE_ARG, "Invalid checkpoint interval: %s\n", ibuf);
+    }
+if (sim_jrn_mode != SIM_JRN_OFF)
+    return sim_messagef (SCPE_ALATT, "Already %s %s\n", sim_jrn_writable ? "recording to" : "replaying", sim_jrn_filename);
+if (!sim_timer_get_pseudo_clock (&base, &ips)) {        /* need the deterministic clock */
+    if ((r = set_cmd (0, "CLOCK NOCALIBRATE")) != SCPE_OK)
+        return r;
+    sim_timer_get_pseudo_clock (&base, &ips);
+    }
+if ((sim_jrn_file = sim_fopen (gbuf, "w+b")) == NULL)
+    return sim_messagef (SCPE_OPENERR, "Can't create journal %s: %s\n", gbuf, strerror (errno));
+sim_jrn_filename = (char *)malloc (1 + strlen (gbuf));
+strcpy (sim_jrn_filename, gbuf);
+sim_jrn_writable = TRUE;
+sim_jrn_interval = interval;
+sim_jrn_base = SIM_JRN_NOW;
+sim_jrn_mode = SIM_JRN_RECORD;
+if ((f = _sim_jrn_img_create (&img, &len)) == NULL) {
+    _sim_jrn_close ();
+    sim_jrn_writable = FALSE;
+    return SCPE_MEM;
+    }
+r = sim_save (f);                                       /* starting state */
+if (r == SCPE_OK)
+    r = _sim_jrn_img_finish (f, &img, &len);
+else
+    _sim_jrn_img_finish (f, &img, &len);
+if (r == SCPE_OK) {                                     /* embed it in the journal */
+    fprintf (sim_jrn_file, "%s\n%s\n%ld %ld %u\n%u\n%.0f\n", SIM_JRN_MAGIC, sim_savename,
+             (long)base.tv_sec, (long)base.tv_nsec, ips, interval, (double)len);
+    if (sim_fwrite (img, 1, len, sim_jrn_file) != len)
+        r = SCPE_IOERR;
+    }
+free (img);
+sim_jrn_last = sim_jrn_base;
+if ((r != SCPE_OK) ||
+    ((r = _sim_jrn_mem_init ()) != SCPE_OK) ||          /* it is also the first checkpoint */
+    ((r = _sim_jrn_snap_take (sim_jrn_base, sim_ftell (sim_jrn_file), sim_jrn_base)) != SCPE_OK)) {
+    _sim_jrn_close ();
+    sim_jrn_writable = FALSE;
+    return r;
+    }
+tmxr_jrn_put_lines ();
+return sim_messagef (SCPE_OK, "Recording input to %s\n", gbuf);
+}
+
+t_stat replay_cmd (int32 flag, CONST char *cptr)
+{
+char gbuf[4*CBUFSIZE];
+char line[CBUFSIZE];
+long secs, nsecs;
+double size;
+struct timespec base;
+uint32 ips, interval;
+int32 saved_switches;
+char *img;
+FILE *f;
+t_stat r;
+
+GET_SWITCHES (cptr);                                    /* get switches */
+if (*cptr == 0)                                         /* must be more */
+    return SCPE_2FARG;
+get_glyph_nc (cptr, gbuf, 0);
+if (sim_jrn_mode != SIM_JRN_OFF)
+    return sim_messagef (SCPE_ALATT, "Already %s %s\n", sim_jrn_writable ? "recording to" : "replaying", sim_jrn_filename);
+if ((sim_jrn_file = sim_fopen (gbuf, "rb")) == NULL)
+    return sim_messagef (SCPE_OPENERR, "Can't open journal %s: %s\n", gbuf, strerror (errno));
+sim_jrn_filename = (char *)malloc (1 + strlen (gbuf));
+strcpy (sim_jrn_filename, gbuf);
+sim_jrn_writable = FALSE;
+r = SCPE_INCOMP;
+if ((read_line (line, sizeof (line), sim_jrn_file) == NULL) ||
+    (strcmp (line, SIM_JRN_MAGIC) != 0))
+    sim_printf ("%s is not a journal\n", gbuf);
+else if ((read_line (line, sizeof (line), sim_jrn_file) == NULL) ||
+         (strcmp (line, sim_savename) != 0))
+    sim_printf ("Wrong system type: %s\n", line);
+else if ((read_line (line, sizeof (line), sim_jrn_file) == NULL) ||
+         (sscanf (line, "%ld %ld %u", &secs, &nsecs, &ips) != 3) ||
+         (read_line (line, sizeof (line), sim_jrn_file) == NULL) ||
+         (sscanf (line, "%u", &interval) != 1) || (interval == 0) ||
+         (read_line (line, sizeof (line), sim_jrn_file) == NULL) ||
+         (sscanf (line, "%lf", &size) != 1))
+    sim_printf ("Invalid journal header in %s\n", gbuf);
+else
+    r = SCPE_OK;
+if (r != SCPE_OK) {
+    _sim_jrn_close ();
+    return r;
+    }
+base.tv_sec = (time_t)secs;
+base.tv_nsec = nsecs;
+if ((r = sim_timer_set_pseudo_clock (&base, ips)) != SCPE_OK) {
+    _sim_jrn_close ();
+    return r;
+    }
+if ((size <= 0) || ((img = (char *)malloc ((size_t)size)) == NULL)) {
+    _sim_jrn_close ();
+    return SCPE_MEM;
+    }
+if (sim_fread (img, 1, (size_t)size, sim_jrn_file) != (size_t)size)  /* the starting state */
+    r = SCPE_IOERR;
+else if ((f = _sim_jrn_img_open (img, (size_t)size)) == NULL)
+    r = SCPE_MEM;
+else {
+    saved_switches = sim_switches;
+    sim_switches = SWMASK ('D') | SWMASK ('Q') | SWMASK ('F');
+    r = sim_rest (f);
+    sim_switches = saved_switches;
+    fclose (f);
+    }
+free (img);
+sim_jrn_interval = interval;
+sim_jrn_mode = SIM_JRN_REPLAY;
+sim_jrn_have = FALSE;
+sim_jrn_base = sim_jrn_last = SIM_JRN_NOW;
+if ((r != SCPE_OK) ||
+    ((r = _sim_jrn_mem_init ()) != SCPE_OK) ||          /* it is also the first checkpoint */
+    ((r = _sim_jrn_snap_take (sim_jrn_base, sim_ftell (sim_jrn_file), sim_jrn_base)) != SCPE_OK)) {
+    _sim_jrn_close ();
+    return r;
+    }
+tmxr_jrn_get_lines ();
+return sim_messagef (SCPE_OK, "Replaying input from %s\n", gbuf);
+}
+
+
+/* Run, go, boot, cont, step, next commands
+
+   ru[n] [new PC]       reset and start simulation
+   go [new PC]          start simulation
+   co[nt]               start simulation
+   s[tep] [step limit]  start simulation for 'limit' instructions
+   next                 start simulation for 1 instruction
+                        stepping over subroutine calls
+   b[oot] device        bootstrap from device and start simulation
+
+   switches:
+    -Q                  quiet return status
+    -T                  (only for step), causes the step limit to
+                        be a number of microseconds to run for
+    -B                  (only for step and cont), run backwards
+                        through the RECORD or REPLAY journal
+*/
+
+t_stat run_cmd (int32 flag, CONST char *cptr)
+{
+char gbuf[CBUFSIZE] = "";
+CONST char *tptr;
+uint32 i, j;
+int32 sim_next = 0;
+int32 unitno;
+t_value new_pcv, orig_pcv;
+t_stat r;
+DEVICE *dptr;
+UNIT *uptr;
+
+if (sim_runlimit_enabled &&                             /* If the run limit has been hit? */
+    (!sim_is_active (&sim_runlimit_unit))) {
+    sim_messagef (SCPE_RUNTIME, "Execution limit exceeded, can't proceed.  Exiting...\n");
+    exit (SCPE_RUNTIME);                                /* Execution can't proceed */
+    }
+GET_SWITCHES (cptr);                                    /* get switches */
+if (sim_switches & SWMASK ('B'))                        /* backwards? */
+    return sim_jrn_reverse (flag, cptr);
+sim_step = 0;
+if ((flag == RU_RUN) || (flag == RU_GO)) {              /* run or go */
+    t_bool new_pc = FALSE;
+
+    new_pcv = orig_pcv = get_rval (sim_PC, 0);          /* get current PC value */
+    if (*cptr != 0) {                                   /* argument? */
+        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+        if (MATCH_CMD (gbuf, "UNTIL") != 0) {
+            if (sim_vm_parse_addr)                      /* address parser? */
+                new_pcv = sim_vm_parse_addr (sim_dflt_dev, gbuf, &tptr);
+            else
+                new_pcv = strtotv (gbuf, &tptr, sim_PC->radix);/* parse PC */
+            if ((tptr == gbuf) || (*tptr != 0) ||       /* error? */
+                (new_pcv > ((sim_PC->maxval > 0)
+                            ? sim_PC->maxval
+                            : (width_mask[sim_PC->width]))))
+                return sim_messagef (SCPE_ARG, "Invalid UNTIL argument: %s\n", gbuf);
+            new_pc = TRUE;
+            }
+        }
+    put_rval_pcchk (sim_PC, 0, new_pcv, new_pc);        /* Save in PC in case reset references PC */
+    if ((flag == RU_RUN) &&                             /* run? */
+        ((r = sim_run_boot_prep (flag)) != SCPE_OK)) {  /* reset sim */
+        put_rval_pcchk (sim_PC, 0, orig_pcv, FALSE);    /* restore original PC */
+        return r;
+        }
+    if ((*cptr) || (MATCH_CMD (gbuf, "UNTIL") == 0)) {  /* should be end */
+        int32 saved_switches = sim_switches;
+
+        if (MATCH_CMD (gbuf, "UNTIL") != 0)
+            cptr = get_glyph (cptr, gbuf, 0);           /* get next glyph */
+        if (MATCH_CMD (gbuf, "UNTIL") != 0)
+            return sim_messagef (SCPE_2MARG, "Unexpected %s command argument: %s %s\n",
+                                             (flag == RU_RUN) ? "RUN" : "GO", gbuf, cptr);
+        sim_switches = 0;
+        GET_SWITCHES (cptr);
+        if (((*cptr == '\'') || (*cptr == '"')) ||      /* Expect UNTIL condition */
+            (!sim_strncasecmp(cptr, "HALTAFTER=", 10))) {
+            r = expect_cmd (1, cptr);
+            if (r != SCPE_OK)
+                return r;
+            }
+        else {                                          /* BREAK UNTIL condition */
+            if (sim_switches == 0)
+                sim_switches = sim_brk_dflt;
+            sim_switches |= BRK_TYP_TEMP;               /* make this a one-shot breakpoint */
+            sim_brk_types |= BRK_TYP_TEMP;
+            r = ssh_break (NULL, cptr, SSH_ST);
+            if (r != SCPE_OK)
+                return sim_messagef (r, "Unable to establish breakpoint at: %s\n", cptr);
+            }
+        sim_switches = saved_switches;
+        }
+    put_rval_pcchk (sim_PC, 0, new_pcv, new_pc);        /* Save in PC again in case reset changed it */
+    }
+
+else if ((flag == RU_STEP) ||
+         ((flag == RU_NEXT) && !sim_vm_is_subroutine_call)) { /* step */
+    static t_bool not_implemented_message = FALSE;
+
+    if ((!not_implemented_message) && (flag == RU_NEXT)) {
+        sim_printf ("This simulator does not have subroutine call detection.\nPerforming a STEP instead\n");
+        not_implemented_message = TRUE;
+        flag = RU_STEP;
+        }
+    if (*cptr != 0) {                                   /* argument? */
+        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+        if (*cptr != 0)                                 /* should be end */
+            return SCPE_2MARG;
+        sim_step = (int32) get_uint (gbuf, 0, INT_MAX, &r);
+        if ((r != SCPE_OK) || (sim_step <= 0))          /* error? */
+            return sim_messagef (SCPE_ARG, "Invalid step specification: %s\n", gbuf);
+        }
+    else
+        sim_step = 1;
+    }
+else if (flag == RU_NEXT) {                             /* next */
+    t_addr *addrs;
+
+    if (*cptr != 0) {                                   /* argument? */
+        cptr = get_glyph (cptr, gbuf, 0);               /* get next glyph */
+        if (*cptr != 0)                                 /* should be end */
+            return SCPE_2MARG;
+        sim_next = (int32) get_uint (gbuf, 0, INT_MAX, &r);
+        if ((r != SCPE_OK) || (sim_next <= 0))          /* error? */
+            return sim_messagef (SCPE_ARG, "Invalid next specification: %s\n", gbuf);
+        }
+    else
+        sim_next = 1;
+    if (sim_vm_is_subroutine_call(&addrs)) {
+        sim_brk_types |= BRK_TYP_DYN_STEPOVER;
+        for (i=0; addrs[i]; i++)
+            sim_brk_set (addrs[i], BRK_TYP_DYN_STEPOVER, 0, NULL);
+        }
+    else
+        sim_step = 1;
+    }
+else if (flag == RU_BOOT) {                             /* boot */
     if (*cptr == 0)                                     /* must be more */
         return SCPE_2FARG;
     cptr = get_glyph (cptr, gbuf, 0);                   /* get next glyph */
@@ -10369,12 +11644,20 @@ if (sim_log)                                            /* flush log if enabled
     fflush (sim_log);
 sim_throt_sched ();                                     /* set throttle */
 sim_start_timer_services ();                            /* enable wall clock timing */
+_sim_jrn_sched ();                                      /* schedule journal checkpoint */
 
 do {
     t_addr *addrs;
 
     while (1) {
         r = sim_instr();
+        if (r == SCPE_CHECKPOINT) {                     /* journal checkpoint due? */
+            UPDATE_SIM_TIME;
+            sim_stop_timer_services ();                 /* save queue as a stopped sim would */
+            sim_jrn_checkpoint ();                      /* take it and carry on */
+            sim_start_timer_services ();
+            continue;
+            }
         if (r != SCPE_REMOTE)
             break;
         UPDATE_SIM_TIME;
@@ -10438,6 +11721,7 @@ signal (SIGHUP, sigterm_received ? SIG_IGN : SIG_DFL);  /* cancel WRU */
 #endif
 signal (SIGTERM, sigterm_received ? SIG_IGN : SIG_DFL); /* cancel WRU */
 sim_flush_buffered_files (TRUE);
+sim_hist_flush ();                                      /* write out instruction history */
 sim_cancel (&sim_flush_unit);                           /* cancel flush timer */
 sim_cancel_step ();                                     /* cancel step timer */
 sim_throt_cancel ();                                    /* cancel throttle */
@@ -11422,7 +12706,6 @@ typedef void (*add_history_func)(const char *);
 static add_history_func p_add_history = NULL;
 typedef void (*free_line_func)(void *);
 static free_line_func p_free_line = NULL;
-char *tptr;
 
 if (prompt && (!initialized)) {
     initialized = 1;
@@ -11481,6 +12764,27 @@ if (cptr == NULL) {
     clearerr (stream);                                  /* clear error */
     return NULL;                                        /* ignore EOF */
     }
+cptr = _sim_read_line_trim (cptr, size);
+if ((*cptr == ';') || (*cptr == '#')) {                 /* ignore comment */
+    if (sim_do_echo)                                    /* echo comments if -v */
+        sim_printf("%s> %s\n", do_position(), cptr);
+    *cptr = 0;
+    }
+
+if (prompt && p_add_history && *cptr)                   /* Save non blank lines in history */
+    p_add_history (cptr);
+
+return cptr;
+}
+
+/* Strip the line terminator, a UTF8 BOM, and surrounding blanks from a
+   line read into cptr (of size bytes).  Returns the trimmed line.
+*/
+
+static char *_sim_read_line_trim (char *cptr, int32 size)
+{
+char *tptr;
+
 for (tptr = cptr; tptr < (cptr + size); tptr++) {       /* remove cr or nl */
     if ((*tptr == '\n') || (*tptr == '\r') ||
         (tptr == (cptr + size - 1))) {                  /* str max length? */
@@ -11493,15 +12797,6 @@ if (0 == memcmp (cptr, "\xEF\xBB\xBF", 3))              /* Skip/ignore UTF8_BOM
 while (sim_isspace (*cptr))                             /* trim leading spc */
     cptr++;
 sim_trim_endspc (cptr);                                 /* trim trailing spc */
-if ((*cptr == ';') || (*cptr == '#')) {                 /* ignore comment */
-    if (sim_do_echo)                                    /* echo comments if -v */
-        sim_printf("%s> %s\n", do_position(), cptr);
-    *cptr = 0;
-    }
-
-if (prompt && p_add_history && *cptr)                   /* Save non blank lines in history */
-    p_add_history (cptr);
-
 return cptr;
 }
 
@@ -13192,6 +14487,7 @@ do {
         (bare_reason >= SCPE_BASE)    &&
         (bare_reason != SCPE_EXPECT)  &&
         (bare_reason != SCPE_REMOTE)  &&
+        (bare_reason != SCPE_CHECKPOINT) &&
         (bare_reason != SCPE_MTRLNT)  &&
         (bare_reason != SCPE_STOP)    &&
         (bare_reason != SCPE_STEP)    &&
@@ -13575,6 +14871,11 @@ return cnt;
    is the bitwise OR of all the type fields).  A simulator need only check for
    a breakpoint of type X if bit SWMASK('X') is set in sim_brk_summ.
 
+   sim_brk_pages is a bit map of the address pages (2^SIM_BRK_V_PAGE addresses,
+   folded into SIM_BRK_N_PAGE bits) which hold at least one breakpoint.  Memory
+   reference routines test it with sim_brk_watch_test, so that data watchpoints
+   cost a full table search only for references to those pages.
+
    The package contains the following public routines:
 
         sim_brk_init            initialize
@@ -13584,6 +14885,7 @@ return cnt;
         sim_brk_show            show breakpoint
         sim_brk_showall         show all breakpoints
         sim_brk_test            test for breakpoint
+        sim_brk_watch_range     test a multi-address reference for watchpoints
         sim_brk_npc             PC has been changed
         sim_brk_getact          get next action
         sim_brk_clract          clear pending actions
@@ -13612,6 +14914,7 @@ sim_brk_tab = (BRKTAB **) realloc (sim_brk_tab, sim_brk_lnt*sizeof (BRKTAB*));
 if (sim_brk_tab == NULL)
     return SCPE_MEM;
 memset (sim_brk_tab, 0, sim_brk_lnt*sizeof (BRKTAB*));
+memset (sim_brk_pages, 0, sizeof (sim_brk_pages));
 sim_brk_ent = sim_brk_ins = 0;
 sim_brk_clract ();
 sim_brk_npc (0);
@@ -13745,6 +15048,7 @@ if ((act != NULL) && (*act != 0)) {                     /* new action? */
     bp->act = newp;                                     /* set pointer */
     }
 sim_brk_summ = sim_brk_summ | (sw & ~BRK_TYP_TEMP);
+sim_brk_pages[SIM_BRK_PAGE (loc) >> 5] |= 1u << (SIM_BRK_PAGE (loc) & 0x1F);
 return SCPE_OK;
 }
 
@@ -13782,8 +15086,10 @@ if (sim_brk_tab[sim_brk_ins] == NULL) {                 /* erased entry */
         sim_brk_tab[i] = sim_brk_tab[i+1];
     }
 sim_brk_summ = 0;                                       /* recalc summary */
+memset (sim_brk_pages, 0, sizeof (sim_brk_pages));      /* and page map */
 for (i = 0; i < sim_brk_ent; i++) {
     bp = sim_brk_tab[i];
+    sim_brk_pages[SIM_BRK_PAGE (bp->addr) >> 5] |= 1u << (SIM_BRK_PAGE (bp->addr) & 0x1F);
     while (bp) {
         sim_brk_summ |= (bp->typ & ~BRK_TYP_TEMP);
         bp = bp->next;
@@ -13950,6 +15256,24 @@ if ((bp = sim_brk_fnd_ex (loc, btyp, TRUE, spc))) {     /* in table, and type ma
 return 0;
 }
 
+/* Test each address of a data reference spanning lnt addresses
+
+   Used through sim_brk_watch_test_range, once the reference is known to
+   touch a page holding a breakpoint.
+*/
+
+uint32 sim_brk_watch_range (t_addr loc, uint32 lnt, uint32 btyp)
+{
+uint32 i, typ;
+
+for (i = 0; i < lnt; i++) {
+    if (sim_brk_watch_page (loc + i) &&
+        ((typ = sim_brk_test (loc + i, btyp)) != 0))
+        return typ;
+    }
+return 0;
+}
+
 /* Get next pending action, if any */
 
 CONST char *sim_brk_getact (char *buf, int32 size)
@@ -14100,6 +15424,413 @@ if (!msg[0])
 return msg;
 }
 
+/* Instruction history package.
+
+   A CPU keeps one fixed size binary record per executed instruction in a
+   ring set up by sim_hist_set (SET CPU HISTORY=n{:file}).  Each record is a
+   SIM_HIST_HDR (sequence number and, with -T, simulated time) followed by
+   the CPU's own payload.  The instruction loop calls sim_hist_add for the
+   next record and fills in the payload; that record, and the one before
+   it, may still be updated (with results or repeat counts, say) until the
+   following sim_hist_add.  Appending takes no locks.
+
+   With a log file, completed records are written out as text by the CPU,
+   through its formatting routine, each time the ring fills.  -B writes them
+   in the same binary format instead, from a writer thread (by the CPU
+   itself, in batches, when threads aren't available), and the CPU waits
+   only if the whole ring is still unwritten.  -O keeps just the latest
+   records: each text flush overwrites the last, and a binary log is slot
+   for slot a copy of the ring.
+
+   sim_hist_show decodes the ring or a log file (SHOW {-n} CPU HISTORY{=n|=file})
+   through the CPU's formatting routine.
+*/
+
+#define SIM_HIST_MAGIC  "SIMH-HISTORY 1"
+#define SIM_HIST_BATCH  256                             /* records handed to the writer at once */
+
+static struct {
+    DEVICE      *dptr;                                  /* recording CPU */
+    size_t      size;                                   /* record size, header included */
+    size_t      payload;                                /* CPU's part of it */
+    SIM_HIST_FMT fmt;                                   /* CPU's record printer */
+    uint8       *ring;
+    t_uint64    seq;                                    /* records handed out */
+    int32       switches;                               /* -T time stamps, -O circular log, -B binary log */
+    FILE        *log;
+    t_offset    logbase;                                /* first record in the log */
+    t_uint64    logged;                                 /* records written to the log */
+    } sim_hist;
+uint32 sim_hist_lnt = 0;                                /* ring length, 0 when off */
+static int32 sim_hist_pub = 0;                          /* records complete (mod 2^32) */
+static int32 sim_hist_done = 0;                         /* records logged (mod 2^32) */
+#if defined (SIM_ASYNCH_IO)
+static pthread_t sim_hist_thread;
+static pthread_mutex_t sim_hist_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_hist_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sim_hist_drained = PTHREAD_COND_INITIALIZER;
+static t_bool sim_hist_thread_running = FALSE;
+static t_bool sim_hist_thread_exit = FALSE;
+#endif
+
+#define SIM_HIST_SLOT(k) ((SIM_HIST_HDR *)(sim_hist.ring + (size_t)((k) % sim_hist_lnt) * sim_hist.size))
+
+static void _sim_hist_put (FILE *st, const SIM_HIST_HDR *h, t_bool timed, SIM_HIST_FMT fmt);
+static void _sim_hist_header (FILE *st, t_bool timed, SIM_HIST_FMT fmt);
+
+/* Copy the next 'count' completed records to the log */
+
+static void _sim_hist_write (uint32 count)
+{
+if (!(sim_hist.switches & SWMASK ('B'))) {              /* text log? */
+    t_bool timed = ((sim_hist.switches & SWMASK ('T')) != 0);
+    t_uint64 end = sim_hist.logged + count;
+    t_uint64 k = sim_hist.logged;
+
+    if (sim_hist.switches & SWMASK ('O')) {             /* overwrite with the latest ring full */
+        sim_set_fsize (sim_hist.log, (t_addr)0);
+        rewind (sim_hist.log);
+        _sim_hist_header (sim_hist.log, timed, sim_hist.fmt);
+        k = (end > sim_hist_lnt) ? end - sim_hist_lnt : 0;
+        }
+    for ( ; k < end; k++)
+        _sim_hist_put (sim_hist.log, SIM_HIST_SLOT (k), timed, sim_hist.fmt);
+    sim_hist.logged = end;
+    return;
+    }
+while (count > 0) {
+    uint32 slot = (uint32)(sim_hist.logged % sim_hist_lnt);
+    uint32 n = sim_hist_lnt - slot;
+
+    if (n > count)
+        n = count;
+    if (sim_hist.switches & SWMASK ('O'))               /* circular? same slot as the ring */
+        sim_fseeko (sim_hist.log, sim_hist.logbase + (t_offset)slot * sim_hist.size, SEEK_SET);
+    fwrite (sim_hist.ring + (size_t)slot * sim_hist.size, sim_hist.size, n, sim_hist.log);
+    sim_hist.logged += n;
+    count -= n;
+    }
+}
+
+#if defined (SIM_ASYNCH_IO)
+static void *_sim_hist_writer (void *arg)
+{
+pthread_mutex_lock (&sim_hist_lock);
+while (1) {
+    uint32 count = (uint32)(sim_shmem_atomic_add (&sim_hist_pub, 0) - sim_hist_done);
+
+    if (count == 0) {
+        if (sim_hist_thread_exit)
+            break;
+        pthread_cond_wait (&sim_hist_wake, &sim_hist_lock);
+        continue;
+        }
+    pthread_mutex_unlock (&sim_hist_lock);
+    _sim_hist_write (count);
+    sim_shmem_atomic_add (&sim_hist_done, (int32)count);
+    pthread_mutex_lock (&sim_hist_lock);
+    pthread_cond_signal (&sim_hist_drained);
+    }
+pthread_mutex_unlock (&sim_hist_lock);
+return NULL;
+}
+#endif
+
+/* Mark the first 'complete' records handed out as ready for the log */
+
+static void _sim_hist_publish (t_uint64 complete)
+{
+sim_shmem_atomic_add (&sim_hist_pub, (int32)((uint32)complete - (uint32)sim_hist_pub));
+#if defined (SIM_ASYNCH_IO)
+if (sim_hist_thread_running)
+    pthread_cond_signal (&sim_hist_wake);
+#endif
+}
+
+/* Wait until at most 'pending' completed records remain unlogged */
+
+static void _sim_hist_wait (uint32 pending)
+{
+#if defined (SIM_ASYNCH_IO)
+if (sim_hist_thread_running) {
+    pthread_mutex_lock (&sim_hist_lock);
+    while ((uint32)(sim_hist_pub - sim_shmem_atomic_add (&sim_hist_done, 0)) > pending) {
+        pthread_cond_signal (&sim_hist_wake);
+        pthread_cond_wait (&sim_hist_drained, &sim_hist_lock);
+        }
+    pthread_mutex_unlock (&sim_hist_lock);
+    return;
+    }
+#endif
+_sim_hist_write ((uint32)(sim_hist_pub - sim_hist_done));
+sim_hist_done = sim_hist_pub;
+}
+
+void *sim_hist_add (void)
+{
+SIM_HIST_HDR *h;
+
+if (sim_hist.log && (sim_hist.seq > 0)) {              /* all but the latest record are complete */
+    if ((((uint32)sim_hist.seq) & (SIM_HIST_BATCH - 1)) == 0)
+        _sim_hist_publish (sim_hist.seq - 1);
+    if ((uint32)((uint32)sim_hist.seq - (uint32)sim_hist_done) >= sim_hist_lnt) {/* ring full of unlogged records? */
+        _sim_hist_publish (sim_hist.seq - 1);
+        _sim_hist_wait (sim_hist_lnt - 2);
+        }
+    }
+h = SIM_HIST_SLOT (sim_hist.seq);
+h->seq = ++sim_hist.seq;
+h->time = (sim_hist.switches & SWMASK ('T')) ? sim_gtime () : 0.0;
+return (void *)(h + 1);
+}
+
+/* The record last handed out, to fill in more of it.  Before the first
+   one this is an empty slot, which sim_hist_add will hand out later. */
+
+void *sim_hist_last (void)
+{
+if (sim_hist_lnt == 0)
+    return NULL;
+return (void *)(SIM_HIST_SLOT (sim_hist.seq + sim_hist_lnt - 1) + 1);
+}
+
+/* The record before that, which a CPU folding repeated loops into one
+   entry may also still update. */
+
+void *sim_hist_prev (void)
+{
+if (sim_hist_lnt == 0)
+    return NULL;
+return (void *)(SIM_HIST_SLOT (sim_hist.seq + sim_hist_lnt - 2) + 1);
+}
+
+/* Log everything recorded so far, when the simulator stops */
+
+void sim_hist_flush (void)
+{
+if (sim_hist.log == NULL)
+    return;
+_sim_hist_publish (sim_hist.seq);
+_sim_hist_wait (0);
+fflush (sim_hist.log);
+}
+
+static void _sim_hist_close (void)
+{
+if (sim_hist.log) {
+    sim_hist_flush ();
+#if defined (SIM_ASYNCH_IO)
+    if (sim_hist_thread_running) {
+        pthread_mutex_lock (&sim_hist_lock);
+        sim_hist_thread_exit = TRUE;
+        pthread_cond_signal (&sim_hist_wake);
+        pthread_mutex_unlock (&sim_hist_lock);
+        pthread_join (sim_hist_thread, NULL);
+        sim_hist_thread_running = FALSE;
+        }
+#endif
+    fclose (sim_hist.log);
+    sim_hist.log = NULL;
+    }
+free (sim_hist.ring);
+sim_hist.ring = NULL;
+sim_hist_lnt = 0;
+sim_hist.seq = sim_hist.logged = 0;
+sim_hist_pub = sim_hist_done = 0;
+}
+
+/* SET <cpu> HISTORY{=n{:file}} for a CPU recording 'size' byte payloads */
+
+t_stat sim_hist_set (DEVICE *dptr, size_t size, SIM_HIST_FMT fmt, uint32 min, uint32 max, CONST char *cptr)
+{
+char gbuf[CBUFSIZE];
+uint32 lnt;
+t_stat r;
+
+if (cptr == NULL) {                                     /* clear history */
+    if (sim_hist_lnt == 0)
+        return SCPE_OK;
+    sim_hist_flush ();
+    memset (sim_hist.ring, 0, (size_t)sim_hist_lnt * sim_hist.size);
+    if (sim_hist.log) {                                 /* and start the log over */
+        sim_set_fsize (sim_hist.log, (t_addr)sim_hist.logbase);
+        sim_fseeko (sim_hist.log, sim_hist.logbase, SEEK_SET);
+        if (!(sim_hist.switches & SWMASK ('B')))
+            _sim_hist_header (sim_hist.log, ((sim_hist.switches & SWMASK ('T')) != 0), sim_hist.fmt);
+        }
+    return SCPE_OK;
+    }
+cptr = get_glyph_nc (cptr, gbuf, ':');
+lnt = (uint32) get_uint (gbuf, 10, max, &r);
+if (r != SCPE_OK)
+    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %u\n", gbuf, max);
+if (min < 2)                                            /* sim_hist_add keeps two records open */
+    min = 2;
+if (lnt && (lnt < min))
+    return sim_messagef (SCPE_ARG, "%u is less than the minumum history value of %u\n", lnt, min);
+_sim_hist_close ();
+if (lnt == 0)
+    return SCPE_OK;
+sim_hist.dptr = dptr;
+sim_hist.payload = size;
+sim_hist.fmt = fmt;
+sim_hist.size = sizeof (SIM_HIST_HDR) + ((size + 7) & ~((size_t)7));
+sim_hist.switches = sim_switches & (SWMASK ('T') | SWMASK ('O') | SWMASK ('B'));
+sim_hist.ring = (uint8 *)calloc (lnt, sim_hist.size);
+if (sim_hist.ring == NULL)
+    return SCPE_MEM;
+sim_hist_lnt = lnt;
+if (*cptr) {
+    sim_hist.log = sim_fopen (cptr, (sim_hist.switches & SWMASK ('B')) ? "wb" : "w");
+    if (sim_hist.log == NULL) {
+        _sim_hist_close ();
+        return sim_messagef (SCPE_OPENERR, "Unable to open file '%s': %s\n", cptr, strerror (errno));
+        }
+    if (!(sim_hist.switches & SWMASK ('B'))) {          /* text log: headings, then CPU writes as it fills */
+        _sim_hist_header (sim_hist.log, ((sim_hist.switches & SWMASK ('T')) != 0), fmt);
+        sim_hist.logbase = sim_ftell (sim_hist.log);
+        return SCPE_OK;
+        }
+    fprintf (sim_hist.log, "%s\n%s\n%s\n%u %u %s%s\n", SIM_HIST_MAGIC, sim_name, dptr->name,
+             (uint32)sim_hist.payload, lnt, (sim_hist.switches & SWMASK ('T')) ? "T" : "-",
+             (sim_hist.switches & SWMASK ('O')) ? "O" : "-");
+    sim_hist.logbase = sim_ftell (sim_hist.log);
+#if defined (SIM_ASYNCH_IO)
+    sim_hist_thread_exit = FALSE;
+    if (pthread_create (&sim_hist_thread, NULL, _sim_hist_writer, NULL) == 0)
+        sim_hist_thread_running = TRUE;
+#endif
+    }
+return SCPE_OK;
+}
+
+static void _sim_hist_put (FILE *st, const SIM_HIST_HDR *h, t_bool timed, SIM_HIST_FMT fmt)
+{
+if (h->seq == 0)                                        /* filled in? */
+    return;
+if (timed)
+    fprintf (st, "%10.0f  ", h->time);
+fmt (st, (const void *)(h + 1), timed);
+fputc ('\n', st);
+}
+
+static t_bool _sim_hist_print (FILE *st, const SIM_HIST_HDR *h, t_bool timed, SIM_HIST_FMT fmt)
+{
+if (stop_cpu) {                                         /* Control-C (SIGINT) */
+    stop_cpu = FALSE;
+    return FALSE;                                       /* abandon remaining output */
+    }
+_sim_hist_put (st, h, timed, fmt);
+return TRUE;
+}
+
+static void _sim_hist_header (FILE *st, t_bool timed, SIM_HIST_FMT fmt)
+{
+if (timed)
+    fprintf (st, " TIME       ");
+fmt (st, NULL, timed);
+}
+
+/* Decode a binary (-B) history log file written by this CPU */
+
+static t_stat _sim_hist_show_file (FILE *st, DEVICE *dptr, size_t size, SIM_HIST_FMT fmt, const char *fname)
+{
+char line[CBUFSIZE], name[CBUFSIZE], flags[8];
+uint32 payload, lnt, count, nrec, i, first;
+size_t recsize = sizeof (SIM_HIST_HDR) + ((size + 7) & ~((size_t)7));
+t_offset base, fsize;
+SIM_HIST_HDR *h;
+t_bool circular;
+FILE *f;
+
+sim_hist_flush ();
+if ((f = sim_fopen (fname, "rb")) == NULL)
+    return sim_messagef (SCPE_OPENERR, "Unable to open file '%s': %s\n", fname, strerror (errno));
+if ((fgets (line, sizeof (line), f) == NULL) ||
+    (strncmp (line, SIM_HIST_MAGIC, strlen (SIM_HIST_MAGIC)) != 0) ||
+    (fgets (line, sizeof (line), f) == NULL) ||         /* simulator name */
+    (fgets (name, sizeof (name), f) == NULL) ||
+    (fgets (line, sizeof (line), f) == NULL) ||
+    (sscanf (line, "%u %u %7s", &payload, &lnt, flags) != 3)) {
+    fclose (f);
+    return sim_messagef (SCPE_FMT, "%s is not a binary instruction history file\n", fname);
+    }
+sim_trim_endspc (name);
+if ((strcmp (name, dptr->name) != 0) || (payload != (uint32)size)) {
+    fclose (f);
+    return sim_messagef (SCPE_ARG, "%s was recorded by a different %s\n", fname, name);
+    }
+base = sim_ftell (f);
+fsize = sim_fsize_ex (f);
+nrec = (fsize > base) ? (uint32)((fsize - base) / recsize) : 0;
+circular = (strchr (flags, 'O') != NULL);
+h = (SIM_HIST_HDR *)calloc (1, recsize);
+if (h == NULL) {
+    fclose (f);
+    return SCPE_MEM;
+    }
+first = 0;
+if (circular) {                                         /* oldest follows newest */
+    t_uint64 newest = 0;
+
+    for (i = 0; i < nrec; i++) {
+        sim_fseeko (f, base + (t_offset)i * recsize, SEEK_SET);
+        if ((fread (h, recsize, 1, f) == 1) && (h->seq > newest)) {
+            newest = h->seq;
+            first = (i + 1) % nrec;
+            }
+        }
+    }
+count = nrec;
+if (sim_switch_number > 0) {                            /* -n: just the last n? */
+    count = (uint32) sim_switch_number;
+    if (count > nrec)
+        count = nrec;
+    }
+first = (first + nrec - count) % (nrec ? nrec : 1);
+_sim_hist_header (st, (strchr (flags, 'T') != NULL), fmt);
+for (i = 0; i < count; i++) {
+    sim_fseeko (f, base + (t_offset)((first + i) % nrec) * recsize, SEEK_SET);
+    if (fread (h, recsize, 1, f) != 1)
+        break;
+    if (!_sim_hist_print (st, h, (strchr (flags, 'T') != NULL), fmt))
+        break;
+    }
+free (h);
+fclose (f);
+return SCPE_OK;
+}
+
+/* SHOW <cpu> HISTORY{=n|=file} */
+
+t_stat sim_hist_show (FILE *st, DEVICE *dptr, size_t size, SIM_HIST_FMT fmt, CONST char *cptr)
+{
+t_bool timed = ((sim_hist.switches & SWMASK ('T')) != 0);
+uint32 k, lnt;
+t_uint64 di;
+t_stat r;
+
+if (cptr && *cptr && !sim_isdigit (*cptr))              /* a log file? */
+    return _sim_hist_show_file (st, dptr, size, fmt, cptr);
+if ((sim_hist_lnt == 0) || (sim_hist.dptr != dptr))     /* enabled? */
+    return SCPE_NOFNC;
+if (cptr) {
+    lnt = (uint32) get_uint (cptr, 10, sim_hist_lnt, &r);
+    if ((r != SCPE_OK) || (lnt == 0))
+        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %u\n", cptr, sim_hist_lnt);
+    }
+else
+    lnt = sim_hist_lnt;
+di = sim_hist.seq + sim_hist_lnt - lnt;                 /* work forward */
+_sim_hist_header (st, timed, fmt);
+for (k = 0; k < lnt; k++) {
+    if (!_sim_hist_print (st, SIM_HIST_SLOT (di + k), timed, fmt))
+        break;
+    }
+fflush (st);
+return SCPE_OK;
+}
+
 /* Expect package.  This code provides a mechanism to stop and control simulator
    execution based on traffic coming out of simulated ports and as well as a means
    to inject data into those ports.  It can conceptually viewed as a string
@@ -86,6 +86,8 @@ t_stat assign_cmd (int32 flag, CONST char *ptr);
 t_stat deassign_cmd (int32 flag, CONST char *ptr);
 t_stat save_cmd (int32 flag, CONST char *ptr);
 t_stat restore_cmd (int32 flag, CONST char *ptr);
+t_stat record_cmd (int32 flag, CONST char *ptr);
+t_stat replay_cmd (int32 flag, CONST char *ptr);
 t_stat exit_cmd (int32 flag, CONST char *ptr);
 t_stat set_cmd (int32 flag, CONST char *ptr);
 t_stat show_cmd (int32 flag, CONST char *ptr);
@@ -99,6 +101,7 @@ t_stat rename_cmd (int32 flg, CONST char *cptr);
 t_stat mkdir_cmd (int32 flg, CONST char *cptr);
 t_stat rmdir_cmd (int32 flg, CONST char *cptr);
 t_stat brk_cmd (int32 flag, CONST char *ptr);
+t_stat watch_cmd (int32 flag, CONST char *ptr);
 t_stat do_cmd (int32 flag, CONST char *ptr);
 t_stat goto_cmd (int32 flag, CONST char *ptr);
 t_stat return_cmd (int32 flag, CONST char *ptr);
@@ -224,6 +227,16 @@ t_stat get_aval (t_addr addr, DEVICE *dptr, UNIT *uptr);
 t_value get_rval (REG *rptr, uint32 idx);
 BRKTAB *sim_brk_fnd (t_addr loc);
 uint32 sim_brk_test (t_addr bloc, uint32 btyp);
+/* Data reference breakpoint test: one summary and one page map test unless the
+   page holds a breakpoint */
+#define sim_brk_watch_page(a) ((sim_brk_pages[SIM_BRK_PAGE (a) >> 5] >> (SIM_BRK_PAGE (a) & 0x1F)) & 1)
+#define sim_brk_watch_test(a, typ) ((sim_brk_summ & (typ)) && sim_brk_watch_page (a) && sim_brk_test ((a), (typ)))
+/* As sim_brk_watch_test, for a reference to lnt consecutive addresses (lnt no
+   larger than a page), so that a watchpoint on any of them is seen */
+#define sim_brk_watch_test_range(a, lnt, typ) ((sim_brk_summ & (typ)) &&                                        \
+                                               (sim_brk_watch_page (a) || sim_brk_watch_page ((a) + (lnt) - 1)) && \
+                                               sim_brk_watch_range ((a), (lnt), (typ)))
+uint32 sim_brk_watch_range (t_addr loc, uint32 lnt, uint32 btyp);
 void sim_brk_clrspc (uint32 spc, uint32 btyp);
 void sim_brk_npc (uint32 cnt);
 void sim_brk_setact (const char *action);
@@ -233,6 +246,38 @@ t_stat sim_send_input (SEND *snd, uint8 *data, size_t size, uint32 after, uint32
 t_stat sim_show_send_input (FILE *st, const SEND *snd);
 t_bool sim_send_poll_data (SEND *snd, t_stat *stat);
 t_stat sim_send_clear (SEND *snd);
+/* Input journal (RECORD/REPLAY).  Sources of non-deterministic input record
+   what they deliver with sim_jrn_put while recording and take it back with
+   sim_jrn_get, at the same simulated time, while replaying. */
+#define SIM_JRN_OFF     0                               /* modes: not journaling */
+#define SIM_JRN_RECORD  1                               /*        recording input */
+#define SIM_JRN_REPLAY  2                               /*        replaying input */
+#define SIM_JRN_CHAN    0                               /* record types: channel name */
+#define SIM_JRN_KBD     1                               /*   console keyboard poll */
+#define SIM_JRN_CONN    2                               /*   mux line connected */
+#define SIM_JRN_LINES   3                               /*   mux lines connected at a checkpoint */
+#define SIM_JRN_RX      4                               /*   mux line received data */
+#define SIM_JRN_DISC    5                               /*   mux line disconnected */
+#define SIM_JRN_ETH     6                               /*   Ethernet frame received */
+t_stat sim_jrn_put (int32 type, const char *chan, const void *data, size_t len);
+t_bool sim_jrn_get (int32 type, const char *chan, void *data, size_t *len);
+/* Instruction history.  Each record is a SIM_HIST_HDR followed by the CPU's
+   fixed size payload; sim_hist_add returns the payload to fill in and
+   sim_hist_last the latest one and sim_hist_prev the one before it (never
+   NULL while recording).  A
+   SIM_HIST_FMT routine prints one payload (or the column headings when rec
+   is NULL) for SHOW <cpu> HISTORY. */
+typedef struct {
+    t_uint64    seq;                                    /* record number, 0 if empty */
+    double      time;                                   /* simulated time (-T) */
+    } SIM_HIST_HDR;
+typedef void (*SIM_HIST_FMT)(FILE *st, const void *rec, t_bool timed);
+t_stat sim_hist_set (DEVICE *dptr, size_t size, SIM_HIST_FMT fmt, uint32 min, uint32 max, CONST char *cptr);
+t_stat sim_hist_show (FILE *st, DEVICE *dptr, size_t size, SIM_HIST_FMT fmt, CONST char *cptr);
+void *sim_hist_add (void);
+void *sim_hist_last (void);
+void *sim_hist_prev (void);
+void sim_hist_flush (void);
 t_stat sim_set_expect (EXPECT *exp, CONST char *cptr);
 t_stat sim_set_noexpect (EXPECT *exp, const char *cptr);
 t_stat sim_exp_set (EXPECT *exp, const char *match, int32 cnt, uint32 after, int32 switches, const char *act);
@@ -338,6 +383,10 @@ extern volatile t_bool stop_cpu;
 extern uint32 sim_brk_types;                            /* breakpoint info */
 extern uint32 sim_brk_dflt;
 extern uint32 sim_brk_summ;
+extern uint32 sim_brk_pages[];
+extern int32 sim_jrn_mode;                              /* input journal mode */
+extern t_bool sim_jrn_quiet;                            /* reverse execution output suppression */
+extern uint32 sim_hist_lnt;                             /* instruction history length */
 extern uint32 sim_brk_match_type;
 extern t_addr sim_brk_match_addr;
 extern BRKTYPTAB *sim_brk_type_desc;                    /* type descriptions */
@@ -141,6 +141,7 @@
 
 #define HIST_MIN        64
 #define HIST_MAX        (1u << 20)
+#define HIST_LAST       ((InstHistory *) sim_hist_last ())
 #define H_INST          0x00800000
 #define H_CHAN          0x00400000
 #define H_ITRP          0x00200000
@@ -182,9 +183,6 @@ uint32 cpu_astop = 0;                                   /* address stop */
 uint32 pcq[PCQ_SIZE] = { 0 };                           /* PC queue */
 int32 pcq_p = 0;                                        /* PC queue ptr */
 REG *pcq_r = NULL;                                      /* PC queue reg ptr */
-int32 hst_p = 0;                                        /* history pointer */
-int32 hst_lnt = 0;                                      /* history length */
-InstHistory *hst = NULL;                                /* inst history */
 
 extern uint32 int_hiact;                                /* highest act int */
 extern uint32 int_hireq;                                /* highest int req */
@@ -201,6 +199,7 @@ t_stat cpu_set_rblks (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_rblks (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat cpu_set_alarm (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_alarm (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 t_stat cpu_show_addr (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
@@ -359,7 +358,7 @@ MTAB cpu_mod[] = {
       NULL, &cpu_show_addr },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, DW, "DA", NULL,
       NULL, &cpu_show_addr },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "HISTORY", "HISTORY",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist },
     { 0 }
     };
@@ -530,7 +529,7 @@ t_bool mprot;
 
 exu_cnt = 0;                                            /* init EXU count */
 EXU_LOOP:
-if (hst_lnt)                                            /* history? record */
+if (sim_hist_lnt)                                       /* history? record */
     inst_hist (IR, real_pc, H_INST);
 op = I_GETOP (IR);                                      /* get opcode */
 rn = I_GETRN (IR);                                      /* get reg num */
@@ -1798,7 +1797,7 @@ op = I_GETOP (IR);                                      /* get op */
 lnt = 3 - (op >> 5);                                    /* 73, 53, 33 */
 acc = (vec == VEC_C4P)? VNT: PH;                        /* access */
 rn = I_GETRN (IR);                                      /* register */
-if (hst_lnt)                                            /* if history */
+if (sim_hist_lnt)                                       /* if history */
     inst_hist (IR, PC, H_ITRP);                         /* record inst */
 if ((acc || QCPU_S567)?                                 /* virt or S5-7? */
     (Ea (IR, &bva, acc, lnt) != 0):                     /* get eff addr */
@@ -1841,9 +1840,9 @@ uint32 IR, op, bva, acc, cc;
 
 ReadPW (TR_GETVEC (vec), &IR);                          /* read vector */
 op = I_GETOP (IR);                                      /* get op */
-if (hst_lnt) {                                          /* if history */
+if (sim_hist_lnt) {                                     /* if history */
     if (vec & TR_FL)                                    /* trap? */
-        hst[hst_p].typ_cc_pc |= H_ABRT;                 /* mark prev abt */
+        HIST_LAST->typ_cc_pc |= H_ABRT;                 /* mark prev abt */
     inst_hist (IR, PC, H_ITRP);                         /* record inst */
     }
 if (vec & TR_FL) {                                      /* trap? */
@@ -1885,8 +1884,11 @@ uint32 ImmOp (uint32 IR, uint32 *imm)
 if (TST_IND (IR))                                       /* indirect traps */
     return TR_NXI;
 *imm = I_GETLIT (IR);
-if (hst_lnt)                                            /* record history */
-    hst[hst_p].ea = hst[hst_p].op = *imm;
+if (sim_hist_lnt) {                                     /* record history */
+    InstHistory *h = HIST_LAST;
+
+    h->ea = h->op = *imm;
+    }
 return 0;
 }
 
@@ -1915,9 +1917,11 @@ if (TST_IND (IR)) {                                     /* indirect */
     else ad = (wd & bvamqrx) << 2;                      /* get byte address */
     }
 *bva = (ad + (xr? (R[xr] << lnt): 0)) & bvamqrx;        /* index, mask */
-if (hst_lnt) {                                          /* history? */
-    hst[hst_p].ea = *bva;
-    ReadHist (*bva, &hst[hst_p].op, &hst[hst_p].op1, acc? VNT: PH, lnt);
+if (sim_hist_lnt) {                                     /* history? */
+    InstHistory *h = HIST_LAST;
+
+    h->ea = *bva;
+    ReadHist (*bva, &h->op, &h->op1, acc? VNT: PH, lnt);
     }
 return 0;
 }
@@ -1937,9 +1941,11 @@ if (TST_IND (IR)) {                                     /* indirect? */
     pa = wd & cpu_tab[cpu_model].pamask;                /* get indirect */
     }
 *bva = pa << 2;
-if (hst_lnt) {                                          /* history? */
-    hst[hst_p].ea = *bva;
-    ReadHist (*bva, &hst[hst_p].op, &hst[hst_p].op1, PH, lnt);
+if (sim_hist_lnt) {                                     /* history? */
+    InstHistory *h = HIST_LAST;
+
+    h->ea = *bva;
+    ReadHist (*bva, &h->op, &h->op1, PH, lnt);
     }
 return 0;
 }
@@ -1961,9 +1967,11 @@ if (xr)
     ad = (ad & ~SHF_M_SC) | ((ad + R[xr]) & SHF_M_SC);  /* indexing? */
 *stype = SHF_GETSOP (ad);                               /* extract type */
 *sc = SHF_GETSC (ad);                                   /* extract count */
-if (hst_lnt) {
-    hst[hst_p].ea = ad << 2;
-    hst[hst_p].op = ad;
+if (sim_hist_lnt) {
+    InstHistory *h = HIST_LAST;
+
+    h->ea = ad << 2;
+    h->op = ad;
     }
 return 0;
 }
@@ -2751,15 +2759,13 @@ return SCPE_OK;
 
 void inst_hist (uint32 ir, uint32 pc, uint32 tp)
 {
+InstHistory *h = (InstHistory *) sim_hist_add ();       /* next entry */
 uint32 rn = I_GETRN (ir);
 
-hst_p = (hst_p + 1);                                    /* next entry */
-if (hst_p >= hst_lnt)
-    hst_p = 0;
-hst[hst_p].typ_cc_pc = (CC << PSW1_V_CC) | pc | tp;
-hst[hst_p].ir = ir;
-hst[hst_p].rn = R[rn];
-hst[hst_p].rn1 = R[rn|1];
+h->typ_cc_pc = (CC << PSW1_V_CC) | pc | tp;
+h->ir = ir;
+h->rn = R[rn];
+h->rn1 = R[rn|1];
 return;
 }
 
@@ -2767,33 +2773,7 @@ return;
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-int32 i, lnt;
-t_stat r;
-
-if (cptr == NULL) {
-    for (i = 0; i < hst_lnt; i++)
-        hst[i].typ_cc_pc = 0;
-    hst_p = 0;
-    return SCPE_OK;
-    }
-lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-hst_p = 0;
-if (hst_lnt) {
-    free (hst);
-    hst_lnt = 0;
-    hst = NULL;
-    }
-if (lnt) {
-    hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-    if (hst == NULL)
-        return SCPE_MEM;
-    hst_lnt = lnt;
-    }
-return SCPE_OK;
+return sim_hist_set (&cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Print one instruction */
@@ -2823,7 +2803,6 @@ if (tcp & (H_INST|H_ITRP)) {                        /* instr or trap? */
     sim_val = ir;
     if ((fprint_sym (st, pc, &sim_val, NULL, SWMASK ('M'))) > 0)
         fprintf (st, "(undefined) %08X", ir);
-    fputc ('\n', st);                               /* end line */
     }
 return;
 }
@@ -2832,30 +2811,18 @@ return;
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-int32 k, di, lnt;
-t_stat r;
-char *cptr = (char *) desc;
-InstHistory *h;
+return sim_hist_show (st, &cpu_dev, sizeof (InstHistory), &cpu_fprint_hist, (CONST char *) desc);
+}
 
-if (hst_lnt == 0)                                   /* enabled? */
-    return SCPE_NOFNC;
-if (cptr) {
-    lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-    if ((r != SCPE_OK) || (lnt == 0))
-        return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
+/* Print one history entry, or the column headings */
+
+void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+const InstHistory *h = (const InstHistory *) rec;
+
+if (h == NULL) {
+    fprintf (st, "  PC   CC Rn       Rn|1     EA    operand  operand1 IR\n\n");
+    return;
     }
-else lnt = hst_lnt;
-di = hst_p - lnt;                                       /* work forward */
-if (di < 0) di = di + hst_lnt;
-fprintf (st, "  PC   CC Rn       Rn|1     EA    operand  operand1 IR\n\n");
-for (k = 0; k < lnt; k++) {                             /* print specified */
-    if (stop_cpu) {                                     /* Control-C (SIGINT) */
-        stop_cpu = FALSE;
-        break;                                          /* abandon remaining output */
-        }
-    h = &hst[(++di) % hst_lnt];                         /* entry pointer */
-    if (h->typ_cc_pc)                                   /* instruction? */
-        cpu_fprint_one_inst (st, h->typ_cc_pc, h->ir, h->rn, h->rn1, h->ea, h->op, h->op1);
-    }                                                   /* end for */
-return SCPE_OK;
+cpu_fprint_one_inst (st, h->typ_cc_pc, h->ir, h->rn, h->rn1, h->ea, h->op, h->op1);
 }
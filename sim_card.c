@@ -90,7 +90,8 @@
 
 #define CARD_EOF          0x1000         /* This card is end of file card. */
 #define CARD_ERR          0x2000         /* Return error for this card */
-#define DECK_SIZE         1000           /* Number of cards to allocate at a time */
+#define DECK_SIZE         1000           /* Minimum number of cards to allocate at a time */
+#define PUNCH_BUF_SIZE    65536          /* Punch output buffered before writing */
 
 
 struct card_context
@@ -101,6 +102,8 @@ struct card_context
     t_addr              hopper_size;     /* Size of hopper */
     t_addr              hopper_cards;    /* Number of cards in hopper */
     uint16              (*images)[1][80];
+    uint8               *punch_buf;      /* Punch output not yet written */
+    size_t              punch_len;       /* Bytes in punch_buf */
 };
 
 /* Character conversion tables */
@@ -666,7 +669,8 @@ sim_card_eof(UNIT *uptr)
 
 
 struct _card_buffer {
-   uint8                 buffer[8192+500];    /* Buffer data */
+   uint8                 data[8192+500];      /* Buffer data */
+   uint8                *buffer;              /* Start of next card in data */
    int                   len;                 /* Amount of data in buffer */
    int                   size;                /* Size of last card read */
 };
@@ -968,14 +972,35 @@ _sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*ima
     return SCPE_OK;
 }
 
+/*
+ * Make room for at least one more card in the hopper.  The hopper
+ * doubles in size so that large decks are not copied repeatedly.
+ */
+static t_stat
+_sim_card_grow_hopper(struct card_context *data)
+{
+    t_addr                size;
+    uint16               (*images)[1][80];
+
+    if (data->hopper_cards < data->hopper_size)
+        return SCPE_OK;
+    size = data->hopper_size + ((data->hopper_size > DECK_SIZE) ? data->hopper_size : DECK_SIZE);
+    images = (uint16 (*)[1][80])realloc(data->images, (size_t)size * sizeof(*(data->images)));
+    if (images == NULL)
+        return SCPE_MEM;
+    memset(&images[data->hopper_cards], 0,
+               (size_t)(size - data->hopper_cards) * sizeof(*(data->images)));
+    data->images = images;
+    data->hopper_size = size;
+    return SCPE_OK;
+}
+
 t_stat
 _sim_read_deck(UNIT * uptr, int eof)
 {
     struct _card_buffer   buf;
     struct card_context  *data;
     DEVICE               *dptr;
-    int                   i;
-    int                   j;
     int                   l;
     int                   cards = 0;
     t_stat                r = SCPE_OK;
@@ -986,6 +1011,7 @@ _sim_read_deck(UNIT * uptr, int eof)
     dptr = find_dev_from_unit( uptr);
     data = (struct card_context *)uptr->card_ctx;
 
+    buf.buffer = buf.data;
     buf.len = 0;
     buf.size = 0;
     buf.buffer[0] = 0; /* Initialize buffer to empty */
@@ -993,18 +1019,20 @@ _sim_read_deck(UNIT * uptr, int eof)
     /* Slurp up current file */
     do {
         if (buf.len < 500 && !feof(uptr->fileref)) {
+            /* Move remaining data to the start of the buffer */
+            /* so that each card is decoded from a single contiguous buffer */
+            memmove(buf.data, buf.buffer, buf.len);
+            buf.buffer = buf.data;
             l = sim_fread(&buf.buffer[buf.len], 1, 8192, uptr->fileref);
             buf.len += l;
+            buf.buffer[buf.len] = '\0';
         }
 
         /* Allocate space for some more cards if needed */
-        if (data->hopper_cards >= data->hopper_size) {
-            data->hopper_size += DECK_SIZE;
-            data->images = (uint16 (*)[1][80])realloc(data->images,
-                       (size_t)data->hopper_size * sizeof(*(data->images)));
-            memset(&data->images[data->hopper_cards], 0,
-                       (size_t)(data->hopper_size - data->hopper_cards) *
-                             sizeof(*(data->images)));
+        if (_sim_card_grow_hopper(data) != SCPE_OK) {
+            r = sim_messagef(SCPE_MEM, "%s: %s No memory for card %d\n",
+                   sim_uname(uptr), uptr->filename, cards + 1);
+            break;
         }
 
         /* Process one card */
@@ -1015,13 +1043,8 @@ _sim_read_deck(UNIT * uptr, int eof)
                    sim_uname(uptr), uptr->filename, sim_error_text(r), cards);
         }
         data->hopper_cards++;
-        /* Move data to start at beginning of buffer */
-        /* Data is moved down to simplify the decoding of one card */
-        l = buf.len - buf.size;
-        j = buf.size;
-        for(i = 0; i < l; i++, j++)
-            buf.buffer[i] = buf.buffer[j];
-        buf.buffer[i] = '\0';
+        /* Step over the card just decoded */
+        buf.buffer += buf.size;
         buf.len -= buf.size;
     } while (buf.len > 0 && r == SCPE_OK);
 
@@ -1029,14 +1052,8 @@ _sim_read_deck(UNIT * uptr, int eof)
     if (r == SCPE_OK) {
        if (eof) {
           /* Allocate space for some more cards if needed */
-          if (data->hopper_cards >= data->hopper_size) {
-              data->hopper_size += DECK_SIZE;
-              data->images = (uint16 (*)[1][80])realloc(data->images,
-                         (size_t)data->hopper_size * sizeof(*(data->images)));
-              memset(&data->images[data->hopper_cards], 0,
-                         (size_t)(data->hopper_size - data->hopper_cards) *
-                               sizeof(*(data->images)));
-          }
+          if (_sim_card_grow_hopper(data) != SCPE_OK)
+              return SCPE_MEM;
 
           /* Create empty card */
           (*data->images)[data->hopper_cards][0] = CARD_EOF;
@@ -1047,8 +1064,28 @@ _sim_read_deck(UNIT * uptr, int eof)
 }
 
 
+/* Write any buffered punch output to the file.  Also called by SCP
+   when it flushes attached files. */
+
+static void
+_sim_card_io_flush(UNIT *uptr)
+{
+    struct card_context *data = (struct card_context *)uptr->card_ctx;
+
+    if (data == NULL || uptr->fileref == NULL)
+        return;
+    if (data->punch_len != 0) {
+        sim_fwrite(data->punch_buf, 1, data->punch_len, uptr->fileref);
+        data->punch_len = 0;
+    }
+    fflush(uptr->fileref);
+}
+
 /* Card punch routine
 
+   Punch output is collected in memory and written in bulk when the
+   buffer fills, when SCP flushes attached files and at detach.
+
    Modifiers have been checked by the caller
    C modifier is recognized (column binary is implemented)
 */
@@ -1203,8 +1240,17 @@ sim_punch_card(UNIT * uptr, uint16 image[80])
         break;
     }
     data->punch_count++;
-    sim_fwrite(out, 1, outp, uptr->fileref);
-    uptr->pos = ftell (uptr->fileref);
+    if (data->punch_buf == NULL)
+        data->punch_buf = (uint8 *)malloc(PUNCH_BUF_SIZE);
+    if (data->punch_buf == NULL)
+        sim_fwrite(out, 1, outp, uptr->fileref);
+    else {
+        if (data->punch_len + outp > PUNCH_BUF_SIZE)
+            _sim_card_io_flush(uptr);
+        memcpy(&data->punch_buf[data->punch_len], out, outp);
+        data->punch_len += outp;
+    }
+    uptr->pos += outp;
     /* Clear image buffer */
     for (i = 0; i < 80; image[i++] = 0);
     return CDSE_OK;
@@ -1347,6 +1393,9 @@ sim_card_attach(UNIT * uptr, CONST char *cptr)
          }
     }
 
+    if ((uptr->flags & UNIT_RO) == 0)       /* Card Punch? */
+        uptr->io_flush = _sim_card_io_flush;
+
     if (uptr->flags & UNIT_RO) {            /* Card Reader? */
         t_addr  previous_cards = data->hopper_cards;
 
@@ -1410,7 +1459,11 @@ sim_card_detach(UNIT * uptr)
     /* Free buffer if one allocated */
     if (uptr->card_ctx != 0) {
         struct card_context * data = (struct card_context *)uptr->card_ctx;
+        if ((uptr->flags & (UNIT_ATT | UNIT_RO)) == UNIT_ATT)
+            _sim_card_io_flush(uptr);   /* Write any pending punch output */
+        uptr->io_flush = NULL;
         /* No clear any existing decks on stack */
+        free(data->punch_buf);
         free(data->images);
         free(uptr->card_ctx);
         uptr->card_ctx = 0;
@@ -1487,10 +1540,30 @@ t_stat stat = SCPE_OK;
 char cmd[CBUFSIZE];
 char saved_filename[4*CBUFSIZE];
 uint16 card_image[80];
+int cards;
 SIM_TEST_INIT;
 
-if ((dptr->units->flags & UNIT_RO) == 0)  /* Punch device? */
+if ((dptr->units->flags & UNIT_RO) == 0) { /* Punch device? */
+    UNIT *uptr = dptr->units;
+
+    sim_printf ("Testing %s device sim_card punch APIs\n", dptr->name);
+    (void)remove ("Punch.deck");
+    sprintf (cmd, "%s -N Punch.deck", dptr->name);
+    SIM_TEST(attach_cmd (0, cmd));
+    for (cards = 0; cards < 5000; cards++) {
+        memset (card_image, 0, sizeof (card_image));
+        card_image[0] = ascii_to_hol_026['A' + (cards % 26)];
+        SIM_TEST(sim_punch_card (uptr, card_image));
+        }
+    SIM_TEST((sim_punch_count (uptr) == 5000) ? SCPE_OK : SCPE_IERR);
+    if (uptr->io_flush)                     /* write buffered output */
+        uptr->io_flush (uptr);
+    sim_printf ("Punched %d cards, %d bytes\n", (int)sim_punch_count (uptr), (int)uptr->pos);
+    SIM_TEST(((t_addr)sim_fsize (uptr->fileref) == uptr->pos) ? SCPE_OK : SCPE_IERR);
+    SIM_TEST(detach_cmd (0, dptr->name));
+    (void)remove ("Punch.deck");
     return SCPE_OK;
+    }
 
 sim_printf ("Testing %s device sim_card APIs\n", dptr->name);
 
@@ -1531,6 +1604,16 @@ show_cmd (0, dptr->name);
 sim_printf ("Input Hopper Count:  %d\n", (int)sim_card_input_hopper_count(dptr->units));
 sim_printf ("Output Hopper Count: %d\n", (int)sim_card_output_hopper_count(dptr->units));
 SIM_TEST(detach_cmd (0, dptr->name));
+/* A deck larger than several hopper allocations and read buffers */
+SIM_TEST(create_card_file ("File5000.deck", 5000));
+sprintf (cmd, "%s File5000.deck", dptr->name);
+SIM_TEST(attach_cmd (0, cmd));
+SIM_TEST((sim_card_input_hopper_count(dptr->units) == 5000) ? SCPE_OK : SCPE_IERR);
+for (cards = 0; sim_read_card (dptr->units, card_image) == CDSE_OK; cards++);
+sim_printf ("Read %d cards\n", cards);
+SIM_TEST((cards == 5000) ? SCPE_OK : SCPE_IERR);
+SIM_TEST(detach_cmd (0, dptr->name));
+(void)remove ("File5000.deck");
 (void)remove ("file10.deck");
 (void)remove ("file20.deck");
 (void)remove ("file30.deck");
@@ -114,6 +114,7 @@
    sim_ttisatty                 called to determine if running interactively
    sim_os_poll_kbd              poll for keyboard input
    _sim_os_putchar              output character to console
+   _sim_con_putchar             output character to console, batched if enabled
    sim_set_noconsole_port       Enable automatic WRU console polling
    sim_set_stable_registers_state Declare that all registers are always stable
 
@@ -343,6 +344,8 @@ static CTAB set_con_tab[] = {
     { "DBGINT",  &sim_set_kmap, KMAP_DBGINT | KMAP_NZ },
     { "DBGSIGNAL", &sim_set_dbgsignal, 0 },
     { "NODBGSIGNAL", &sim_reset_dbgsignal, 0 },
+    { "BATCH", &sim_set_cons_batch, 1 },
+    { "NOBATCH", &sim_set_cons_batch, 0 },
     { NULL, NULL, 0 }
     };
 
@@ -374,6 +377,7 @@ static SHTAB show_con_tab[] = {
     { "RESPONSE", &sim_show_cons_send_input, -1 },
     { "DELAY", &sim_show_cons_expect, -1 },
     { "DBGSIGNAL", &sim_show_dbgsignal, 0 },
+    { "BATCH", &sim_show_cons_batch, 0 },
     { NULL, NULL, 0 }
     };
 
@@ -3014,10 +3018,295 @@ fprintf(st, "Debugger interrupt not supported on this platform.\n");
 return SCPE_OK;
 }
 
-/* Poll for character */
+/* Batch console I/O (SET CONSOLE BATCH)
+
+   For headless runs, console output is appended to a ring that a writer
+   thread drains to stdout, and stdin is read by a reader thread into a
+   queue, so the simulator never blocks on a slow pipe and a keyboard poll
+   is just a look at the queue.  The simulator only waits when the output
+   ring is full.  Each ring has one producer and one consumer and needs no
+   lock; the mutex is only used to sleep and wake the other side.  The
+   reader only reads while the simulator is running, so a line typed at
+   the sim> prompt still goes to the command reader, but anything typed
+   ahead while running belongs to the simulated console; commands should
+   come from a DO script.
+*/
+
+#if defined (SIM_ASYNCH_IO) && !defined (_WIN32) && !defined (VMS)
+#define CON_BATCH       1
+#endif
+
+#define CON_BATCH_OSIZE 65536                           /* output ring size, power of 2 */
+#define CON_BATCH_ISIZE 4096                            /* input queue size, power of 2 */
+
+static t_bool sim_con_batch = FALSE;                    /* batch mode active */
+
+#if defined (CON_BATCH)
+#include <unistd.h>
+#include <poll.h>
+
+static uint8 sim_con_bo_buf[CON_BATCH_OSIZE];
+static int32 sim_con_bo_head = 0;                       /* chars written by the simulator (mod 2^32) */
+static int32 sim_con_bo_tail = 0;                       /* chars written to stdout (mod 2^32) */
+static int32 sim_con_bo_wsleep = 0;                     /* writer waiting for output */
+static int32 sim_con_bo_pwait = 0;                      /* simulator waiting for space */
+static uint8 sim_con_bi_buf[CON_BATCH_ISIZE];
+static int32 sim_con_bi_head = 0;                       /* chars read from stdin */
+static int32 sim_con_bi_tail = 0;                       /* chars polled by the simulator */
+static t_bool sim_con_batch_stop = FALSE;
+static t_bool sim_con_batch_rrun = FALSE;               /* reader may read stdin */
+static pthread_t sim_con_batch_writer;
+static pthread_t sim_con_batch_reader;
+static pthread_mutex_t sim_con_batch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_con_batch_owork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sim_con_batch_ospace = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sim_con_batch_iwork = PTHREAD_COND_INITIALIZER;
+
+static void *_sim_con_batch_write (void *arg)
+{
+while (1) {
+    int32 tail = sim_con_bo_tail;
+    uint32 count = (uint32)(sim_shmem_atomic_add (&sim_con_bo_head, 0) - tail);
+    uint32 off, n;
+    ssize_t written;
+
+    if (count == 0) {                                   /* nothing to write? */
+        pthread_mutex_lock (&sim_con_batch_lock);
+        sim_shmem_atomic_add (&sim_con_bo_wsleep, 1);   /* announce sleep, then recheck */
+        if ((sim_shmem_atomic_add (&sim_con_bo_head, 0) == tail) && !sim_con_batch_stop)
+            pthread_cond_wait (&sim_con_batch_owork, &sim_con_batch_lock);
+        sim_shmem_atomic_add (&sim_con_bo_wsleep, -1);
+        if (sim_con_batch_stop && (sim_shmem_atomic_add (&sim_con_bo_head, 0) == tail)) {
+            pthread_mutex_unlock (&sim_con_batch_lock);
+            break;
+            }
+        pthread_mutex_unlock (&sim_con_batch_lock);
+        continue;
+        }
+    off = (uint32)tail & (CON_BATCH_OSIZE - 1);
+    n = MIN (count, CON_BATCH_OSIZE - off);             /* contiguous part */
+    written = write (1, &sim_con_bo_buf[off], n);
+    if (written < 0) {
+        if (errno == EINTR)
+            continue;
+        written = n;                                    /* stdout gone: discard */
+        }
+    sim_shmem_atomic_add (&sim_con_bo_tail, (int32)written);
+    if (sim_shmem_atomic_add (&sim_con_bo_pwait, 0)) {  /* simulator waiting for space? */
+        pthread_mutex_lock (&sim_con_batch_lock);
+        pthread_cond_broadcast (&sim_con_batch_ospace);
+        pthread_mutex_unlock (&sim_con_batch_lock);
+        }
+    }
+return NULL;
+}
+
+static void *_sim_con_batch_read (void *arg)
+{
+uint8 buf[256];
+ssize_t i, n;
+struct pollfd pfd;
+t_bool stop;
+
+while (1) {
+    pthread_mutex_lock (&sim_con_batch_lock);
+    while (!sim_con_batch_rrun && !sim_con_batch_stop)  /* paused at the sim> prompt */
+        pthread_cond_wait (&sim_con_batch_iwork, &sim_con_batch_lock);
+    stop = sim_con_batch_stop;
+    pthread_mutex_unlock (&sim_con_batch_lock);
+    if (stop)
+        break;
+    pfd.fd = 0;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll (&pfd, 1, 100) <= 0)                       /* nothing yet (or EINTR)? */
+        continue;
+    pthread_mutex_lock (&sim_con_batch_lock);           /* read only if still running */
+    n = sim_con_batch_rrun ? read (0, buf, sizeof (buf)) : -1;
+    pthread_mutex_unlock (&sim_con_batch_lock);
+    if (n < 0) {
+        if ((errno == EINTR) || !sim_con_batch_rrun)
+            continue;
+        break;
+        }
+    if (n == 0)                                         /* EOF */
+        break;
+    for (i = 0; i < n; i++) {
+        while ((uint32)(sim_con_bi_head - sim_shmem_atomic_add (&sim_con_bi_tail, 0)) >= CON_BATCH_ISIZE)
+            sim_os_ms_sleep (10);                       /* queue full: the simulator isn't polling */
+        sim_con_bi_buf[(uint32)sim_con_bi_head & (CON_BATCH_ISIZE - 1)] = buf[i];
+        sim_shmem_atomic_add (&sim_con_bi_head, 1);
+        }
+    }
+return NULL;
+}
+
+/* Wait until the output ring has at most 'pending' characters in it */
+
+static void _sim_con_batch_wait (uint32 pending)
+{
+pthread_mutex_lock (&sim_con_batch_lock);
+sim_shmem_atomic_add (&sim_con_bo_pwait, 1);            /* announce wait, then recheck */
+while ((uint32)(sim_con_bo_head - sim_shmem_atomic_add (&sim_con_bo_tail, 0)) > pending) {
+    pthread_cond_signal (&sim_con_batch_owork);
+    pthread_cond_wait (&sim_con_batch_ospace, &sim_con_batch_lock);
+    }
+sim_shmem_atomic_add (&sim_con_bo_pwait, -1);
+pthread_mutex_unlock (&sim_con_batch_lock);
+}
+
+static t_stat _sim_con_batch_putc (int32 c)
+{
+if ((uint32)(sim_con_bo_head - sim_shmem_atomic_add (&sim_con_bo_tail, 0)) >= CON_BATCH_OSIZE)
+    _sim_con_batch_wait (CON_BATCH_OSIZE - 1);          /* full: stall */
+sim_con_bo_buf[(uint32)sim_con_bo_head & (CON_BATCH_OSIZE - 1)] = (uint8)c;
+sim_shmem_atomic_add (&sim_con_bo_head, 1);             /* publish */
+if (sim_shmem_atomic_add (&sim_con_bo_wsleep, 0)) {     /* writer asleep? */
+    pthread_mutex_lock (&sim_con_batch_lock);
+    pthread_cond_signal (&sim_con_batch_owork);
+    pthread_mutex_unlock (&sim_con_batch_lock);
+    }
+return SCPE_OK;
+}
+
+static t_stat _sim_con_batch_getc (void)
+{
+uint8 c;
+
+if (sim_con_bi_tail == sim_shmem_atomic_add (&sim_con_bi_head, 0))
+    return SCPE_OK;                                     /* nothing queued */
+c = sim_con_bi_buf[(uint32)sim_con_bi_tail & (CON_BATCH_ISIZE - 1)];
+sim_shmem_atomic_add (&sim_con_bi_tail, 1);
+if (sim_brk_char && (c == sim_brk_char))
+    return SCPE_BREAK;
+if (sim_int_char && (c == sim_int_char))
+    return SCPE_STOP;
+return (c | SCPE_KFLAG);
+}
+
+/* Let the reader take stdin while running and give it back at the prompt;
+   a read already under way finishes before the pause takes effect */
+
+static void _sim_con_batch_reader (t_bool run)
+{
+pthread_mutex_lock (&sim_con_batch_lock);
+sim_con_batch_rrun = run;
+pthread_cond_signal (&sim_con_batch_iwork);
+pthread_mutex_unlock (&sim_con_batch_lock);
+}
+
+static t_stat _sim_con_batch_end (void)
+{
+if (!sim_con_batch)
+    return SCPE_OK;
+_sim_con_batch_wait (0);                                /* write out everything */
+pthread_mutex_lock (&sim_con_batch_lock);
+sim_con_batch_stop = TRUE;
+pthread_cond_signal (&sim_con_batch_owork);
+pthread_cond_signal (&sim_con_batch_iwork);
+pthread_mutex_unlock (&sim_con_batch_lock);
+pthread_join (sim_con_batch_writer, NULL);
+pthread_join (sim_con_batch_reader, NULL);              /* polls, so sees stop */
+sim_con_batch = FALSE;
+return SCPE_OK;
+}
+#endif
+
+t_stat sim_set_cons_batch (int32 flag, CONST char *cptr)
+{
+if ((cptr != NULL) && (*cptr != '\0'))                  /* too many arguments? */
+    return SCPE_2MARG;
+#if defined (CON_BATCH)
+if (!flag)                                              /* NOBATCH */
+    return _sim_con_batch_end ();
+if (sim_con_batch)
+    return SCPE_OK;
+fflush (stdout);
+sim_con_bo_head = sim_con_bo_tail = 0;
+sim_con_bi_head = sim_con_bi_tail = 0;
+sim_con_batch_stop = FALSE;
+sim_con_batch_rrun = FALSE;                             /* set from the command prompt */
+if (pthread_create (&sim_con_batch_writer, NULL, _sim_con_batch_write, NULL) != 0)
+    return sim_messagef (SCPE_IERR, "Can't start console output thread\n");
+if (pthread_create (&sim_con_batch_reader, NULL, _sim_con_batch_read, NULL) != 0) {
+    sim_con_batch = TRUE;
+    pthread_mutex_lock (&sim_con_batch_lock);
+    sim_con_batch_stop = TRUE;
+    pthread_cond_signal (&sim_con_batch_owork);
+    pthread_mutex_unlock (&sim_con_batch_lock);
+    pthread_join (sim_con_batch_writer, NULL);
+    sim_con_batch = FALSE;
+    return sim_messagef (SCPE_IERR, "Can't start console input thread\n");
+    }
+sim_con_batch = TRUE;
+return SCPE_OK;
+#else
+if (!flag)
+    return SCPE_OK;
+return sim_messagef (SCPE_NOFNC, "Batch console I/O is not available on this host\n");
+#endif
+}
+
+t_stat sim_show_cons_batch (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, CONST char *cptr)
+{
+if (cptr && (*cptr != 0))
+    return SCPE_2MARG;
+if (sim_con_batch)
+    fprintf (st, "Console I/O is batched through reader and writer threads\n");
+else
+    fprintf (st, "Console I/O is direct\n");
+return SCPE_OK;
+}
+
+/* Console output to the sim> session's stdout, by way of the writer
+   thread in batch mode */
+
+t_stat _sim_con_putchar (int32 out)
+{
+#if defined (CON_BATCH)
+if (sim_con_batch)
+    return _sim_con_batch_putc (out);
+#endif
+return _sim_os_putchar (out);
+}
+
+/* Poll for character
+
+   While recording an input journal, what a poll returns to the running
+   simulator is journaled; while replaying one, live input is discarded
+   (other than the WRU character) and the journaled results are returned
+   instead.
+*/
+
+static t_stat _sim_poll_kbd (void);
 
 t_stat sim_poll_kbd (void)
 {
+t_stat c = _sim_poll_kbd ();
+uint8 data[4];
+size_t len = sizeof (data);
+
+if ((sim_jrn_mode == SIM_JRN_OFF) || !sim_is_running)
+    return c;
+if (sim_jrn_mode == SIM_JRN_RECORD) {
+    if ((c != SCPE_OK) && (c != SCPE_STOP)) {
+        data[0] = c & 0xFF;
+        data[1] = (c >> 8) & 0xFF;
+        data[2] = (c >> 16) & 0xFF;
+        data[3] = (c >> 24) & 0xFF;
+        sim_jrn_put (SIM_JRN_KBD, "CON", data, sizeof (data));
+        }
+    return c;
+    }
+if (c == SCPE_STOP)
+    return c;
+if (sim_jrn_get (SIM_JRN_KBD, "CON", data, &len) && (len == sizeof (data)))
+    return (t_stat)(data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32)data[3] << 24));
+return SCPE_OK;
+}
+
+static t_stat _sim_poll_kbd (void)
+{
 t_stat c;
 
 sim_last_poll_kbd_time = sim_os_msec ();                    /* record when this poll happened */
@@ -3027,6 +3316,11 @@ if (!sim_rem_master_mode) {
     if ((sim_con_ldsc.rxbps) &&                             /* rate limiting && */
         (sim_gtime () < sim_con_ldsc.rxnexttime))           /* too soon? */
         return SCPE_OK;                                     /* not yet */
+#if defined (CON_BATCH)
+    if (sim_con_batch)
+        c = _sim_con_batch_getc ();                         /* get queued character */
+    else
+#endif
     if (sim_ttisatty ())
         c = sim_os_poll_kbd ();                             /* get character */
     else
@@ -3065,6 +3359,8 @@ return SCPE_OK;
 
 t_stat sim_putchar (int32 c)
 {
+if (sim_jrn_quiet)                                      /* replaying quietly? */
+    return SCPE_OK;
 if (!sim_con_ldsc.console      &&                       /* Non Console */
     !sim_con_ldsc.serport      &&                       /* no serial connection */
     ((sim_con_tmxr.master != 0) &&                      /* Telnet but not connected */
@@ -3087,6 +3383,8 @@ t_stat sim_putchar_s (int32 c)
 {
 t_stat r;
 
+if (sim_jrn_quiet)                                      /* replaying quietly? */
+    return SCPE_OK;
 if (!sim_con_ldsc.console      &&                       /* Non Console */
     !sim_con_ldsc.serport      &&                       /* no serial connection */
     ((sim_con_tmxr.master != 0) &&                      /* Telnet but not connected */
@@ -3287,19 +3585,35 @@ t_stat sim_ttrun (void)
 {
 if (!sim_con_tmxr.ldsc->uptr)                           /* If simulator didn't declare its input polling unit */
     sim_con_unit.dynflags &= ~UNIT_TM_POLL;             /* we can't poll asynchronously */
+if (sim_con_batch)                                      /* batch? */
+    fflush (stdout);                                    /* command output first */
+#if defined (CON_BATCH)
+if (sim_con_batch)
+    _sim_con_batch_reader (TRUE);                       /* stdin now feeds the console */
+#endif
 return sim_os_ttrun ();
 }
 
 t_stat sim_ttcmd (void)
 {
+#if defined (CON_BATCH)
+if (sim_con_batch) {                                    /* batch? */
+    _sim_con_batch_reader (FALSE);                      /* stdin back to the command reader */
+    _sim_con_batch_wait (0);                            /* console output first */
+    }
+#endif
 return sim_os_ttcmd ();
 }
 
 t_stat sim_ttclose (void)
 {
-t_stat r1 = tmxr_shutdown ();
-t_stat r2 = sim_os_ttclose ();
+t_stat r1, r2;
 
+#if defined (CON_BATCH)
+_sim_con_batch_end ();
+#endif
+r1 = tmxr_shutdown ();
+r2 = sim_os_ttclose ();
 if (r1 != SCPE_OK)
     return r1;
 return r2;
@@ -340,6 +340,12 @@ typedef uint32          t_addr;
 #define SIM_BKPT_N_SPC  (1 << (32 - SIM_BKPT_V_SPC))    /* max number spaces */
 #define SIM_BKPT_V_SPC  (BRK_TYP_MAX + 1)               /* location in arg */
 
+/* Breakpoint page map definitions */
+
+#define SIM_BRK_V_PAGE  9                               /* log2 addresses per page */
+#define SIM_BRK_N_PAGE  (1 << 16)                       /* pages in map (folded) */
+#define SIM_BRK_PAGE(a) ((uint32)((a) >> SIM_BRK_V_PAGE) & (SIM_BRK_N_PAGE - 1))
+
 /* Extended switch definitions (bits >= 26) */
 
 #define SIM_SW_HIDE     (1u << 26)                      /* enable hiding */
@@ -410,8 +416,9 @@ typedef uint32          t_addr;
 #define SCPE_RUNTIME    (SCPE_BASE + 50)                /* Run Time Limit Exhausted */
 #define SCPE_INCOMPDSK  (SCPE_BASE + 51)                /* Incompatible Disk Container */
 #define SCPE_AMBASSIGN  (SCPE_BASE + 52)                /* ambiguous logical name */
+#define SCPE_CHECKPOINT (SCPE_BASE + 53)                /* journal checkpoint due */
 
-#define SCPE_MAX_ERR    (SCPE_BASE + 52)                /* Maximum SCPE Error Value */
+#define SCPE_MAX_ERR    (SCPE_BASE + 53)                /* Maximum SCPE Error Value */
 #define SCPE_KFLAG      0x10000000                      /* tti data flag */
 #define SCPE_BREAK      0x20000000                      /* tti break flag */
 #define SCPE_NOMESSAGE  0x40000000                      /* message display suppression flag */
@@ -399,6 +399,7 @@
 
 /* Internal routine - forward declaration */
 static int _eth_get_system_id (char *buf, size_t buf_size);
+static t_stat eth_show_statistics (FILE *st);
 static void eth_get_nic_hw_addr(ETH_DEV* dev, const char *devname, int set_on, char Info[ETH_DEV_INFO_MAX]);
 
 static const unsigned char framer_oui[3] = { 0xaa, 0x00, 0x03 };
@@ -795,6 +796,14 @@ ethq_insert_data(que, type, pack->oversize ? pack->oversize : pack->msg, pack->u
 
 t_stat eth_show_devices (FILE* st, DEVICE *dptr, UNIT* uptr, int32 val, CONST char *desc)
 {
+if ((desc != NULL) && (*desc != '\0')) {
+  char gbuf[CBUFSIZE];
+
+  get_glyph (desc, gbuf, 0);
+  if (MATCH_CMD (gbuf, "STATISTICS") == 0)
+    return eth_show_statistics (st);
+  return sim_messagef (SCPE_ARG, "Unknown SHOW ETHERNET option: %s\n", gbuf);
+  }
 return eth_show (st, uptr, val, NULL);
 }
 
@@ -1121,6 +1130,11 @@ t_stat eth_show (FILE* st, UNIT* uptr, int32 val, CONST void* desc)
   }
 static int _eth_get_system_id (char *buf, size_t buf_size)
   {memset (buf, 0, buf_size); return 0;}
+static t_stat eth_show_statistics (FILE *st)
+  {
+  fprintf(st, "  network support not available in simulator\n");
+  return SCPE_OK;
+  }
 t_stat sim_ether_test (DEVICE *dptr, const char *cptr)
   {return SCPE_OK;}
 #else    /* endif unimplemented */
@@ -1392,6 +1406,654 @@ static t_bool eth_vde_network_available = FALSE;
 #include "sim_slirp.h"
 #endif /* HAVE_SLIRP_NETWORK */
 
+#if defined(HAVE_VSWITCH_NETWORK)
+/*
+  Shared memory virtual switch (vswitch:name)
+
+  All simulators attached to the same vswitch name map a common POSIX
+  shared memory object (/simh-vswitch-name).  It contains one receive ring
+  per port and a MAC address table which is learned from the source
+  address of transmitted frames.  Forwarding is done by the sender: a
+  frame is copied directly into the receive ring of the port which owns
+  the destination address, or into every other active port's ring for
+  broadcast, multicast and not yet learned destinations.  A frame which
+  finds a full receive ring is dropped and counted against that port.
+
+  No host networking facilities are involved and no privileges are
+  required, but all participants must run as the same user.  The shared
+  object is removed when the last port on the switch is closed.
+*/
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#define VSW_MAGIC       0x31575356                      /* "VSW1" */
+#define VSW_PORTS       32                              /* ports per switch */
+#define VSW_RING        64                              /* frames per port receive ring */
+#define VSW_MACS        256                             /* MAC address table entries */
+/* PTHREAD_MUTEX_ROBUST is an enum constant in glibc, not a macro, so test
+   for the POSIX.1-2008 robust mutex feature itself */
+#if defined(EOWNERDEAD) && (defined(__linux__) || (defined(_POSIX_THREADS) && (_POSIX_THREADS >= 200809L)))
+#define VSW_ROBUST      1                               /* survive a port dying with the lock held */
+#endif
+
+typedef struct {
+    uint32          len;                                /* frame length */
+    uint8           msg[ETH_MAX_PACKET];                /* frame data */
+    } VSW_FRAME;
+
+typedef struct {
+    uint32          in_use;                             /* port is attached */
+    pid_t           pid;                                /* owning process */
+    pthread_cond_t  rx_cond;                            /* signalled when a frame is queued */
+    uint32          head;                               /* next frame to receive */
+    uint32          tail;                               /* next free ring slot */
+    uint32          tx_packets;                         /* frames sent by port */
+    uint32          rx_packets;                         /* frames queued to port */
+    uint32          rx_dropped;                         /* frames dropped (ring full) */
+    VSW_FRAME       ring[VSW_RING];                     /* receive ring */
+    } VSW_PORT;
+
+typedef struct {
+    ETH_MAC         mac;                                /* learned address */
+    int32           port;                               /* owning port, -1 if free */
+    uint32          stamp;                              /* last use */
+    } VSW_MAC;
+
+typedef struct {
+    uint32          magic;                              /* VSW_MAGIC when initialized */
+    uint32          retired;                            /* last port closed, object unlinked */
+    pthread_mutex_t lock;                               /* guards everything below */
+    uint32          stamp;                              /* MAC table use counter */
+    VSW_MAC         macs[VSW_MACS];                     /* MAC address table */
+    VSW_PORT        ports[VSW_PORTS];                   /* switch ports */
+    } VSW_SHARED;
+
+typedef struct {
+    VSW_SHARED      *sw;                                /* mapped switch */
+    int             port;                               /* our port number */
+    char            name[CBUFSIZE];                     /* switch name */
+    char            shm_name[CBUFSIZE];                 /* shared memory object name */
+    } VSW_HANDLE;
+
+static void _vsw_lock (VSW_SHARED *sw)
+{
+#if defined(VSW_ROBUST)
+if (pthread_mutex_lock (&sw->lock) == EOWNERDEAD)       /* holder died? */
+    pthread_mutex_consistent (&sw->lock);               /* state is still usable */
+#else
+pthread_mutex_lock (&sw->lock);
+#endif
+}
+
+static void _vsw_unlock (VSW_SHARED *sw)
+{
+pthread_mutex_unlock (&sw->lock);
+}
+
+/* Free a port and forget the addresses learned on it; called with the lock held */
+
+static void _vsw_free_port (VSW_SHARED *sw, int port)
+{
+int i;
+
+sw->ports[port].in_use = 0;
+for (i = 0; i < VSW_MACS; i++)
+    if (sw->macs[i].port == port)
+        sw->macs[i].port = -1;
+}
+
+static void _vsw_init (VSW_SHARED *sw)
+{
+pthread_mutexattr_t mattr;
+pthread_condattr_t cattr;
+int i;
+
+pthread_mutexattr_init (&mattr);
+pthread_mutexattr_setpshared (&mattr, PTHREAD_PROCESS_SHARED);
+#if defined(VSW_ROBUST)
+pthread_mutexattr_setrobust (&mattr, PTHREAD_MUTEX_ROBUST);
+#endif
+pthread_mutex_init (&sw->lock, &mattr);
+pthread_mutexattr_destroy (&mattr);
+pthread_condattr_init (&cattr);
+pthread_condattr_setpshared (&cattr, PTHREAD_PROCESS_SHARED);
+for (i = 0; i < VSW_PORTS; i++)
+    pthread_cond_init (&sw->ports[i].rx_cond, &cattr);
+pthread_condattr_destroy (&cattr);
+for (i = 0; i < VSW_MACS; i++)
+    sw->macs[i].port = -1;
+__sync_synchronize ();
+sw->magic = VSW_MAGIC;
+}
+
+static t_stat _vsw_open (const char *name, void **handle, char *errbuf, size_t errbuf_size)
+{
+VSW_HANDLE *vsw;
+VSW_SHARED *sw;
+int fd, i, tries;
+t_bool created;
+struct stat st;
+
+if ((*name == '\0') || (strchr (name, '/') != NULL)) {
+    snprintf (errbuf, errbuf_size, "Must specify a vswitch name (i.e. vswitch:lan0)");
+    return SCPE_OPENERR;
+    }
+vsw = (VSW_HANDLE *)calloc (1, sizeof (*vsw));
+if (vsw == NULL) {
+    snprintf (errbuf, errbuf_size, "%s", strerror (errno));
+    return SCPE_MEM;
+    }
+strlcpy (vsw->name, name, sizeof (vsw->name));
+snprintf (vsw->shm_name, sizeof (vsw->shm_name), "/simh-vswitch-%s", name);
+for (tries = 0; ; tries++) {
+    created = TRUE;
+    fd = shm_open (vsw->shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if ((fd < 0) && (errno == EEXIST)) {
+        created = FALSE;
+        fd = shm_open (vsw->shm_name, O_RDWR, 0600);
+        }
+    if (fd < 0) {
+        if ((errno == ENOENT) && (tries < 10))          /* removed by a closing port? */
+            continue;
+        snprintf (errbuf, errbuf_size, "Can't open vswitch %s: %s", name, strerror (errno));
+        free (vsw);
+        return SCPE_OPENERR;
+        }
+    if (created && (ftruncate (fd, sizeof (VSW_SHARED)) != 0)) {
+        snprintf (errbuf, errbuf_size, "Can't size vswitch %s: %s", name, strerror (errno));
+        close (fd);
+        shm_unlink (vsw->shm_name);
+        free (vsw);
+        return SCPE_OPENERR;
+        }
+    for (i = 0; (i < 100) && !created; i++) {           /* wait for creator to size it */
+        if ((fstat (fd, &st) == 0) && (st.st_size >= (off_t)sizeof (VSW_SHARED)))
+            break;
+        sim_os_ms_sleep (10);
+        }
+    sw = (VSW_SHARED *)mmap (NULL, sizeof (VSW_SHARED), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close (fd);
+    if (sw == MAP_FAILED) {
+        snprintf (errbuf, errbuf_size, "Can't map vswitch %s: %s", name, strerror (errno));
+        free (vsw);
+        return SCPE_OPENERR;
+        }
+    if (created)
+        _vsw_init (sw);
+    for (i = 0; (i < 100) && (sw->magic != VSW_MAGIC); i++)
+        sim_os_ms_sleep (10);
+    if (sw->magic != VSW_MAGIC) {
+        snprintf (errbuf, errbuf_size, "vswitch %s is not initialized", name);
+        munmap (sw, sizeof (VSW_SHARED));
+        free (vsw);
+        return SCPE_OPENERR;
+        }
+    _vsw_lock (sw);
+    if (!sw->retired)
+        break;
+    _vsw_unlock (sw);                                   /* raced with the last close */
+    munmap (sw, sizeof (VSW_SHARED));
+    }
+for (i = 0; i < VSW_PORTS; i++)                         /* reclaim ports of dead processes */
+    if (sw->ports[i].in_use && (kill (sw->ports[i].pid, 0) != 0) && (errno == ESRCH))
+        _vsw_free_port (sw, i);
+for (i = 0; (i < VSW_PORTS) && sw->ports[i].in_use; i++)
+    ;
+if (i == VSW_PORTS) {
+    _vsw_unlock (sw);
+    munmap (sw, sizeof (VSW_SHARED));
+    snprintf (errbuf, errbuf_size, "vswitch %s has no free ports", name);
+    free (vsw);
+    return SCPE_OPENERR;
+    }
+sw->ports[i].in_use = 1;
+sw->ports[i].pid = getpid ();
+sw->ports[i].head = sw->ports[i].tail = 0;
+sw->ports[i].tx_packets = sw->ports[i].rx_packets = sw->ports[i].rx_dropped = 0;
+_vsw_unlock (sw);
+vsw->sw = sw;
+vsw->port = i;
+*handle = (void *)vsw;
+return SCPE_OK;
+}
+
+static void _vsw_close (VSW_HANDLE *vsw)
+{
+VSW_SHARED *sw = vsw->sw;
+int i;
+
+_vsw_lock (sw);
+_vsw_free_port (sw, vsw->port);
+for (i = 0; (i < VSW_PORTS) && !sw->ports[i].in_use; i++)
+    ;
+if (i == VSW_PORTS) {                                   /* last one out? */
+    sw->retired = 1;
+    shm_unlink (vsw->shm_name);
+    }
+_vsw_unlock (sw);
+munmap (sw, sizeof (VSW_SHARED));
+free (vsw);
+}
+
+/* Queue a frame on a port's receive ring; called with the lock held */
+
+static void _vsw_deliver (VSW_SHARED *sw, int port, const uint8 *msg, size_t len)
+{
+VSW_PORT *p = &sw->ports[port];
+VSW_FRAME *f;
+
+if ((p->tail - p->head) >= VSW_RING) {
+    ++p->rx_dropped;
+    return;
+    }
+f = &p->ring[p->tail % VSW_RING];
+f->len = (uint32)len;
+memcpy (f->msg, msg, len);
+++p->tail;
+++p->rx_packets;
+pthread_cond_signal (&p->rx_cond);
+}
+
+static int _vsw_send (VSW_HANDLE *vsw, const uint8 *msg, size_t len)
+{
+VSW_SHARED *sw = vsw->sw;
+VSW_MAC *m, *victim = NULL;
+int i, dst = -1;
+
+_vsw_lock (sw);
+++sw->ports[vsw->port].tx_packets;
+++sw->stamp;
+if (!(msg[6] & 1)) {                                    /* learn unicast source address */
+    for (i = 0; i < VSW_MACS; i++) {
+        m = &sw->macs[i];
+        if ((m->port >= 0) && (memcmp (m->mac, &msg[6], sizeof (ETH_MAC)) == 0))
+            break;
+        if ((victim == NULL) || (m->port < 0) ||
+            ((victim->port >= 0) && ((sw->stamp - m->stamp) > (sw->stamp - victim->stamp))))
+            victim = m;
+        }
+    m = (i < VSW_MACS) ? &sw->macs[i] : victim;
+    memcpy (m->mac, &msg[6], sizeof (ETH_MAC));
+    m->port = vsw->port;
+    m->stamp = sw->stamp;
+    }
+if (!(msg[0] & 1)) {                                    /* look up unicast destination */
+    for (i = 0; i < VSW_MACS; i++) {
+        m = &sw->macs[i];
+        if ((m->port >= 0) && (memcmp (m->mac, msg, sizeof (ETH_MAC)) == 0)) {
+            dst = m->port;
+            m->stamp = sw->stamp;
+            break;
+            }
+        }
+    }
+if (dst >= 0) {
+    if (dst != vsw->port)
+        _vsw_deliver (sw, dst, msg, len);
+    }
+else {                                                  /* flood */
+    for (i = 0; i < VSW_PORTS; i++)
+        if ((i != vsw->port) && sw->ports[i].in_use)
+            _vsw_deliver (sw, i, msg, len);
+    }
+_vsw_unlock (sw);
+return 0;
+}
+
+/* Wait up to 250ms for a frame, returns its length or 0 */
+
+static int _vsw_recv (VSW_HANDLE *vsw, uint8 *buf, size_t size)
+{
+VSW_SHARED *sw = vsw->sw;
+VSW_PORT *p = &sw->ports[vsw->port];
+VSW_FRAME *f;
+struct timespec deadline;
+int len = 0;
+
+clock_gettime (CLOCK_REALTIME, &deadline);
+deadline.tv_nsec += 250*1000*1000;
+if (deadline.tv_nsec >= 1000*1000*1000) {
+    deadline.tv_nsec -= 1000*1000*1000;
+    ++deadline.tv_sec;
+    }
+_vsw_lock (sw);
+if (p->head == p->tail) {
+#if defined(VSW_ROBUST)
+    if (pthread_cond_timedwait (&p->rx_cond, &sw->lock, &deadline) == EOWNERDEAD)
+        pthread_mutex_consistent (&sw->lock);           /* holder died while we waited */
+#else
+    pthread_cond_timedwait (&p->rx_cond, &sw->lock, &deadline);
+#endif
+    }
+if (p->head != p->tail) {
+    f = &p->ring[p->head % VSW_RING];
+    len = (int)((f->len < size) ? f->len : size);
+    memcpy (buf, f->msg, len);
+    ++p->head;
+    }
+_vsw_unlock (sw);
+return len;
+}
+
+static void _vsw_show (VSW_HANDLE *vsw, FILE *st)
+{
+VSW_SHARED *sw = vsw->sw;
+int i;
+
+fprintf (st, "  VSwitch:                 %s, port %d\n", vsw->name, vsw->port);
+fprintf (st, "  VSwitch Port   PID        Sent   Received    Dropped\n");
+_vsw_lock (sw);
+for (i = 0; i < VSW_PORTS; i++) {
+    VSW_PORT *p = &sw->ports[i];
+
+    if (p->in_use)
+        fprintf (st, "          %c%3d %6d %10u %10u %10u\n", (i == vsw->port) ? '*' : ' ', i, (int)p->pid,
+                 p->tx_packets, p->rx_packets, p->rx_dropped);
+    }
+_vsw_unlock (sw);
+}
+#endif /* HAVE_VSWITCH_NETWORK */
+
+#if defined (USE_READER_THREAD)
+/* Host wall clock time in seconds, for pacing and latency measurements */
+
+static double _eth_host_time (void)
+{
+struct timespec now;
+
+clock_gettime (CLOCK_REALTIME, &now);
+return now.tv_sec + now.tv_nsec / 1.0e9;
+}
+#endif
+
+#if defined(HAVE_PCAPFILE_NETWORK)
+/*
+  Packet capture file replay (pcapfile:in.pcap,out.pcap{,rate=n})
+
+  Frames from the input capture file are handed to the simulated device
+  as if they had arrived from a LAN, and every frame the device transmits
+  is appended, with a host timestamp, to the output capture file.  Either
+  file name may be omitted.  Replay starts when the device first sets a
+  receive address filter.  By default frames are replayed with the
+  spacing recorded in the input capture; rate=n replays n frames per
+  second and rate=0 replays as fast as the reader thread can deliver.
+  Both files use the classic libpcap format (not pcapng), so the capture
+  can be produced and examined with tcpdump or wireshark.  Combined with
+  SHOW ETHERNET STATISTICS this allows measuring a device's receive
+  throughput, queue losses and queueing latency without a live network.
+*/
+
+#define PCAPFILE_MAGIC_USEC     0xA1B2C3D4              /* classic, microsecond timestamps */
+#define PCAPFILE_MAGIC_NSEC     0xA1B23C4D              /* classic, nanosecond timestamps */
+
+typedef struct {
+    uint32          magic;
+    uint16          version_major;
+    uint16          version_minor;
+    int32           thiszone;
+    uint32          sigfigs;
+    uint32          snaplen;
+    uint32          network;
+    } PCAPFILE_HDR;
+
+typedef struct {
+    uint32          ts_sec;
+    uint32          ts_frac;                            /* usec or nsec */
+    uint32          incl_len;
+    uint32          orig_len;
+    } PCAPFILE_REC;
+
+typedef struct {
+    FILE            *in;                                /* replay capture, NULL if none */
+    FILE            *out;                               /* transmit capture, NULL if none */
+    t_bool          swapped;                            /* input byte order differs from ours */
+    t_bool          nsec;                               /* input has nanosecond timestamps */
+    double          rate;                               /* frames/sec, 0 unpaced, <0 capture timing */
+    double          start;                              /* host time of first replayed frame */
+    double          first;                              /* capture time of first frame */
+    double          last;                               /* host time of last replayed frame */
+    volatile t_bool armed;                              /* device has set a receive filter */
+    t_bool          done;                               /* input exhausted */
+    t_bool          damaged;                            /* input ended with a bad record */
+    uint32          replayed;                           /* frames replayed */
+    uint32          recorded;                           /* frames recorded */
+    pthread_mutex_t lock;                               /* serializes output */
+    } PCAPFILE_HANDLE;
+
+static uint32 _pcapfile_swap (uint32 val)
+{
+return ((val & 0xFF) << 24) | ((val & 0xFF00) << 8) | ((val >> 8) & 0xFF00) | ((val >> 24) & 0xFF);
+}
+
+static void _pcapfile_free (PCAPFILE_HANDLE *pf)
+{
+if (pf->in)
+    fclose (pf->in);
+if (pf->out)
+    fclose (pf->out);
+pthread_mutex_destroy (&pf->lock);
+free (pf);
+}
+
+static t_stat _pcapfile_open (const char *spec, void **handle, char *errbuf, size_t errbuf_size)
+{
+PCAPFILE_HANDLE *pf;
+char in_name[CBUFSIZE] = "", out_name[CBUFSIZE] = "", gbuf[CBUFSIZE];
+const char *cptr = spec;
+int field;
+PCAPFILE_HDR hdr;
+
+pf = (PCAPFILE_HANDLE *)calloc (1, sizeof (*pf));
+if (pf == NULL) {
+    snprintf (errbuf, errbuf_size, "%s", strerror (errno));
+    return SCPE_MEM;
+    }
+pthread_mutex_init (&pf->lock, NULL);
+pf->rate = -1.0;
+for (field = 0; *cptr; field++) {
+    cptr = get_glyph_nc (cptr, gbuf, ',');
+    if (0 == sim_strncasecmp (gbuf, "RATE=", 5)) {
+        char *eptr;
+
+        pf->rate = strtod (gbuf + 5, &eptr);
+        if ((*eptr != '\0') || (pf->rate < 0.0)) {
+            snprintf (errbuf, errbuf_size, "Invalid replay rate: %s", gbuf + 5);
+            _pcapfile_free (pf);
+            return SCPE_OPENERR;
+            }
+        }
+    else {
+        if (field == 0)
+            strlcpy (in_name, gbuf, sizeof (in_name));
+        else
+            if (field == 1)
+                strlcpy (out_name, gbuf, sizeof (out_name));
+            else {
+                snprintf (errbuf, errbuf_size, "Unexpected pcapfile parameter: %s", gbuf);
+                _pcapfile_free (pf);
+                return SCPE_OPENERR;
+                }
+        }
+    }
+if ((in_name[0] == '\0') && (out_name[0] == '\0')) {
+    snprintf (errbuf, errbuf_size, "Must specify a capture file (i.e. pcapfile:in.pcap,out.pcap)");
+    _pcapfile_free (pf);
+    return SCPE_OPENERR;
+    }
+if (in_name[0]) {
+    pf->in = sim_fopen (in_name, "rb");
+    if ((pf->in == NULL) ||
+        (1 != fread (&hdr, sizeof (hdr), 1, pf->in))) {
+        snprintf (errbuf, errbuf_size, "Can't read capture file %s: %s", in_name, strerror (errno));
+        _pcapfile_free (pf);
+        return SCPE_OPENERR;
+        }
+    pf->swapped = ((_pcapfile_swap (hdr.magic) == PCAPFILE_MAGIC_USEC) ||
+                   (_pcapfile_swap (hdr.magic) == PCAPFILE_MAGIC_NSEC));
+    if (pf->swapped) {
+        hdr.magic = _pcapfile_swap (hdr.magic);
+        hdr.network = _pcapfile_swap (hdr.network);
+        }
+    pf->nsec = (hdr.magic == PCAPFILE_MAGIC_NSEC);
+    if ((hdr.magic != PCAPFILE_MAGIC_USEC) && (hdr.magic != PCAPFILE_MAGIC_NSEC)) {
+        snprintf (errbuf, errbuf_size, "%s is not a libpcap capture file (pcapng is not supported)", in_name);
+        _pcapfile_free (pf);
+        return SCPE_OPENERR;
+        }
+    if (hdr.network != DLT_EN10MB) {
+        snprintf (errbuf, errbuf_size, "%s does not contain Ethernet frames", in_name);
+        _pcapfile_free (pf);
+        return SCPE_OPENERR;
+        }
+    }
+if (out_name[0]) {
+    pf->out = sim_fopen (out_name, "wb");
+    if (pf->out == NULL) {
+        snprintf (errbuf, errbuf_size, "Can't create capture file %s: %s", out_name, strerror (errno));
+        _pcapfile_free (pf);
+        return SCPE_OPENERR;
+        }
+    memset (&hdr, 0, sizeof (hdr));
+    hdr.magic = PCAPFILE_MAGIC_USEC;
+    hdr.version_major = 2;
+    hdr.version_minor = 4;
+    hdr.snaplen = ETH_MAX_JUMBO_FRAME;
+    hdr.network = DLT_EN10MB;
+    fwrite (&hdr, sizeof (hdr), 1, pf->out);
+    }
+pf->done = (pf->in == NULL);
+*handle = (void *)pf;
+return SCPE_OK;
+}
+
+static void _pcapfile_close (PCAPFILE_HANDLE *pf)
+{
+_pcapfile_free (pf);
+}
+
+/* Address conflict checks set their own filter and drain the read queue,
+   so replay is held off while one is in progress */
+
+static t_bool _pcapfile_hold (ETH_DEV *dev)
+{
+PCAPFILE_HANDLE *pf = (PCAPFILE_HANDLE *)dev->handle;
+t_bool armed;
+
+if (dev->eth_api != ETH_API_PCAPFILE)
+    return FALSE;
+armed = pf->armed;
+pf->armed = FALSE;
+return armed;
+}
+
+static void _pcapfile_release (ETH_DEV *dev, t_bool armed)
+{
+if (dev->eth_api == ETH_API_PCAPFILE)
+    ((PCAPFILE_HANDLE *)dev->handle)->armed = armed;
+}
+
+/* Deliver the next frame from the input capture once it is due.
+   Waits at most 250ms, returns the frame length or 0 if none is due yet
+   or the input is exhausted */
+
+static int _pcapfile_replay (PCAPFILE_HANDLE *pf, uint8 *buf, size_t size)
+{
+PCAPFILE_REC rec;
+double now, due, when;
+long pos;
+
+if (pf->done) {
+    sim_os_ms_sleep (250);
+    return 0;
+    }
+if (!pf->armed) {
+    sim_os_ms_sleep (10);
+    return 0;
+    }
+pos = ftell (pf->in);
+if (1 != fread (&rec, sizeof (rec), 1, pf->in)) {
+    pf->done = TRUE;
+    return 0;
+    }
+if (pf->swapped) {
+    rec.ts_sec = _pcapfile_swap (rec.ts_sec);
+    rec.ts_frac = _pcapfile_swap (rec.ts_frac);
+    rec.incl_len = _pcapfile_swap (rec.incl_len);
+    }
+when = rec.ts_sec + rec.ts_frac / (pf->nsec ? 1.0e9 : 1.0e6);
+now = _eth_host_time ();
+if (pf->replayed == 0) {
+    pf->start = now;
+    pf->first = when;
+    }
+if (pf->rate > 0.0)
+    due = pf->start + pf->replayed / pf->rate;
+else
+    due = (pf->rate < 0.0) ? pf->start + (when - pf->first) : now;
+if (due > now + 0.25) {                                 /* not yet? */
+    fseek (pf->in, pos, SEEK_SET);                      /* retry this record later */
+    sim_os_ms_sleep (250);
+    return 0;
+    }
+if (due > now)
+    sim_os_ms_sleep ((unsigned int)((due - now) * 1000.0));
+if ((rec.incl_len > size) ||
+    (rec.incl_len != fread (buf, 1, rec.incl_len, pf->in))) {
+    pf->done = pf->damaged = TRUE;
+    return 0;
+    }
+++pf->replayed;
+pf->last = _eth_host_time ();
+return (int)rec.incl_len;
+}
+
+static int _pcapfile_record (PCAPFILE_HANDLE *pf, const uint8 *msg, size_t len)
+{
+PCAPFILE_REC rec;
+double now;
+int status = 0;
+
+if (pf->out == NULL)                                    /* transmit goes nowhere */
+    return 0;
+now = _eth_host_time ();
+rec.ts_sec = (uint32)now;
+rec.ts_frac = (uint32)((now - rec.ts_sec) * 1.0e6);
+rec.incl_len = rec.orig_len = (uint32)len;
+pthread_mutex_lock (&pf->lock);
+if ((1 != fwrite (&rec, sizeof (rec), 1, pf->out)) ||
+    (len != fwrite (msg, 1, len, pf->out)))
+    status = -1;
+else
+    ++pf->recorded;
+pthread_mutex_unlock (&pf->lock);
+return status;
+}
+
+static void _pcapfile_show (PCAPFILE_HANDLE *pf, FILE *st)
+{
+double elapsed = pf->last - pf->start;
+
+if (pf->in) {
+    fprintf (st, "  Frames Replayed:         %u%s\n", pf->replayed, pf->damaged ? " (damaged capture file)" : (pf->done ? " (done)" : ""));
+    if (pf->rate > 0.0)
+        fprintf (st, "  Replay Rate:             %.0f frames/sec\n", pf->rate);
+    else
+        fprintf (st, "  Replay Rate:             %s\n", (pf->rate < 0.0) ? "capture timing" : "unpaced");
+    if ((pf->replayed > 1) && (elapsed > 0.0))
+        fprintf (st, "  Achieved Replay Rate:    %.0f frames/sec\n", (pf->replayed - 1) / elapsed);
+    }
+if (pf->out) {
+    pthread_mutex_lock (&pf->lock);
+    fflush (pf->out);
+    pthread_mutex_unlock (&pf->lock);
+    fprintf (st, "  Frames Recorded:         %u\n", pf->recorded);
+    }
+}
+#endif /* HAVE_PCAPFILE_NETWORK */
+
 /* Allows windows to look up user-defined adapter names */
 #if defined(_WIN32)
 #include <winreg.h>
@@ -1433,6 +2095,12 @@ const char *eth_capabilities(void)
  strlcat (capabilities, ":NAT", sizeof (capabilities));
 #endif
  strlcat (capabilities, ":UDP", sizeof (capabilities));
+#if defined (HAVE_VSWITCH_NETWORK)
+ strlcat (capabilities, ":VSWITCH", sizeof (capabilities));
+#endif
+#if defined (HAVE_PCAPFILE_NETWORK)
+ strlcat (capabilities, ":PCAPFILE", sizeof (capabilities));
+#endif
  return capabilities;
  }
 
@@ -1574,6 +2242,23 @@ if (used < max) {
   ++used;
   }
 
+#ifdef HAVE_VSWITCH_NETWORK
+if (used < max) {
+  sprintf(list[used].name, "%s", "vswitch:name");
+  sprintf(list[used].desc, "%s", "Integrated shared memory virtual switch");
+  list[used].eth_api = ETH_API_VSWITCH;
+  ++used;
+  }
+#endif
+#ifdef HAVE_PCAPFILE_NETWORK
+if (used < max) {
+  sprintf(list[used].name, "%s", "pcapfile:in.pcap,out.pcap{,rate=n}");
+  sprintf(list[used].desc, "%s", "Integrated capture file replay");
+  list[used].eth_api = ETH_API_PCAPFILE;
+  ++used;
+  }
+#endif
+
 /* return device count */
 return used;
 }
@@ -2553,6 +3238,10 @@ switch (dev->eth_api) {
     do_select = 1;
     select_fd = dev->fd_handle;
     break;
+  case ETH_API_VSWITCH:                   /* _vsw_recv does its own waiting */
+  case ETH_API_PCAPFILE:                  /* as does _pcapfile_replay */
+    do_select = 0;
+    break;
   }
 
 sim_debug(dev->dbit, dev->dptr, "Reader Thread Starting\n");
@@ -2708,6 +3397,43 @@ while (dev->handle) {
             }
           }
         break;
+#ifdef HAVE_VSWITCH_NETWORK
+      case ETH_API_VSWITCH:
+        if (1) {
+          struct pcap_pkthdr header;
+          int len;
+          u_char buf[ETH_MAX_PACKET];
+
+          VSW_HANDLE *vsw = (VSW_HANDLE *)dev->handle;
+
+          memset(&header, 0, sizeof(header));
+          len = (vsw != NULL) ? _vsw_recv (vsw, buf, sizeof(buf)) : 0;
+          status = (len > 0) ? 1 : 0;
+          if (len > 0) {
+            header.caplen = header.len = len;
+            _eth_callback((u_char *)dev, &header, buf);
+            }
+          }
+        break;
+#endif /* HAVE_VSWITCH_NETWORK */
+#ifdef HAVE_PCAPFILE_NETWORK
+      case ETH_API_PCAPFILE:
+        if (1) {
+          struct pcap_pkthdr header;
+          int len;
+          u_char buf[ETH_MAX_JUMBO_FRAME];
+          PCAPFILE_HANDLE *pf = (PCAPFILE_HANDLE *)dev->handle;
+
+          memset(&header, 0, sizeof(header));
+          len = (pf != NULL) ? _pcapfile_replay (pf, buf, sizeof(buf)) : 0;
+          status = (len > 0) ? 1 : 0;
+          if (len > 0) {
+            header.caplen = header.len = len;
+            _eth_callback((u_char *)dev, &header, buf);
+            }
+          }
+        break;
+#endif /* HAVE_PCAPFILE_NETWORK */
       }
     if ((status > 0) && (dev->asynch_io)) {
       int wakeup_needed;
@@ -2909,6 +3635,43 @@ if (0 == strncmp("udp:", savname, 4)) {
   *handle = (void *)1;  /* Flag used to indicated open */
   return SCPE_OK;
   }
+if (0 == strncmp("vswitch:", savname, 8)) {
+#if defined(HAVE_VSWITCH_NETWORK)
+  const char *swname = savname + 8;
+  t_stat r;
+
+  while (isspace(*swname))
+    ++swname;
+  if (!strcmp(swname, "name")) {
+    snprintf (errbuf, errbuf_size, "Must specify actual vswitch name (i.e. vswitch:lan0)");
+    return SCPE_OPENERR;
+    }
+  r = _vsw_open (swname, handle, errbuf, errbuf_size);
+  if (r == SCPE_OK)
+    *eth_api = ETH_API_VSWITCH;
+  return r;
+#else
+  snprintf (errbuf, errbuf_size, "No support for vswitch: network devices");
+  return SCPE_OPENERR;
+#endif /* defined(HAVE_VSWITCH_NETWORK) */
+  }
+if (0 == strncmp("pcapfile:", savname, 9)) {
+#if defined(HAVE_PCAPFILE_NETWORK)
+  t_stat r;
+
+  if (!strcmp(savname, "pcapfile:in.pcap,out.pcap{,rate=n}")) {
+    snprintf (errbuf, errbuf_size, "Must specify actual capture file names (i.e. pcapfile:in.pcap,out.pcap)");
+    return SCPE_OPENERR;
+    }
+  r = _pcapfile_open (savname + 9, handle, errbuf, errbuf_size);
+  if (r == SCPE_OK)
+    *eth_api = ETH_API_PCAPFILE;
+  return r;
+#else
+  snprintf (errbuf, errbuf_size, "No support for pcapfile: network devices");
+  return SCPE_OPENERR;
+#endif /* defined(HAVE_PCAPFILE_NETWORK) */
+  }
 #if !defined(USE_VMNET_SHARED_AS_NAT)
 if (0 == strncmp("nat:", savname, 4)) {
 #if defined(HAVE_SLIRP_NETWORK)
@@ -3490,6 +4253,16 @@ switch (eth_api) {
   case ETH_API_UDP:
     sim_close_sock(pcap_fd);
     break;
+#ifdef HAVE_VSWITCH_NETWORK
+  case ETH_API_VSWITCH:
+    _vsw_close((VSW_HANDLE *)pcap);
+    break;
+#endif
+#ifdef HAVE_PCAPFILE_NETWORK
+  case ETH_API_PCAPFILE:
+    _pcapfile_close((PCAPFILE_HANDLE *)pcap);
+    break;
+#endif
   }
 return SCPE_OK;
 }
@@ -3660,6 +4433,12 @@ if (eth_device_help_string == NULL) {
 #endif
 #endif /* !defined(HAVE_VMNET_NETWORK) */
         Mprintf (f, "+eth4   udp:sourceport:remotehost:remoteport (Integrated UDP bridge support)\n");
+#if defined(HAVE_VSWITCH_NETWORK)
+        Mprintf (f, "+eth5   vswitch:name                         (Integrated shared memory virtual switch)\n");
+#endif
+#if defined(HAVE_PCAPFILE_NETWORK)
+        Mprintf (f, "+eth6   pcapfile:in.pcap,out.pcap{,rate=n}   (Integrated capture file replay)\n");
+#endif
         Mprintf (f, "+sim> ATTACH %s eth0\n\n", dptr->name);
         Mprintf (f, " or equivalently:\n\n");
         Mprintf (f, "+sim> ATTACH %s en0\n\n", dptr->name);
@@ -3708,6 +4487,9 @@ uint32 i;
 int responses = 0;
 uint32 offset, function;
 char mac_string[32];
+#if defined(HAVE_PCAPFILE_NETWORK)
+t_bool replay_armed;
+#endif
 
 if (reflections)
     *reflections = 0;
@@ -3798,12 +4580,21 @@ memcpy(&send.msg[18], mac, sizeof(ETH_MAC));            /* Forward Destination *
 send.msg[24] = 1;                                       /* Reply */
 send.msg[25] = 0;
 
+#if defined(HAVE_PCAPFILE_NETWORK)
+replay_armed = _pcapfile_hold (dev);
+#endif
 eth_filter(dev, 1, (ETH_MAC *)mac, 0, 0);
+#if defined(HAVE_PCAPFILE_NETWORK)
+_pcapfile_hold (dev);                                   /* eth_filter rearmed it */
+#endif
 
 /* send the packet */
 status = _eth_write (dev, &send, NULL);
 if (status != SCPE_OK) {
   const char *msg;
+#if defined(HAVE_PCAPFILE_NETWORK)
+  _pcapfile_release (dev, replay_armed);
+#endif
   msg = (dev->eth_api == ETH_API_PCAP) ?
       "%s: Eth: Error Transmitting packet: %s\n"
         "You may need to run as root, or install a libpcap version\n"
@@ -3832,6 +4623,9 @@ do {
       (0 == memcmp(send.msg, recv.msg, send.len)))     /* Packet Match (Reflection) */
     responses++;
   } while (recv.len > 0);
+#if defined(HAVE_PCAPFILE_NETWORK)
+_pcapfile_release (dev, replay_armed);
+#endif
 
 sim_debug(dev->dbit, dev->dptr, "Address Conflict = %d\n", responses);
 if (responses && !silent)
@@ -3899,6 +4693,12 @@ switch (dev->eth_api) {
   case ETH_API_VMNET:
       netname = "vmnet";
       break;
+  case ETH_API_VSWITCH:
+      netname = "vswitch";
+      break;
+  case ETH_API_PCAPFILE:
+      netname = "pcapfile";
+      break;
   }
 sprintf(msg, "%s(%s): ", where, netname);
 switch (dev->eth_api) {
@@ -4058,6 +4858,16 @@ if ((packet->len >= ETH_MIN_PACKET) && (packet->len <= ETH_MAX_PACKET)) {
     case ETH_API_UDP:
       status = (((int32)packet->len == sim_write_sock (dev->fd_handle, (char *)packet->msg, (int32)packet->len)) ? 0 : -1);
       break;
+#ifdef HAVE_VSWITCH_NETWORK
+    case ETH_API_VSWITCH:
+      status = _vsw_send((VSW_HANDLE *)dev->handle, packet->msg, (size_t)packet->len);
+      break;
+#endif
+#ifdef HAVE_PCAPFILE_NETWORK
+    case ETH_API_PCAPFILE:
+      status = _pcapfile_record((PCAPFILE_HANDLE *)dev->handle, packet->msg, (size_t)packet->len);
+      break;
+#endif
     }
   ++dev->packets_sent;              /* basic bookkeeping */
   /* On error, correct loopback bookkeeping */
@@ -4094,6 +4904,13 @@ int write_queue_size = 1;
 /* make sure device exists */
 if ((!dev) || (dev->eth_api == ETH_API_NONE)) return SCPE_UNATT;
 
+/* while replaying an input journal, output goes nowhere */
+if (sim_jrn_mode == SIM_JRN_REPLAY) {
+  if (routine)
+    (routine)(0);
+  return SCPE_OK;
+  }
+
 if (packet->len > sizeof (packet->msg)) /* packet oversized? */
     return SCPE_IERR;                   /* that's no good! */
 
@@ -4140,6 +4957,12 @@ if (routine)
   (routine)(dev->write_status);
 return dev->write_status;
 #else
+/* while replaying an input journal, output goes nowhere */
+if ((sim_jrn_mode == SIM_JRN_REPLAY) && dev && (dev->eth_api != ETH_API_NONE)) {
+  if (routine)
+    (routine)(0);
+  return SCPE_OK;
+  }
 return _eth_write(dev, packet, routine);
 #endif
 }
@@ -4679,6 +5502,8 @@ switch (dev->eth_api) {
   case ETH_API_UDP:
   case ETH_API_NAT:
   case ETH_API_VMNET:
+  case ETH_API_VSWITCH:
+  case ETH_API_PCAPFILE:
     bpf_used = 0;
     to_me = 0;
     eth_packet_trace (dev, data, header->len, "received");
@@ -4725,7 +5550,9 @@ if ((LOOPBACK_SELF_FRAME(dev->physical_addr, data)) ||
 #endif
   }
 
-if (bpf_used ? to_me : (to_me && !from_me)) {
+if (!(bpf_used ? to_me : (to_me && !from_me)))
+  ++dev->packets_filtered;
+else {
   if (header->len > ETH_MIN_JUMBO_FRAME) {
     if (header->len <= header->caplen) {/* Whole Frame captured? */
       u_char *datacopy = (u_char *)malloc(header->len);
@@ -4766,6 +5593,7 @@ if (bpf_used ? to_me : (to_me && !from_me)) {
 
     pthread_mutex_lock (&dev->lock);
     ethq_insert_data(&dev->read_queue, ETH_ITM_NORMAL, data, 0, len, crc_len, crc_data, 0);
+    dev->read_queue.item[dev->read_queue.tail].queued = _eth_host_time ();
     ++dev->packets_received;
     pthread_mutex_unlock (&dev->lock);
     free(moved_data);
@@ -4802,8 +5630,58 @@ if (bpf_used ? to_me : (to_me && !from_me)) {
   }
 }
 
+/* Read a packet.  While recording an input journal, packets delivered are
+   journaled; while replaying one, live packets are discarded and the
+   journaled ones are delivered instead. */
+
+static int _eth_read(ETH_DEV* dev, ETH_PACK* packet, ETH_PCALLBACK routine);
+
 int eth_read(ETH_DEV* dev, ETH_PACK* packet, ETH_PCALLBACK routine)
 {
+static ETH_PACK discard;
+static uint8 jrn[8 + ETH_FRAME_SIZE];
+const char *chan;
+size_t len, msglen;
+int status;
+
+if ((sim_jrn_mode == SIM_JRN_OFF) ||
+    (!dev) || (dev->eth_api == ETH_API_NONE) || (!packet))
+  return _eth_read(dev, packet, routine);
+chan = dev->dptr ? sim_dname (dev->dptr) : "ETH";
+if (sim_jrn_mode == SIM_JRN_RECORD) {
+  status = _eth_read(dev, packet, routine);
+  if (status > 0) {
+    msglen = (packet->len > packet->crc_len) ? packet->len : packet->crc_len;
+    if (msglen > sizeof (packet->msg))
+      msglen = sizeof (packet->msg);
+    jrn[0] = packet->len & 0xFF;
+    jrn[1] = (packet->len >> 8) & 0xFF;
+    jrn[2] = (packet->len >> 16) & 0xFF;
+    jrn[3] = (packet->len >> 24) & 0xFF;
+    jrn[4] = packet->crc_len & 0xFF;
+    jrn[5] = (packet->crc_len >> 8) & 0xFF;
+    jrn[6] = (packet->crc_len >> 16) & 0xFF;
+    jrn[7] = (packet->crc_len >> 24) & 0xFF;
+    memcpy (&jrn[8], packet->msg, msglen);
+    sim_jrn_put (SIM_JRN_ETH, chan, jrn, 8 + msglen);
+    }
+  return status;
+  }
+_eth_read(dev, &discard, NULL);                         /* live traffic isn't replayed */
+packet->len = 0;
+len = sizeof (jrn);
+if ((!sim_jrn_get (SIM_JRN_ETH, chan, jrn, &len)) || (len < 8))
+  return 0;
+packet->len = jrn[0] | (jrn[1] << 8) | (jrn[2] << 16) | ((uint32)jrn[3] << 24);
+packet->crc_len = jrn[4] | (jrn[5] << 8) | (jrn[6] << 16) | ((uint32)jrn[7] << 24);
+memcpy (packet->msg, &jrn[8], len - 8);
+if (routine)
+  routine(0);
+return 1;
+}
+
+static int _eth_read(ETH_DEV* dev, ETH_PACK* packet, ETH_PCALLBACK routine)
+{
 int status;
 
 /* make sure device exists */
@@ -4940,10 +5818,16 @@ if (status < 0) {
   pthread_mutex_lock (&dev->lock);
   if (dev->read_queue.count > 0) {
     ETH_ITEM* item = &dev->read_queue.item[dev->read_queue.head];
+    double latency = _eth_host_time () - item->queued;
+
     packet->len = item->packet.len;
     packet->crc_len = item->packet.crc_len;
     memcpy(packet->msg, item->packet.msg, ((packet->len > packet->crc_len) ? packet->len : packet->crc_len));
     status = 1;
+    ++dev->read_latency_count;
+    dev->read_latency_total += latency;
+    if (latency > dev->read_latency_max)
+      dev->read_latency_max = latency;
     ethq_remove(&dev->read_queue);
   }
   pthread_mutex_unlock (&dev->lock);
@@ -5104,6 +5988,12 @@ dev->addr_count = addr_count;
 dev->all_multicast = all_multicast;
 dev->promiscuous   = promiscuous;
 
+#if defined(HAVE_PCAPFILE_NETWORK)
+/* replay starts once the device is prepared to receive something */
+if ((dev->eth_api == ETH_API_PCAPFILE) && (addr_count || all_multicast || promiscuous))
+  ((PCAPFILE_HANDLE *)dev->handle)->armed = TRUE;
+#endif
+
 /* store multicast hash data */
 dev->hash_filter = (hash != NULL);
 if (hash) {
@@ -5253,6 +6143,8 @@ if (dev->transmit_packet_errors)
   fprintf(st, "  Send Packet Errors:      %d\n", dev->transmit_packet_errors);
 if (dev->packets_received)
   fprintf(st, "  Packets Received:        %d\n", dev->packets_received);
+if (dev->packets_filtered)
+  fprintf(st, "  Packets Filtered:        %d\n", dev->packets_filtered);
 if (dev->receive_packet_errors)
   fprintf(st, "  Read Packet Errors:      %d\n", dev->receive_packet_errors);
 if (dev->error_reopen_count)
@@ -5296,6 +6188,51 @@ if (dev->bpf_filter)
 if (dev->eth_api == ETH_API_NAT)
   sim_slirp_show ((SLIRP *)dev->handle, st);
 #endif
+#if defined(HAVE_VSWITCH_NETWORK)
+if (dev->eth_api == ETH_API_VSWITCH)
+  _vsw_show ((VSW_HANDLE *)dev->handle, st);
+#endif
+#if defined(HAVE_PCAPFILE_NETWORK)
+if (dev->eth_api == ETH_API_PCAPFILE)
+  _pcapfile_show ((PCAPFILE_HANDLE *)dev->handle, st);
+#endif
+}
+
+/* SHOW ETHERNET STATISTICS - throughput, loss and latency of open devices */
+
+static t_stat eth_show_statistics (FILE *st)
+{
+int i;
+
+if (eth_open_device_count == 0) {
+  fprintf(st, "No open ETH devices\n");
+  return SCPE_OK;
+  }
+for (i=0; i<eth_open_device_count; i++) {
+  ETH_DEV *dev = eth_open_devices[i];
+
+  fprintf(st, "%s: %s\n", dev->dptr->name, dev->name);
+  fprintf(st, "  Packets Sent:            %u\n", dev->packets_sent);
+  fprintf(st, "  Send Packet Errors:      %u\n", dev->transmit_packet_errors);
+  fprintf(st, "  Packets Received:        %u\n", dev->packets_received);
+  fprintf(st, "  Packets Filtered:        %u\n", dev->packets_filtered);
+  fprintf(st, "  Read Packet Errors:      %u\n", dev->receive_packet_errors);
+#if defined(USE_READER_THREAD)
+  pthread_mutex_lock (&dev->lock);
+  fprintf(st, "  Read Queue: Loss:        %d\n", dev->read_queue.loss);
+  fprintf(st, "  Read Queue: High:        %d of %d\n", dev->read_queue.high, dev->read_queue.max);
+  if (dev->read_latency_count) {
+    fprintf(st, "  Read Latency: Average:   %.3f ms\n", 1000.0 * dev->read_latency_total / dev->read_latency_count);
+    fprintf(st, "  Read Latency: Maximum:   %.3f ms\n", 1000.0 * dev->read_latency_max);
+    }
+  pthread_mutex_unlock (&dev->lock);
+#endif
+#if defined(HAVE_PCAPFILE_NETWORK)
+  if (dev->eth_api == ETH_API_PCAPFILE)
+    _pcapfile_show ((PCAPFILE_HANDLE *)dev->handle, st);
+#endif
+  }
+return SCPE_OK;
 }
 
 static
@@ -5413,7 +6350,9 @@ for (eth_num=0; eth_num<eth_device_count; eth_num++) {
   if ((0 == memcmp (eth_list[eth_num].name, "nat:", 4)) ||
       (0 == memcmp (eth_list[eth_num].name, "tap:", 4)) ||
       (0 == memcmp (eth_list[eth_num].name, "vde:", 4)) ||
-      (0 == memcmp (eth_list[eth_num].name, "udp:", 4)))
+      (0 == memcmp (eth_list[eth_num].name, "udp:", 4)) ||
+      (0 == memcmp (eth_list[eth_num].name, "vswitch:", 8)) ||
+      (0 == memcmp (eth_list[eth_num].name, "pcapfile:", 9)))
       continue;
   snprintf (eth_name, sizeof (eth_name), "eth%d", eth_num);
   r = eth_open(&dev, eth_name, &eth_tst, 1);
@@ -5491,6 +6430,200 @@ if (bpf_compile_skip_count)
 return (errors == 0) ? SCPE_OK : SCPE_IERR;
 }
 
+#if defined(HAVE_VSWITCH_NETWORK)
+/* Send a frame from one vswitch port and wait for it on another */
+
+static int eth_test_vswitch_xfer (ETH_DEV *from, ETH_DEV *to, ETH_MAC *dst, ETH_MAC *src)
+{
+ETH_PACK send, recv;
+int i;
+
+memset (&send, 0, sizeof(send));
+memcpy (&send.msg[0], dst, sizeof(ETH_MAC));
+memcpy (&send.msg[6], src, sizeof(ETH_MAC));
+send.msg[12] = 0x60;                                    /* DECnet routing */
+send.msg[13] = 0x03;
+for (i = 14; i < ETH_MIN_PACKET; i++)
+  send.msg[i] = (uint8)i;
+send.len = ETH_MIN_PACKET;
+if (eth_write (from, &send, NULL) != SCPE_OK)
+  return 0;
+for (i = 0; i < 100; i++) {
+  memset (&recv, 0, sizeof(recv));
+  if (eth_read (to, &recv, NULL))
+    return ((recv.len == send.len) && (0 == memcmp (recv.msg, send.msg, send.len)));
+  sim_os_ms_sleep (10);
+  }
+return 0;
+}
+#endif
+
+static
+t_stat eth_test_vswitch (DEVICE *dptr)
+{
+int errors = 0;
+#if defined(HAVE_VSWITCH_NETWORK)
+DEVICE eth_tst;
+ETH_DEV dev_a, dev_b;
+ETH_MAC filter_a[2] = {{0x08, 0x00, 0x2B, 0x0A, 0x0A, 0x0A},
+                       {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+ETH_MAC filter_b[2] = {{0x08, 0x00, 0x2B, 0x0B, 0x0B, 0x0B},
+                       {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+char name[CBUFSIZE];
+
+memset (&eth_tst, 0, sizeof(eth_tst));
+eth_tst.name = dptr->name;
+memset (&dev_a, 0, sizeof(dev_a));
+memset (&dev_b, 0, sizeof(dev_b));
+snprintf (name, sizeof (name), "vswitch:simhtest%d", (int)getpid ());
+if (eth_open (&dev_a, name, &eth_tst, 1) != SCPE_OK) {
+  sim_printf ("%s: Eth: Error opening %s\n", dptr->name, name);
+  return SCPE_IERR;
+  }
+if (eth_open (&dev_b, name, &eth_tst, 1) != SCPE_OK) {
+  sim_printf ("%s: Eth: Error opening second port of %s\n", dptr->name, name);
+  eth_close (&dev_a);
+  return SCPE_IERR;
+  }
+eth_filter (&dev_a, 2, filter_a, FALSE, FALSE);
+eth_filter (&dev_b, 2, filter_b, FALSE, FALSE);
+/* broadcast is flooded, which also teaches the switch where A is */
+if (!eth_test_vswitch_xfer (&dev_a, &dev_b, &filter_b[1], &filter_a[0])) {
+  sim_printf ("%s: Eth: vswitch broadcast not delivered\n", dptr->name);
+  ++errors;
+  }
+/* unknown unicast destination is flooded */
+if (!eth_test_vswitch_xfer (&dev_b, &dev_a, &filter_a[0], &filter_b[0])) {
+  sim_printf ("%s: Eth: vswitch flooded unicast not delivered\n", dptr->name);
+  ++errors;
+  }
+/* learned unicast destination is forwarded */
+if (!eth_test_vswitch_xfer (&dev_a, &dev_b, &filter_b[0], &filter_a[0])) {
+  sim_printf ("%s: Eth: vswitch learned unicast not delivered\n", dptr->name);
+  ++errors;
+  }
+#if defined(VSW_ROBUST)
+/* a port which dies holding the switch lock must not wedge the others */
+if (1) {
+  VSW_SHARED *sw = ((VSW_HANDLE *)dev_a.handle)->sw;
+  pid_t pid = fork ();
+
+  if (pid == 0) {
+    pthread_mutex_lock (&sw->lock);
+    _exit (0);
+    }
+  if (pid > 0)
+    waitpid (pid, NULL, 0);
+  if ((pid < 0) || !eth_test_vswitch_xfer (&dev_a, &dev_b, &filter_b[0], &filter_a[0])) {
+    sim_printf ("%s: Eth: vswitch unusable after a port died holding its lock\n", dptr->name);
+    ++errors;
+    }
+  }
+#endif
+if (sim_switches & SWMASK('D'))
+  eth_show_dev (stdout, &dev_a);
+eth_close (&dev_b);
+eth_close (&dev_a);
+#endif /* HAVE_VSWITCH_NETWORK */
+return (errors == 0) ? SCPE_OK : SCPE_IERR;
+}
+
+static
+t_stat eth_test_pcapfile (DEVICE *dptr)
+{
+int errors = 0;
+#if defined(HAVE_PCAPFILE_NETWORK)
+DEVICE eth_tst;
+ETH_DEV dev;
+ETH_PACK packet;
+ETH_MAC filter[2] = {{0x08, 0x00, 0x2B, 0x0C, 0x0C, 0x0C},
+                     {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+PCAPFILE_HDR hdr;
+PCAPFILE_REC rec;
+char in_name[64], out_name[64], name[CBUFSIZE];
+uint8 frame[ETH_MIN_PACKET];
+FILE *f;
+long size;
+int i, frames = 5, received = 0, recorded;
+
+snprintf (in_name, sizeof (in_name), "Test-Replay-%d.pcap", (int)getpid ());
+snprintf (out_name, sizeof (out_name), "Test-Record-%d.pcap", (int)getpid ());
+f = fopen (in_name, "wb");
+if (f == NULL)
+  return SCPE_OPENERR;
+memset (&hdr, 0, sizeof (hdr));
+hdr.magic = PCAPFILE_MAGIC_USEC;
+hdr.version_major = 2;
+hdr.version_minor = 4;
+hdr.snaplen = ETH_MAX_PACKET;
+hdr.network = DLT_EN10MB;
+fwrite (&hdr, sizeof (hdr), 1, f);
+memset (frame, 0, sizeof (frame));
+memcpy (&frame[0], filter[1], sizeof (ETH_MAC));    /* broadcast */
+memcpy (&frame[6], filter[0], sizeof (ETH_MAC));
+frame[6] = 0xAA;                                      /* from someone else */
+frame[12] = 0x60;
+frame[13] = 0x03;
+for (i = 0; i < frames; i++) {
+  rec.ts_sec = 1000;
+  rec.ts_frac = i * 1000;                             /* 1ms apart */
+  rec.incl_len = rec.orig_len = sizeof (frame);
+  frame[14] = (uint8)i;
+  fwrite (&rec, sizeof (rec), 1, f);
+  fwrite (frame, sizeof (frame), 1, f);
+  }
+fclose (f);
+memset (&eth_tst, 0, sizeof(eth_tst));
+eth_tst.name = dptr->name;
+memset (&dev, 0, sizeof(dev));
+snprintf (name, sizeof (name), "pcapfile:%s,%s", in_name, out_name);
+if (eth_open (&dev, name, &eth_tst, 1) != SCPE_OK) {
+  sim_printf ("%s: Eth: Error opening %s\n", dptr->name, name);
+  (void)remove (in_name);
+  return SCPE_IERR;
+  }
+eth_filter (&dev, 2, filter, FALSE, FALSE);
+for (i = 0; (i < 200) && (received < frames); i++) {
+  memset (&packet, 0, sizeof(packet));
+  if (eth_read (&dev, &packet, NULL)) {
+    if ((packet.len != sizeof (frame)) || (packet.msg[14] != received)) {
+      sim_printf ("%s: Eth: replayed frame %d out of order or damaged\n", dptr->name, received);
+      ++errors;
+      }
+    ++received;
+    }
+  else
+    sim_os_ms_sleep (10);
+  }
+if (received != frames) {
+  sim_printf ("%s: Eth: %d of %d replayed frames received\n", dptr->name, received, frames);
+  ++errors;
+  }
+memcpy (&packet.msg[0], filter[1], sizeof (ETH_MAC));
+memcpy (&packet.msg[6], filter[0], sizeof (ETH_MAC));
+packet.len = ETH_MIN_PACKET;
+_eth_write (&dev, &packet, NULL);                   /* synchronous, so recorded before close */
+if (sim_switches & SWMASK('D'))
+  eth_show_statistics (stdout);
+recorded = dev.packets_sent;                        /* includes reflection checks */
+eth_close (&dev);
+f = fopen (out_name, "rb");
+size = -1;
+if (f != NULL) {
+  fseek (f, 0, SEEK_END);
+  size = ftell (f);
+  fclose (f);
+  }
+if (size != (long)(sizeof (hdr) + recorded * (sizeof (rec) + ETH_MIN_PACKET))) {
+  sim_printf ("%s: Eth: recorded capture file has unexpected size %ld\n", dptr->name, size);
+  ++errors;
+  }
+(void)remove (in_name);
+(void)remove (out_name);
+#endif /* HAVE_PCAPFILE_NETWORK */
+return (errors == 0) ? SCPE_OK : SCPE_IERR;
+}
+
 t_stat sim_ether_test (DEVICE *dptr, const char *cptr)
 {
 t_stat stat = SCPE_OK;
@@ -5499,6 +6632,8 @@ SIM_TEST_INIT;
 sim_printf ("Testing %s device sim_ether APIs\n", dptr->name);
 
 SIM_TEST(eth_test_crc32 (dptr));
+SIM_TEST(eth_test_vswitch (dptr));
+SIM_TEST(eth_test_pcapfile (dptr));
 SIM_TEST(eth_test_bpf (dptr));
 return stat;
 }
@@ -118,6 +118,12 @@ extern "C" {
 #if (!defined (xBSD) && !defined(_WIN32) && !defined(VMS) && !defined(__CYGWIN__)) || defined (HAVE_TAP_NETWORK) || defined (HAVE_VDE_NETWORK)
 #define MUST_DO_SELECT 1
 #endif
+/* the shared memory virtual switch needs process shared pthread objects */
+#if !defined(_WIN32) && !defined(VMS) && !defined(__CYGWIN__)
+#define HAVE_VSWITCH_NETWORK 1
+#endif
+/* capture file replay is paced by the reader thread */
+#define HAVE_PCAPFILE_NETWORK 1
 #endif /* USE_READER_THREAD */
 
 /* give priority to USE_NETWORK over USE_SHARED */
@@ -228,6 +234,7 @@ struct eth_item {
 #define ETH_ITM_SETUP    0
 #define ETH_ITM_LOOPBACK 1
 #define ETH_ITM_NORMAL   2
+  double              queued;                           /* host time item was queued (seconds) */
   struct eth_packet   packet;
 };
 
@@ -277,6 +284,8 @@ struct eth_device {
 #define ETH_API_UDP   4                                 /* UDP API in use */
 #define ETH_API_NAT   5                                 /* NAT (SLiRP) API in use */
 #define ETH_API_VMNET 6                                 /* Apple vmnet.framework in use */
+#define ETH_API_VSWITCH 7                               /* Shared memory virtual switch in use */
+#define ETH_API_PCAPFILE 8                              /* Capture file replay in use */
   ETH_PCALLBACK read_callback;                          /* read callback function */
   ETH_PCALLBACK write_callback;                         /* write callback function */
   ETH_PACK*     read_packet;                            /* read packet */
@@ -301,6 +310,7 @@ struct eth_device {
   uint32        loopback_packets_processed;             /* Total Loopback Packets Processed */
   uint32        transmit_packet_errors;                 /* Total Send Packet Errors */
   uint32        receive_packet_errors;                  /* Total Read Packet Errors */
+  uint32        packets_filtered;                       /* Total Received Packets Not Addressed To Us */
   int32         error_waiting_threads;                  /* Count of threads currently waiting after an error */
   ETH_BOOL      error_needs_reset;                      /* Flag indicating to force reset */
 #define ETH_ERROR_REOPEN_THRESHOLD 10                   /* Attempt ReOpen after 20 send/receive errors */
@@ -327,6 +337,9 @@ struct eth_device {
   int           asynch_io;                              /* Asynchronous Interrupt scheduling enabled */
   int           asynch_io_latency;                      /* instructions to delay pending interrupt */
   ETH_QUE       read_queue;
+  uint32        read_latency_count;                     /* packets with measured queueing latency */
+  double        read_latency_total;                     /* total seconds packets spent queued */
+  double        read_latency_max;                       /* longest seconds a packet spent queued */
   pthread_mutex_t     lock;
   pthread_t     reader_thread;                          /* Reader Thread Id */
   pthread_t     writer_thread;                          /* Writer Thread Id */
@@ -53,8 +53,18 @@
    sim_buf_swap_data -       swap data elements inplace in buffer if needed
    sim_byte_swap_data -      swap data elements inplace in buffer
    sim_buf_pack_unpack -     pack or unpack data between buffers
+                             (12, 16, 18, 32, 36 and 64 bit words, etc.
+                             are moved a word at a time, other packings
+                             are moved a bit at a time)
    sim_shmem_open            create or attach to a shared memory region
    sim_shmem_close           close a shared memory region
+   sim_mem_alloc             allocate simulated memory, committed on first touch
+   sim_mem_realloc           resize simulated memory
+   sim_mem_free              free simulated memory
+   sim_mem_size              size of simulated memory
+   sim_mem_untouched         test for never written simulated memory
+   sim_set_mem_backing       SET <cpu> MEMBACKING=HUGE|NORMAL
+   sim_set_numa_node         SET <cpu> NUMANODE=n and NONUMANODE
    sim_chdir                 change working directory
    sim_mkdir                 create a directory
    sim_rmdir                 remove a directory
@@ -161,25 +171,113 @@ if (sim_end || (count == 0) || (size == sizeof (char)))
 sim_byte_swap_data (bptr, size, count);
 }
 
-void sim_byte_swap_data (void *bptr, size_t size, size_t count)
+/* Byte swap kernels
+
+   The common element sizes (2, 4 and 8 bytes) are swapped a whole
+   element at a time.  The loads and stores go through memcpy so that
+   unaligned buffers are handled, and the swaps are written as plain
+   shift and mask expressions which current compilers recognize as
+   byte swap instructions and vectorize.  Other element sizes are
+   reversed a byte at a time.
+
+   All kernels allow the source and destination to be the same buffer.
+*/
+
+static SIM_INLINE uint16 _sim_bswap16 (uint16 x)
+{
+return (uint16)((x >> 8) | (x << 8));
+}
+
+static SIM_INLINE uint32 _sim_bswap32 (uint32 x)
 {
-uint32 j;
-int32 k;
-unsigned char by, *sptr, *dptr;
+return ((x >> 24) & 0x000000FF) | ((x >> 8) & 0x0000FF00) |
+       ((x << 8)  & 0x00FF0000) | ((x << 24) & 0xFF000000);
+}
 
-if (sim_end || (count == 0) || (size == sizeof (char)))
-    return;
-for (j = 0, dptr = sptr = (unsigned char *) bptr;       /* loop on items */
-     j < count; j++) {
-    for (k = (int32)(size - 1); k >= (((int32) size + 1) / 2); k--) {
-        by = *sptr;                                     /* swap end-for-end */
-        *sptr++ = *(dptr + k);
-        *(dptr + k) = by;
+static SIM_INLINE t_uint64 _sim_bswap64 (t_uint64 x)
+{
+return ((t_uint64)_sim_bswap32 ((uint32)x) << 32) | _sim_bswap32 ((uint32)(x >> 32));
+}
+
+static void _sim_swap_copy_2 (unsigned char *dptr, const unsigned char *sptr, size_t count)
+{
+uint16 w;
+
+for (; count > 0; count--, sptr += 2, dptr += 2) {
+    memcpy (&w, sptr, sizeof (w));
+    w = _sim_bswap16 (w);
+    memcpy (dptr, &w, sizeof (w));
+    }
+}
+
+static void _sim_swap_copy_4 (unsigned char *dptr, const unsigned char *sptr, size_t count)
+{
+uint32 w;
+
+for (; count > 0; count--, sptr += 4, dptr += 4) {
+    memcpy (&w, sptr, sizeof (w));
+    w = _sim_bswap32 (w);
+    memcpy (dptr, &w, sizeof (w));
+    }
+}
+
+static void _sim_swap_copy_8 (unsigned char *dptr, const unsigned char *sptr, size_t count)
+{
+t_uint64 w;
+
+for (; count > 0; count--, sptr += 8, dptr += 8) {
+    memcpy (&w, sptr, sizeof (w));
+    w = _sim_bswap64 (w);
+    memcpy (dptr, &w, sizeof (w));
+    }
+}
+
+static void _sim_swap_copy_n (unsigned char *dptr, const unsigned char *sptr, size_t size, size_t count)
+{
+size_t j, k;
+unsigned char by;
+
+for (j = 0; j < count; j++) {                           /* loop on items */
+    for (k = 0; k < size / 2; k++) {                    /* swap end-for-end */
+        by = sptr[k];
+        dptr[k] = sptr[size - 1 - k];
+        dptr[size - 1 - k] = by;
         }
-    sptr = dptr = dptr + size;                          /* next item */
+    if (size & 1)                                       /* odd size? */
+        dptr[size / 2] = sptr[size / 2];                /* copy middle byte */
+    sptr = sptr + size;                                 /* next item */
+    dptr = dptr + size;
     }
 }
 
+static void _sim_swap_copy (void *dbuf, const void *sbuf, size_t size, size_t count)
+{
+const unsigned char *sptr = (const unsigned char *)sbuf;
+unsigned char *dptr = (unsigned char *)dbuf;
+
+switch (size) {
+    case 2:
+        _sim_swap_copy_2 (dptr, sptr, count);
+        break;
+    case 4:
+        _sim_swap_copy_4 (dptr, sptr, count);
+        break;
+    case 8:
+        _sim_swap_copy_8 (dptr, sptr, count);
+        break;
+    default:
+        _sim_swap_copy_n (dptr, sptr, size, count);
+        break;
+    }
+}
+
+void sim_byte_swap_data (void *bptr, size_t size, size_t count)
+{
+if (sim_end || (count == 0) || (size == sizeof (char)))
+    return;
+_sim_swap_copy (bptr, bptr, size, count);
+}
+
 size_t sim_fread (void *bptr, size_t size, size_t count, FILE *fptr)
 {
 size_t c;
@@ -195,20 +293,11 @@ return c;
 
 void sim_buf_copy_swapped (void *dbuf, const void *sbuf, size_t size, size_t count)
 {
-size_t j;
-int32 k;
-const unsigned char *sptr = (const unsigned char *)sbuf;
-unsigned char *dptr = (unsigned char *)dbuf;
-
 if (sim_end || (size == sizeof (char))) {
-    memcpy (dptr, sptr, size * count);
+    memcpy (dbuf, sbuf, size * count);
     return;
     }
-for (j = 0; j < count; j++) {                           /* loop on items */
-    for (k = (int32)(size - 1); k >= 0; k--)
-        *(dptr + k) = *sptr++;
-    dptr = dptr + size;
-    }
+_sim_swap_copy (dbuf, sbuf, size, count);
 }
 
 static uint32 _bit_index (uint32 bit, uint32 bits, t_bool LSB)
@@ -224,6 +313,108 @@ bit = (bit % bits) + offset;
 return base + (bits - (((bit + (bits % 8)) / 8) * 8) - (bits % 8)) + offset + ((bit + (bits % 8)) % 8);
 }
 
+/* Move elements a bit at a time, honoring any element size and numbering */
+
+static void _sim_buf_pack_unpack_bits (const uint8 *s, uint8 *d,
+                                       uint32 sbits, t_bool sLSB_o_numbering,
+                                       uint32 scount,
+                                       uint32 dbits, t_bool dLSB_o_numbering)
+{
+uint32 bits_to_process;         /* bits in current source element remaining to be processed */
+uint32 sbit_offset, dbit_offset;/* source and destination bit offsets */
+uint32 sx;                      /* source byte index */
+uint32 dx;                      /* destination byte index */
+uint32 bit;                     /* Current Bit number */
+uint32 element;                 /* Current element number */
+
+bits_to_process = MIN (sbits, dbits);
+for (element = 0; element < scount; element++) {
+    sbit_offset = element * sbits;
+    dbit_offset = element * dbits;
+    for (bit = 0; bit < bits_to_process; bit++, sbit_offset++, dbit_offset++) {
+        sx = _bit_index (sbit_offset, sbits, sLSB_o_numbering);
+        dx = _bit_index (dbit_offset, dbits, dLSB_o_numbering);
+        d[dx >> 3] |= (((s[sx >> 3] >> (sx & 7)) & 1) << (dx & 7));
+        }
+    }
+}
+
+/* Move elements a word at a time
+
+   With LSB numbering the elements form a little endian bit stream,
+   and with MSB numbering a big endian bit stream.  The latter only
+   holds for element sizes which are a multiple of 4 bits (8, 12, 16,
+   32, 36, 64 etc.), so _sim_pack_word_ok limits this path to element
+   sizes whose layout it reproduces exactly.  Each element is gathered
+   with at most 9 byte loads rather than one load per bit.
+*/
+
+static t_bool _sim_pack_word_ok (uint32 bits, t_bool LSB_o_numbering)
+{
+return (bits > 0) && (bits <= 64) && (LSB_o_numbering || ((bits % 4) == 0));
+}
+
+static SIM_INLINE t_uint64 _sim_pack_get (const uint8 *s, t_uint64 bit_offset, uint32 bits, t_bool LSB)
+{
+const uint8 *p = s + (size_t)(bit_offset >> 3);
+uint32 shift = (uint32)(bit_offset & 7);
+uint32 end = shift + bits;
+uint32 nbytes = (end + 7) >> 3;
+uint32 i;
+t_uint64 val;
+
+if (LSB) {
+    val = p[0] >> shift;
+    for (i = 1; i < nbytes; i++)
+        val |= ((t_uint64)p[i]) << ((8 * i) - shift);
+    }
+else {
+    val = p[0] & (0xFF >> shift);
+    for (i = 1; i < nbytes; i++)
+        val = (val << 8) | p[i];
+    val >>= (8 * nbytes) - end;
+    }
+if (bits < 64)
+    val &= ((((t_uint64)1) << bits) - 1);
+return val;
+}
+
+static SIM_INLINE void _sim_pack_put (uint8 *d, t_uint64 bit_offset, uint32 bits, t_bool LSB, t_uint64 val)
+{
+uint8 *p = d + (size_t)(bit_offset >> 3);
+uint32 shift = (uint32)(bit_offset & 7);
+uint32 end = shift + bits;
+uint32 nbytes = (end + 7) >> 3;
+uint32 i;
+
+if (LSB) {
+    p[0] |= (uint8)(val << shift);
+    for (i = 1; i < nbytes; i++)
+        p[i] |= (uint8)(val >> ((8 * i) - shift));
+    }
+else {
+    val <<= (8 * nbytes) - end;
+    for (i = nbytes; i > 0; i--) {
+        p[i - 1] |= (uint8)val;
+        val >>= 8;
+        }
+    }
+}
+
+static void _sim_buf_pack_unpack_words (const uint8 *s, uint8 *d,
+                                        uint32 sbits, t_bool sLSB_o_numbering,
+                                        uint32 scount,
+                                        uint32 dbits, t_bool dLSB_o_numbering)
+{
+uint32 element;
+uint32 bits = MIN (sbits, dbits);
+t_uint64 mask = (bits < 64) ? ((((t_uint64)1) << bits) - 1) : ~((t_uint64)0);
+
+for (element = 0; element < scount; element++)
+    _sim_pack_put (d, (t_uint64)element * dbits, dbits, dLSB_o_numbering,
+                   _sim_pack_get (s, (t_uint64)element * sbits, sbits, sLSB_o_numbering) & mask);
+}
+
 t_bool sim_buf_pack_unpack (const void *sptr,          /* source buffer pointer */
                             void *dptr,                /* destination buffer pointer */
                             uint32 sbits,              /* source buffer element size in bits */
@@ -234,12 +425,6 @@ t_bool sim_buf_pack_unpack (const void *sptr,          /* source buffer pointer
 {
 const uint8 *s = (const uint8 *)sptr;
 uint8 *d = (uint8 *)dptr;
-uint32 bits_to_process;         /* bits in current source element remaining to be processed */
-uint32 sbit_offset, dbit_offset;/* source and destination bit offsets */
-uint32 sx;                      /* source byte index */
-uint32 dx;                      /* destination byte index */
-uint32 bit;                     /* Current Bit number */
-uint32 element;                 /* Current element number */
 
 sim_debug (FIO_DBG_PACK, &sim_fio_test_dev, "sim_buf_pack_unpack(sbits=%d, dLSB_o=%s, scount=%d, dbits=%d, dLSB_o=%s)\n", sbits, sLSB_o_numbering ? "True" : "False", scount, dbits, dLSB_o_numbering ? "True" : "False");
 if (((dbits * scount) & 7) != 0)
@@ -252,19 +437,40 @@ if (((sbits % 8) == 0)                  &&
     sim_buf_copy_swapped (dptr, sptr, sbits >> 3, scount);
     return FALSE;
     }
-bits_to_process = MIN (sbits, dbits);
-for (element = 0; element < scount; element++) {
-    sbit_offset = element * sbits;
-    dbit_offset = element * dbits;
-    for (bit = 0; bit < bits_to_process; bit++, sbit_offset++, dbit_offset++) {
-        sx = _bit_index (sbit_offset, sbits, sLSB_o_numbering);
-        dx = _bit_index (dbit_offset, dbits, dLSB_o_numbering);
-        d[dx >> 3] |= (((s[sx >> 3] >> (sx & 7)) & 1) << (dx & 7));
-        }
+if (_sim_pack_word_ok (sbits, sLSB_o_numbering) &&
+    _sim_pack_word_ok (dbits, dLSB_o_numbering)) {
+    _sim_buf_pack_unpack_words (s, d, sbits, sLSB_o_numbering, scount, dbits, dLSB_o_numbering);
+    return FALSE;
     }
+_sim_buf_pack_unpack_bits (s, d, sbits, sLSB_o_numbering, scount, dbits, dLSB_o_numbering);
 return FALSE;
 }
 
+/* The sim_fwrite swap buffer is allocated once per thread and reused.
+   Without real thread local storage, it is allocated on each call. */
+
+#if !defined (AIO_TLS_NONE)
+static AIO_TLS unsigned char *sim_flip_buf = NULL;
+#endif
+
+static unsigned char *_sim_flip_get (void)
+{
+#if !defined (AIO_TLS_NONE)
+if (sim_flip_buf == NULL)
+    sim_flip_buf = (unsigned char *)malloc (FLIP_SIZE);
+return sim_flip_buf;
+#else
+return (unsigned char *)malloc (FLIP_SIZE);
+#endif
+}
+
+static void _sim_flip_release (unsigned char *sim_flip)
+{
+#if defined (AIO_TLS_NONE)
+free (sim_flip);
+#endif
+}
+
 size_t sim_fwrite (const void *bptr, size_t size, size_t count, FILE *fptr)
 {
 size_t c, nelem, nbuf, lcnt, total;
@@ -276,7 +482,9 @@ if ((size == 0) || (count == 0))                        /* check arguments */
     return 0;
 if (sim_end || (size == sizeof (char)))                 /* le or byte? */
     return fwrite (bptr, size, count, fptr);            /* done */
-sim_flip = (unsigned char *)malloc(FLIP_SIZE);
+if (size > FLIP_SIZE)                                   /* element bigger than buffer? */
+    return 0;
+sim_flip = _sim_flip_get ();
 if (!sim_flip)
     return 0;
 nelem = FLIP_SIZE / size;                               /* elements in buffer */
@@ -292,12 +500,12 @@ for (i = (int32)nbuf; i > 0; i--) {                     /* loop on buffers */
     sptr = sptr + size * c;
     c = fwrite (sim_flip, size, c, fptr);
     if (c == 0) {
-        free(sim_flip);
+        _sim_flip_release (sim_flip);
         return total;
         }
     total = total + c;
     }
-free(sim_flip);
+_sim_flip_release (sim_flip);
 return total;
 }
 
@@ -669,6 +877,108 @@ static struct get_filelist_test {
 
 #if !defined (NO_FIO_TEST_CODE)
 
+/* Compare the word at a time pack/unpack path against the bit at a time
+   reference for random data, and time both of them. */
+
+static t_stat _sim_fio_pack_word_test (void)
+{
+static const uint32 sizes[] = {4, 8, 12, 16, 18, 24, 32, 36, 64, 0};
+const uint32 scount = 64;
+uint8 src[(64 * 64) / 8], ref[(64 * 64) / 8], fast[(64 * 64) / 8];
+uint32 i, si, di, so, doo, loops;
+uint32 start_ms, bit_ms, word_ms;
+t_stat r = SCPE_OK;
+int tests = 0;
+
+for (i = 0; i < sizeof (src); i++)
+    src[i] = (uint8)(rand () >> 3);
+for (si = 0; sizes[si]; si++) {
+    for (di = 0; sizes[di]; di++) {
+        for (so = 0; so < 2; so++) {
+            for (doo = 0; doo < 2; doo++) {
+                uint32 sbits = sizes[si], dbits = sizes[di];
+
+                if (!_sim_pack_word_ok (sbits, so) || !_sim_pack_word_ok (dbits, doo))
+                    continue;
+                ++tests;
+                memset (ref, 0, sizeof (ref));
+                memset (fast, 0, sizeof (fast));
+                _sim_buf_pack_unpack_bits (src, ref, sbits, so, scount, dbits, doo);
+                _sim_buf_pack_unpack_words (src, fast, sbits, so, scount, dbits, doo);
+                if (memcmp (ref, fast, (scount * dbits) / 8) != 0)
+                    r = sim_messagef (SCPE_IERR, "%dbit%s->%dbit%s word path differs from bit path\n", sbits, so ? "LSB" : "MSB", dbits, doo ? "LSB" : "MSB");
+                }
+            }
+        }
+    }
+if (r != SCPE_OK)
+    return r;
+sim_messagef (SCPE_OK, "*** All %d word/bit sim_buf_pack_unpack comparisons GOOD\n", tests);
+loops = 2000;
+start_ms = sim_os_msec ();
+for (i = 0; i < loops; i++)
+    _sim_buf_pack_unpack_bits (src, ref, 36, FALSE, scount, 64, TRUE);
+bit_ms = sim_os_msec () - start_ms;
+start_ms = sim_os_msec ();
+for (i = 0; i < loops; i++)
+    _sim_buf_pack_unpack_words (src, fast, 36, FALSE, scount, 64, TRUE);
+word_ms = sim_os_msec () - start_ms;
+sim_messagef (SCPE_OK, "36bitMSB->64bitLSB %d x %d words: bit path %d ms, word path %d ms\n", (int)loops, (int)scount, (int)bit_ms, (int)word_ms);
+return r;
+}
+
+/* Check that the byte swap kernels reverse each element and that
+   sim_fwrite/sim_fread round trip swapped data through a file. */
+
+static t_stat _sim_fio_swap_test (void)
+{
+static const size_t sizes[] = {2, 3, 4, 6, 8, 0};
+uint8 src[480], dst[480], back[480];
+size_t si, i, k;
+FILE *f;
+t_bool saved_end = sim_end;
+t_stat r = SCPE_OK;
+
+for (i = 0; i < sizeof (src); i++)
+    src[i] = (uint8)(i * 7 + 3);
+sim_end = FALSE;                                /* force swapping */
+for (si = 0; sizes[si]; si++) {
+    size_t size = sizes[si];
+    size_t count = sizeof (src) / size;
+
+    sim_buf_copy_swapped (dst, src, size, count);
+    for (i = 0; i < count; i++)
+        for (k = 0; k < size; k++)
+            if (dst[i * size + k] != src[i * size + (size - 1 - k)]) {
+                r = sim_messagef (SCPE_IERR, "sim_buf_copy_swapped size %d element %d BAD\n", (int)size, (int)i);
+                i = count;
+                break;
+                }
+    memcpy (back, dst, sizeof (back));
+    sim_byte_swap_data (back, size, count);
+    if (memcmp (back, src, sizeof (src)) != 0)
+        r = sim_messagef (SCPE_IERR, "sim_byte_swap_data size %d BAD\n", (int)size);
+    f = tmpfile ();
+    if (f == NULL)
+        continue;
+    if (sim_fwrite (src, size, count, f) != count)
+        r = sim_messagef (SCPE_IERR, "sim_fwrite size %d BAD count\n", (int)size);
+    rewind (f);                                 /* file holds swapped data? */
+    if ((fread (back, size, count, f) != count) ||
+        (memcmp (back, dst, sizeof (dst)) != 0))
+        r = sim_messagef (SCPE_IERR, "sim_fwrite size %d BAD file data\n", (int)size);
+    rewind (f);
+    if ((sim_fread (back, size, count, f) != count) ||
+        (memcmp (back, src, sizeof (src)) != 0))
+        r = sim_messagef (SCPE_IERR, "sim_fwrite/sim_fread size %d round trip BAD\n", (int)size);
+    fclose (f);
+    }
+sim_end = saved_end;
+if (r == SCPE_OK)
+    sim_messagef (SCPE_OK, "*** All byte swap tests GOOD\n");
+return r;
+}
+
 t_stat sim_fio_test (const char *cptr)
 {
 struct pack_test *pt;
@@ -712,6 +1022,11 @@ for (pt = p_test, tests = 0; pt->src; ++pt) {
 if (r != SCPE_OK)
     return r;
 sim_messagef (SCPE_OK, "*** All %d sim_buf_pack_unpack tests GOOD\n", tests);
+r = _sim_fio_pack_word_test ();
+if (r == SCPE_OK)
+    r = _sim_fio_swap_test ();
+if (r != SCPE_OK)
+    return r;
 sim_messagef (SCPE_OK, "*** Testing relative path logic:\n");
 for (rt = r_test, tests = 0; rt->input; ++rt) {
     char input[PATH_MAX + 1];
@@ -1807,6 +2122,565 @@ return FALSE;
 #endif /* defined (__linux__) || defined (__APPLE__) */
 #endif /* defined (_WIN32) */
 
+/* Simulated memory allocation.
+
+   sim_mem_alloc reserves address space for a simulated memory and lets the
+   host commit each page, zero filled, the first time it is touched, so a
+   simulator configured with a large memory only costs what the simulated
+   system actually uses.  sim_mem_untouched reports whether a range has never
+   been written; SAVE uses it to skip untouched memory without examining it.
+   The answer is conservative: it is FALSE whenever the host can't tell
+   (and for pages that have only been read, on Linux).  Memory that can't be
+   mapped comes from calloc and is never reported untouched.
+
+   On Linux, SET CPU MEMBACKING=HUGE backs simulated memory with huge pages
+   (reserved hugetlb pages when there are enough, otherwise transparent huge
+   pages) to cut host TLB misses, and SET CPU NUMANODE=n binds simulated
+   memory and the simulator thread to one NUMA node.  Both apply to memory
+   already allocated as well as to later allocations.
+*/
+
+#define SIM_MEM_NORMAL  0                               /* backing: host's default pages */
+#define SIM_MEM_HUGE    1                               /*          huge pages */
+#define SIM_MEM_MAXNODE 1024                            /* NUMA nodes and CPUs we can name */
+
+typedef struct SIM_MEM_REGION {
+    void                    *base;
+    size_t                  size;                       /* size requested */
+    size_t                  msize;                      /* size mapped */
+    t_bool                  mapped;                     /* mmap/VirtualAlloc rather than calloc */
+    t_bool                  hugetlb;                    /* backed by reserved huge pages */
+    t_bool                  thp;                        /* advised to use transparent huge pages */
+    struct SIM_MEM_REGION   *next;
+    } SIM_MEM_REGION;
+
+static SIM_MEM_REGION *sim_mem_regions = NULL;
+static int32 sim_mem_backing = SIM_MEM_NORMAL;
+static int32 sim_mem_node = -1;                         /* NUMA node, -1 if unbound */
+
+#if defined (_WIN32)
+static t_bool _sim_mem_map (SIM_MEM_REGION *rgn)
+{
+rgn->msize = rgn->size;
+rgn->base = VirtualAlloc (NULL, rgn->msize, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE);
+return (rgn->base != NULL);
+}
+
+static void _sim_mem_unmap (SIM_MEM_REGION *rgn)
+{
+VirtualFree (rgn->base, 0, MEM_RELEASE);
+}
+
+static size_t _sim_mem_pagesize (void)
+{
+SYSTEM_INFO SysInfo;
+
+GetSystemInfo (&SysInfo);
+return (size_t)SysInfo.dwPageSize;
+}
+
+static t_bool _sim_mem_untouched (const uint8 *addr, size_t len)
+{
+PVOID written[1];
+ULONG_PTR count = 1;
+ULONG granularity;
+
+if (GetWriteWatch (0, (PVOID)addr, len, written, &count, &granularity) != 0)
+    return FALSE;
+return (count == 0);
+}
+
+#elif (defined (__linux__) || defined (__APPLE__) || defined (__CYGWIN__) || defined (__FreeBSD__) || defined(__NetBSD__) || defined (__OpenBSD__))
+#include <sys/mman.h>
+#if !defined (MAP_ANONYMOUS) && defined (MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if !defined (MAP_NORESERVE)
+#define MAP_NORESERVE 0
+#endif
+
+static size_t _sim_mem_pagesize (void)
+{
+return (size_t)sysconf (_SC_PAGESIZE);
+}
+
+#if defined (__linux__)
+#include <sys/syscall.h>
+
+#define PM_PRESENT      (((t_uint64)1) << 63)
+#define PM_SWAPPED      (((t_uint64)1) << 62)
+#define MPOL_DEFAULT_   0                               /* mbind modes (linux/mempolicy.h) */
+#define MPOL_BIND_      2
+#define MPOL_MF_MOVE_   2
+
+static size_t _sim_mem_hugepagesize (void)
+{
+static size_t hps = 0;
+char line[128];
+FILE *f;
+
+if (hps == 0) {
+    hps = 2 * 1024 * 1024;
+    if ((f = fopen ("/proc/meminfo", "r"))) {
+        while (fgets (line, sizeof (line), f)) {
+            unsigned long kb;
+
+            if (sscanf (line, "Hugepagesize: %lu kB", &kb) == 1) {
+                hps = (size_t)kb * 1024;
+                break;
+                }
+            }
+        fclose (f);
+        }
+    }
+return hps;
+}
+
+/* Bytes of reserved huge pages that are free and not already promised
+   to another mapping */
+
+static size_t _sim_mem_hugepages_free (void)
+{
+unsigned long free_pages = 0, rsvd_pages = 0, n;
+char line[128];
+FILE *f;
+
+if ((f = fopen ("/proc/meminfo", "r"))) {
+    while (fgets (line, sizeof (line), f)) {
+        if (sscanf (line, "HugePages_Free: %lu", &n) == 1)
+            free_pages = n;
+        else if (sscanf (line, "HugePages_Rsvd: %lu", &n) == 1)
+            rsvd_pages = n;
+        }
+    fclose (f);
+    }
+if (free_pages <= rsvd_pages)
+    return 0;
+return (size_t)(free_pages - rsvd_pages) * _sim_mem_hugepagesize ();
+}
+
+static void *_sim_mem_mmap (void *addr, size_t size, t_bool hugetlb)
+{
+int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+void *base;
+
+if (addr)
+    flags |= MAP_FIXED;
+#if defined (MAP_HUGETLB)
+if (hugetlb) {                                          /* reserve now rather than SIGBUS later */
+    if (_sim_mem_hugepages_free () < size)              /* not enough to go round? */
+        return NULL;
+    flags = (flags & ~MAP_NORESERVE) | MAP_HUGETLB;
+    }
+#else
+if (hugetlb)
+    return NULL;
+#endif
+base = mmap (addr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+return (base == MAP_FAILED) ? NULL : base;
+}
+
+/* Apply the current huge page and NUMA settings to a mapped region */
+
+static void _sim_mem_policy (SIM_MEM_REGION *rgn)
+{
+unsigned long mask[SIM_MEM_MAXNODE / (8 * sizeof (unsigned long))];
+
+#if defined (MADV_HUGEPAGE)
+rgn->thp = !rgn->hugetlb && (sim_mem_backing == SIM_MEM_HUGE);
+if (rgn->thp)                                           /* NORMAL leaves the host's THP policy alone */
+    madvise (rgn->base, rgn->msize, MADV_HUGEPAGE);
+#endif
+memset (mask, 0, sizeof (mask));
+if (sim_mem_node >= 0) {
+    mask[sim_mem_node / (8 * sizeof (unsigned long))] |= 1UL << (sim_mem_node % (8 * sizeof (unsigned long)));
+    syscall (SYS_mbind, rgn->base, rgn->msize, MPOL_BIND_, mask, SIM_MEM_MAXNODE + 1, MPOL_MF_MOVE_);
+    }
+else
+    syscall (SYS_mbind, rgn->base, rgn->msize, MPOL_DEFAULT_, NULL, 0, 0);
+}
+
+/* Reserve size rounded to, and aligned on, a huge page so the region can
+   be rebacked in place by hugetlb pages whenever MEMBACKING changes */
+
+static t_bool _sim_mem_map (SIM_MEM_REGION *rgn)
+{
+size_t hps = _sim_mem_hugepagesize ();
+uint8 *resv, *base;
+
+rgn->msize = (rgn->size + hps - 1) & ~(hps - 1);
+resv = (uint8 *)_sim_mem_mmap (NULL, rgn->msize + hps, FALSE);
+if (resv == NULL)
+    return FALSE;
+base = (uint8 *)(((size_t)resv + hps - 1) & ~(hps - 1));
+if (base != resv)
+    munmap (resv, base - resv);
+munmap (base + rgn->msize, (resv + hps) - base);
+rgn->base = base;
+rgn->hugetlb = (sim_mem_backing == SIM_MEM_HUGE) &&
+               (_sim_mem_mmap (base, rgn->msize, TRUE) != NULL);
+if (!rgn->hugetlb && (sim_mem_backing == SIM_MEM_HUGE) &&   /* a failed MAP_FIXED may */
+    (_sim_mem_mmap (base, rgn->msize, FALSE) == NULL)) {    /* have unmapped the range */
+    munmap (base, rgn->msize);
+    return FALSE;
+    }
+_sim_mem_policy (rgn);
+return TRUE;
+}
+
+static void _sim_mem_unmap (SIM_MEM_REGION *rgn)
+{
+munmap (rgn->base, rgn->msize);
+}
+
+/* A page that is neither present nor swapped out has never been touched.
+   /proc/self/pagemap has one 64 bit entry per virtual page. */
+
+static t_bool _sim_mem_untouched (const uint8 *addr, size_t len)
+{
+static int pagemap = -2;
+size_t pagesize = _sim_mem_pagesize ();
+size_t page = (size_t)addr / pagesize;
+size_t pages = (((size_t)addr + len + pagesize - 1) / pagesize) - page;
+t_uint64 entries[512];
+
+if (pagemap == -2)
+    pagemap = open ("/proc/self/pagemap", O_RDONLY);
+if (pagemap < 0)
+    return FALSE;
+while (pages > 0) {
+    size_t i, n = (pages < 512) ? pages : 512;
+
+    if (pread (pagemap, entries, n * sizeof (entries[0]), (off_t)(page * sizeof (entries[0]))) != (ssize_t)(n * sizeof (entries[0])))
+        return FALSE;
+    for (i = 0; i < n; i++)
+        if (entries[i] & (PM_PRESENT | PM_SWAPPED))
+            return FALSE;
+    page += n;
+    pages -= n;
+    }
+return TRUE;
+}
+
+/* Switch a region between hugetlb and ordinary pages, keeping its address
+   and contents; falls back to ordinary pages if hugetlb pages run out */
+
+static t_stat _sim_mem_reback (SIM_MEM_REGION *rgn, t_bool hugetlb)
+{
+size_t pagesize = _sim_mem_pagesize ();
+size_t off, len;
+uint8 *save = NULL, *touched = NULL;
+
+if (!_sim_mem_untouched ((uint8 *)rgn->base, rgn->size)) {  /* anything to keep? */
+    save = (uint8 *)malloc (rgn->size);                 /* committed only where copied */
+    touched = (uint8 *)calloc (rgn->size / pagesize + 1, 1);
+    if ((save == NULL) || (touched == NULL)) {
+        free (save);
+        free (touched);
+        return SCPE_MEM;
+        }
+    for (off = 0; off < rgn->size; off += len) {
+        len = (rgn->size - off < pagesize) ? rgn->size - off : pagesize;
+        if (!_sim_mem_untouched ((uint8 *)rgn->base + off, len)) {
+            memcpy (save + off, (uint8 *)rgn->base + off, len);
+            touched[off / pagesize] = 1;
+            }
+        }
+    }
+rgn->hugetlb = hugetlb && (_sim_mem_mmap (rgn->base, rgn->msize, TRUE) != NULL);
+if (!rgn->hugetlb &&
+    (_sim_mem_mmap (rgn->base, rgn->msize, FALSE) == NULL)) {
+    free (save);                                        /* address space lost */
+    free (touched);
+    return sim_messagef (SCPE_MEM, "Can't remap simulated memory: %s\n", strerror (errno));
+    }
+_sim_mem_policy (rgn);
+if (save) {
+    for (off = 0; off < rgn->size; off += pagesize)
+        if (touched[off / pagesize])
+            memcpy ((uint8 *)rgn->base + off, save + off, (rgn->size - off < pagesize) ? rgn->size - off : pagesize);
+    }
+free (save);
+free (touched);
+return SCPE_OK;
+}
+
+static t_stat _sim_mem_set_backing (int32 backing)
+{
+SIM_MEM_REGION *rgn;
+t_stat r = SCPE_OK;
+
+sim_mem_backing = backing;
+for (rgn = sim_mem_regions; (rgn != NULL) && (r == SCPE_OK); rgn = rgn->next) {
+    if (!rgn->mapped)
+        continue;
+    if ((rgn->hugetlb != (backing == SIM_MEM_HUGE)) ||
+        (rgn->thp && (backing != SIM_MEM_HUGE)))        /* only a fresh mapping drops MADV_HUGEPAGE */
+        r = _sim_mem_reback (rgn, (backing == SIM_MEM_HUGE));
+    else
+        _sim_mem_policy (rgn);
+    }
+return r;
+}
+
+/* Bind (node >= 0) or unbind (node < 0) memory and the calling thread */
+
+static t_stat _sim_mem_set_node (int32 node)
+{
+static unsigned long all_cpus[SIM_MEM_MAXNODE / (8 * sizeof (unsigned long))];
+static t_bool saved = FALSE;
+unsigned long cpus[SIM_MEM_MAXNODE / (8 * sizeof (unsigned long))];
+SIM_MEM_REGION *rgn;
+char path[64], list[1024];
+char *cptr;
+FILE *f;
+
+if (!saved)                                             /* remember affinity before binding */
+    saved = (syscall (SYS_sched_getaffinity, 0, sizeof (all_cpus), all_cpus) > 0);
+memset (cpus, 0, sizeof (cpus));
+if (node >= 0) {
+    snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist", node);
+    if (((f = fopen (path, "r")) == NULL) ||
+        (fgets (list, sizeof (list), f) == NULL)) {
+        if (f)
+            fclose (f);
+        return sim_messagef (SCPE_ARG, "NUMA node %d doesn't exist\n", node);
+        }
+    fclose (f);
+    for (cptr = list; *cptr && !sim_isspace (*cptr); ) {/* "0-7,16-23" */
+        unsigned long lo, hi;
+        char *eptr;
+
+        lo = hi = strtoul (cptr, &eptr, 10);
+        if (*eptr == '-')
+            hi = strtoul (eptr + 1, &eptr, 10);
+        for (; (lo <= hi) && (lo < SIM_MEM_MAXNODE); lo++)
+            cpus[lo / (8 * sizeof (unsigned long))] |= 1UL << (lo % (8 * sizeof (unsigned long)));
+        cptr = (*eptr == ',') ? eptr + 1 : eptr;
+        if (eptr == cptr)
+            break;
+        }
+    }
+else if (saved)
+    memcpy (cpus, all_cpus, sizeof (cpus));
+sim_mem_node = node;
+if ((node >= 0) || saved)
+    syscall (SYS_sched_setaffinity, 0, sizeof (cpus), cpus);
+for (rgn = sim_mem_regions; rgn != NULL; rgn = rgn->next)
+    if (rgn->mapped)
+        _sim_mem_policy (rgn);
+return SCPE_OK;
+}
+
+static void _sim_mem_show_backing (FILE *st)
+{
+SIM_MEM_REGION *rgn;
+t_bool hugetlb = FALSE;
+
+for (rgn = sim_mem_regions; rgn != NULL; rgn = rgn->next)
+    hugetlb |= rgn->hugetlb;
+if (sim_mem_backing == SIM_MEM_HUGE)
+    fprintf (st, "memory backing=HUGE (%s %uKB pages)\n", hugetlb ? "reserved" : "transparent",
+             (uint32)(_sim_mem_hugepagesize () / 1024));
+else
+    fprintf (st, "memory backing=NORMAL\n");
+}
+
+#else /* !defined (__linux__) */
+static t_bool _sim_mem_map (SIM_MEM_REGION *rgn)
+{
+void *base;
+
+rgn->msize = rgn->size;
+base = mmap (NULL, rgn->msize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+rgn->base = (base == MAP_FAILED) ? NULL : base;
+return (rgn->base != NULL);
+}
+
+static void _sim_mem_unmap (SIM_MEM_REGION *rgn)
+{
+munmap (rgn->base, rgn->msize);
+}
+
+static t_bool _sim_mem_untouched (const uint8 *addr, size_t len)
+{
+return FALSE;                                           /* no portable way to ask */
+}
+#endif
+
+#else /* no memory mapping */
+static t_bool _sim_mem_map (SIM_MEM_REGION *rgn)
+{
+return FALSE;
+}
+
+static void _sim_mem_unmap (SIM_MEM_REGION *rgn)
+{
+}
+
+static size_t _sim_mem_pagesize (void)
+{
+return 4096;
+}
+
+static t_bool _sim_mem_untouched (const uint8 *addr, size_t len)
+{
+return FALSE;
+}
+#endif
+
+static SIM_MEM_REGION *_sim_mem_find (const void *mem)
+{
+SIM_MEM_REGION *rgn;
+
+for (rgn = sim_mem_regions; rgn != NULL; rgn = rgn->next)
+    if (rgn->base == mem)
+        break;
+return rgn;
+}
+
+void *sim_mem_alloc (size_t size)
+{
+SIM_MEM_REGION *rgn = (SIM_MEM_REGION *)calloc (1, sizeof (*rgn));
+
+if (rgn == NULL)
+    return NULL;
+rgn->size = (size != 0) ? size : 1;
+rgn->mapped = _sim_mem_map (rgn);
+if (!rgn->mapped)
+    rgn->base = calloc (1, rgn->size);
+if (rgn->base == NULL) {
+    free (rgn);
+    return NULL;
+    }
+rgn->next = sim_mem_regions;
+sim_mem_regions = rgn;
+return rgn->base;
+}
+
+void sim_mem_free (void *mem)
+{
+SIM_MEM_REGION **prgn, *rgn;
+
+if (mem == NULL)
+    return;
+for (prgn = &sim_mem_regions; (rgn = *prgn) != NULL; prgn = &rgn->next)
+    if (rgn->base == mem)
+        break;
+if (rgn == NULL) {                                      /* not ours? */
+    free (mem);
+    return;
+    }
+*prgn = rgn->next;
+if (rgn->mapped)
+    _sim_mem_unmap (rgn);
+else
+    free (rgn->base);
+free (rgn);
+}
+
+size_t sim_mem_size (const void *mem)
+{
+SIM_MEM_REGION *rgn = _sim_mem_find (mem);
+
+return (rgn != NULL) ? rgn->size : 0;
+}
+
+t_bool sim_mem_untouched (const void *mem, size_t offset, size_t len)
+{
+SIM_MEM_REGION *rgn = _sim_mem_find (mem);
+
+if ((rgn == NULL) || !rgn->mapped || (offset >= rgn->size))
+    return FALSE;
+if (len > rgn->size - offset)
+    len = rgn->size - offset;
+return _sim_mem_untouched ((const uint8 *)mem + offset, len);
+}
+
+/* Resize: only pages that have been touched are copied */
+
+void *sim_mem_realloc (void *mem, size_t size)
+{
+size_t pagesize = _sim_mem_pagesize ();
+size_t off, len, old = sim_mem_size (mem);
+void *nmem = sim_mem_alloc (size);
+
+if ((nmem == NULL) || (mem == NULL))
+    return nmem;
+if (old > size)
+    old = size;
+for (off = 0; off < old; off += len) {
+    len = (old - off < pagesize) ? old - off : pagesize;
+    if (!sim_mem_untouched (mem, off, len))
+        memcpy ((uint8 *)nmem + off, (uint8 *)mem + off, len);
+    }
+sim_mem_free (mem);
+return nmem;
+}
+
+/* SET/SHOW <cpu> MEMBACKING and NUMANODE, for CPUs using sim_mem_alloc */
+
+t_stat sim_set_mem_backing (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+int32 backing;
+
+if (cptr == NULL)
+    return SCPE_MISVAL;
+if (MATCH_CMD (cptr, "HUGE") == 0)
+    backing = SIM_MEM_HUGE;
+else if (MATCH_CMD (cptr, "NORMAL") == 0)
+    backing = SIM_MEM_NORMAL;
+else
+    return sim_messagef (SCPE_ARG, "Unknown memory backing: %s\n", cptr);
+#if defined (__linux__)
+return _sim_mem_set_backing (backing);
+#else
+if (backing == SIM_MEM_HUGE)
+    return sim_messagef (SCPE_NOFNC, "Huge page memory backing is not available on this host\n");
+return SCPE_OK;
+#endif
+}
+
+t_stat sim_show_mem_backing (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+#if defined (__linux__)
+_sim_mem_show_backing (st);
+#else
+fprintf (st, "memory backing=%s\n", (sim_mem_backing == SIM_MEM_HUGE) ? "HUGE" : "NORMAL");
+#endif
+return SCPE_OK;
+}
+
+t_stat sim_set_numa_node (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
+{
+int32 node = -1;
+t_stat r;
+
+if (val) {                                              /* NUMANODE=n? */
+    if (cptr == NULL)
+        return SCPE_MISVAL;
+    node = (int32) get_uint (cptr, 10, SIM_MEM_MAXNODE - 1, &r);
+    if (r != SCPE_OK)
+        return sim_messagef (SCPE_ARG, "Invalid NUMA node: %s\n", cptr);
+    }
+#if defined (__linux__)
+return _sim_mem_set_node (node);
+#else
+if (node >= 0)
+    return sim_messagef (SCPE_NOFNC, "NUMA binding is not available on this host\n");
+return SCPE_OK;
+#endif
+}
+
+t_stat sim_show_numa_node (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
+{
+if (sim_mem_node >= 0)
+    fprintf (st, "NUMA node=%d\n", sim_mem_node);
+else
+    fprintf (st, "no NUMA binding\n");
+return SCPE_OK;
+}
+
 #if defined(__VAX)
 /*
  * We provide a 'basic' snprintf, which 'might' overrun a buffer, but
@@ -111,6 +111,15 @@ t_stat sim_shmem_open (const char *name, size_t size, SHMEM **shmem, void **addr
 void sim_shmem_close (SHMEM *shmem);
 int32 sim_shmem_atomic_add (int32 *ptr, int32 val);
 t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv);
+void *sim_mem_alloc (size_t size);
+void *sim_mem_realloc (void *mem, size_t size);
+void sim_mem_free (void *mem);
+size_t sim_mem_size (const void *mem);
+t_bool sim_mem_untouched (const void *mem, size_t offset, size_t len);
+t_stat sim_set_mem_backing (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+t_stat sim_show_mem_backing (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+t_stat sim_set_numa_node (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
+t_stat sim_show_numa_node (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
 extern int sim_check_source (int argc, char **argv);
 
 extern t_bool sim_taddr_64;         /* t_addr is > 32b and Large File Support available */
@@ -46,10 +46,23 @@
 static t_stat commentParse(DISK_INFO *myDisk, uint8 comment[], uint32 buffLen);
 static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose);
 static t_stat diskFormat(DISK_INFO *myDisk);
+static void diskFreeImage(DISK_INFO *myDisk);
+static void diskUnitFlush(UNIT *uptr);
+
+static DISK_INFO *diskFlushList = NULL;    /* In-memory images flushed through their unit */
 
 /* Open an existing IMD disk image.  It will be opened and parsed, and after this
  * call, will be ready for sector read/write. The result is the corresponding
  * DISK_INFO or NULL if an error occurred.
+ *
+ * When the unit is attached with the -M switch, the whole image is decoded into
+ * memory.  Sector reads, writes and track formats are then served from memory,
+ * compressed sectors are writable, and the image is re-encoded to the file by
+ * diskFlush().  When the attached unit can be found on the device, diskFlush()
+ * is installed as the unit's io_flush routine, so the image is written back
+ * whenever SCP flushes attached files: periodically while running and each
+ * time the simulator stops, so the file is current at the sim> prompt and for
+ * SAVE.  diskClose() writes any remaining changes.
  */
 DISK_INFO *diskOpenEx(FILE *fileref, uint32 isVerbose, DEVICE *device, uint32 debugmask, uint32 verbosedebugmask)
 {
@@ -65,10 +78,32 @@ DISK_INFO *diskOpenEx(FILE *fileref, uint32 isVerbose, DEVICE *device, uint32 de
     myDisk->device = device;
     myDisk->debugmask = debugmask;
     myDisk->verbosedebugmask = verbosedebugmask;
+    if (sim_switches & SWMASK ('M'))
+        myDisk->flags = FD_FLAG_IN_MEMORY;
+    if (device != NULL) {
+        uint32 i;
+
+        for (i = 0; i < device->numunits; i++) {
+            if ((device->units[i].flags & UNIT_ATT) && (device->units[i].fileref == fileref)) {
+                myDisk->unit = &device->units[i];
+                break;
+            }
+        }
+    }
+    if ((myDisk->unit != NULL) ? (myDisk->unit->flags & UNIT_RO) : (sim_switches & SWMASK ('R')))
+        myDisk->flags |= FD_FLAG_READONLY;
 
     if (diskParse(myDisk, isVerbose) != SCPE_OK) {
+        diskFreeImage(myDisk);
         free(myDisk);
-        myDisk = NULL;
+        return NULL;
+    }
+
+    if ((myDisk->flags & FD_FLAG_IN_MEMORY) && !(myDisk->flags & FD_FLAG_READONLY) &&
+        (myDisk->unit != NULL) && (myDisk->unit->io_flush == NULL)) {
+        myDisk->unit->io_flush = diskUnitFlush;
+        myDisk->next = diskFlushList;
+        diskFlushList = myDisk;
     }
 
     return myDisk;
@@ -113,6 +148,43 @@ static uint32 headerOk(IMD_HEADER imd) {
     return (imd.cyl < MAX_CYL) && (imd.head < MAX_HEAD);
 }
 
+/* Release the decoded sector data and comment of an in-memory image. */
+static void diskFreeImage(DISK_INFO *myDisk)
+{
+    uint32 cyl, head;
+
+    for (cyl = 0; cyl < MAX_CYL; cyl++) {
+        for (head = 0; head < MAX_HEAD; head++) {
+            free(myDisk->track[cyl][head].data);
+            myDisk->track[cyl][head].data = NULL;
+        }
+    }
+    free(myDisk->comment);
+    myDisk->comment = NULL;
+    myDisk->commentLen = 0;
+}
+
+/* Keep a copy of the comment, including the 0x1A marker, so that an in-memory
+ * image can be re-encoded.  The file is left positioned after the marker.
+ */
+static t_stat commentSave(DISK_INFO *myDisk)
+{
+    long commentLen = ftell(myDisk->file);
+
+    if (commentLen < 0)
+        return SCPE_OPENERR;
+    myDisk->comment = (uint8 *)malloc(commentLen + 1);
+    if (myDisk->comment == NULL) {
+        sim_printf("%s: %s(): memory allocation failure.\n", __FILE__, __FUNCTION__);
+        return SCPE_MEM;
+    }
+    rewind(myDisk->file);
+    myDisk->commentLen = (uint32)sim_fread(myDisk->comment, 1, commentLen, myDisk->file);
+    if (myDisk->commentLen != (uint32)commentLen)
+        return SCPE_OPENERR;
+    return SCPE_OK;
+}
+
 /* Parse an IMD image.  This sets up sim_imd to be able to do sector read/write and
  * track write.
  */
@@ -133,18 +205,23 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
         return (SCPE_OPENERR);
     }
 
+    diskFreeImage(myDisk);
     memset(myDisk->track, 0, (sizeof(TRACK_INFO)*MAX_CYL*MAX_HEAD));
 
     if (commentParse(myDisk, comment, sizeof(comment)) != SCPE_OK) {
         return (SCPE_OPENERR);
     }
 
+    if ((myDisk->flags & FD_FLAG_IN_MEMORY) && (commentSave(myDisk) != SCPE_OK)) {
+        return (SCPE_OPENERR);
+    }
+
     if(isVerbose)
         sim_printf("%s\n", comment);
 
     myDisk->nsides = 1;
     myDisk->ntracks = 0;
-    myDisk->flags = 0;      /* Make sure all flags are clear. */
+    myDisk->flags &= (FD_FLAG_IN_MEMORY | FD_FLAG_READONLY);   /* Make sure all other flags are clear. */
 
     if(feof(myDisk->file)) {
         sim_printf("SIM_IMD: Disk image is blank, it must be formatted.\n");
@@ -178,6 +255,12 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
             return (SCPE_OPENERR);
         }
 
+        if (imd.nsects > MAX_SPT) {
+            sim_printf("SIM_IMD: Invalid sector count %d, a maximum of %d sectors per track are supported.\n",
+                imd.nsects, MAX_SPT);
+            return (SCPE_OPENERR);
+        }
+
         if((imd.head + 1) > myDisk->nsides) {
             myDisk->nsides = imd.head + 1;
         }
@@ -212,38 +295,39 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
         }
         sim_debug(myDisk->debugmask, myDisk->device, ", Start Sector=%d", myDisk->track[imd.cyl][imd.head].start_sector);
 
-        if(sectorHeadwithFlags & IMD_FLAG_SECT_HEAD_MAP) {
-            if (sim_fread(sectorHeadMap, 1, imd.nsects, myDisk->file) != imd.nsects) {
-                sim_printf("SIM_IMD: Corrupt file [Sector Head Map].\n");
+        /* The cylinder map precedes the head map in the IMD format */
+        if(sectorHeadwithFlags & IMD_FLAG_SECT_CYL_MAP) {
+            if (sim_fread(sectorCylMap, 1, imd.nsects, myDisk->file) != imd.nsects) {
+                sim_printf("SIM_IMD: Corrupt file [Sector Cyl Map].\n");
                 return (SCPE_OPENERR);
             }
-            sim_debug(myDisk->debugmask, myDisk->device, "\tSector Head Map: ");
+            sim_debug(myDisk->debugmask, myDisk->device, "\tSector Cyl Map: ");
             for(i=0;i<imd.nsects;i++) {
-                sim_debug(myDisk->debugmask, myDisk->device, "%d ", sectorHeadMap[i]);
+                sim_debug(myDisk->debugmask, myDisk->device, "%d ", sectorCylMap[i]);
             }
             sim_debug(myDisk->debugmask, myDisk->device, "\n");
         } else {
-            /* Default Head is physical head for each sector */
+            /* Default Cyl Map is physical cylinder for each sector */
             for(i=0;i<imd.nsects;i++) {
-                sectorHeadMap[i] = imd.head;
-            };
+                sectorCylMap[i] = imd.cyl;
+            }
         }
 
-        if(sectorHeadwithFlags & IMD_FLAG_SECT_CYL_MAP) {
-            if (sim_fread(sectorCylMap, 1, imd.nsects, myDisk->file) != imd.nsects) {
-                sim_printf("SIM_IMD: Corrupt file [Sector Cyl Map].\n");
+        if(sectorHeadwithFlags & IMD_FLAG_SECT_HEAD_MAP) {
+            if (sim_fread(sectorHeadMap, 1, imd.nsects, myDisk->file) != imd.nsects) {
+                sim_printf("SIM_IMD: Corrupt file [Sector Head Map].\n");
                 return (SCPE_OPENERR);
             }
-            sim_debug(myDisk->debugmask, myDisk->device, "\tSector Cyl Map: ");
+            sim_debug(myDisk->debugmask, myDisk->device, "\tSector Head Map: ");
             for(i=0;i<imd.nsects;i++) {
-                sim_debug(myDisk->debugmask, myDisk->device, "%d ", sectorCylMap[i]);
+                sim_debug(myDisk->debugmask, myDisk->device, "%d ", sectorHeadMap[i]);
             }
             sim_debug(myDisk->debugmask, myDisk->device, "\n");
         } else {
-            /* Default Cyl Map is physical cylinder for each sector */
+            /* Default Head is physical head for each sector */
             for(i=0;i<imd.nsects;i++) {
-                sectorCylMap[i] = imd.cyl;
-            }
+                sectorHeadMap[i] = imd.head;
+            };
         }
 
         sim_debug(myDisk->debugmask, myDisk->device, "\nSector data at offset 0x%08lx\n", ftell(myDisk->file));
@@ -251,6 +335,25 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
         /* Build the table with location 0 being the start sector. */
         start_sect = myDisk->track[imd.cyl][imd.head].start_sector;
 
+        if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+            TRACK_INFO *track = &myDisk->track[imd.cyl][imd.head];
+
+            track->headFlags = sectorHeadwithFlags & (IMD_FLAG_SECT_HEAD_MAP | IMD_FLAG_SECT_CYL_MAP);
+            track->nslots = 0;
+            for(i=0;i<imd.nsects;i++) {
+                track->sectorMap[i] = sectorMap[i];
+                if ((sectorMap[i] - start_sect < MAX_SPT) && (sectorMap[i] - start_sect >= track->nslots))
+                    track->nslots = sectorMap[i] - start_sect + 1;
+            }
+            memset(track->sectorType, IMD_SECT_ABSENT, sizeof(track->sectorType));
+            free(track->data);
+            track->data = (uint8 *)calloc(track->nslots ? track->nslots : 1, sectorSize);
+            if (track->data == NULL) {
+                sim_printf("%s: %s(): memory allocation failure.\n", __FILE__, __FUNCTION__);
+                return (SCPE_MEM);
+            }
+        }
+
         /* Now read each sector */
         for(i=0;i<imd.nsects;i++) {
             TotalSectorCount++;
@@ -262,8 +365,11 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
             myDisk->track[imd.cyl][imd.head].logicalCyl[i] = sectorCylMap[i];
             switch(sectRecordType) {
                 case SECT_RECORD_UNAVAILABLE:   /* Data could not be read from the original media */
-                    if (sectorMap[i]-start_sect < MAX_SPT)
+                    if (sectorMap[i]-start_sect < MAX_SPT) {
                         myDisk->track[imd.cyl][imd.head].sectorOffsetMap[sectorMap[i]-start_sect] = 0xBADBAD;
+                        if (myDisk->flags & FD_FLAG_IN_MEMORY)
+                            myDisk->track[imd.cyl][imd.head].sectorType[sectorMap[i]-start_sect] = SECT_RECORD_UNAVAILABLE;
+                    }
                     else {
                         sim_printf("SIM_IMD: ERROR: Illegal sector offset %d\n", sectorMap[i]-start_sect);
                         return (SCPE_OPENERR);
@@ -276,7 +382,17 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
 /*                  sim_debug(myDisk->debugmask, myDisk->device, "Uncompressed Data\n"); */
                     if (sectorMap[i]-start_sect < MAX_SPT) {
                         myDisk->track[imd.cyl][imd.head].sectorOffsetMap[sectorMap[i]-start_sect] = ftell(myDisk->file);
-                        (void)sim_fseek(myDisk->file, sectorSize, SEEK_CUR);
+                        if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+                            TRACK_INFO *track = &myDisk->track[imd.cyl][imd.head];
+
+                            track->sectorType[sectorMap[i]-start_sect] = (uint8)sectRecordType;
+                            if (sim_fread(track->data + (sectorMap[i]-start_sect) * sectorSize, 1, sectorSize, myDisk->file) != sectorSize) {
+                                sim_printf("SIM_IMD: Corrupt file [Sector Data].\n");
+                                return (SCPE_OPENERR);
+                            }
+                        }
+                        else
+                            (void)sim_fseek(myDisk->file, sectorSize, SEEK_CUR);
                     }
                     else {
                         sim_printf("SIM_IMD: ERROR: Illegal sector offset %d\n", sectorMap[i]-start_sect);
@@ -289,11 +405,19 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
                 case SECT_RECORD_NORM_DAM_COMP_ERR: /* Compressed Normal Data with deleted address mark */
                     if (sectorMap[i]-start_sect < MAX_SPT) {
                         myDisk->track[imd.cyl][imd.head].sectorOffsetMap[sectorMap[i]-start_sect] = ftell(myDisk->file);
-                        myDisk->flags |= FD_FLAG_WRITELOCK; /* Write-protect the disk if any sectors are compressed. */
+                        if (!(myDisk->flags & FD_FLAG_IN_MEMORY))
+                            myDisk->flags |= FD_FLAG_WRITELOCK; /* Write-protect the disk if any sectors are compressed. */
                         if (1) {
                             uint8 cdata = (uint8)fgetc(myDisk->file);
 
                             sim_debug(myDisk->debugmask, myDisk->device, "Compressed Data = 0x%02x", cdata);
+                            if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+                                TRACK_INFO *track = &myDisk->track[imd.cyl][imd.head];
+
+                                /* Expand the sector, it is stored uncompressed until re-encoded */
+                                track->sectorType[sectorMap[i]-start_sect] = (uint8)(sectRecordType - 1);
+                                memset(track->data + (sectorMap[i]-start_sect) * sectorSize, cdata, sectorSize);
+                            }
                             }
                     }
                     else {
@@ -338,13 +462,122 @@ static t_stat diskParse(DISK_INFO *myDisk, uint32 isVerbose)
  */
 t_stat diskClose(DISK_INFO **myDisk)
 {
+    DISK_INFO **prev;
+    t_stat r;
+
     if(*myDisk == NULL)
         return SCPE_OPENERR;
+    r = diskFlush(*myDisk);
+    for (prev = &diskFlushList; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == *myDisk) {
+            *prev = (*myDisk)->next;
+            if ((*myDisk)->unit->io_flush == diskUnitFlush)
+                (*myDisk)->unit->io_flush = NULL;
+            break;
+        }
+    }
+    diskFreeImage(*myDisk);
     free(*myDisk);
     *myDisk = NULL;
+    return r;
+}
+
+/* Encode one sector of an in-memory image.  Sectors which are filled with a
+ * single byte value are written compressed.
+ */
+static void sectEncode(FILE *fileref, uint8 sectRecordType, const uint8 *data, uint32 sectsize)
+{
+    uint32 i;
+
+    if (sectRecordType == SECT_RECORD_UNAVAILABLE) {
+        fputc(SECT_RECORD_UNAVAILABLE, fileref);
+        return;
+    }
+    for (i = 1; (i < sectsize) && (data[i] == data[0]); i++);
+    if (i == sectsize) {
+        fputc(sectRecordType + 1, fileref);     /* Compressed form of the record type */
+        fputc(data[0], fileref);
+    } else {
+        fputc(sectRecordType, fileref);
+        sim_fwrite((void *)data, 1, sectsize, fileref);
+    }
+}
+
+/*
+ * Write an in-memory IMD image back to its file if it has been modified.  The
+ * original comment is kept, and the tracks are written in cylinder/head order.
+ * Images which are not held in memory are always up to date.
+ */
+t_stat diskFlush(DISK_INFO *myDisk)
+{
+    FILE *fileref;
+    IMD_HEADER track_header;
+    uint32 cyl, head, i;
+
+    if(myDisk == NULL)
+        return SCPE_OPENERR;
+    if ((myDisk->flags & (FD_FLAG_IN_MEMORY | FD_FLAG_DIRTY)) != (FD_FLAG_IN_MEMORY | FD_FLAG_DIRTY))
+        return SCPE_OK;
+
+    fileref = myDisk->file;
+    sim_debug(myDisk->debugmask, myDisk->device, "Writing in-memory image, %d tracks\n", myDisk->ntracks);
+
+    rewind(fileref);
+    if (sim_set_fsize(fileref, 0) == -1) {
+        sim_printf("SIM_IMD: Error rewriting disk image.\n");
+        return SCPE_IOERR;
+    }
+    sim_fwrite(myDisk->comment, 1, myDisk->commentLen, fileref);
+
+    for (cyl = 0; cyl < MAX_CYL; cyl++) {
+        for (head = 0; head < MAX_HEAD; head++) {
+            TRACK_INFO *track = &myDisk->track[cyl][head];
+            uint8 sectsize = 0;
+
+            if (track->nsects == 0)
+                continue;
+            for (i = (track->sectsize >> 8); i; i >>= 1)
+                sectsize++;
+            track_header.mode = track->mode;
+            track_header.cyl = (uint8)cyl;
+            track_header.head = (uint8)(head | track->headFlags);
+            track_header.nsects = track->nsects;
+            track_header.sectsize = sectsize;
+            sim_fwrite(&track_header, 1, sizeof(IMD_HEADER), fileref);
+            sim_fwrite(track->sectorMap, 1, track->nsects, fileref);
+            if (track->headFlags & IMD_FLAG_SECT_CYL_MAP)
+                sim_fwrite(track->logicalCyl, 1, track->nsects, fileref);
+            if (track->headFlags & IMD_FLAG_SECT_HEAD_MAP)
+                sim_fwrite(track->logicalHead, 1, track->nsects, fileref);
+            for (i = 0; i < track->nsects; i++) {
+                uint32 slot = track->sectorMap[i] - track->start_sector;
+
+                sectEncode(fileref, track->sectorType[slot], track->data + slot * track->sectsize, track->sectsize);
+            }
+        }
+    }
+
+    if ((fflush(fileref) != 0) || ferror(fileref)) {
+        sim_printf("SIM_IMD: Error writing disk image.\n");
+        return SCPE_IOERR;
+    }
+    myDisk->flags &= ~FD_FLAG_DIRTY;
     return SCPE_OK;
 }
 
+/* Unit io_flush routine for in-memory images, called by sim_flush_buffered_files() */
+static void diskUnitFlush(UNIT *uptr)
+{
+    DISK_INFO *myDisk;
+
+    for (myDisk = diskFlushList; myDisk != NULL; myDisk = myDisk->next) {
+        if (myDisk->unit == uptr) {
+            diskFlush(myDisk);
+            break;
+        }
+    }
+}
+
 #define MAX_COMMENT_LEN 256
 
 /*
@@ -466,7 +699,16 @@ uint32 imdGetSides(DISK_INFO *myDisk)
 uint32 imdIsWriteLocked(DISK_INFO *myDisk)
 {
     if(myDisk != NULL) {
-        return((myDisk->flags & FD_FLAG_WRITELOCK) ? 1 : 0);
+        return((myDisk->flags & (FD_FLAG_WRITELOCK | FD_FLAG_READONLY)) ? 1 : 0);
+    }
+
+    return (0);
+}
+
+uint32 imdIsInMemory(DISK_INFO *myDisk)
+{
+    if(myDisk != NULL) {
+        return((myDisk->flags & FD_FLAG_IN_MEMORY) ? 1 : 0);
     }
 
     return (0);
@@ -534,6 +776,32 @@ t_stat sectRead(DISK_INFO *myDisk,
 
     start_sect = myDisk->track[Cyl][Head].start_sector;
 
+    if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+        TRACK_INFO *track = &myDisk->track[Cyl][Head];
+        uint32 slot = Sector - start_sect;
+
+        sim_debug(myDisk->debugmask, myDisk->device, "Reading C:%d/H:%d/S:%d, len=%d, in memory\n", Cyl, Head, Sector, buflen);
+
+        sectRecordType = (slot < track->nslots) ? track->sectorType[slot] : IMD_SECT_ABSENT;
+        switch(sectRecordType) {
+            case SECT_RECORD_NORM_ERR:      /* Normal Data with read error */
+            case SECT_RECORD_NORM_DAM_ERR:  /* Normal Data with deleted address mark with read error */
+                *flags |= IMD_DISK_IO_ERROR_CRC;
+                /* fall through */
+            case SECT_RECORD_NORM:          /* Normal Data */
+            case SECT_RECORD_NORM_DAM:      /* Normal Data with deleted address mark */
+                memcpy(buf, track->data + slot * track->sectsize, track->sectsize);
+                *readlen = track->sectsize;
+                break;
+            default:                        /* Unavailable or not on the track */
+                *flags |= IMD_DISK_IO_ERROR_GENERAL;
+                break;
+        }
+        if ((sectRecordType == SECT_RECORD_NORM_DAM) || (sectRecordType == SECT_RECORD_NORM_DAM_ERR))
+            *flags |= IMD_DISK_IO_DELETED_ADDR_MARK;
+        return(SCPE_OK);
+    }
+
     sectorFileOffset = myDisk->track[Cyl][Head].sectorOffsetMap[Sector-start_sect];
 
     sim_debug(myDisk->debugmask, myDisk->device, "Reading C:%d/H:%d/S:%d, len=%d, offset=0x%08x\n", Cyl, Head, Sector, buflen, sectorFileOffset);
@@ -628,6 +896,12 @@ t_stat sectWrite(DISK_INFO *myDisk,
         return(SCPE_IOERR);
     }
 
+    if(myDisk->flags & FD_FLAG_READONLY) {
+        sim_printf("Disk write-protected, the image is attached read-only.\n");
+        *flags = IMD_DISK_IO_ERROR_WPROT;
+        return(SCPE_IOERR);
+    }
+
     if(buflen < myDisk->track[Cyl][Head].sectsize) {
         sim_printf("%s: user buffer too short [buflen %i < sectsize %i]\n",
                    __FUNCTION__, buflen, myDisk->track[Cyl][Head].sectsize);
@@ -637,10 +911,6 @@ t_stat sectWrite(DISK_INFO *myDisk,
 
     start_sect = myDisk->track[Cyl][Head].start_sector;
 
-    sectorFileOffset = myDisk->track[Cyl][Head].sectorOffsetMap[Sector-start_sect];
-
-    (void)sim_fseek(myDisk->file, sectorFileOffset-1, SEEK_SET);
-
     if (*flags & IMD_DISK_IO_ERROR_GENERAL) {
         sectRecordType = SECT_RECORD_UNAVAILABLE;
     } else if (*flags & IMD_DISK_IO_ERROR_CRC) {
@@ -655,6 +925,26 @@ t_stat sectWrite(DISK_INFO *myDisk,
         sectRecordType = SECT_RECORD_NORM;
     }
 
+    if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+        TRACK_INFO *track = &myDisk->track[Cyl][Head];
+        uint32 slot = Sector - start_sect;
+
+        if ((slot >= track->nslots) || (track->sectorType[slot] == IMD_SECT_ABSENT)) {
+            sim_debug(myDisk->debugmask, myDisk->device, "%s: sector not on track\n", __FUNCTION__);
+            *flags = IMD_DISK_IO_ERROR_GENERAL;
+            return(SCPE_IOERR);
+        }
+        track->sectorType[slot] = sectRecordType;
+        memcpy(track->data + slot * track->sectsize, buf, track->sectsize);
+        myDisk->flags |= FD_FLAG_DIRTY;
+        *writelen = track->sectsize;
+        return(SCPE_OK);
+    }
+
+    sectorFileOffset = myDisk->track[Cyl][Head].sectorOffsetMap[Sector-start_sect];
+
+    (void)sim_fseek(myDisk->file, sectorFileOffset-1, SEEK_SET);
+
     fputc(sectRecordType, myDisk->file);
     sim_fwrite(buf, 1, myDisk->track[Cyl][Head].sectsize, myDisk->file);
     *writelen = myDisk->track[Cyl][Head].sectsize;
@@ -709,18 +999,39 @@ t_stat trackWrite(DISK_INFO *myDisk,
         return(SCPE_IOERR);
     }
 
-    if(myDisk->flags & FD_FLAG_WRITELOCK) {
+    if(myDisk->flags & (FD_FLAG_WRITELOCK | FD_FLAG_READONLY)) {
         sim_printf("Disk write-protected, cannot format tracks.\n");
         *flags |= IMD_DISK_IO_ERROR_WPROT;
         return(SCPE_IOERR);
     }
 
+    if((Cyl >= MAX_CYL) || (Head >= MAX_HEAD)) {
+        sim_printf("SIM_IMD: ERROR: Cannot format C:%d/H:%d, track out of range.\n", Cyl, Head);
+        *flags |= IMD_DISK_IO_ERROR_GENERAL;
+        return(SCPE_IOERR);
+    }
+
     fileref = myDisk->file;
 
     sim_debug(myDisk->debugmask, myDisk->device, "Formatting C:%d/H:%d/N:%d, len=%d, Fill=0x%02x\n", Cyl, Head, numSectors, sectorLen, fillbyte);
 
+    /* Discard all in-memory tracks when formatting Cyl 0, Head 0 */
+    if((Cyl == 0) && (Head == 0) && (myDisk->flags & FD_FLAG_IN_MEMORY))
+    {
+        uint32 cyl, head;
+
+        for (cyl = 0; cyl < MAX_CYL; cyl++) {
+            for (head = 0; head < MAX_HEAD; head++) {
+                free(myDisk->track[cyl][head].data);
+            }
+        }
+        memset(myDisk->track, 0, (sizeof(TRACK_INFO)*MAX_CYL*MAX_HEAD));
+        myDisk->ntracks = 0;
+        myDisk->nsides = 1;
+        myDisk->flags |= FD_FLAG_DIRTY;
+    }
     /* Truncate the IMD file when formatting Cyl 0, Head 0 */
-    if((Cyl == 0) && (Head == 0))
+    else if((Cyl == 0) && (Head == 0))
     {
         /* Skip over IMD comment field. */
         commentParse(myDisk, NULL, 0);
@@ -759,6 +1070,63 @@ t_stat trackWrite(DISK_INFO *myDisk,
     }
     track_header.sectsize = sectsize;
 
+    if (myDisk->flags & FD_FLAG_IN_MEMORY) {
+        TRACK_INFO *track = &myDisk->track[Cyl][Head];
+        uint8 start_sect, nslots;
+
+        if ((numSectors == 0) || (numSectors > MAX_SPT)) {
+            sim_printf("SIM_IMD: ERROR: Cannot format C:%d/H:%d with %d sectors.\n", Cyl, Head, numSectors);
+            *flags |= IMD_DISK_IO_ERROR_GENERAL;
+            return(SCPE_IOERR);
+        }
+        start_sect = sectorMap[0];
+        for (i = 0; i < numSectors; i++) {
+            if (sectorMap[i] < start_sect)
+                start_sect = sectorMap[i];
+        }
+        nslots = 0;
+        for (i = 0; i < numSectors; i++) {
+            if (sectorMap[i] - start_sect >= MAX_SPT) {
+                sim_printf("SIM_IMD: ERROR: Illegal sector offset %d\n", sectorMap[i] - start_sect);
+                *flags |= IMD_DISK_IO_ERROR_GENERAL;
+                return(SCPE_IOERR);
+            }
+            if (sectorMap[i] - start_sect >= nslots)
+                nslots = sectorMap[i] - start_sect + 1;
+        }
+        /* A track formatted again keeps its buffer if the size is unchanged */
+        if ((track->data == NULL) || (nslots * sectorLen != track->nslots * track->sectsize)) {
+            uint8 *data = (uint8 *)malloc(nslots * sectorLen);
+
+            if (data == NULL) {
+                sim_printf("%s: %s(): memory allocation failure.\n", __FILE__, __FUNCTION__);
+                return SCPE_MEM;
+            }
+            free(track->data);
+            track->data = data;
+        }
+        if (track->nsects == 0)
+            myDisk->ntracks++;
+        track->start_sector = start_sect;
+        track->nslots = nslots;
+        memset(track->data, fillbyte, nslots * sectorLen);
+        memset(track->sectorType, IMD_SECT_ABSENT, sizeof(track->sectorType));
+        track->mode = mode;
+        track->nsects = numSectors;
+        track->sectsize = sectorLen;
+        track->headFlags = 0;
+        for (i = 0; i < numSectors; i++) {
+            track->sectorMap[i] = sectorMap[i];
+            track->logicalHead[i] = Head;
+            track->logicalCyl[i] = Cyl;
+            track->sectorType[sectorMap[i] - track->start_sector] = SECT_RECORD_NORM;
+        }
+        if (Head + 1 > myDisk->nsides)
+            myDisk->nsides = Head + 1;
+        myDisk->flags |= FD_FLAG_DIRTY;
+        return(SCPE_OK);
+    }
+
     /* Forward to end of the file, write track header and sector map. */
     (void)sim_fseek(myDisk->file, 0, SEEK_END);
     sim_fwrite(&track_header, 1, sizeof(IMD_HEADER), fileref);
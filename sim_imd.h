@@ -67,6 +67,11 @@ typedef struct {
 #define MAX_SPT     26
 
 #define FD_FLAG_WRITELOCK   1
+#define FD_FLAG_IN_MEMORY   2   /* Image decoded into memory, see diskOpenEx() */
+#define FD_FLAG_DIRTY       4   /* In-memory image modified since last diskFlush() */
+#define FD_FLAG_READONLY    8   /* Image file attached read-only */
+
+#define IMD_SECT_ABSENT     0xFF    /* In-memory sector type for unused sector slots */
 
 #define IMD_DISK_IO_ERROR_GENERAL       (1 << 0)    /* General data error. */
 #define IMD_DISK_IO_ERROR_CRC           (1 << 1)    /* Data read/written, but got a CRC error. */
@@ -98,9 +103,15 @@ typedef struct {
     uint8 start_sector;
     uint8 logicalHead[MAX_SPT];
     uint8 logicalCyl[MAX_SPT];
+    /* The following are only used for images held in memory */
+    uint8 headFlags;                /* IMD_FLAG_SECT_HEAD_MAP/IMD_FLAG_SECT_CYL_MAP */
+    uint8 nslots;                   /* Sector slots in data[] */
+    uint8 sectorMap[MAX_SPT];       /* Logical sector number in physical order */
+    uint8 sectorType[MAX_SPT];      /* Uncompressed record type, indexed by Sector-start_sector */
+    uint8 *data;                    /* Decoded sector data, indexed by Sector-start_sector */
 } TRACK_INFO;
 
-typedef struct {
+typedef struct DISK_INFO {
     FILE *file;
     uint32 ntracks;
     uint8 nsides;
@@ -108,15 +119,21 @@ typedef struct {
     DEVICE *device;
     uint32 debugmask;
     uint32 verbosedebugmask;
+    uint8 *comment;                 /* In-memory images: comment including 0x1A marker */
+    uint32 commentLen;
+    UNIT *unit;                     /* In-memory images: unit flushed through io_flush */
+    struct DISK_INFO *next;         /* In-memory images: next image with an io_flush hook */
     TRACK_INFO track[MAX_CYL][MAX_HEAD];
 } DISK_INFO;
 
 extern DISK_INFO *diskOpen(FILE *fileref, uint32 isVerbose);
 extern DISK_INFO *diskOpenEx(FILE *fileref, uint32 isVerbose, DEVICE *device, uint32 debugmask, uint32 verbosedebugmask);
 extern t_stat diskClose(DISK_INFO **myDisk);
+extern t_stat diskFlush(DISK_INFO *myDisk);
 extern t_stat diskCreate(FILE *fileref, const char *ctlr_comment);
 extern uint32 imdGetSides(DISK_INFO *myDisk);
 extern uint32 imdIsWriteLocked(DISK_INFO *myDisk);
+extern uint32 imdIsInMemory(DISK_INFO *myDisk);
 
 extern t_stat sectSeek(DISK_INFO *myDisk, uint32 Cyl, uint32 Head);
 extern t_stat sectRead(DISK_INFO *myDisk, uint32 Cyl, uint32 Head, uint32 Sector, uint8 *buf, uint32 buflen, uint32 *flags, uint32 *readlen);
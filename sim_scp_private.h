@@ -208,6 +208,7 @@ extern int32 sim_asynch_inst_latency;
 /* Other compiler environment, then don't worry about thread local storage. */
 /* It is primarily used only used in debugging messages */
 #define AIO_TLS
+#define AIO_TLS_NONE 1      /* Not truly thread local */
 #endif
 #define AIO_INIT                                                  \
     do {                                                          \
@@ -323,6 +324,7 @@ extern int32 sim_asynch_inst_latency;
           AIO_LOCK;                                                    \
           }                                                            \
         pthread_cond_signal (&sim_asynch_wake);                        \
+        sim_idle_wakeup ();                                            \
         }                                                              \
       AIO_UNLOCK;                                                      \
       sim_asynch_check = 0;     /* try to force check */               \
@@ -415,6 +417,7 @@ typedef struct MFILE {
 /* Private SCP only APIs */
 
 t_stat _sim_os_putchar (int32 out);
+t_stat _sim_con_putchar (int32 out);
 t_bool _sim_running_as_root (void);
 
 /* Memory File Support */
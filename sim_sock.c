@@ -78,6 +78,7 @@ extern "C" {
    sim_connect_sock_ex  connect a socket to a remote destination
    sim_accept_conn      accept connection
    sim_read_sock        read from socket
+   sim_read_sock_batch  read waiting datagrams from socket
    sim_write_sock       write from socket
    sim_close_sock       close socket
    sim_setnonblock      set socket non-blocking
@@ -1328,6 +1329,26 @@ return 0;
 }
 
 
+static int _sim_read_sock_error (void)
+{
+int err = WSAGetLastError ();
+
+if (err == WSAEWOULDBLOCK)                              /* no data */
+    return 0;
+#if defined(EAGAIN)
+if (err == EAGAIN)                                      /* no data */
+    return 0;
+#endif
+if ((err != WSAETIMEDOUT) &&                            /* expected errors after a connect failure */
+    (err != WSAEHOSTUNREACH) &&
+    (err != WSAECONNREFUSED) &&
+    (err != WSAECONNABORTED) &&
+    (err != WSAECONNRESET) &&
+    (err != WSAEINTR))                                  /* or a close of a blocking read */
+    sim_err_sock (INVALID_SOCKET, "read");
+return -1;
+}
+
 int sim_read_sock (SOCKET sock, char *buf, int nbytes)
 {
 int rbytes, err;
@@ -1337,24 +1358,54 @@ if (rbytes == 0) {                                       /* disconnect */
     err = WSAGetLastError ();
     return -1;
     }
-if (rbytes == SOCKET_ERROR) {
-    err = WSAGetLastError ();
-    if (err == WSAEWOULDBLOCK)                          /* no data */
-        return 0;
-#if defined(EAGAIN)
-    if (err == EAGAIN)                                  /* no data */
-        return 0;
-#endif
-    if ((err != WSAETIMEDOUT) &&                        /* expected errors after a connect failure */
-        (err != WSAEHOSTUNREACH) &&
-        (err != WSAECONNREFUSED) &&
-        (err != WSAECONNABORTED) &&
-        (err != WSAECONNRESET) &&
-        (err != WSAEINTR))                              /* or a close of a blocking read */
-        sim_err_sock (INVALID_SOCKET, "read");
-    return -1;
+if (rbytes == SOCKET_ERROR)
+    return _sim_read_sock_error ();
+return rbytes;
+}
+
+/* Read the datagrams waiting on a (non-blocking) datagram socket
+
+   Up to count datagrams are read, each into bufs[i] (nbytes long), with
+   its length stored in lens[i].  Returns the number of datagrams read, 0
+   when none are waiting, or -1 if the socket failed before any were read.
+   Where recvmmsg() is available the whole batch takes one system call.
+*/
+
+int sim_read_sock_batch (SOCKET sock, char **bufs, int *lens, int count, int nbytes)
+{
+int i, rbytes;
+#if defined(MSG_WAITFORONE)
+struct mmsghdr msgs[SIM_SOCK_BATCH_MAX];
+struct iovec iovs[SIM_SOCK_BATCH_MAX];
+
+if (count > SIM_SOCK_BATCH_MAX)
+    count = SIM_SOCK_BATCH_MAX;
+memset (msgs, 0, count * sizeof (*msgs));
+for (i = 0; i < count; i++) {
+    iovs[i].iov_base = bufs[i];
+    iovs[i].iov_len = nbytes;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
     }
+rbytes = recvmmsg (sock, msgs, count, MSG_DONTWAIT, NULL);
+if (rbytes == SOCKET_ERROR)
+    return _sim_read_sock_error ();
+for (i = 0; i < rbytes; i++)
+    lens[i] = (int)msgs[i].msg_len;
 return rbytes;
+#else
+for (i = 0; i < count; i++) {
+    rbytes = recv (sock, bufs[i], nbytes, 0);
+    if (rbytes == SOCKET_ERROR) {
+        rbytes = _sim_read_sock_error ();
+        if ((rbytes < 0) && (i == 0))                   /* failed before reading any? */
+            return rbytes;
+        break;
+        }
+    lens[i] = rbytes;
+    }
+return i;
+#endif
 }
 
 int sim_write_sock (SOCKET sock, const char *msg, int nbytes)
@@ -148,6 +148,8 @@ SOCKET sim_accept_conn_ex (SOCKET master, char **connectaddr, int opt_flags);
 #define sim_accept_conn(master, connectaddr) sim_accept_conn_ex(master, connectaddr, 0)
 int sim_check_conn (SOCKET sock, int rd);
 int sim_read_sock (SOCKET sock, char *buf, int nbytes);
+#define SIM_SOCK_BATCH_MAX          64              /* max datagrams per sim_read_sock_batch */
+int sim_read_sock_batch (SOCKET sock, char **bufs, int *lens, int count, int nbytes);
 int sim_write_sock (SOCKET sock, const char *msg, int nbytes);
 void sim_close_sock (SOCKET sock);
 const char *sim_get_err_sock (const char *emsg);
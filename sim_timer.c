@@ -69,7 +69,8 @@
    sim_os_ms_sleep -        sleep specified number of milliseconds
    sim_idle_ms_sleep -      sleep specified number of milliseconds
                             or until awakened by an asynchronous
-                            event
+                            event or host input
+   sim_idle_wakeup -        end an idle sleep in progress
    sim_timespec_diff        subtract two timespec values
    sim_timer_activate_after schedule unit for specific time
    sim_timer_activate_time  determine activation time
@@ -88,6 +89,17 @@
 #include "sim_defs.h"
 
 #include "sim_scp_private.h"
+#include "sim_tmxr.h"
+
+#if !defined(_WIN32) && !defined(VMS)
+#define SIM_IDLE_POLL       /* idle waits on host descriptors via poll() */
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+#endif
 
 #define SIM_INTERNAL_CLK (SIM_NTIMERS+(1<<30))
 #define SIM_INTERNAL_UNIT sim_internal_timer_unit
@@ -189,6 +201,17 @@ static double sim_throt_inst_start;
 static uint32 sim_throt_sleep_time = 0;
 static int32 sim_throt_wait = 0;
 static uint32 sim_throt_delay = 3;
+static t_bool sim_throt_paced = FALSE;                  /* paced to a host deadline schedule */
+static uint32 sim_throt_slice = SIM_THROT_SLICE_DFLT;   /* paced slice length (usecs) */
+static double sim_throt_pace_time;                      /* host time origin of the schedule */
+static double sim_throt_pace_inst;                      /* instruction count at that origin */
+static double sim_throt_win_time;                       /* start of rate observation window */
+static double sim_throt_win_inst;
+static double sim_throt_obs_cps;                        /* observed rate over the last window */
+static double sim_throt_pace_slept;                     /* total time slept (secs) */
+static double sim_throt_pace_max_lag;                   /* worst lag behind schedule (secs) */
+static uint32 sim_throt_pace_sleeps;                    /* sleeps taken */
+static uint32 sim_throt_pace_restarts;                  /* schedule restarts after falling behind */
 #define CLK_TPS 100
 #define CLK_INIT (sim_precalibrate_ips/CLK_TPS)
 static int32 sim_int_clk_tps;
@@ -319,7 +342,210 @@ return sim_os_sleep_min_ms;
 
 #endif /* defined(MS_MIN_GRANULARITY) && (MS_MIN_GRANULARITY != 1) */
 
+#if defined(SIM_IDLE_POLL)
+/*
+   Event-driven idle wait.
+
+   The idle sleep is a single poll() (ppoll() with a nanosecond timeout on
+   Linux) on a wakeup descriptor and on the host descriptors on which
+   console, multiplexer, and remote console input can arrive.  The wait
+   ends at the timeout (the next pending event), when an asynchronous I/O
+   completion posts the wakeup descriptor (see sim_idle_wakeup), or when
+   input becomes available.  In the last case, the unit that polls for that
+   input is activated immediately when sim_idle returns, so the input is
+   seen without waiting for the unit's next scheduled poll.
+
+   A descriptor that ended a wait is not watched again until its input
+   has been consumed.  This keeps a device which leaves its input pending
+   (e.g. a disabled line or a full receive buffer) from turning idle time
+   into a busy loop; its unit still sees the input on its regular poll.
+
+   Descriptors are only watched when sim_idle is waiting.  The other users
+   of sim_idle_ms_sleep (host timing calibration and throttling) see a
+   plain timed sleep.
+*/
+
+#define SIM_IDLE_MAX_FDS 256
+
+static int sim_idle_wake_fd[2] = {-1, -1};          /* [0] read, [1] write (same for eventfd) */
+static t_bool sim_idle_io = FALSE;                  /* watch I/O descriptors during this wait */
+static UNIT *sim_idle_ready[SIM_IDLE_MAX_FDS];      /* units with input found by the last wait */
+static int sim_idle_ready_count = 0;
+static SOCKET sim_idle_fired[SIM_IDLE_MAX_FDS];     /* descriptors with input not yet consumed */
+static int sim_idle_fired_count = 0;
+static uint32 sim_idle_io_wakeups = 0;              /* waits ended by host input */
+static uint32 sim_idle_async_wakeups = 0;           /* waits ended by asynch I/O completion */
+
+static void _sim_idle_wake_open (void)
+{
+#if defined(__linux__)
+sim_idle_wake_fd[0] = sim_idle_wake_fd[1] = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+if (pipe (sim_idle_wake_fd) == 0) {
+    fcntl (sim_idle_wake_fd[0], F_SETFL, fcntl (sim_idle_wake_fd[0], F_GETFL) | O_NONBLOCK);
+    fcntl (sim_idle_wake_fd[1], F_SETFL, fcntl (sim_idle_wake_fd[1], F_GETFL) | O_NONBLOCK);
+    }
+else
+    sim_idle_wake_fd[0] = sim_idle_wake_fd[1] = -1;
+#endif
+}
+
+/* End an idle wait in progress.  May be called from any thread. */
+
+void sim_idle_wakeup (void)
+{
+#if defined(__linux__)
+uint64_t one = 1;
+#else
+char one = 1;
+#endif
+
+if (sim_idle_wake_fd[1] != -1)
+    if (write (sim_idle_wake_fd[1], &one, sizeof (one)) < 0) {} /* full means a wakeup is already pending */
+}
+
+static void _sim_idle_wake_drain (void)
+{
+char buf[64];
+
+while (read (sim_idle_wake_fd[0], buf, sizeof (buf)) > 0)
+    ;
+}
+
+uint32 sim_idle_ms_sleep (unsigned int msec)
+{
+struct pollfd pfd[SIM_IDLE_MAX_FDS + 1];
+UNIT *uptrs[SIM_IDLE_MAX_FDS + 1];
+SOCKET fds[SIM_IDLE_MAX_FDS];
+UNIT *fd_uptrs[SIM_IDLE_MAX_FDS];
+struct timespec start, end;
+double delta_ms;
+int i, j, nfds = 0, count;
+t_bool woken = FALSE;
+
+if (sim_idle_wake_fd[0] == -1)
+    _sim_idle_wake_open ();
+if (sim_idle_wake_fd[0] != -1) {
+    pfd[nfds].fd = sim_idle_wake_fd[0];
+    pfd[nfds].events = POLLIN;
+    uptrs[nfds++] = NULL;
+    }
+sim_idle_ready_count = 0;
+if (sim_idle_fired_count) {                         /* recheck descriptors still holding input */
+    for (i = 0; i < sim_idle_fired_count; i++) {
+        pfd[nfds + i].fd = (int)sim_idle_fired[i];
+        pfd[nfds + i].events = POLLIN;
+        pfd[nfds + i].revents = 0;
+        }
+    if (poll (&pfd[nfds], sim_idle_fired_count, 0) < 0)
+        sim_idle_fired_count = 0;
+    for (i = j = 0; i < sim_idle_fired_count; i++)
+        if ((pfd[nfds + i].revents & POLLIN) &&     /* still unconsumed and */
+            !(pfd[nfds + i].revents & (POLLNVAL | POLLERR)))/* not closed or failed? */
+            sim_idle_fired[j++] = sim_idle_fired[i];/* keep it out of the wait */
+    sim_idle_fired_count = j;
+    }
+if (sim_idle_io) {
+    count = tmxr_idle_fds (fds, fd_uptrs, SIM_IDLE_MAX_FDS);
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < sim_idle_fired_count; j++)
+            if (fds[i] == sim_idle_fired[j])
+                break;
+        if (j < sim_idle_fired_count)               /* input still pending? */
+            continue;                               /* then leave it to the unit's poll */
+        pfd[nfds].fd = (int)fds[i];
+        pfd[nfds].events = POLLIN;
+        uptrs[nfds++] = fd_uptrs[i];
+        }
+    }
+clock_gettime (idle_clock, &start);
 #if defined(SIM_ASYNCH_IO)
+pthread_mutex_lock (&sim_asynch_lock);
+sim_idle_wait = TRUE;
+pthread_mutex_unlock (&sim_asynch_lock);
+#endif
+#if defined(__linux__)
+if (1) {
+    struct timespec timeout;
+
+    timeout.tv_sec = msec / 1000;
+    timeout.tv_nsec = (msec % 1000) * 1000000;
+    count = ppoll (pfd, nfds, &timeout, NULL);
+    }
+#else
+count = poll (pfd, nfds, (int)msec);
+#endif
+#if defined(SIM_ASYNCH_IO)
+pthread_mutex_lock (&sim_asynch_lock);
+sim_idle_wait = FALSE;
+pthread_mutex_unlock (&sim_asynch_lock);
+#endif
+clock_gettime (idle_clock, &end);
+for (i = 0; (count > 0) && (i < nfds); i++) {
+    if (pfd[i].revents == 0)
+        continue;
+    if (uptrs[i] == NULL) {                         /* wakeup descriptor? */
+        _sim_idle_wake_drain ();
+        woken = TRUE;
+        ++sim_idle_async_wakeups;
+        continue;
+        }
+    if ((pfd[i].revents & POLLIN) &&                /* data to consume? */
+        !(pfd[i].revents & (POLLNVAL | POLLERR)) &&
+        (sim_idle_fired_count < SIM_IDLE_MAX_FDS))
+        sim_idle_fired[sim_idle_fired_count++] = (SOCKET)pfd[i].fd;
+    for (j = 0; j < sim_idle_ready_count; j++)
+        if (sim_idle_ready[j] == uptrs[i])
+            break;
+    if (j == sim_idle_ready_count)
+        sim_idle_ready[sim_idle_ready_count++] = uptrs[i];
+    }
+if (sim_idle_ready_count)
+    ++sim_idle_io_wakeups;
+#if defined(SIM_ASYNCH_IO)
+if (woken) {
+    sim_asynch_check = 0;                 /* force check of asynch queue now */
+    AIO_UPDATE_QUEUE;
+    }
+#endif
+delta_ms = (_timespec_to_double (&end) - _timespec_to_double (&start)) * 1000.0;
+/* a NTP or other system time adjustment might have taken place   */
+/* while we were sleeping.  If time moved forward, we limit the   */
+/* returned value to 10x the requested sleep time.  If time moved */
+/* backwards, the return value is 0.                               */
+if (delta_ms < 0.0) {
+    ++sim_idle_backward_jumps;
+    sim_idle_backward_total += delta_ms;
+    return 0;
+    }
+if (delta_ms > 10.0 * msec) {
+    ++sim_idle_forward_jumps;
+    sim_idle_forward_total += delta_ms;
+    return (uint32)(10 * msec);
+    }
+return (uint32)(delta_ms + 0.5);
+}
+
+/* Activate the units whose input ended the last idle wait */
+
+static void _sim_idle_activate_ready (void)
+{
+int i, tmr;
+
+for (i = 0; i < sim_idle_ready_count; i++) {
+    UNIT *uptr = sim_idle_ready[i];
+
+    for (tmr = 0; tmr <= SIM_NTIMERS; tmr++)        /* never disturb a clock */
+        if (uptr == rtcs[tmr].clock_unit)
+            break;
+    if (tmr <= SIM_NTIMERS)
+        continue;
+    sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "host input pending for %s - polling now\n", sim_uname (uptr));
+    sim_activate_abs (uptr, 0);
+    }
+sim_idle_ready_count = 0;
+}
+#elif defined(SIM_ASYNCH_IO)
 uint32 sim_idle_ms_sleep (unsigned int msec)
 {
 struct timespec end_time, timeout_time;
@@ -368,6 +594,13 @@ uint32 sim_idle_ms_sleep (unsigned int msec)
 return sim_os_ms_sleep (msec);
 }
 #endif
+#if !defined(SIM_IDLE_POLL)
+/* Idle waits here are already ended by the asynch I/O wakeup condition */
+
+void sim_idle_wakeup (void)
+{
+}
+#endif
 
 /* Mark the need for the sim_os_set_thread_priority routine, */
 /* allowing the feature and/or platform dependent code to provide it */
@@ -1241,6 +1474,12 @@ if (sim_idle_enab) {
         fprintf (st, "Forward Time Jumps while Idle:  %u\n", sim_idle_forward_jumps);
         fprintf (st, "Total Forward Adjustments:      %s milliseconds\n", sim_fmt_numeric (sim_idle_forward_total));
         }
+#if defined(SIM_IDLE_POLL)
+    if (sim_idle_io_wakeups)
+        fprintf (st, "Idle Waits Ended by Input:      %u\n", sim_idle_io_wakeups);
+    if (sim_idle_async_wakeups)
+        fprintf (st, "Idle Waits Ended by Async I/O:  %u\n", sim_idle_async_wakeups);
+#endif
     }
 if (sim_throt_type != SIM_THROT_NONE) {
     sim_show_throt (st, NULL, uptr, val, desc);
@@ -1551,6 +1790,11 @@ REG sim_throttle_reg[] = {
     { DBRDATAD (THROT_START_TIME,sim_throt_inst_start,       "Time when actual throttling started") },
     { DRDATAD (THROT_DELAY,      sim_throt_delay,        32, "Seconds before throttling starts"), PV_RSPC},
     { DRDATAD (THROT_DRIFT_PCT,  sim_throt_drift_pct,    32, "Percent of throttle drift before correction"), PV_RSPC},
+    { FLDATAD (THROT_PACED,      sim_throt_paced,         0, "Throttle paced to a host deadline schedule"), REG_RO},
+    { DRDATAD (THROT_SLICE,      sim_throt_slice,        32, "Paced throttle slice (usecs)"), PV_RSPC|REG_RO},
+    { DBRDATAD (THROT_OBS_CPS,   sim_throt_obs_cps,          "Observed paced cycles per second") },
+    { DRDATAD (THROT_SLEEPS,     sim_throt_pace_sleeps,  32, "Paced throttle sleeps"), PV_RSPC|REG_RO},
+    { DRDATAD (THROT_RESTARTS,   sim_throt_pace_restarts,32, "Paced throttle schedule restarts"), PV_RSPC|REG_RO},
     { NULL }
     };
 
@@ -1580,12 +1824,13 @@ return SCPE_OK;
 
 /* Enable/Disable calibration, specify idle calibration percentage */
 
+static t_stat _sim_timer_uncalibrate (uint32 ips);
+
 t_stat sim_timer_set_calib (int32 arg, CONST char *cptr)
 {
 CONST char *tptr;
 char c;
 t_value val, units = 1;
-int tmr, clocks;
 
 if (arg != 0) {                         /* Enabling Calibration? */
     t_stat r = SCPE_OK;
@@ -1644,13 +1889,22 @@ else {
     else
         return sim_messagef (SCPE_ARG, "Invalid NOCALIBRATE rate specification: %s\n", cptr);
     }
+return _sim_timer_uncalibrate ((uint32)(val * units));
+}
+
+/* Disable calibration running at a specific pseudo rate */
+
+static t_stat _sim_timer_uncalibrate (uint32 ips)
+{
+int tmr, clocks;
+
 sim_timer_set_async (0, NULL);
 if (sim_timer_uncalib_base_time.tv_sec == 0)
     sim_rtcn_get_time (&sim_timer_uncalib_base_time, 0);
 sim_timer_calib_enabled = FALSE;
 sim_time_at_sim_prompt = 0.0;
 sim_reset_time ();
-sim_precalibrate_ips = (uint32)(val * units);
+sim_precalibrate_ips = ips;
 for (tmr=clocks=0; tmr<=SIM_NTIMERS; ++tmr) {
     RTC *rtc = &rtcs[tmr];
 
@@ -1676,6 +1930,66 @@ else
 return SCPE_OK;
 }
 
+/* Pseudo clock parameters.  A RECORD journal saves these so that a later
+   REPLAY of it sees exactly the same uncalibrated time base. */
+
+t_bool sim_timer_get_pseudo_clock (struct timespec *basetime, uint32 *ips)
+{
+*basetime = sim_timer_uncalib_base_time;
+*ips = sim_precalibrate_ips;
+return !sim_timer_calib_enabled;
+}
+
+t_stat sim_timer_set_pseudo_clock (const struct timespec *basetime, uint32 ips)
+{
+if (sim_throt_type != SIM_THROT_NONE)
+    return sim_messagef (SCPE_NOFNC, "calibration can't be disabled when throttling\n");
+if (sim_idle_enab)
+    return sim_messagef (SCPE_NOFNC, "calibration can't be disabled with idle detection enabled\n");
+sim_timer_uncalib_base_time = *basetime;
+return _sim_timer_uncalibrate (ips);
+}
+
+/* Clock state of a stopped simulator.  SAVE images don't carry it, so a
+   journal checkpoint keeps a copy next to its image in case a clock is
+   registered or changes rate after the checkpoint was taken. */
+
+typedef struct {
+    RTC         rtcs[SIM_NTIMERS+1];
+    int32       calb_tmr;
+    int32       calb_tmr_last;
+    double      inst_per_sec_last;
+    int32       internal_timer_time;
+    double      timer_stop_time;
+    } SIM_TIMER_STATE;
+
+void *sim_timer_get_state (void)
+{
+SIM_TIMER_STATE *st = (SIM_TIMER_STATE *)malloc (sizeof (*st));
+
+if (st == NULL)
+    return NULL;
+memcpy (st->rtcs, rtcs, sizeof (rtcs));
+st->calb_tmr = sim_calb_tmr;
+st->calb_tmr_last = sim_calb_tmr_last;
+st->inst_per_sec_last = sim_inst_per_sec_last;
+st->internal_timer_time = sim_internal_timer_time;
+st->timer_stop_time = sim_timer_stop_time;
+return st;
+}
+
+void sim_timer_set_state (const void *state)
+{
+const SIM_TIMER_STATE *st = (const SIM_TIMER_STATE *)state;
+
+memcpy (rtcs, st->rtcs, sizeof (rtcs));
+sim_calb_tmr = st->calb_tmr;
+sim_calb_tmr_last = st->calb_tmr_last;
+sim_inst_per_sec_last = st->inst_per_sec_last;
+sim_internal_timer_time = st->internal_timer_time;
+sim_timer_stop_time = st->timer_stop_time;
+}
+
 t_stat sim_timer_set_uncalib_base (int32 arg, CONST char *cptr)
 {
 struct tm base;
@@ -1963,7 +2277,13 @@ if (sim_clock_queue == QUEUE_LIST_END)
 else
     sim_debug (DBG_IDL, &sim_timer_dev, "sleeping for %d ms - pending event on %s in %d %s\n", w_ms, sim_uname(sim_clock_queue), sim_interval, sim_vm_interval_units);
 cyc_since_idle = sim_gtime() - sim_idle_end_time;       /* time since prior idle completed */
+#if defined(SIM_IDLE_POLL)
+sim_idle_io = TRUE;                                     /* end the wait on host input */
+#endif
 act_ms = sim_idle_ms_sleep (w_ms);                      /* wait */
+#if defined(SIM_IDLE_POLL)
+sim_idle_io = FALSE;
+#endif
 rtc->clock_time_idled += act_ms;
 act_cyc = act_ms * sim_idle_cyc_ms;                     /* Total potential cycles executed while sleeping */
                                                         /* In general, sleeps will end at the boundary of host OS ticks */
@@ -1973,6 +2293,9 @@ else
     act_cyc -= (int32)cyc_since_idle;                   /* adjust for cycles executed */
 sim_interval = sim_interval - act_cyc;                  /* count down sim_interval to reflect idle period */
 sim_idle_end_time = sim_gtime();                        /* save idle completed time */
+#if defined(SIM_IDLE_POLL)
+_sim_idle_activate_ready ();                            /* poll units whose input arrived */
+#endif
 if (sim_clock_queue == QUEUE_LIST_END)
     sim_debug (DBG_IDL, &sim_timer_dev, "slept for %d ms - pending event in %d %s\n", act_ms, sim_interval, sim_vm_interval_units);
 else
@@ -2032,18 +2355,91 @@ return SCPE_OK;
 
 /* Throttling package */
 
+/* Paced throttling
+
+   Rather than measuring the execution rate and sleeping for a fixed
+   quantum after a computed number of instructions, a paced throttle
+   holds execution to a deadline schedule on the host's monotonic clock.
+   Every slice (default 100 usecs) worth of instructions, the time at
+   which the instructions executed so far should have completed is
+   computed from the schedule origin and the desired rate, and the
+   simulator sleeps until then if it is ahead.  Since the deadline is
+   absolute, an oversleep is absorbed by the following slices instead of
+   accumulating, so no recalibration is needed and the long term rate is
+   exact.  If the host falls more than SIM_THROT_LAG_MAX behind (heavy
+   host load, or the process was suspended), the schedule restarts from
+   the present instead of running flat out to catch up.
+*/
+
+static double _sim_throt_host_time (void)
+{
+struct timespec now;
+
+#if defined(CLOCK_MONOTONIC) && !defined(_WIN32)
+clock_gettime (CLOCK_MONOTONIC, &now);
+#else
+clock_gettime (CLOCK_REALTIME, &now);
+#endif
+return _timespec_to_double (&now);
+}
+
+static void _sim_throt_pace_start (void)
+{
+sim_throt_pace_time = sim_throt_win_time = _sim_throt_host_time ();
+sim_throt_pace_inst = sim_throt_win_inst = sim_gtime ();
+}
+
+static void _sim_throt_pace (void)
+{
+double now = _sim_throt_host_time ();
+double inst = sim_gtime ();
+double ahead = sim_throt_pace_time + ((inst - sim_throt_pace_inst) / sim_throt_cps) - now;
+
+if (ahead > 0.0) {                                  /* ahead of schedule? */
+#if !defined(_WIN32) && !defined(VMS)
+    struct timespec delay;
+
+    _double_to_timespec (&delay, ahead);
+    nanosleep (&delay, NULL);
+#else
+    if ((ahead * 1000.0) >= (double)sim_idle_rate_ms)
+        sim_os_ms_sleep ((unsigned int)(ahead * 1000.0));
+#endif
+    ++sim_throt_pace_sleeps;
+    sim_throt_pace_slept += ahead;
+    }
+else {
+    if (-ahead > sim_throt_pace_max_lag)
+        sim_throt_pace_max_lag = -ahead;
+    if (-ahead > SIM_THROT_LAG_MAX) {               /* too far behind to catch up? */
+        sim_debug (DBG_THR, &sim_timer_dev, "_sim_throt_pace() %.3f ms behind schedule - restarting schedule\n", -ahead * 1000.0);
+        ++sim_throt_pace_restarts;
+        sim_throt_pace_time = now;
+        sim_throt_pace_inst = inst;
+        }
+    }
+if ((now - sim_throt_win_time) >= 1.0) {            /* observation window complete? */
+    sim_throt_obs_cps = (inst - sim_throt_win_inst) / (now - sim_throt_win_time);
+    sim_throt_win_time = now;
+    sim_throt_win_inst = inst;
+    }
+}
+
 t_stat sim_set_throt (int32 arg, CONST char *cptr)
 {
 CONST char *tptr;
 char c;
 uint32 saved_throt_type = sim_throt_type;
 int factor = 1;
-t_value val, val2 = 0;
+t_value val, val2 = 0, slice = 0;
+t_bool paced = FALSE;
+char gbuf[CBUFSIZE], pbuf[CBUFSIZE];
 
 if (arg == 0) {
     if ((cptr != NULL) && (*cptr != 0))
         return sim_messagef (SCPE_ARG, "Unexpected NOTHROTTLE argument: %s\n", cptr);
     sim_throt_type = SIM_THROT_NONE;
+    sim_throt_paced = FALSE;
     sim_throt_cancel ();
     return SCPE_OK;
     }
@@ -2053,6 +2449,19 @@ if (sim_idle_rate_ms == 0)
     return sim_messagef (SCPE_NOFNC, "Throttling is not available, Minimum OS sleep time is %dms\n", sim_os_sleep_min_ms);
 if (*cptr == '\0')
     return sim_messagef (SCPE_ARG, "Missing throttle mode specification\n");
+tptr = get_glyph_nc (cptr, gbuf, 0);                /* rate */
+if (*tptr != '\0') {                                /* pacing option? */
+    tptr = get_glyph (tptr, pbuf, '=');
+    if (MATCH_CMD (pbuf, "PACED") != 0)
+        return sim_messagef (SCPE_ARG, "Invalid throttle option: %s\n", pbuf);
+    if (*tptr != '\0') {
+        slice = strtotv (tptr, &tptr, 10);
+        if ((*tptr != '\0') || (slice < SIM_THROT_SLICE_MIN) || (slice > SIM_THROT_SLICE_MAX))
+            return sim_messagef (SCPE_ARG, "Paced slice must be %d to %d usecs\n", SIM_THROT_SLICE_MIN, SIM_THROT_SLICE_MAX);
+        }
+    paced = TRUE;
+    }
+cptr = gbuf;
 val = strtotv (cptr, &tptr, 10);
 if (cptr == tptr)
     return sim_messagef (SCPE_ARG, "Invalid throttle specification: %s\n", cptr);
@@ -2095,6 +2504,10 @@ else {
             }
         }
     }
+if (paced && (sim_throt_type != SIM_THROT_MCYC) && (sim_throt_type != SIM_THROT_KCYC)) {
+    sim_throt_type = saved_throt_type;
+    return sim_messagef (SCPE_ARG, "PACED requires an xM or xK throttle rate\n");
+    }
 if (sim_throttle_has_been_active) {
     sim_throt_type = saved_throt_type;
     sim_messagef (SCPE_ARG, "Throttling was previously active.\n");
@@ -2110,7 +2523,8 @@ if (sim_idle_enab) {
     sim_clr_idle (NULL, 0, NULL, NULL);
     }
 sim_throt_val = (uint32) val;
-if (sim_throt_type != SIM_THROT_SPC)
+sim_throt_paced = paced;
+if ((sim_throt_type != SIM_THROT_SPC) && !paced)
     sim_throt_cps = sim_precalibrate_ips;       /* Set initial value while correct one is determined */
 else {                                          /* otherwise use best guess based on measured execution and sleep times */
     int32 tmr;
@@ -2133,10 +2547,19 @@ else {                                          /* otherwise use best guess base
             }
         sim_throt_state = SIM_THROT_STATE_THROTTLE;     /* force state */
         sim_throt_wait = sim_throt_val;
+        sim_throt_cps = (int32)((1000.0 * sim_throt_val) / (double)sim_throt_sleep_time);
+        }
+    else {                                              /* paced: the rate is known exactly */
+        sim_throt_cps = (double)(val * factor);
+        sim_throt_slice = (uint32)(slice ? slice : SIM_THROT_SLICE_DFLT);
+        sim_throt_wait = (int32)((sim_throt_cps * sim_throt_slice) / 1000000.0);
+        if (sim_throt_wait < 1)
+            sim_throt_wait = 1;
+        sim_throt_state = SIM_THROT_STATE_THROTTLE;     /* no measurement needed */
+        sim_throt_sleep_time = 0;
         }
 
     sim_throt_delay = 1;
-    sim_throt_cps = (int32)((1000.0 * sim_throt_val) / (double)sim_throt_sleep_time);
     sim_inst_per_sec_last = sim_throt_cps;      /* Reflect the throttle rate for where cps is needed */
     /* Run through all timers and adjust the calibration for each */
     /* one that is running to reflect the throttle specified rate */
@@ -2162,6 +2585,24 @@ t_stat sim_show_throt (FILE *st, DEVICE *dnotused, UNIT *unotused, int32 flag, C
 if (sim_idle_rate_ms == 0)
     fprintf (st, "Throttling:                    Not Available\n");
 else {
+    if (sim_throt_paced) {
+        fprintf (st, "Throttle:                      %d %s %s per second, paced\n", sim_throt_val,
+                                                 (sim_throt_type == SIM_THROT_MCYC) ? "mega" : "kilo", sim_vm_interval_units);
+        fprintf (st, "Pacing slice:                  %u usecs (%d %s)\n", sim_throt_slice, sim_throt_wait, sim_vm_interval_units);
+        fprintf (st, "Target rate:                   %s %s per second\n", sim_fmt_numeric (sim_throt_cps), sim_vm_interval_units);
+        if (sim_throt_obs_cps > 0.0)
+            fprintf (st, "Observed rate:                 %s %s per second (%.2f%%)\n", sim_fmt_numeric (sim_throt_obs_cps), sim_vm_interval_units,
+                                                                                   (100.0 * sim_throt_obs_cps) / sim_throt_cps);
+        if (sim_throt_pace_sleeps) {
+            fprintf (st, "Sleeps:                        %s", sim_fmt_numeric ((double)sim_throt_pace_sleeps));
+            fprintf (st, ", %s ms total\n", sim_fmt_numeric (sim_throt_pace_slept * 1000.0));
+            }
+        if (sim_throt_pace_max_lag > 0.0)
+            fprintf (st, "Maximum lag behind schedule:   %.3f ms\n", sim_throt_pace_max_lag * 1000.0);
+        if (sim_throt_pace_restarts)
+            fprintf (st, "Schedule restarts:             %u\n", sim_throt_pace_restarts);
+        return SCPE_OK;
+        }
     switch (sim_throt_type) {
 
     case SIM_THROT_MCYC:
@@ -2214,6 +2655,8 @@ if (sim_throt_type != SIM_THROT_NONE) {
         /* Reset recalibration reference times */
         sim_throt_ms_start = sim_os_msec ();
         sim_throt_inst_start = sim_gtime ();
+        if (sim_throt_paced)                            /* time stopped isn't caught up */
+            _sim_throt_pace_start ();
         /* Start with prior calibrated delay */
         sim_activate (&sim_throttle_unit, sim_throt_wait);
         }
@@ -2382,6 +2825,10 @@ switch (sim_throt_state) {
         break;
 
     case SIM_THROT_STATE_THROTTLE:                      /* throttling */
+        if (sim_throt_paced) {
+            _sim_throt_pace ();
+            break;
+            }
         sim_idle_ms_sleep (sim_throt_sleep_time);
         delta_ms = sim_os_msec () - sim_throt_ms_start;
         if (delta_ms >= 10000) {                        /* recompute every 10 sec */
@@ -3037,7 +3484,7 @@ for (tmr=0; tmr<=SIM_NTIMERS; tmr++) {
     RTC *rtc = &rtcs[tmr];
 
     if (rtc->clock_unit) {
-        int32 clock_time = _sim_activate_time (rtc->timer_unit);
+        int32 clock_time = _sim_activate_time (rtc->timer_unit) - 1; /* remaining, not remaining + 1 */
 
         /* Stop clock assist unit and make sure the clock unit has a tick queued */
         if (sim_is_active (rtc->timer_unit)) {
@@ -96,6 +96,10 @@ int clock_gettime(int clock_id, struct timespec *tp);
 #define SIM_THROT_STATE_INIT      0                 /* Starting */
 #define SIM_THROT_STATE_TIME      1                 /* Checking Time */
 #define SIM_THROT_STATE_THROTTLE  2                 /* Throttling  */
+#define SIM_THROT_SLICE_DFLT      100               /* paced throttle slice (usecs) */
+#define SIM_THROT_SLICE_MIN       10                /* min paced slice */
+#define SIM_THROT_SLICE_MAX       100000            /* max paced slice */
+#define SIM_THROT_LAG_MAX         0.050             /* paced lag (secs) before schedule restart */
 
 #define TIMER_DBG_IDLE  0x001                       /* Debug Flag for Idle Debugging */
 #define TIMER_DBG_QUEUE 0x002                       /* Debug Flag for Asynch Queue Debugging */
@@ -109,6 +113,10 @@ int32 sim_rtcn_init_unit (UNIT *uptr, int32 time, int32 tmr);
 int32 sim_rtcn_init_unit_ticks (UNIT *uptr, int32 time, int32 tmr, int32 ticksper);
 void sim_rtcn_set_debug_basetime (const struct timespec *basetime);
 const struct timespec *sim_rtcn_get_debug_basetime (void);
+t_bool sim_timer_get_pseudo_clock (struct timespec *basetime, uint32 *ips);
+t_stat sim_timer_set_pseudo_clock (const struct timespec *basetime, uint32 ips);
+void *sim_timer_get_state (void);
+void sim_timer_set_state (const void *state);
 void sim_rtcn_debug_time (struct timespec *now);
 void sim_rtcn_get_time (struct timespec *now, int tmr);
 time_t sim_get_time (time_t *now);
@@ -133,6 +141,7 @@ uint32 sim_os_msec (void);
 void sim_os_sleep (unsigned int sec);
 uint32 sim_os_ms_sleep (unsigned int msec);
 uint32 sim_os_ms_sleep_init (void);
+void sim_idle_wakeup (void);
 void sim_start_timer_services (void);
 void sim_stop_timer_services (void);
 t_stat sim_timer_change_asynch (void);
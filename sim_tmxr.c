@@ -68,6 +68,7 @@
    tmxr_detach_ln -                     reset line and close per line listener and outgoing destination
    tmxr_getc_ln -                       get character for line
    tmxr_get_packet_ln -                 get packet from line
+   tmxr_get_packets_ln -                get all pending packets from line
    tmxr_get_packet_ln_ex -              get packet from line with separator byte
    tmxr_poll_rx -                       poll receive
    tmxr_putc_ln -                       put character for line
@@ -487,6 +488,133 @@ static int  tmxr_framer_read (TMLN *line, char *buf, int nbytes);
 static int  tmxr_framer_write (TMLN *line, const char *buf, int32 length);
 
 static void tmxr_add_to_open_list (TMXR* mux);
+static void _tmxr_jrn_connect (TMLN *lp);
+static void _tmxr_jrn_rx (TMLN *lp, int32 rxbpi, t_bool closed);
+
+/* Multiplexers whose input is journaled by RECORD and supplied by REPLAY:
+   those of simulated devices, not the (DEV_NOSAVE) console or remote
+   console ones */
+
+#define TMXR_JRN(mp) ((sim_jrn_mode != SIM_JRN_OFF) && ((mp)->dptr != NULL) && \
+                      !((mp)->dptr->flags & DEV_NOSAVE))
+
+/* Datagram receive queue
+
+   Packets arriving on a datagram (UDP) line which is read with the packet
+   routines are received straight into a queue of preallocated slots, as
+   many as are waiting per poll (in one system call where the host
+   supports it), rather than being read one datagram per poll into the
+   line's character buffer and reassembled a byte at a time.  The packet
+   routines hand out pointers into the slots; slots handed out are
+   released by the next packet call on the line.
+
+   The queue is set up by the first packet read on an eligible line, and
+   is released when the line is reinitialized.  Loopback, framer, and
+   serial lines, lines with a receive speed limit, and all lines while
+   input is being journaled, keep using the character path.
+*/
+
+#define TMXR_PQ_SLOTS 32                                /* datagram queue depth */
+
+#define TMXR_PQ_ELIGIBLE(lp) ((lp)->datagram && (lp)->sock && !(lp)->loopback && \
+                              !(lp)->framer && !(lp)->serport && !(lp)->rxbps && \
+                              (sim_jrn_mode == SIM_JRN_OFF))
+
+static void _tmxr_pq_release (TMLN *lp)
+{
+free (lp->rxpq);
+lp->rxpq = NULL;
+free (lp->rxpqlen);
+lp->rxpqlen = NULL;
+lp->rxpqhead = lp->rxpqcount = lp->rxpqheld = 0;
+}
+
+static t_bool _tmxr_pq_setup (TMLN *lp)
+{
+if (lp->rxpq)
+    return TRUE;
+lp->rxpqslot = lp->rxbsz;
+lp->rxpq = (uint8 *)malloc (TMXR_PQ_SLOTS * lp->rxpqslot);
+lp->rxpqlen = (int32 *)calloc (TMXR_PQ_SLOTS, sizeof (*lp->rxpqlen));
+if ((lp->rxpq == NULL) || (lp->rxpqlen == NULL)) {
+    _tmxr_pq_release (lp);
+    return FALSE;
+    }
+lp->rxpqhead = lp->rxpqcount = lp->rxpqheld = 0;
+return TRUE;
+}
+
+/* Read every datagram waiting for a free slot */
+
+static int32 _tmxr_pq_fill (TMLN *lp)
+{
+char *bufs[TMXR_PQ_SLOTS];
+int lens[TMXR_PQ_SLOTS];
+int32 i, n, slot, space, total = 0;
+
+while ((space = TMXR_PQ_SLOTS - lp->rxpqcount) > 0) {
+    slot = (lp->rxpqhead + lp->rxpqcount) % TMXR_PQ_SLOTS;
+    if (slot + space > TMXR_PQ_SLOTS)                   /* batch to the end of the ring */
+        space = TMXR_PQ_SLOTS - slot;
+    for (i = 0; i < space; i++)
+        bufs[i] = (char *)&lp->rxpq[(slot + i) * lp->rxpqslot];
+    n = sim_read_sock_batch (lp->sock, bufs, lens, space, lp->rxpqslot - TMXR_GUARD);
+    if (n <= 0)
+        return (total || (n == 0)) ? total : n;
+    for (i = 0; i < n; i++) {
+        uint8 *pkt = &lp->rxpq[((lp->rxpqhead + lp->rxpqcount) % TMXR_PQ_SLOTS) * lp->rxpqslot];
+
+        if (lens[i] == 0)                               /* ignore empty datagrams */
+            continue;
+        if ((uint8 *)bufs[i] != pkt)                    /* close up after an empty one */
+            memcpy (pkt, bufs[i], lens[i]);
+        tmxr_debug (TMXR_DBG_RCV, lp, "Received", (char *)pkt, lens[i]);
+        lp->rxcnt += lens[i];
+        lp->rxpqlen[(lp->rxpqhead + lp->rxpqcount) % TMXR_PQ_SLOTS] = lens[i];
+        ++lp->rxpqcount;
+        ++total;
+        }
+    if (n < space)                                      /* nothing more waiting? */
+        break;
+    }
+return total;
+}
+
+/* Release the packets handed out by the previous packet call */
+
+static void _tmxr_pq_return (TMLN *lp)
+{
+lp->rxpqhead = (lp->rxpqhead + lp->rxpqheld) % TMXR_PQ_SLOTS;
+lp->rxpqcount -= lp->rxpqheld;
+lp->rxpqheld = 0;
+}
+
+/* Hand out the next queued packet, or return FALSE if there isn't one */
+
+static t_bool _tmxr_pq_next (TMLN *lp, const uint8 **pbuf, size_t *psize, uint8 frame_byte)
+{
+while (lp->rxpqheld < lp->rxpqcount) {
+    int32 slot = (lp->rxpqhead + lp->rxpqheld) % TMXR_PQ_SLOTS;
+    uint8 *pkt = &lp->rxpq[slot * lp->rxpqslot];
+    size_t size = (size_t)lp->rxpqlen[slot];
+
+    ++lp->rxpqheld;
+    if (frame_byte) {
+        if (pkt[0] != frame_byte) {
+            tmxr_debug (TMXR_DBG_PRCV, lp, "Received Unexpected Framing Byte", (char *)pkt, 1);
+            continue;
+            }
+        ++pkt;
+        --size;
+        }
+    ++lp->rxpcnt;
+    *pbuf = pkt;
+    *psize = size;
+    tmxr_debug (TMXR_DBG_PRCV, lp, "Received Packet", (char *)pkt, size);
+    return TRUE;
+    }
+return FALSE;
+}
 
 /* Initialize the line state.
 
@@ -527,6 +655,8 @@ if (lp->rxpb) {
     free (lp->rxpb);
     lp->rxpb = NULL;
     }
+if (lp->rxpq)
+    _tmxr_pq_release (lp);
 if (lp->txpb) {
     lp->txpbsize = lp->txppsize = lp->txppoffset = 0;
     free (lp->txpb);
@@ -752,7 +882,10 @@ if ((lp->txbps) && (sim_gtime () < lp->txnexttime) && (sim_is_running))
 if (lp->loopback)
     return loop_write (lp, &(lp->txb[i]), length);
 
-if (lp->serport) {                                      /* serial port connection? */
+if ((sim_jrn_mode == SIM_JRN_REPLAY) && lp->mp &&       /* replaying a journaled line? */
+    TMXR_JRN (lp->mp))
+    written = length;                                   /* output goes nowhere */
+else if (lp->serport) {                                 /* serial port connection? */
     written = sim_write_serial (lp->serport, &(lp->txb[i]), length);
     }
 else {
@@ -772,7 +905,7 @@ else {
             }
         else {
             if (lp->console)
-                written = (SCPE_OK == _sim_os_putchar (lp->txb[i])) ? 1 : 0; /* write to the sim> session */
+                written = (SCPE_OK == _sim_con_putchar (lp->txb[i])) ? 1 : 0; /* write to the sim> session */
             else {
                 if ((lp->conn == TMXR_LINE_DISABLED) ||
                     ((lp->conn == 0) && lp->txbfd)){
@@ -1074,10 +1207,47 @@ return SCPE_OK;
    not -1 (indicating default order), then the order array is used to find an
    open line.  Otherwise, a search is made of all lines in numerical sequence.
 
+   While replaying an input journal, the connections of journaled lines come
+   from the journal.
 */
 
+static int32 _tmxr_poll_conn (TMXR *mp);
+
 int32 tmxr_poll_conn (TMXR *mp)
 {
+int32 ln = _tmxr_poll_conn (mp);
+uint8 data[4];
+size_t len = sizeof (data);
+
+if (!TMXR_JRN (mp))
+    return ln;
+if (sim_jrn_mode == SIM_JRN_RECORD) {
+    if (ln >= 0) {
+        data[0] = ln & 0xFF;
+        data[1] = (ln >> 8) & 0xFF;
+        data[2] = (ln >> 16) & 0xFF;
+        data[3] = (ln >> 24) & 0xFF;
+        sim_jrn_put (SIM_JRN_CONN, sim_dname (mp->dptr), data, sizeof (data));
+        }
+    return ln;
+    }
+if (ln >= 0)                                            /* live connections aren't replayed */
+    tmxr_reset_ln (mp->ldsc + ln);
+if ((!sim_jrn_get (SIM_JRN_CONN, sim_dname (mp->dptr), data, &len)) ||
+    (len != sizeof (data)))
+    return -1;
+ln = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+if ((ln < 0) || (ln >= mp->lines))
+    return -1;
+if (!mp->ldsc[ln].conn) {
+    _tmxr_jrn_connect (mp->ldsc + ln);
+    tmxr_report_connection (mp, mp->ldsc + ln);
+    }
+return ln;
+}
+
+static int32 _tmxr_poll_conn (TMXR *mp)
+{
 SOCKET newsock;
 TMLN *lp;
 int32 *op;
@@ -2137,6 +2307,8 @@ return val;
 
     1. If a packet is not yet available, then the pbuf address returned is
        NULL, but success (SCPE_OK) is returned
+    2. Datagram lines return packets directly from the receive queue; the
+       packet returned is valid until the next packet call on the line.
 */
 
 t_stat tmxr_get_packet_ln (TMLN *lp, const uint8 **pbuf, size_t *psize)
@@ -2150,6 +2322,21 @@ int32 c;
 size_t pktsize;
 size_t fc_size = (frame_byte ? 1 : 0);
 
+if (lp->rxpq && (sim_jrn_mode != SIM_JRN_OFF))          /* journaling reads the character path */
+    _tmxr_pq_release (lp);
+if (lp->rxpq || (TMXR_PQ_ELIGIBLE (lp) && _tmxr_pq_setup (lp))) {
+    _tmxr_pq_return (lp);
+    if ((lp->rxbpi == lp->rxbpr) &&                     /* nothing left in the character path */
+        (!lp->send || (lp->send->extoff >= lp->send->insoff))) {
+        if (lp->rxpqcount == 0)
+            _tmxr_pq_fill (lp);
+        if (_tmxr_pq_next (lp, pbuf, psize, frame_byte))
+            return SCPE_OK;
+        *pbuf = NULL;
+        *psize = 0;
+        return (lp->conn) ? SCPE_OK : SCPE_LOST;
+        }
+    }
 while (TMXR_VALID & (c = tmxr_getc_ln (lp))) {
     if (lp->rxpboffset + 3 > lp->rxpbsize) {
         lp->rxpbsize += 512;
@@ -2187,6 +2374,46 @@ if (lp->conn)
 return SCPE_LOST;
 }
 
+/* Get all pending packets from specific line
+
+   Inputs:
+        *lp     =       pointer to terminal line descriptor
+        **pbufs =       array of pointers to receive packet contents
+        *psizes =       array of packet sizes
+        max     =       size of pbufs and psizes arrays
+        *pcount =       pointer to count of packets returned
+
+   Output:
+        SCPE_LOST       link state lost
+        SCPE_OK         Packets returned OR no packet available
+
+   Implementation notes:
+
+    1. Packets returned remain valid until the next packet call on the
+       line.
+    2. Only datagram lines deliver more than one packet per call; other
+       lines deliver at most one.
+*/
+
+t_stat tmxr_get_packets_ln (TMLN *lp, const uint8 **pbufs, size_t *psizes, int32 max, int32 *pcount)
+{
+t_stat r = SCPE_OK;
+
+*pcount = 0;
+if ((max <= 0) ||
+    (SCPE_OK != (r = tmxr_get_packet_ln (lp, &pbufs[0], &psizes[0]))))
+    return r;
+if (pbufs[0] == NULL)
+    return SCPE_OK;
+*pcount = 1;
+if (lp->rxpq == NULL)
+    return SCPE_OK;
+while ((*pcount < max) &&
+       _tmxr_pq_next (lp, &pbufs[*pcount], &psizes[*pcount], 0))
+    ++*pcount;
+return SCPE_OK;
+}
+
 /* Poll for input
 
    Inputs:
@@ -2196,16 +2423,28 @@ return SCPE_LOST;
 
 void tmxr_poll_rx (TMXR *mp)
 {
-int32 i, nbytes, j;
+int32 i, nbytes, j, jrnpi;
 TMLN *lp;
+t_bool jrn = TMXR_JRN (mp);
 
 tmxr_debug_trace (mp, "tmxr_poll_rx()");
 for (i = 0; i < mp->lines; i++) {                       /* loop thru lines */
     lp = mp->ldsc + i;                                  /* get line desc */
+    if (jrn && (sim_jrn_mode == SIM_JRN_REPLAY)) {      /* replaying? */
+        _tmxr_jrn_rx (lp, 0, FALSE);                    /* input comes from the journal */
+        continue;
+        }
     if (!(lp->sock || lp->serport || lp->loopback || lp->framer) ||
         !(lp->rcve))                                    /* skip if not connected */
         continue;
 
+    if (lp->rxpq && (sim_jrn_mode != SIM_JRN_OFF))      /* journaling reads the character path */
+        _tmxr_pq_release (lp);
+    if (lp->rxpq) {                                     /* datagram queue? */
+        _tmxr_pq_fill (lp);                             /* read what's waiting */
+        continue;
+        }
+    jrnpi = lp->rxbpi;                                  /* journal what arrives */
     nbytes = 0;
     if (lp->rxbpi == 0)                                 /* need input? */
         nbytes = tmxr_read (lp,                         /* yes, read */
@@ -2427,6 +2666,8 @@ for (i = 0; i < mp->lines; i++) {                       /* loop thru lines */
                 }
             }
         }                                               /* end else nbytes */
+    if (jrn)
+        _tmxr_jrn_rx (lp, jrnpi, (nbytes < 0) && !lp->datagram);
     }                                                   /* end for lines */
 for (i = 0; i < mp->lines; i++) {                       /* loop thru lines */
     lp = mp->ldsc + i;                                  /* get line desc */
@@ -2547,6 +2788,9 @@ return SCPE_STALL;                                      /* char not sent */
     1. If the line is not connected, SCPE_LOST is returned.
     2. If prior packet transmission still in progress, SCPE_STALL is
        returned and no packet data is stored.  The caller must retry later.
+    3. A packet on an idle datagram line, with nothing in the way (logging,
+       expect rules, output rate limiting), is written directly from the
+       caller's buffer.
 */
 t_stat tmxr_put_packet_ln (TMLN *lp, const uint8 *buf, size_t size)
 {
@@ -2565,6 +2809,20 @@ if (lp->txppoffset < lp->txppsize) {
     tmxr_debug (TMXR_DBG_PXMT, lp, "Skipped Sending Packet - Transmit Busy", (char *)&lp->txpb[3], size);
     return SCPE_STALL;
     }
+if ((lp->datagram) && (lp->sock) && (lp->conn) &&       /* idle plain datagram line? */
+    (sim_jrn_mode == SIM_JRN_OFF) &&
+    (!lp->loopback) && (!lp->framer) && (!lp->serport) &&
+    (!frame_byte) && (!lp->txbps) && (!lp->txlog) &&
+    ((!lp->expect) || (!lp->expect->rules)) &&
+    (tmxr_tqln (lp) == 0) &&
+    (sim_write_sock (lp->sock, (const char *)buf, (int)size) == (int)size)) {
+    tmxr_debug (TMXR_DBG_PXMT, lp, "Sending Packet", (char *)buf, size);
+    tmxr_debug (TMXR_DBG_XMT, lp, "Sent", (char *)buf, size);
+    ++lp->txpcnt;
+    lp->txcnt += size;
+    lp->txdone = FALSE;
+    return SCPE_OK;
+    }
 if (lp->txpbsize < size + pktlen_size + fc_size) {
     lp->txpbsize = size + pktlen_size + fc_size;
     lp->txpb = (uint8 *)realloc (lp->txpb, lp->txpbsize);
@@ -3813,6 +4071,207 @@ for (i=0; i<tmxr_open_device_count; ++i)
         }
 }
 
+/* Input journal (RECORD/REPLAY) support
+
+   Journaled lines record their connections, received data and disconnects.
+   While replaying, those come from the journal instead: a connection that
+   only exists in the journal is a "ghost" line without a socket, output to
+   journaled lines is discarded, and live connections and input are ignored.
+*/
+
+static void _tmxr_jrn_chan (TMLN *lp, char *chan, size_t size)
+{
+snprintf (chan, size, "%s:%d", sim_dname (lp->mp->dptr), (int)(lp - lp->mp->ldsc));
+}
+
+static void _tmxr_jrn_connect (TMLN *lp)
+{
+lp->conn = TRUE;
+lp->jrnghost = TRUE;
+tmxr_init_line (lp);
+lp->notelnet = lp->mp->notelnet;
+lp->nomessage = lp->mp->nomessage;
+lp->cnms = sim_os_msec ();
+}
+
+static void _tmxr_jrn_disconnect (TMLN *lp)
+{
+tmxr_reset_ln_ex (lp, TRUE);
+if (lp->jrnghost) {
+    lp->jrnghost = FALSE;
+    lp->conn = FALSE;
+    lp->cnms = 0;
+    lp->xmte = 1;
+    }
+}
+
+/* Record the connected lines of each journaled multiplexer at a checkpoint */
+
+void tmxr_jrn_put_lines (void)
+{
+int i, j;
+
+for (i = 0; i < tmxr_open_device_count; i++) {
+    TMXR *mp = tmxr_open_devices[i];
+    uint8 *map;
+
+    if (!TMXR_JRN (mp))
+        continue;
+    map = (uint8 *)calloc ((mp->lines + 7) / 8, 1);
+    for (j = 0; j < mp->lines; j++)
+        if (mp->ldsc[j].conn)
+            map[j >> 3] |= (1 << (j & 7));
+    sim_jrn_put (SIM_JRN_LINES, sim_dname (mp->dptr), map, (mp->lines + 7) / 8);
+    free (map);
+    }
+}
+
+/* Make the connected lines match a checkpoint that replay starts from */
+
+void tmxr_jrn_get_lines (void)
+{
+int i, j;
+
+for (i = 0; i < tmxr_open_device_count; i++) {
+    TMXR *mp = tmxr_open_devices[i];
+    size_t len = (mp->lines + 7) / 8;
+    uint8 *map;
+
+    if (!TMXR_JRN (mp))
+        continue;
+    map = (uint8 *)calloc (len, 1);
+    sim_jrn_get (SIM_JRN_LINES, sim_dname (mp->dptr), map, &len);
+    for (j = 0; j < mp->lines; j++) {
+        TMLN *lp = mp->ldsc + j;
+
+        if (map[j >> 3] & (1 << (j & 7))) {
+            if (!lp->conn)
+                _tmxr_jrn_connect (lp);
+            }
+        else {
+            if (lp->conn)
+                _tmxr_jrn_disconnect (lp);
+            }
+        }
+    free (map);
+    }
+}
+
+/* Replay has finished: lines that were only connected in the journal go
+   away (which is journaled if recording carries on) */
+
+void tmxr_jrn_replay_done (void)
+{
+int i, j;
+
+for (i = 0; i < tmxr_open_device_count; i++) {
+    TMXR *mp = tmxr_open_devices[i];
+
+    for (j = 0; j < mp->lines; j++) {
+        TMLN *lp = mp->ldsc + j;
+
+        if (lp->jrnghost) {
+            char chan[CBUFSIZE];
+
+            _tmxr_jrn_disconnect (lp);
+            _tmxr_jrn_chan (lp, chan, sizeof (chan));
+            sim_jrn_put (SIM_JRN_DISC, chan, NULL, 0);
+            }
+        }
+    }
+}
+
+/* Journal, or replay, what a receive poll of a line delivered */
+
+static void _tmxr_jrn_rx (TMLN *lp, int32 rxbpi, t_bool closed)
+{
+char chan[CBUFSIZE];
+size_t len;
+
+_tmxr_jrn_chan (lp, chan, sizeof (chan));
+if (sim_jrn_mode == SIM_JRN_RECORD) {
+    if (lp->rxbpi > rxbpi) {
+        uint8 *data = (uint8 *)malloc (2 * (lp->rxbpi - rxbpi));
+
+        memcpy (data, &lp->rxb[rxbpi], lp->rxbpi - rxbpi);
+        memcpy (data + (lp->rxbpi - rxbpi), &lp->rbr[rxbpi], lp->rxbpi - rxbpi);
+        sim_jrn_put (SIM_JRN_RX, chan, data, 2 * (lp->rxbpi - rxbpi));
+        free (data);
+        }
+    if (closed)
+        sim_jrn_put (SIM_JRN_DISC, chan, NULL, 0);
+    return;
+    }
+if (!lp->conn || !lp->rcve)
+    return;
+len = 2 * (lp->rxbsz - lp->rxbpi);
+if (len > 0) {
+    uint8 *data = (uint8 *)malloc (len);
+
+    if (sim_jrn_get (SIM_JRN_RX, chan, data, &len)) {
+        memcpy (&lp->rxb[lp->rxbpi], data, len / 2);
+        memcpy (&lp->rbr[lp->rxbpi], data + len / 2, len / 2);
+        lp->rxbpi += (int32)(len / 2);
+        lp->rxcnt += (int32)(len / 2);
+        }
+    free (data);
+    }
+len = 0;
+if (sim_jrn_get (SIM_JRN_DISC, chan, NULL, &len))
+    _tmxr_jrn_disconnect (lp);
+}
+
+/* Collect the host descriptors on which multiplexer input can arrive.
+
+   Called by sim_idle so that an idle wait ends when a connection request
+   or line data arrives rather than at the end of the sleep.  Each
+   descriptor is returned with the unit whose service routine polls for
+   that input: the connection poll unit for listening sockets, and the
+   line's input polling unit for connected lines.  The console keyboard is
+   included when the simulator has declared its console input unit and
+   the console is an interactive terminal.  Returns the number of entries
+   stored, at most max.
+*/
+
+int tmxr_idle_fds (SOCKET *fds, UNIT **uptrs, int max)
+{
+extern TMXR sim_con_tmxr;
+int i, j, n = 0;
+
+if ((n < max) &&
+    (sim_con_tmxr.ldsc->uptr != NULL) &&
+    (sim_con_tmxr.master == 0) &&
+    (sim_con_tmxr.ldsc->serport == 0) &&
+    sim_ttisatty ()) {
+    fds[n] = 0;                                         /* stdin */
+    uptrs[n++] = sim_con_tmxr.ldsc->uptr;
+    }
+for (i=0; i<tmxr_open_device_count; ++i) {
+    TMXR *mp = tmxr_open_devices[i];
+
+    if ((mp->master) && (mp->uptr) && (n < max)) {
+        fds[n] = mp->master;
+        uptrs[n++] = mp->uptr;
+        }
+    for (j=0; j<mp->lines; j++) {
+        TMLN *lp = &mp->ldsc[j];
+        UNIT *uptr = lp->uptr ? lp->uptr : mp->uptr;
+
+        if (uptr == NULL)
+            continue;
+        if ((lp->master) && (n < max)) {
+            fds[n] = lp->master;
+            uptrs[n++] = mp->uptr ? mp->uptr : uptr;
+            }
+        if ((lp->sock) && (n < max)) {
+            fds[n] = lp->sock;
+            uptrs[n++] = uptr;
+            }
+        }
+    }
+return n;
+}
+
 static t_stat _tmxr_locate_line_send_expect (const char *cptr, TMLN **lp, SEND **snd, EXPECT **exp)
 {
 char gbuf[CBUFSIZE];
@@ -5625,6 +6084,54 @@ tmxr->lines = saved_lines;
 return SCPE_OK;
 }
 
+/* Send datagrams to a UDP line and take them from the packet queue */
+
+static t_stat sim_tmxr_test_packet_queue (DEVICE *dptr, TMXR *tmxr)
+{
+char cmd[CBUFSIZE];
+TMLN *ln = &tmxr->ldsc[0];
+SOCKET sock;
+const uint8 *pbufs[8];
+size_t psizes[8];
+char pkt[16];
+int32 i, count, taken;
+t_stat r;
+
+tmxr->modem_control = ln->modem_control = FALSE;
+snprintf (cmd, sizeof (cmd), "%s Line=0,localhost:65502,UDP,Connect=localhost:65503", dptr->name);
+if (SCPE_OK != (r = attach_cmd (0, cmd)))
+    return r;
+sock = sim_connect_sock_ex ("localhost:65503", "localhost:65502", NULL, NULL, SIM_SOCK_OPT_DATAGRAM);
+if (sock == INVALID_SOCKET) {
+    detach_cmd (0, dptr->name);
+    return sim_messagef (SCPE_OPENERR, "Can't open datagram test socket\n");
+    }
+tmxr_poll_conn (tmxr);
+ln->rcve = TRUE;
+for (i = 0; i < 5; i++) {
+    snprintf (pkt, sizeof (pkt), "Packet %d", i);
+    sim_write_sock (sock, pkt, (int32)strlen (pkt) + 1);
+    }
+sim_os_ms_sleep (100);
+r = tmxr_get_packets_ln (ln, pbufs, psizes, 3, &count);  /* three of five */
+if ((r == SCPE_OK) && (count != 3))
+    r = sim_messagef (SCPE_IERR, "Expected 3 datagrams, got %d\n", count);
+taken = 0;
+while ((r == SCPE_OK) && (count > 0)) {
+    for (i = 0; (r == SCPE_OK) && (i < count); i++, taken++) {
+        snprintf (pkt, sizeof (pkt), "Packet %d", taken);
+        if ((psizes[i] != strlen (pkt) + 1) || (memcmp (pbufs[i], pkt, psizes[i]) != 0))
+            r = sim_messagef (SCPE_IERR, "Datagram %d out of order or damaged\n", taken);
+        }
+    if (r == SCPE_OK)
+        r = tmxr_get_packets_ln (ln, pbufs, psizes, 8, &count); /* the rest */
+    }
+if ((r == SCPE_OK) && (taken != 5))
+    r = sim_messagef (SCPE_IERR, "Expected 5 datagrams, got %d\n", taken);
+sim_close_sock (sock);
+detach_cmd (0, dptr->name);
+return r;
+}
 
 t_stat tmxr_sock_test (DEVICE *dptr, const char *cptr)
 {
@@ -5687,6 +6194,7 @@ if (tmxr->lines > 1) {
     SIM_TEST(detach_cmd (0, dptr->name));
     SIM_TEST(sim_tmxr_test_lnorder (tmxr));
     }
+SIM_TEST(sim_tmxr_test_packet_queue (dptr, tmxr));
 return stat;
 }
 
@@ -174,6 +174,12 @@ struct tmln {
     uint8               *rxpb;                          /* rcv packet buffer */
     uint32              rxpbsize;                       /* rcv packet buffer size */
     uint32              rxpboffset;                     /* rcv packet buffer offset */
+    uint8               *rxpq;                          /* rcv datagram queue slots */
+    int32               *rxpqlen;                       /* rcv datagram queue packet lengths */
+    int32               rxpqslot;                       /* rcv datagram queue slot size */
+    int32               rxpqhead;                       /* rcv datagram queue first packet */
+    int32               rxpqcount;                      /* rcv datagram queue packets queued */
+    int32               rxpqheld;                       /* rcv datagram queue packets handed out */
     uint32              rxbps;                          /* rcv bps speed (0 - unlimited) */
     double              bpsfactor;                      /* receive speed factor (scaled to usecs) */
 #define USECS_PER_SECOND 1000000.0
@@ -197,6 +203,7 @@ struct tmln {
     t_bool              loopback;                       /* Line in loopback mode */
     t_bool              halfduplex;                     /* Line in half-duplex mode */
     t_bool              datagram;                       /* Line is datagram packet oriented */
+    t_bool              jrnghost;                       /* connection exists only in a replayed journal */
     t_bool              packet;                         /* Line is packet oriented */
     int32               lpbpr;                          /* loopback buf remove */
     int32               lpbpi;                          /* loopback buf insert */
@@ -247,6 +254,7 @@ int32 tmxr_input_pending_ln (TMLN *lp);
 int32 tmxr_getc_ln (TMLN *lp);
 t_stat tmxr_get_packet_ln (TMLN *lp, const uint8 **pbuf, size_t *psize);
 t_stat tmxr_get_packet_ln_ex (TMLN *lp, const uint8 **pbuf, size_t *psize, uint8 frame_byte);
+t_stat tmxr_get_packets_ln (TMLN *lp, const uint8 **pbufs, size_t *psizes, int32 max, int32 *pcount);
 void tmxr_poll_rx (TMXR *mp);
 t_stat tmxr_putc_ln (TMLN *lp, int32 chr);
 t_stat tmxr_put_packet_ln (TMLN *lp, const uint8 *buf, size_t size);
@@ -283,6 +291,7 @@ t_stat tmxr_set_line_modem_control (TMLN *lp, t_bool enab_disab);
 t_stat tmxr_set_line_unit (TMXR *mp, int line, UNIT *uptr_poll);
 t_stat tmxr_set_line_output_unit (TMXR *mp, int line, UNIT *uptr_poll);
 t_stat tmxr_set_console_units (UNIT *rxuptr, UNIT *txuptr);
+int tmxr_idle_fds (SOCKET *fds, UNIT **uptrs, int max);
 t_stat tmxr_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat tmxr_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 void tmxr_msg (SOCKET sock, const char *msg);
@@ -309,6 +318,9 @@ t_stat tmxr_show_open_devices (FILE* st, DEVICE *dptr, UNIT* uptr, int32 val, CO
 t_stat tmxr_show_sync_devices (FILE* st, DEVICE *dptr, UNIT* uptr, int32 val, CONST char *desc);
 t_stat tmxr_show_sync (FILE* st, UNIT* uptr, int32 val, CONST void *desc);
 t_stat tmxr_flush_log_files (void);
+void tmxr_jrn_put_lines (void);
+void tmxr_jrn_get_lines (void);
+void tmxr_jrn_replay_done (void);
 t_stat tmxr_activate (UNIT *uptr, int32 interval);
 t_stat tmxr_activate_abs (UNIT *uptr, int32 interval);
 t_stat tmxr_activate_after (UNIT *uptr, uint32 usecs_walltime);
@@ -136,9 +136,6 @@ int32 CC = CC_ALWAYS_ON | IF;           /* Condition Code Register */
 int32 saved_PC = 0xffff;                /* Program counter */
 int32 PC;                               /* global for the helper routines */
 int32 NMI = 0, IRQ = 0;                 //interrupt flags
-int32 hst_p = 0;                        /* history pointer */
-int32 hst_lnt = 0;                      /* history length */
-InstHistory *hst = NULL;                /* instruction history */
 int32 reason;                           //reason for halting processor
 static const char* m6800_desc(DEVICE *dptr) {
     return m6800_NAME;
@@ -147,6 +144,7 @@ static const char* m6800_desc(DEVICE *dptr) {
 /* function prototypes */
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc);
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed);
 t_stat m6800_reset (DEVICE *dptr);
 t_stat m6800_ex(t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat m6800_dep(t_value val, t_addr addr, UNIT *uptr, int32 sw);
@@ -287,7 +285,7 @@ MTAB m6800_mod[] = {
     { UNIT_OPSTOP, 0, "NOITRAP", "NOITRAP", NULL },
     { UNIT_MSTOP, UNIT_MSTOP, "MTRAP", "MTRAP", NULL },
     { UNIT_MSTOP, 0, "NOMTRAP", "NOMTRAP", NULL },
-    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n",
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP|MTAB_NC, 0, "HISTORY", "HISTORY=n{:file}",
       &cpu_set_hist, &cpu_show_hist, NULL, "Enable/Display instruction history" },
     { 0 }  
 };
@@ -368,8 +366,8 @@ t_stat sim_instr (void)
             break;
         }
 
-        if (hst_lnt) {                  /* record history? */
-            hst_ent = &hst[hst_p];
+        if (sim_hist_lnt) {             /* record history? */
+            hst_ent = (InstHistory *) sim_hist_add ();
             hst_ent->pc = PC;
             hst_ent->sp = SP;
             hst_ent->cc = CC;
@@ -378,9 +376,6 @@ t_stat sim_instr (void)
             hst_ent->ix = IX;
             for (i = 0; i < HIST_ILNT; i++)
                 hst_ent->inst[i] = (t_value)CPU_BD_get_mbyte (PC + i);
-            hst_p = (hst_p + 1);
-            if (hst_p >= hst_lnt)
-                hst_p = 0;
         }
 
         sim_interval--;
@@ -2165,70 +2160,30 @@ t_stat parse_sym(CONST char *cptr, t_addr addr, UNIT *uptr, t_value *val, int32
 
 t_stat cpu_set_hist (UNIT *uptr, int32 val, CONST char *cptr, void *desc)
 {
-    int i, lnt;
-    t_stat r;
-
-    if (cptr == NULL) {
-        for (i = 0; i < hst_lnt; i++)
-            hst[i].pc = 0;
-        hst_p = 0;
-        return SCPE_OK;
-        }
-    lnt = (int32) get_uint (cptr, 10, HIST_MAX, &r);
-if (r != SCPE_OK)
-    return sim_messagef (SCPE_ARG, "Invalid Numeric Value: %s.  Maximum is %d\n", cptr, HIST_MAX);
-if (lnt && (lnt < HIST_MIN))
-    return sim_messagef (SCPE_ARG, "%d is less than the minumum history value of %d\n", lnt, HIST_MIN);
-    hst_p = 0;
-    if (hst_lnt) {
-        free (hst);
-        hst_lnt = 0;
-        hst = NULL;
-        }
-    if (lnt) {
-        hst = (InstHistory *) calloc (lnt, sizeof (InstHistory));
-        if (hst == NULL)
-            return SCPE_MEM;
-        hst_lnt = lnt;
-        }
-    return SCPE_OK;
+    return sim_hist_set (&m6800_dev, sizeof (InstHistory), &cpu_fprint_hist, HIST_MIN, HIST_MAX, cptr);
 }
 
 /* Show history */
 
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, CONST void *desc)
 {
-    int k, di, lnt, ir;
-    const char *cptr = (const char *) desc;
-    t_stat r;
-    InstHistory *h;
-
-    if (hst_lnt == 0)                       /* enabled? */
-        return SCPE_NOFNC;
-    if (cptr) {
-        lnt = (int32) get_uint (cptr, 10, hst_lnt, &r);
-        if ((r != SCPE_OK) || (lnt == 0))
-            return sim_messagef (SCPE_ARG, "Invalid count specifier: %s, max is %d\n", cptr, hst_lnt);
-        }
-    else lnt = hst_lnt;
-    di = hst_p - lnt;                       /* work forward */
-    if (di < 0)
-        di = di + hst_lnt;
-    fprintf (st, "PC   SP   CC A  B  IX   Instruction\n\n");
-    for (k = 0; k < lnt; k++) {             /* print specified */
-        if (stop_cpu) {                     /* Control-C (SIGINT) */
-            stop_cpu = FALSE;
-            break;                          /* abandon remaining output */
-            }
-        h = &hst[(di++) % hst_lnt];         /* entry pointer */
-        ir = h->inst[0];
-        fprintf (st, "%04X %04X %02X ", h->pc , h->sp, h->cc);
-        fprintf (st, "%02X %02X %04X ", h->a, h->b, h->ix);
-        if ((fprint_sym (st, h->pc, h->inst, &m6800_unit, SWMASK ('M'))) > 0)
-            fprintf (st, "(undefined) %02X", h->inst[0]);
-        fputc ('\n', st);                               /* end line */
+    return sim_hist_show (st, &m6800_dev, sizeof (InstHistory), &cpu_fprint_hist, (const char *) desc);
+}
+
+/* Print one history entry, or the column headings */
+
+static void cpu_fprint_hist (FILE *st, const void *rec, t_bool timed)
+{
+    const InstHistory *h = (const InstHistory *) rec;
+
+    if (h == NULL) {
+        fprintf (st, "PC   SP   CC A  B  IX   Instruction\n\n");
+        return;
         }
-    return SCPE_OK;
+    fprintf (st, "%04X %04X %02X ", h->pc , h->sp, h->cc);
+    fprintf (st, "%02X %02X %04X ", h->a, h->b, h->ix);
+    if ((fprint_sym (st, h->pc, (t_value *) h->inst, &m6800_unit, SWMASK ('M'))) > 0)
+        fprintf (st, "(undefined) %02X", h->inst[0]);
 }
 
 /* Memory examine */